@@ -59,6 +59,7 @@
 #include <ti/devices/msp/peripherals/hw_iomux.h>
 #include "LaunchPad.h"
 #include "clock.h"
+#include "kernel.h"
 
 
 //-----------------------------------------------------------------------------
@@ -68,6 +69,15 @@
 #define ACTIVE_LOW                                                          (0)
 #define ACTIVE_HIGH                                                         (1)
 
+// Phases of the I2C transfer in flight
+#define I2C_STATE_IDLE                                                       (0)
+#define I2C_STATE_TX                                                         (1)
+#define I2C_STATE_RX                                                         (2)
+
+// I2C functional clock divider from ULPCLK, and ULPCLK from MCLK
+#define I2C_CLOCK_DIV                                                        (4)
+#define I2C_ULPCLK_DIV                                                       (2)
+
 
 //-----------------------------------------------------------------------------
 // Define global variable and structures here.
@@ -92,6 +102,24 @@ typedef struct
   uint8_t  io_func;
 } i2c_struct;
 
+// The I2C transfer in flight, shared with the I2C ISR
+typedef struct
+{
+  const uint8_t    *tx_buffer;
+  uint8_t          *rx_buffer;
+  uint16_t          tx_count;
+  uint16_t          tx_index;
+  uint16_t          rx_count;
+  uint16_t          rx_index;
+  uint8_t           slave;
+  i2c_callback_t    callback;
+  volatile uint8_t  state;
+  volatile uint32_t status;
+} i2c_xfer_struct;
+
+static i2c_stats_struct g_i2c_stats = {0};
+static i2c_xfer_struct g_i2c_xfer = {0};
+
 
 // Define the configuration data for the LEDs on the LP-MSPM0G3507
 const gpio_struct lp_led_config_data[] = {
@@ -1520,6 +1548,63 @@ void wait_no_key_pressed(void)
 //***************************************************************************
 
 
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function sets the SCL period for I2C_BUS_SPEED_HZ from the bus
+//    clock. The I2C module clock is MCLK / (UDIV * DIV_BY_n) and
+//    FSCL = I2C_ClkPeriod*(1+MTPR)*10, so for example:
+//    MCLK=40MHz, MTPR=4, frequency =  5MHz/50  = 100kHz
+//    MCLK=80MHz, MTPR=9, frequency = 10MHz/100 = 100kHz
+//    MTPR is rounded up, so SCL never runs faster than I2C_BUS_SPEED_HZ
+//    at bus clocks that do not divide evenly:
+//    MCLK=50MHz, MTPR=6, frequency = 6.25MHz/70 = 89kHz
+//
+// INPUT PARAMETERS:
+//    bus_clock_freq - the bus clock frequency in Hz
+//
+// OUTPUT PARAMETERS:
+//    none
+//
+// RETURN:
+//    none
+// -----------------------------------------------------------------------------
+static void I2C_set_bus_speed(uint32_t bus_clock_freq)
+{
+  uint32_t module_clock = bus_clock_freq / I2C_ULPCLK_DIV / I2C_CLOCK_DIV;
+  uint32_t period_clock = 10 * I2C_BUS_SPEED_HZ;
+
+  I2C_INST->MASTER.MTPR = (module_clock + period_clock - 1) / period_clock - 1;
+} /* I2C_set_bus_speed */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function keeps the I2C bus speed across a bus clock change. Before
+//    the change it lets the transfer in flight finish; after it, it sets the
+//    SCL period for the new bus clock.
+//
+// INPUT PARAMETERS:
+//    stage - CLOCK_CHANGE_PREPARE or CLOCK_CHANGE_COMMIT
+//    freq  - the new bus clock frequency in Hz
+//
+// OUTPUT PARAMETERS:
+//    none
+//
+// RETURN:
+//    none
+// -----------------------------------------------------------------------------
+static void I2C_clock_changed(uint8_t stage, uint32_t freq)
+{
+  if (stage == CLOCK_CHANGE_PREPARE)
+  {
+    while (g_i2c_xfer.state != I2C_STATE_IDLE);
+    return;
+  } /* if */
+
+  I2C_set_bus_speed(freq);
+} /* I2C_clock_changed */
+
+
 //-----------------------------------------------------------------------------
 // DESCRIPTION:
 //    This function initializes the I2C peripheral for communication with a
@@ -1571,19 +1656,33 @@ void I2C_init(void)
 
   I2C_INST->MASTER.MCTR = 0x00;
 
-  // I2C_mod = MCLK/(UDIV * DIV_BY_n) = 40MHz/(2*4) = 5MHz
-  // Set the timer period for the SCL clock to 100kHz
-  // FSCL = I2C_ClkPeriod*(1+MTPR)*10
-  // MCLK=32MHz, make MTPR=7, frequency =   8MHz/80 = 100kHz
-  // MCLK=40MHz, make MTPR=4, frequency =   5MHz/50 = 100kHz
-  // MCLK=80MHz, make MTPR=9, frequency = 10MHz/100 = 100kHz
-  I2C_INST->MASTER.MTPR = 4;
+  // Set the timer period for the SCL clock to 100kHz, and keep it there
+  // when the bus clock changes
+  I2C_set_bus_speed(get_bus_clock_freq());
+  clock_register_notifier(I2C_clock_changed);
 
   // Setup IIC configuration options
   I2C_INST->MASTER.MCR = I2C_MCR_CLKSTRETCH_ENABLE;
 
-  // Disable using interrupts; FIFO triggers not used
-  I2C_INST->MASTER.MFIFOCTL = 0;
+  // FIFO triggers refill and drain bursts longer than the FIFO depth
+  I2C_INST->MASTER.MFIFOCTL = (I2C_TX_FIFO_TRIGGER | I2C_RX_FIFO_TRIGGER);
+
+  // Completion and error interrupts stay on; the FIFO triggers are only
+  // unmasked while a transfer needs them
+  I2C_INST->CPU_INT.ICLR = (I2C_CPU_INT_ICLR_MTXDONE_CLR |
+                            I2C_CPU_INT_ICLR_MRXDONE_CLR |
+                            I2C_CPU_INT_ICLR_MNACK_CLR |
+                            I2C_CPU_INT_ICLR_MARBLOST_CLR |
+                            I2C_CPU_INT_ICLR_MTXFIFOTRG_CLR |
+                            I2C_CPU_INT_ICLR_MRXFIFOTRG_CLR);
+  I2C_INST->CPU_INT.IMASK = (I2C_CPU_INT_IMASK_MTXDONE_SET |
+                             I2C_CPU_INT_IMASK_MRXDONE_SET |
+                             I2C_CPU_INT_IMASK_MNACK_SET |
+                             I2C_CPU_INT_IMASK_MARBLOST_SET);
+  NVIC_EnableIRQ(I2C_INST_INT_IRQN);
+
+  g_i2c_xfer.state = I2C_STATE_IDLE;
+  g_i2c_xfer.status = I2C_STATUS_OK;
 
   // Configuration done, enable IIC
   I2C_INST->MASTER.MCR |= I2C_MCR_ACTIVE_ENABLE;
@@ -1592,56 +1691,472 @@ void I2C_init(void)
 
 //-----------------------------------------------------------------------------
 // DESCRIPTION:
-//    This function fills the I2C transmit FIFO buffer with data from the
-//    provided buffer. It writes a specified number of bytes to the FIFO and
-//    checks if the FIFO is full during the process. If the FIFO is full,
-//    the function returns a failure status; otherwise, it returns success.
+//    This function fills the I2C transmit FIFO with the next bytes of the
+//    transfer in flight, as many as the FIFO has room for. Once every byte
+//    is queued the TX FIFO trigger interrupt is masked again. It is called
+//    to prime the FIFO before a burst starts and from the I2C ISR while the
+//    burst runs.
+//
+// INPUT PARAMETERS:
+//    none
+//
+// OUTPUT PARAMETERS:
+//    none
+//
+// RETURN:
+//    none
+// -----------------------------------------------------------------------------
+static void I2C_fill_tx_fifo(void)
+{
+  while ((g_i2c_xfer.tx_index < g_i2c_xfer.tx_count) &&
+         ((I2C_INST->MASTER.MFIFOSR & I2C_MFIFOSR_TXFIFOCNT_MASK) != 0))
+  {
+    I2C_INST->MASTER.MTXDATA = g_i2c_xfer.tx_buffer[g_i2c_xfer.tx_index++];
+  } /* while */
+
+  if (g_i2c_xfer.tx_index == g_i2c_xfer.tx_count)
+  {
+    I2C_INST->CPU_INT.IMASK &= ~I2C_CPU_INT_IMASK_MTXFIFOTRG_SET;
+  } /* if */
+} /* I2C_fill_tx_fifo */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function moves the bytes waiting in the I2C receive FIFO into the
+//    buffer of the transfer in flight. Bytes beyond the requested count are
+//    left in the FIFO.
+//
+// INPUT PARAMETERS:
+//    none
+//
+// OUTPUT PARAMETERS:
+//    none
+//
+// RETURN:
+//    none
+// -----------------------------------------------------------------------------
+static void I2C_drain_rx_fifo(void)
+{
+  while ((g_i2c_xfer.rx_index < g_i2c_xfer.rx_count) &&
+         ((I2C_INST->MASTER.MFIFOSR & I2C_MFIFOSR_RXFIFOCNT_MASK) != 0))
+  {
+    g_i2c_xfer.rx_buffer[g_i2c_xfer.rx_index++] =
+                                    (uint8_t)I2C_INST->MASTER.MRXDATA;
+  } /* while */
+} /* I2C_drain_rx_fifo */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function starts the read phase of the transfer in flight. It
+//    addresses the slave for reading, with a repeated START when a write
+//    phase came first, and asks for the whole read in one burst ending in a
+//    STOP. The controller NACKs the last byte as the I2C protocol requires.
 //
 // INPUT PARAMETERS:
-//    buffer - Pointer to the data buffer that holds the bytes to be transmitted.
-//    count  - The number of bytes to be written to the I2C transmit FIFO.
+//    none
 //
 // OUTPUT PARAMETERS:
 //    none
 //
 // RETURN:
-//    1 if all bytes are written to the FIFO without issue,
-//    0 if the FIFO was full before all bytes could be written.
+//    none
 // -----------------------------------------------------------------------------
-uint32_t static I2C_fill_tx_fifo(uint8_t *buffer, uint16_t count)
+static void I2C_start_read(void)
 {
-  uint32_t ret_status = 1;
+  g_i2c_xfer.state = I2C_STATE_RX;
+
+  I2C_INST->CPU_INT.ICLR = I2C_CPU_INT_ICLR_MRXFIFOTRG_CLR;
+  I2C_INST->CPU_INT.IMASK |= I2C_CPU_INT_IMASK_MRXFIFOTRG_SET;
+
+  I2C_INST->MASTER.MSA = ((g_i2c_xfer.slave << 1) | I2C_MSA_DIR_RECEIVE);
+  I2C_INST->MASTER.MCTR = (((uint32_t)g_i2c_xfer.rx_count <<
+                            I2C_MCTR_MBLEN_OFS) | I2C_MCTR_STOP_ENABLE |
+                           I2C_MCTR_START_ENABLE | I2C_MCTR_BURSTRUN_ENABLE);
+} /* I2C_start_read */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function ends the transfer in flight. It masks the FIFO trigger
+//    interrupts, counts the transfer in the I2C stats, flushes the FIFOs if
+//    the transfer failed, marks the bus idle and then reports the status to
+//    the completion callback and to any task waiting in I2C_wait(). The bus
+//    is idle before the callback runs, so the callback may start the next
+//    transfer.
+//
+// INPUT PARAMETERS:
+//    status - I2C_STATUS_xxx result of the transfer
+//
+// OUTPUT PARAMETERS:
+//    none
+//
+// RETURN:
+//    none
+// -----------------------------------------------------------------------------
+static void I2C_finish(uint32_t status)
+{
+  i2c_callback_t callback = g_i2c_xfer.callback;
+
+  I2C_INST->CPU_INT.IMASK &= ~(I2C_CPU_INT_IMASK_MTXFIFOTRG_SET |
+                               I2C_CPU_INT_IMASK_MRXFIFOTRG_SET);
+
+  g_i2c_stats.xfers++;
+  g_i2c_stats.tx_bytes += g_i2c_xfer.tx_index;
+  g_i2c_stats.rx_bytes += g_i2c_xfer.rx_index;
 
-  for(uint8_t i = 0; i < count; i++)
+  if (status != I2C_STATUS_OK)
   {
-    if ((I2C1->MASTER.MFIFOSR & I2C_MFIFOSR_TXFIFOCNT_MASK) == 0)
+    if (status == I2C_STATUS_ARB_LOST)
     {
-      // fail TxFifo full
-      ret_status = 0;
+      g_i2c_stats.arb_lost++;
+    }
+    else
+    {
+      g_i2c_stats.nacks++;
     } /* if */
 
-    I2C1->MASTER.MTXDATA = buffer[i];
-  } /* for */
+    // drop whatever the failed burst left behind
+    I2C_INST->MASTER.MFIFOCTL |= (I2C_MFIFOCTL_TXFLUSH_FLUSH |
+                                  I2C_MFIFOCTL_RXFLUSH_FLUSH);
+    I2C_INST->MASTER.MFIFOCTL &= ~(I2C_MFIFOCTL_TXFLUSH_FLUSH |
+                                   I2C_MFIFOCTL_RXFLUSH_FLUSH);
+  } /* if */
+
+  g_i2c_xfer.status = status;
+  g_i2c_xfer.state = I2C_STATE_IDLE;
 
-  return (ret_status);
+  if (callback != NULL)
+  {
+    callback(status);
+  } /* if */
 
-} /*I2C_fill_tx_fifo */
+  kernel_signal_event(KERNEL_EVENT_I2C_DONE);
+} /* I2C_finish */
 
 
 //-----------------------------------------------------------------------------
 // DESCRIPTION:
-//    This function sends a single byte of data to a specified I2C slave device.
-//    It sets up the I2C communication by filling the transmit FIFO with the 
-//    data byte, configures the I2C controller for the transmission, and waits 
-//    for the transmission to complete. The function also checks for errors 
-//    during the process and returns a status indicating success or failure.
+//    This function starts an interrupt driven I2C transfer: an optional
+//    write phase followed by an optional read phase. Each phase is a single
+//    burst of up to I2C_MAX_BURST_LEN bytes. When both phases are used the
+//    read follows the write with a repeated START instead of a STOP. The
+//    function primes the transmit FIFO, starts the controller and returns;
+//    the I2C ISR keeps the FIFOs moving and ends the transfer.
+//
+// INPUT PARAMETERS:
+//    slave     - The 7-bit address of the I2C slave device.
+//
+//    tx_buffer - The bytes to write. Must stay valid until the transfer ends.
+//
+//    tx_count  - The number of bytes to write, 0 to skip the write phase.
+//
+//    rx_buffer - Where the bytes read are stored. Must stay valid until the
+//                transfer ends.
 //
-//    The function performs the following operations:
-//    - Fills the I2C transmit FIFO with one byte of data.
-//    - Waits until the I2C controller is idle.
-//    - Configures the I2C controller to send data to the slave device.
-//    - Starts the I2C transmission with the appropriate control settings.
-//    - Waits for the I2C transmission to complete and checks for errors.
+//    rx_count  - The number of bytes to read, 0 to skip the read phase.
+//
+//    callback  - Called from the I2C ISR when the transfer ends, or NULL.
+//
+// OUTPUT PARAMETERS:
+//    none
+//
+// RETURN:
+//    I2C_STATUS_OK if the transfer was started,
+//    I2C_STATUS_BUSY if another transfer is still in flight,
+//    I2C_STATUS_INVALID if a length is out of range.
+// -----------------------------------------------------------------------------
+static uint32_t I2C_start(uint8_t slave, const uint8_t *tx_buffer,
+                          uint16_t tx_count, uint8_t *rx_buffer,
+                          uint16_t rx_count, i2c_callback_t callback)
+{
+  uint32_t primask;
+  uint32_t mctr;
+  bool busy;
+
+  if ((tx_count > I2C_MAX_BURST_LEN) || (rx_count > I2C_MAX_BURST_LEN) ||
+      ((tx_count == 0) && (rx_count == 0)))
+  {
+    return (I2C_STATUS_INVALID);
+  } /* if */
+
+  // claim the bus; another task may be trying to do the same
+  primask = __get_PRIMASK();
+  __disable_irq();
+  busy = (g_i2c_xfer.state != I2C_STATE_IDLE);
+  if (!busy)
+  {
+    g_i2c_xfer.state = I2C_STATE_TX;
+  } /* if */
+  __set_PRIMASK(primask);
+
+  if (busy)
+  {
+    return (I2C_STATUS_BUSY);
+  } /* if */
+
+  g_i2c_xfer.slave = slave;
+  g_i2c_xfer.tx_buffer = tx_buffer;
+  g_i2c_xfer.tx_count = tx_count;
+  g_i2c_xfer.tx_index = 0;
+  g_i2c_xfer.rx_buffer = rx_buffer;
+  g_i2c_xfer.rx_count = rx_count;
+  g_i2c_xfer.rx_index = 0;
+  g_i2c_xfer.callback = callback;
+  g_i2c_xfer.status = I2C_STATUS_BUSY;
+
+  // wait until I2C controller idle (IDLE bit = 1)
+  while((I2C_INST->MASTER.MSR & I2C_MSR_IDLE_MASK) == I2C_MSR_IDLE_CLEARED);
+
+  if (tx_count == 0)
+  {
+    I2C_start_read();
+    return (I2C_STATUS_OK);
+  } /* if */
+
+  // prime the TX FIFO, the ISR tops it up if the burst is longer. The
+  // trigger is unmasked only once the FIFO is primed, and with interrupts
+  // masked, so the ISR never fills it or updates IMASK under this task.
+  primask = __get_PRIMASK();
+  __disable_irq();
+  I2C_fill_tx_fifo();
+  I2C_INST->CPU_INT.ICLR = I2C_CPU_INT_ICLR_MTXFIFOTRG_CLR;
+  if (g_i2c_xfer.tx_index < g_i2c_xfer.tx_count)
+  {
+    I2C_INST->CPU_INT.IMASK |= I2C_CPU_INT_IMASK_MTXFIFOTRG_SET;
+  } /* if */
+  __set_PRIMASK(primask);
+
+  // a read phase follows with a repeated START, so no STOP after the write
+  mctr = (((uint32_t)tx_count << I2C_MCTR_MBLEN_OFS) |
+          I2C_MCTR_START_ENABLE | I2C_MCTR_BURSTRUN_ENABLE);
+  if (rx_count == 0)
+  {
+    mctr |= I2C_MCTR_STOP_ENABLE;
+  } /* if */
+
+  I2C_INST->MASTER.MSA = (slave << 1);
+  I2C_INST->MASTER.MCTR = mctr;
+
+  return (I2C_STATUS_OK);
+} /* I2C_start */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function runs an I2C transfer and waits for it to end. If another
+//    transfer is in flight it sleeps a tick at a time until the bus is free,
+//    so it never steals the completion event of the task that owns it.
+//
+// INPUT PARAMETERS:
+//    slave     - The 7-bit address of the I2C slave device.
+//
+//    tx_buffer - The bytes to write.
+//
+//    tx_count  - The number of bytes to write, 0 to skip the write phase.
+//
+//    rx_buffer - Where the bytes read are stored.
+//
+//    rx_count  - The number of bytes to read, 0 to skip the read phase.
+//
+// OUTPUT PARAMETERS:
+//    none
+//
+// RETURN:
+//    the I2C_STATUS_xxx result of the transfer
+// -----------------------------------------------------------------------------
+static uint32_t I2C_transfer(uint8_t slave, const uint8_t *tx_buffer,
+                             uint16_t tx_count, uint8_t *rx_buffer,
+                             uint16_t rx_count)
+{
+  uint32_t status;
+
+  status = I2C_start(slave, tx_buffer, tx_count, rx_buffer, rx_count, NULL);
+  while (status == I2C_STATUS_BUSY)
+  {
+    kernel_sleep(1);
+    status = I2C_start(slave, tx_buffer, tx_count, rx_buffer, rx_count,
+                       NULL);
+  } /* while */
+
+  if (status == I2C_STATUS_OK)
+  {
+    status = I2C_wait();
+  } /* if */
+
+  return (status);
+} /* I2C_transfer */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function starts writing a buffer of bytes to an I2C slave device
+//    in a single burst, with one START and one STOP around the whole buffer.
+//    It returns once the burst is started; the I2C ISR feeds the transmit
+//    FIFO and calls the callback when the burst ends.
+//
+// INPUT PARAMETERS:
+//    slave    - The 7-bit address of the I2C slave device to which data is
+//               sent.
+//
+//    buffer   - The bytes to be transmitted. Must stay valid until the
+//               transfer ends.
+//
+//    count    - The number of bytes to send, 1 to I2C_MAX_BURST_LEN.
+//
+//    callback - Called from the I2C ISR when the transfer ends, or NULL.
+//
+// OUTPUT PARAMETERS:
+//    none
+//
+// RETURN:
+//    I2C_STATUS_OK if the transfer was started,
+//    I2C_STATUS_BUSY if another transfer is still in flight,
+//    I2C_STATUS_INVALID if count is out of range.
+// -----------------------------------------------------------------------------
+uint32_t I2C_write(uint8_t slave, const uint8_t *buffer, uint16_t count,
+                   i2c_callback_t callback)
+{
+  if (count == 0)
+  {
+    return (I2C_STATUS_INVALID);
+  } /* if */
+
+  return (I2C_start(slave, buffer, count, NULL, 0, callback));
+} /* I2C_write */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function starts reading a buffer of bytes from an I2C slave device
+//    in a single burst. It returns once the burst is started; the I2C ISR
+//    drains the receive FIFO and calls the callback when the burst ends.
+//
+// INPUT PARAMETERS:
+//    slave    - The 7-bit address of the I2C slave device to read from.
+//
+//    buffer   - Where the bytes read are stored. Must stay valid until the
+//               transfer ends.
+//
+//    count    - The number of bytes to read, 1 to I2C_MAX_BURST_LEN.
+//
+//    callback - Called from the I2C ISR when the transfer ends, or NULL.
+//
+// OUTPUT PARAMETERS:
+//    none
+//
+// RETURN:
+//    I2C_STATUS_OK if the transfer was started,
+//    I2C_STATUS_BUSY if another transfer is still in flight,
+//    I2C_STATUS_INVALID if count is out of range.
+// -----------------------------------------------------------------------------
+uint32_t I2C_read(uint8_t slave, uint8_t *buffer, uint16_t count,
+                  i2c_callback_t callback)
+{
+  if (count == 0)
+  {
+    return (I2C_STATUS_INVALID);
+  } /* if */
+
+  return (I2C_start(slave, NULL, 0, buffer, count, callback));
+} /* I2C_read */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function starts the usual register read of an I2C sensor: it
+//    writes a buffer (typically a register address) and then reads a reply
+//    after a repeated START, without releasing the bus in between. It
+//    returns once the write is started; the I2C ISR runs both phases and
+//    calls the callback when the read ends or either phase fails.
+//
+// INPUT PARAMETERS:
+//    slave     - The 7-bit address of the I2C slave device.
+//
+//    tx_buffer - The bytes to write. Must stay valid until the transfer
+//                ends.
+//
+//    tx_count  - The number of bytes to write, 1 to I2C_MAX_BURST_LEN.
+//
+//    rx_buffer - Where the bytes read are stored. Must stay valid until the
+//                transfer ends.
+//
+//    rx_count  - The number of bytes to read, 1 to I2C_MAX_BURST_LEN.
+//
+//    callback  - Called from the I2C ISR when the transfer ends, or NULL.
+//
+// OUTPUT PARAMETERS:
+//    none
+//
+// RETURN:
+//    I2C_STATUS_OK if the transfer was started,
+//    I2C_STATUS_BUSY if another transfer is still in flight,
+//    I2C_STATUS_INVALID if a count is out of range.
+// -----------------------------------------------------------------------------
+uint32_t I2C_write_read(uint8_t slave, const uint8_t *tx_buffer,
+                        uint16_t tx_count, uint8_t *rx_buffer,
+                        uint16_t rx_count, i2c_callback_t callback)
+{
+  if ((tx_count == 0) || (rx_count == 0))
+  {
+    return (I2C_STATUS_INVALID);
+  } /* if */
+
+  return (I2C_start(slave, tx_buffer, tx_count, rx_buffer, rx_count,
+                    callback));
+} /* I2C_write_read */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function reports whether an I2C transfer is still in flight.
+//
+// INPUT PARAMETERS:
+//    none
+//
+// OUTPUT PARAMETERS:
+//    none
+//
+// RETURN:
+//    true if a transfer is in flight, false if the bus is idle
+// -----------------------------------------------------------------------------
+bool I2C_busy(void)
+{
+  return (g_i2c_xfer.state != I2C_STATE_IDLE);
+} /* I2C_busy */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function waits for the I2C transfer in flight to end. The calling
+//    task sleeps on the I2C completion event instead of polling the
+//    controller, so other tasks run while the bytes are on the bus.
+//
+// INPUT PARAMETERS:
+//    none
+//
+// OUTPUT PARAMETERS:
+//    none
+//
+// RETURN:
+//    the I2C_STATUS_xxx result of the last transfer
+// -----------------------------------------------------------------------------
+uint32_t I2C_wait(void)
+{
+  while (g_i2c_xfer.state != I2C_STATE_IDLE)
+  {
+    kernel_wait_event(KERNEL_EVENT_I2C_DONE);
+  } /* while */
+
+  return (g_i2c_xfer.status);
+} /* I2C_wait */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function sends a single byte of data to a specified I2C slave
+//    device and waits for the transfer to end.
 //
 // INPUT PARAMETERS:
 //    slave  - The 7-bit address of the I2C slave device to which data is sent.
@@ -1658,42 +2173,210 @@ uint32_t static I2C_fill_tx_fifo(uint8_t *buffer, uint16_t count)
 // -----------------------------------------------------------------------------
 uint32_t I2C_send1(uint8_t slave, uint8_t data1)
 {
-  uint32_t I2C_error;
-  uint32_t ret_status = 1;
+  return (I2C_send(slave, &data1, 1));
+} /* I2C_send1 */
 
-  if(I2C_fill_tx_fifo(&data1, 1) == 0)
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function sends a buffer of bytes to a specified I2C slave device in
+//    a single burst, with one START and one STOP around the whole buffer, and
+//    waits for the burst to end. The calling task sleeps while the I2C ISR
+//    moves the bytes.
+//
+// INPUT PARAMETERS:
+//    slave  - The 7-bit address of the I2C slave device to which data is sent.
+//             The address is shifted left by 1 to fit the I2C address format.
+//
+//    buffer - The bytes to be transmitted to the slave device.
+//
+//    count  - The number of bytes to send, 1 to I2C_MAX_BURST_LEN.
+//
+// OUTPUT PARAMETERS:
+//    none
+//
+// RETURN:
+//    1 if the transmission was successful without errors,
+//    0 if there was an error during the transmission process.
+// -----------------------------------------------------------------------------
+uint32_t I2C_send(uint8_t slave, const uint8_t *buffer, uint16_t count)
+{
+  if (count == 0)
+  {
     return 0;
+  } /* if */
+
+  return (I2C_transfer(slave, buffer, count, NULL, 0) == I2C_STATUS_OK);
+} /* I2C_send */
 
-  // wait until I2C controller idle (IDLE bit = 1)
-  while((I2C1->MASTER.MSR & I2C_MSR_IDLE_MASK) == I2C_MSR_IDLE_CLEARED);
 
-  // bit 7-1 address
-  // bit 0 direction=0 transmit
-  I2C1->MASTER.MSA = (slave << 1);
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function reads a single byte from a specified I2C slave device and
+//    waits for the transfer to end.
+//
+// INPUT PARAMETERS:
+//    slave  - The 7-bit address of the I2C slave device to read from.
+//
+// OUTPUT PARAMETERS:
+//    none
+//
+// RETURN:
+//    the byte read, or 0 if the transfer failed
+// -----------------------------------------------------------------------------
+uint8_t I2C_recv1(uint8_t slave)
+{
+  uint8_t data[1] = {0};
+
+  if (I2C_transfer(slave, NULL, 0, data, 1) != I2C_STATUS_OK)
+  {
+    data[0] = 0;
+  } /* if */
+
+  return (data[0]);
+} /* I2C_recv1 */
 
-  // bits 27-16 MBLEN =1 (length)
-  // bit 3 ACK, bit 2 STOP=1, bit 1 START=1, bit 0 BURSTRUN=1
-  //I2C1->MASTER.MCTR = 0x00010007;
-  I2C1->MASTER.MCTR = (0x00010000 |  I2C_MCTR_ACK_ENABLE |
-                       I2C_MCTR_STOP_ENABLE | I2C_MCTR_START_ENABLE |
-                       I2C_MCTR_BURSTRUN_ENABLE);
 
-  // wait until not I2C controller FSM is not busy
-  while((I2C1->MASTER.MSR & I2C_MSR_BUSY_MASK) == I2C_MSR_BUSY_SET);
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function reads two bytes from a specified I2C slave device in one
+//    burst and waits for the transfer to end. The first byte received is
+//    the most significant.
+//
+// INPUT PARAMETERS:
+//    slave  - The 7-bit address of the I2C slave device to read from.
+//
+// OUTPUT PARAMETERS:
+//    none
+//
+// RETURN:
+//    the 16-bit value read, or 0 if the transfer failed
+// -----------------------------------------------------------------------------
+uint16_t I2C_recv2(uint8_t slave)
+{
+  uint8_t data[2] = {0, 0};
 
-  // check for error or if lost arbitration or no ack
-  if (I2C1->MASTER.MSR & (I2C_MSR_ARBLST_SET | I2C_MSR_ERR_SET))
+  if (I2C_transfer(slave, NULL, 0, data, 2) != I2C_STATUS_OK)
   {
-	  // help debugging
-    I2C_error = I2C1->MASTER.MSR;
-    ret_status = 0;
+    return 0;
   } /* if */
 
-  // wait until I2C controller idle (IDLE bit = 1)
-  while((I2C1->MASTER.MSR & I2C_MSR_IDLE_MASK) == I2C_MSR_IDLE_CLEARED);
+  return ((uint16_t)((data[0] << 8) | data[1]));
+} /* I2C_recv2 */
 
-  return (ret_status);
-} /* I2C_send1 */
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function services the I2C controller interrupt. It tops up the
+//    transmit FIFO and drains the receive FIFO while a burst runs, starts
+//    the read phase of a write-read after its write phase, and ends the
+//    transfer when the last phase completes or the slave NACKs or another
+//    controller wins arbitration. It is called from the I2C ISR.
+//
+// INPUT PARAMETERS:
+//    none
+//
+// OUTPUT PARAMETERS:
+//    none
+//
+// RETURN:
+//    none
+// -----------------------------------------------------------------------------
+void I2C_irq_handler(void)
+{
+  switch (I2C_INST->CPU_INT.IIDX)  // Read (clears)
+  {
+    case I2C_CPU_INT_IIDX_STAT_MTXFIFOTRG:
+      I2C_fill_tx_fifo();
+      break;
+
+    case I2C_CPU_INT_IIDX_STAT_MRXFIFOTRG:
+      I2C_drain_rx_fifo();
+      break;
+
+    case I2C_CPU_INT_IIDX_STAT_MTXDONEFG:
+      if (g_i2c_xfer.state == I2C_STATE_TX)
+      {
+        if (g_i2c_xfer.rx_count != 0)
+        {
+          I2C_start_read();
+        }
+        else
+        {
+          I2C_finish(I2C_STATUS_OK);
+        } /* if */
+      } /* if */
+      break;
+
+    case I2C_CPU_INT_IIDX_STAT_MRXDONEFG:
+      if (g_i2c_xfer.state == I2C_STATE_RX)
+      {
+        I2C_drain_rx_fifo();
+        I2C_finish(I2C_STATUS_OK);
+      } /* if */
+      break;
+
+    case I2C_CPU_INT_IIDX_STAT_MNACKFG:
+      if (g_i2c_xfer.state != I2C_STATE_IDLE)
+      {
+        I2C_finish(I2C_STATUS_NACK);
+      } /* if */
+      break;
+
+    case I2C_CPU_INT_IIDX_STAT_MARBLOSTFG:
+      if (g_i2c_xfer.state != I2C_STATE_IDLE)
+      {
+        I2C_finish(I2C_STATUS_ARB_LOST);
+      } /* if */
+      break;
+
+    default:
+      break;
+  } /* switch */
+} /* I2C_irq_handler */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function copies the I2C traffic totals counted since startup or 
+//    the last call to I2C_clear_stats().
+//
+// INPUT PARAMETERS:
+//    none
+//
+// OUTPUT PARAMETERS:
+//    stats - the I2C traffic totals
+//
+// RETURN:
+//    none
+// -----------------------------------------------------------------------------
+void I2C_get_stats(i2c_stats_struct *stats)
+{
+  *stats = g_i2c_stats;
+} /* I2C_get_stats */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function resets the I2C traffic totals to zero.
+//
+// INPUT PARAMETERS:
+//    none
+//
+// OUTPUT PARAMETERS:
+//    none
+//
+// RETURN:
+//    none
+// -----------------------------------------------------------------------------
+void I2C_clear_stats(void)
+{
+  g_i2c_stats.xfers = 0;
+  g_i2c_stats.tx_bytes = 0;
+  g_i2c_stats.rx_bytes = 0;
+  g_i2c_stats.nacks = 0;
+  g_i2c_stats.arb_lost = 0;
+} /* I2C_clear_stats */
 
 
 
@@ -247,6 +247,33 @@
 #define I2C_SCL_IOMUX                                            (IOMUX_PINCM15)
 #define I2C_SCL_PINCM_IOMUX_FUNC                     (IOMUX_PINCM15_PF_I2C1_SCL)
 
+// Longest burst one START/STOP can carry (12-bit MBLEN field)
+#define I2C_MAX_BURST_LEN                                                 (4095)
+
+// FIFO levels that raise the I2C FIFO trigger interrupts
+#define I2C_TX_FIFO_TRIGGER                         (I2C_MFIFOCTL_TXTRIG_LEVEL_4)
+#define I2C_RX_FIFO_TRIGGER                         (I2C_MFIFOCTL_RXTRIG_LEVEL_4)
+
+// Status reported by the I2C transfer functions and completion callback
+#define I2C_STATUS_OK                                                        (0)
+#define I2C_STATUS_BUSY                                                      (1)
+#define I2C_STATUS_NACK                                                      (2)
+#define I2C_STATUS_ARB_LOST                                                  (3)
+#define I2C_STATUS_INVALID                                                   (4)
+
+// Called from the I2C ISR when a transfer ends, with its I2C_STATUS_xxx
+typedef void (*i2c_callback_t)(uint32_t status);
+
+// Running totals of I2C traffic, used to measure driver throughput
+typedef struct
+{
+  uint32_t xfers;
+  uint32_t tx_bytes;
+  uint32_t rx_bytes;
+  uint32_t nacks;
+  uint32_t arb_lost;
+} i2c_stats_struct;
+
 
 
 // --------------------------------------------------------------------------
@@ -290,6 +317,19 @@ void I2C_init(void);
 uint8_t I2C_recv1(uint8_t slave);
 uint16_t I2C_recv2(uint8_t slave);
 uint32_t I2C_send1(uint8_t slave, uint8_t data);
+uint32_t I2C_send(uint8_t slave, const uint8_t *buffer, uint16_t count);
+uint32_t I2C_write(uint8_t slave, const uint8_t *buffer, uint16_t count,
+                   i2c_callback_t callback);
+uint32_t I2C_read(uint8_t slave, uint8_t *buffer, uint16_t count,
+                  i2c_callback_t callback);
+uint32_t I2C_write_read(uint8_t slave, const uint8_t *tx_buffer,
+                        uint16_t tx_count, uint8_t *rx_buffer,
+                        uint16_t rx_count, i2c_callback_t callback);
+bool I2C_busy(void);
+uint32_t I2C_wait(void);
+void I2C_irq_handler(void);
+void I2C_get_stats(i2c_stats_struct *stats);
+void I2C_clear_stats(void);
 
 void motor0_init(void);
 void motor0_pwm_init(uint32_t load_value, uint32_t compare_value);
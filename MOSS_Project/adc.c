@@ -68,9 +68,94 @@
 #include <ti/devices/msp/msp.h>
 #include "ti/devices/msp/peripherals/hw_adc12.h"
 #include "clock.h"
+#include "kernel.h"
 #include "adc.h"
 
 
+//-----------------------------------------------------------------------------
+// Define symbolic constants used by the program
+//-----------------------------------------------------------------------------
+// The ADC samples on ULPCLK, half of MCLK
+#define ADC0_ULPCLK_DIV                                                      (2)
+
+#define USEC_PER_SECOND                                                (1000000)
+
+
+//-----------------------------------------------------------------------------
+// Define global variables and structures here.
+// NOTE: when possible avoid using global variables
+//-----------------------------------------------------------------------------
+
+// TMP61 temperature in tenths of a degree Celsius at every
+// THERMISTOR_TABLE_STEP ADC codes, from code 0 through code 4096. Generated 
+// by tests/gen_thermistor_table.c from the polynomial in
+// thermistor_calc_temperature(), rounded to the nearest tenth. The host
+// test build fails if the two differ; "make -C tests thermistor-table"
+// prints the entries to paste in after changing the coefficients or VBias.
+static const int16_t g_thermistor_table[THERMISTOR_TABLE_SIZE] = {
+  -4233, -3994, -3766, -3547, -3338, -3138, -2946, -2762,
+  -2587, -2419, -2257, -2103, -1955, -1812, -1676, -1544,
+  -1417, -1295, -1176, -1062,  -950,  -842,  -736,  -633,
+   -531,  -431,  -332,  -234,  -136,   -39,    59,   157,
+    257,   357,   459,   563,   669,   778,   889,  1004,
+   1123,  1245,  1371,  1502,  1638,  1779,  1925,  2078,
+   2236,  2401,  2572,  2750,  2936,  3129,  3330,  3539,
+   3757,  3984,  4219,  4464,  4719,  4983,  5258,  5543,
+   5839
+};
+
+// Define a structure to hold the state of the streaming engine
+typedef struct
+{
+  uint16_t              *buffer;
+  uint16_t               half_count;
+  adc_stream_callback_t  callback;
+  volatile bool          busy;
+} adc_stream_struct;
+
+static adc_stream_struct g_adc_stream = {0};
+
+// Define a structure to hold the state of timed acquisition. The ring holds
+// whole frames; head is only written by the ADC ISR, tail by the reader.
+typedef struct
+{
+  uint16_t          ring[ADC0_TIMED_RING_SIZE];
+  volatile uint16_t head;
+  volatile uint16_t tail;
+  uint8_t           channels[ADC0_STREAM_MAX_CHANNELS];
+  uint8_t           channel_count;
+  uint32_t          request_us;
+  uint32_t          period_us;
+  volatile bool     busy;
+} adc_timed_struct;
+
+static adc_timed_struct g_adc_timed = {0};
+static adc_timed_stats_struct g_adc_timed_stats = {0};
+
+// Define a structure to hold the state of window monitoring
+typedef struct
+{
+  uint16_t      value;
+  uint16_t      low;
+  uint16_t      high;
+  uint16_t      half_width;
+  uint32_t      events;
+  uint8_t       channel;
+  volatile bool busy;
+} adc_window_struct;
+
+static adc_window_struct g_adc_window = {0};
+
+
+//-----------------------------------------------------------------------------
+// Prototype for local functions
+//-----------------------------------------------------------------------------
+static void adc0_window_rearm(uint16_t value);
+static uint32_t adc0_clock_range(uint32_t sample_clock_freq);
+static void adc0_clock_changed(uint8_t stage, uint32_t freq);
+static void adc0_timed_set_rate(uint32_t freq);
+
+
 
 //-----------------------------------------------------------------------------
 // DESCRIPTION:
@@ -158,9 +243,138 @@ void ADC0_init(uint32_t reference)
     while((VREF->CTL1 & 0x01)==0){}; // wait for VREF to be ready
   } /* if */
 
+  clock_register_notifier(adc0_clock_changed);
+
 } /* ADC0_init */
 
 
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//   This function picks the CLKFREQ range setting that holds the sample
+//   clock frequency.
+//
+// INPUT PARAMETERS:
+//   sample_clock_freq - the ADC sample clock frequency in Hz
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   The ADC12_CLKFREQ_FRANGE_xxx value
+// -----------------------------------------------------------------------------
+static uint32_t adc0_clock_range(uint32_t sample_clock_freq)
+{
+  if (sample_clock_freq > 40000000)
+  {
+    return ADC12_CLKFREQ_FRANGE_RANGE40TO48;
+  } /* if */
+  else if (sample_clock_freq > 32000000)
+  {
+    return ADC12_CLKFREQ_FRANGE_RANGE32TO40;
+  } /* else if */
+  else if (sample_clock_freq > 24000000)
+  {
+    return ADC12_CLKFREQ_FRANGE_RANGE24TO32;
+  } /* else if */
+  else if (sample_clock_freq > 20000000)
+  {
+    return ADC12_CLKFREQ_FRANGE_RANGE20TO24;
+  } /* else if */
+  else if (sample_clock_freq > 16000000)
+  {
+    return ADC12_CLKFREQ_FRANGE_RANGE16TO20;
+  } /* else if */
+  else if (sample_clock_freq > 8000000)
+  {
+    return ADC12_CLKFREQ_FRANGE_RANGE8TO16;
+  } /* else if */
+  else if (sample_clock_freq > 4000000)
+  {
+    return ADC12_CLKFREQ_FRANGE_RANGE4TO8;
+  } /* else if */
+
+  return ADC12_CLKFREQ_FRANGE_RANGE1TO4;
+} /* adc0_clock_range */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//   This function follows a bus clock change. The sample clock range is set
+//   for the new ULPCLK, and if timed acquisition is running TIMG6 is set
+//   for the requested trigger period at the new clock. A conversion
+//   running across the change only samples for a little more or less time,
+//   so there is nothing to wait for beforehand.
+//
+// INPUT PARAMETERS:
+//   stage - CLOCK_CHANGE_PREPARE or CLOCK_CHANGE_COMMIT
+//   freq  - the new bus clock frequency in Hz
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+static void adc0_clock_changed(uint8_t stage, uint32_t freq)
+{
+  if (stage == CLOCK_CHANGE_PREPARE)
+  {
+    return;
+  } /* if */
+
+  ADC0->ULLMEM.CLKFREQ = adc0_clock_range(freq / ADC0_ULPCLK_DIV);
+
+  if (g_adc_timed.busy)
+  {
+    adc0_timed_set_rate(freq);
+  } /* if */
+} /* adc0_clock_changed */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//   This function sets the TIMG6 prescaler and period for the requested
+//   timed acquisition period at a given bus clock, and records the period
+//   actually achieved. TIMG6 counts BusClock / 8. The prescaler is rounded
+//   up so a tick is never shorter than ADC0_TIMED_TICK_US, which keeps the
+//   longest period within the 16-bit LOAD, and the tick count is rounded to
+//   nearest. When BusClock / 8 is a multiple of ADC0_TIMED_TICKS_PER_SEC,
+//   as at 40 and 80 MHz, the period is exact; otherwise it is off by at
+//   most half a tick, e.g. 9 MHz gives 20.44 us ticks.
+//
+// INPUT PARAMETERS:
+//   freq - the bus clock frequency in Hz
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+static void adc0_timed_set_rate(uint32_t freq)
+{
+  uint32_t timer_clock = freq / 8;
+  uint32_t prescale = (timer_clock + ADC0_TIMED_TICKS_PER_SEC - 1) /
+                      ADC0_TIMED_TICKS_PER_SEC;
+  uint64_t tick_scale = (uint64_t)prescale * USEC_PER_SECOND;
+  uint32_t ticks;
+
+  ticks = ((uint64_t)g_adc_timed.request_us * timer_clock + tick_scale / 2) /
+          tick_scale;
+  if (ticks == 0)
+  {
+    ticks = 1;
+  } /* if */
+
+  // TimerClock = BusClock / (8 * (PCNT + 1))
+  TIMG6->COMMONREGS.CPS = GPTIMER_CPS_PCNT_MASK & (prescale - 1);
+  TIMG6->COUNTERREGS.LOAD = GPTIMER_LOAD_LD_MASK & (ticks - 1);
+
+  g_adc_timed.period_us = (ticks * tick_scale + timer_clock / 2) /
+                          timer_clock;
+} /* adc0_timed_set_rate */
+
+
 //-----------------------------------------------------------------------------
 // DESCRIPTION:
 //   This function starts an ADC conversion on the ADC0 peripheral and waits 
@@ -176,7 +390,8 @@ void ADC0_init(uint32_t reference)
 //     returns it.
 //
 //   This function assumes that the ADC has been properly initialized using
-//   the `ADC0_init` function before calling this function.
+//   the `ADC0_init` function before calling this function, and that the ADC
+//   is not taken by another mode (see `ADC0_busy`).
 //
 // INPUT PARAMETERS:
 //   channel  - The ADC input channel to be used for the conversion. This
@@ -224,6 +439,745 @@ uint32_t ADC0_in(uint8_t channel)
 } /* ADC0_in */
 
 
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//   This function starts sampling several channels continuously without CPU
+//   involvement. Each channel gets a MEMCTL slot and the ADC repeats the
+//   sequence of slots on its own. Results go through the ADC FIFO, two per
+//   word, and a repeating DMA channel copies them into a double buffer:
+//   the callback is handed each half as it fills while the other half is
+//   being written, and the DMA starts over at the top after the second half.
+//
+//   With averaging enabled every result is the mean of 2^avg_log2 
+//   conversions, computed by the ADC (AVGN/AVGD), which lowers both noise 
+//   and the result rate.
+//
+//   `ADC0_in` must not be used while a stream is running (see `ADC0_busy`).
+//
+// INPUT PARAMETERS:
+//   channels      - The ADC input channels to sample, in sequence order
+//   channel_count - Number of channels (1 to ADC0_STREAM_MAX_CHANNELS)
+//   buffer        - Buffer for the results, both halves
+//   count         - Number of results the buffer holds. Each half must hold
+//                   a whole number of sequences and an even number of 
+//                   results.
+//   avg_log2      - Hardware averaging, 0 (off) to ADC0_STREAM_MAX_AVG_LOG2
+//   callback      - Function called from the DMA ISR for each full half
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   true  - if the stream was started
+//   false - if the ADC is in use or a parameter is out of range
+// -----------------------------------------------------------------------------
+bool ADC0_stream_start(const uint8_t *channels, uint8_t channel_count,
+                       uint16_t *buffer, uint16_t count, uint8_t avg_log2,
+                       adc_stream_callback_t callback)
+{
+  uint32_t avgen = ADC12_MEMCTL_AVGEN_DISABLE;
+  uint16_t half_count = count / 2;
+  uint8_t i;
+
+  if (ADC0_busy() || channel_count == 0 || 
+      channel_count > ADC0_STREAM_MAX_CHANNELS || 
+      avg_log2 > ADC0_STREAM_MAX_AVG_LOG2 || callback == NULL ||
+      half_count == 0 || (half_count % 2) != 0 || 
+      (half_count % channel_count) != 0)
+  {
+    return false;
+  } /* if */
+
+  if (avg_log2 > 0)
+  {
+    avgen = ADC12_MEMCTL_AVGEN_ENABLE;
+  } /* if */
+
+  g_adc_stream.buffer = buffer;
+  g_adc_stream.half_count = half_count;
+  g_adc_stream.callback = callback;
+  g_adc_stream.busy = true;
+
+  // Repeat the sequence from software trigger, averaging in hardware
+  ADC0->ULLMEM.CTL1 = (((uint32_t)avg_log2 << ADC12_CTL1_AVGD_OFS) | 
+                       ((uint32_t)avg_log2 << ADC12_CTL1_AVGN_OFS) |
+                       ADC12_CTL1_SAMPMODE_AUTO | 
+                       ADC12_CTL1_CONSEQ_REPEATSEQUENCE |
+                       ADC12_CTL1_SC_STOP | ADC12_CTL1_TRIGSRC_SOFTWARE);
+
+  // Slots 0 to channel_count - 1, two results per DMA trigger
+  ADC0->ULLMEM.CTL2 = (((uint32_t)(channel_count - 1) << 
+                        ADC12_CTL2_ENDADD_OFS) | 
+                       ADC12_CTL2_STARTADD_ADDR_00 |
+                       (2 << ADC12_CTL2_SAMPCNT_OFS) | 
+                       ADC12_CTL2_FIFOEN_ENABLE | ADC12_CTL2_DMAEN_ENABLE | 
+                       ADC12_CTL2_RES_BIT_12 | ADC12_CTL2_DF_UNSIGNED);
+
+  for (i = 0; i < channel_count; i++)
+  {
+    ADC0->ULLMEM.MEMCTL[i] = ADC12_MEMCTL_WINCOMP_DISABLE | 
+                      ADC12_MEMCTL_TRIG_AUTO_NEXT | ADC12_MEMCTL_BCSEN_DISABLE | 
+                      avgen | ADC12_MEMCTL_STIME_SEL_SCOMP0 | 
+                      ADC12_MEMCTL_VRSEL_VDDA_VSSA | channels[i];
+  } /* for */
+
+  ADC0->ULLMEM.DMA_TRIG.IMASK = ADC12_DMA_TRIG_IMASK_MEMRESIFG0_SET;
+
+  // One word (two results) per trigger into the buffer. The channel reloads
+  // itself after the last word, and interrupts at half and full.
+  DMA->DMATRIG[ADC0_DMA_CHAN].DMATCTL = (DMA_DMATCTL_DMATINT_EXTERNAL |
+                                         DMA_ADC0_EVT_GEN_BD_TRIG);
+  DMA->DMACHAN[ADC0_DMA_CHAN].DMASA = (uint32_t)&ADC0->ULLMEM.FIFODATA;
+  DMA->DMACHAN[ADC0_DMA_CHAN].DMADA = (uint32_t)buffer;
+  DMA->DMACHAN[ADC0_DMA_CHAN].DMASZ = half_count;
+  DMA->DMACHAN[ADC0_DMA_CHAN].DMACTL = (DMA_DMACTL_DMATM_RPTSNGL | 
+                DMA_DMACTL_DMADSTINCR_INCREMENT | 
+                DMA_DMACTL_DMASRCINCR_UNCHANGED |
+                DMA_DMACTL_DMADSTWDTH_WORD | DMA_DMACTL_DMASRCWDTH_WORD |
+                DMA_DMACTL_DMAPREIRQ_PREIRQ_HALF | DMA_DMACTL_DMAEM_NORMAL |
+                DMA_DMACTL_DMAEN_ENABLE);
+
+  DMA->CPU_INT.ICLR = (DMA_CPU_INT_ICLR_DMACH1_CLR | 
+                       DMA_CPU_INT_ICLR_PREIRQCH1_CLR);
+  DMA->CPU_INT.IMASK |= (DMA_CPU_INT_IMASK_DMACH1_SET | 
+                         DMA_CPU_INT_IMASK_PREIRQCH1_SET);
+  NVIC_EnableIRQ(DMA_INT_IRQn);
+
+  ADC0->ULLMEM.CTL0 |= ADC12_CTL0_ENC_ON;
+  ADC0->ULLMEM.CTL1 |= ADC12_CTL1_SC_START; 
+
+  return true;
+} /* ADC0_stream_start */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//   This function stops a running stream. The sequence is allowed to finish,
+//   then the DMA channel is disabled and the FIFO and DMA trigger are turned
+//   off so `ADC0_in` can be used again. Results not yet handed to the 
+//   callback are dropped.
+//
+// INPUT PARAMETERS:
+//   none
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+void ADC0_stream_stop(void)
+{
+  volatile uint32_t *status_reg = (volatile uint32_t *)&(ADC0->ULLMEM.STATUS);
+
+  if (!g_adc_stream.busy)
+  {
+    return;
+  } /* if */
+
+  ADC0->ULLMEM.CTL0 &= ~ADC12_CTL0_ENC_MASK;
+  while((*status_reg & ADC12_STATUS_BUSY_MASK) == ADC12_STATUS_BUSY_ACTIVE);
+
+  DMA->CPU_INT.IMASK &= ~(DMA_CPU_INT_IMASK_DMACH1_MASK | 
+                          DMA_CPU_INT_IMASK_PREIRQCH1_MASK);
+  DMA->DMACHAN[ADC0_DMA_CHAN].DMACTL &= ~DMA_DMACTL_DMAEN_MASK;
+  ADC0->ULLMEM.DMA_TRIG.IMASK = 0;
+  ADC0->ULLMEM.CTL2 &= ~(ADC12_CTL2_FIFOEN_MASK | ADC12_CTL2_DMAEN_MASK);
+
+  g_adc_stream.busy = false;
+} /* ADC0_stream_stop */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//   This function checks whether a stream is running.
+//
+// INPUT PARAMETERS:
+//   none
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   true  - if a stream is running
+//   false - otherwise
+// -----------------------------------------------------------------------------
+bool ADC0_stream_busy(void)
+{
+  return g_adc_stream.busy;
+} /* ADC0_stream_busy */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//   This function handles the DMA interrupts for the ADC0 stream channel and
+//   hands the half of the buffer that just filled to the stream callback.
+//   The ADC clears its DMA enable when the DMA block is done, so it is set
+//   again after the second half; the FIFO holds results meanwhile. Call it
+//   from the DMA ISR.
+//
+// INPUT PARAMETERS:
+//   half - true for the half-way interrupt, false for the end of the buffer
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+void ADC0_dma_handler(bool half)
+{
+  if (!g_adc_stream.busy)
+  {
+    return;
+  } /* if */
+
+  if (half)
+  {
+    g_adc_stream.callback(g_adc_stream.buffer, g_adc_stream.half_count);
+  } /* if */
+  else
+  {
+    ADC0->ULLMEM.CTL2 |= ADC12_CTL2_DMAEN_ENABLE;
+    g_adc_stream.callback(g_adc_stream.buffer + g_adc_stream.half_count,
+                          g_adc_stream.half_count);
+  } /* else */
+} /* ADC0_dma_handler */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//   This function starts sampling a list of channels at a fixed rate. TIMG6
+//   counts down from the period and publishes its zero event on the event 
+//   fabric; ADC0 subscribes to it and converts the whole channel sequence on
+//   each event, so the timing does not depend on what the CPU is doing. The
+//   ADC ISR moves each frame of results into a ring buffer and signals 
+//   KERNEL_EVENT_ADC_DATA; read them with `ADC0_timed_read`. Frames that do
+//   not fit in the ring are dropped and counted.
+//
+//   `ADC0_in` and `ADC0_stream_start` must not be used while it runs.
+//
+// INPUT PARAMETERS:
+//   channels      - The ADC input channels to sample, in sequence order
+//   channel_count - Number of channels (1 to ADC0_STREAM_MAX_CHANNELS)
+//   period_us     - Time between frames in microseconds, rounded down to a
+//                   multiple of ADC0_TIMED_TICK_US (ADC0_TIMED_MIN_PERIOD_US 
+//                   to ADC0_TIMED_MAX_PERIOD_US). At bus clocks that do not
+//                   divide evenly the period achieved differs slightly;
+//                   `ADC0_timed_get_config` reports it.
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   true  - if acquisition was started
+//   false - if the ADC is in use or a parameter is out of range
+// -----------------------------------------------------------------------------
+bool ADC0_timed_start(const uint8_t *channels, uint8_t channel_count,
+                      uint32_t period_us)
+{
+  uint32_t trig;
+  uint8_t i;
+
+  if (ADC0_busy() || channel_count == 0 || 
+      channel_count > ADC0_STREAM_MAX_CHANNELS || 
+      period_us < ADC0_TIMED_MIN_PERIOD_US || 
+      period_us > ADC0_TIMED_MAX_PERIOD_US)
+  {
+    return false;
+  } /* if */
+
+  for (i = 0; i < channel_count; i++)
+  {
+    g_adc_timed.channels[i] = channels[i];
+  } /* for */
+  g_adc_timed.channel_count = channel_count;
+  g_adc_timed.request_us = period_us - (period_us % ADC0_TIMED_TICK_US);
+  g_adc_timed.head = g_adc_timed.tail = 0;
+  g_adc_timed.busy = true;
+
+  // One sequence per event: every slot runs into the next except the last,
+  // which waits for the following trigger
+  ADC0->ULLMEM.CTL1 = (ADC12_CTL1_AVGD_SHIFT0 | ADC12_CTL1_AVGN_DISABLE |
+                       ADC12_CTL1_SAMPMODE_AUTO | 
+                       ADC12_CTL1_CONSEQ_REPEATSEQUENCE |
+                       ADC12_CTL1_SC_STOP | ADC12_CTL1_TRIGSRC_EVENT);
+
+  ADC0->ULLMEM.CTL2 = (((uint32_t)(channel_count - 1) << 
+                        ADC12_CTL2_ENDADD_OFS) | 
+                       ADC12_CTL2_STARTADD_ADDR_00 |
+                       ADC12_CTL2_SAMPCNT_MIN | ADC12_CTL2_FIFOEN_DISABLE |
+                       ADC12_CTL2_DMAEN_DISABLE | ADC12_CTL2_RES_BIT_12 |
+                       ADC12_CTL2_DF_UNSIGNED);
+
+  for (i = 0; i < channel_count; i++)
+  {
+    trig = ADC12_MEMCTL_TRIG_AUTO_NEXT;
+    if (i == channel_count - 1)
+    {
+      trig = ADC12_MEMCTL_TRIG_TRIGGER_NEXT;
+    } /* if */
+
+    ADC0->ULLMEM.MEMCTL[i] = ADC12_MEMCTL_WINCOMP_DISABLE | trig | 
+                      ADC12_MEMCTL_BCSEN_DISABLE | ADC12_MEMCTL_AVGEN_DISABLE | 
+                      ADC12_MEMCTL_STIME_SEL_SCOMP0 | 
+                      ADC12_MEMCTL_VRSEL_VDDA_VSSA | channels[i];
+  } /* for */
+
+  // Interrupt once the last result of the frame is in
+  ADC0->ULLMEM.FSUB_0 = ADC0_TIMED_EVENT_CHAN;
+  ADC0->ULLMEM.CPU_INT.ICLR = 0xFFFFFFFF;
+  ADC0->ULLMEM.CPU_INT.IMASK = (ADC12_CPU_INT_IMASK_MEMRESIFG0_SET << 
+                                (channel_count - 1));
+  NVIC_EnableIRQ(ADC0_INT_IRQn);
+  ADC0->ULLMEM.CTL0 |= ADC12_CTL0_ENC_ON;
+
+  // Reset TIMG6
+  TIMG6->GPRCM.RSTCTL = (GPTIMER_RSTCTL_KEY_UNLOCK_W | 
+                         GPTIMER_RSTCTL_RESETSTKYCLR_CLR |
+                         GPTIMER_RSTCTL_RESETASSERT_ASSERT);
+
+  // Enable power to TIMG6
+  TIMG6->GPRCM.PWREN = (GPTIMER_PWREN_KEY_UNLOCK_W | 
+                        GPTIMER_PWREN_ENABLE_ENABLE);
+
+  clock_delay(24);
+
+  TIMG6->CLKSEL = (GPTIMER_CLKSEL_BUSCLK_SEL_ENABLE | 
+                   GPTIMER_CLKSEL_MFCLK_SEL_DISABLE |  
+                   GPTIMER_CLKSEL_LFCLK_SEL_DISABLE);
+
+  // One tick per 20 us, or the nearest longer tick the bus clock allows
+  TIMG6->CLKDIV = GPTIMER_CLKDIV_RATIO_DIV_BY_8;
+  adc0_timed_set_rate(get_bus_clock_freq());
+
+  // Publish the zero event to the ADC
+  TIMG6->FPUB_0 = ADC0_TIMED_EVENT_CHAN;
+  TIMG6->GEN_EVENT0.IMASK = GPTIMER_GEN_EVENT0_IMASK_Z_SET;
+
+  // Count down from LOAD and reload on zero, forever
+  TIMG6->COUNTERREGS.CTRCTL = (GPTIMER_CTRCTL_CVAE_LDVAL | 
+                               GPTIMER_CTRCTL_REPEAT_REPEAT_1 | 
+                               GPTIMER_CTRCTL_CM_DOWN);
+
+  TIMG6->COMMONREGS.CCLKCTL = GPTIMER_CCLKCTL_CLKEN_ENABLED;
+  TIMG6->COUNTERREGS.CTRCTL |= GPTIMER_CTRCTL_EN_ENABLED;
+
+  return true;
+} /* ADC0_timed_start */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//   This function stops timed acquisition. The timer is powered down, the 
+//   last sequence is allowed to finish and the ADC is released for other 
+//   uses. Frames still in the ring can be read afterwards. Tasks waiting on
+//   KERNEL_EVENT_ADC_DATA are woken so they notice.
+//
+// INPUT PARAMETERS:
+//   none
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+void ADC0_timed_stop(void)
+{
+  volatile uint32_t *status_reg = (volatile uint32_t *)&(ADC0->ULLMEM.STATUS);
+
+  if (!g_adc_timed.busy)
+  {
+    return;
+  } /* if */
+
+  TIMG6->COUNTERREGS.CTRCTL &= ~GPTIMER_CTRCTL_EN_MASK;
+  TIMG6->FPUB_0 = 0;
+  TIMG6->GPRCM.PWREN = (GPTIMER_PWREN_KEY_UNLOCK_W | 
+                        GPTIMER_PWREN_ENABLE_DISABLE);
+
+  ADC0->ULLMEM.CTL0 &= ~ADC12_CTL0_ENC_MASK;
+  while((*status_reg & ADC12_STATUS_BUSY_MASK) == ADC12_STATUS_BUSY_ACTIVE);
+
+  ADC0->ULLMEM.CPU_INT.IMASK = 0;
+  ADC0->ULLMEM.FSUB_0 = 0;
+
+  g_adc_timed.busy = false;
+  kernel_signal_event(KERNEL_EVENT_ADC_DATA);
+} /* ADC0_timed_stop */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//   This function checks whether timed acquisition is running.
+//
+// INPUT PARAMETERS:
+//   none
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   true  - if timed acquisition is running
+//   false - otherwise
+// -----------------------------------------------------------------------------
+bool ADC0_timed_busy(void)
+{
+  return g_adc_timed.busy;
+} /* ADC0_timed_busy */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//   This function copies up to max_frames whole frames out of the timed
+//   acquisition ring buffer. Each frame holds one result per channel in 
+//   channel list order. It never blocks.
+//
+// INPUT PARAMETERS:
+//   max_frames - maximum number of frames to read
+//
+// OUTPUT PARAMETERS:
+//   frames - the results read, room for max_frames * channel count
+//
+// RETURN:
+//   The number of frames read, 0 if none were waiting
+// -----------------------------------------------------------------------------
+uint16_t ADC0_timed_read(uint16_t *frames, uint16_t max_frames)
+{
+  uint16_t tail = g_adc_timed.tail;
+  uint16_t head = g_adc_timed.head;
+  uint16_t frame_count = 0;
+  uint8_t i;
+
+  while ((tail != head) && (frame_count < max_frames))
+  {
+    for (i = 0; i < g_adc_timed.channel_count; i++)
+    {
+      *frames++ = g_adc_timed.ring[tail];
+      tail = (tail + 1) & ADC0_TIMED_RING_MASK;
+    } /* for */
+    frame_count++;
+  } /* while */
+
+  g_adc_timed.tail = tail;
+
+  return frame_count;
+} /* ADC0_timed_read */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//   This function finds where a channel sits in the timed acquisition frame.
+//
+// INPUT PARAMETERS:
+//   channel - The ADC input channel to look for
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   The index of the channel within a frame, or -1 if it is not sampled
+// -----------------------------------------------------------------------------
+int8_t ADC0_timed_slot(uint8_t channel)
+{
+  uint8_t i;
+
+  for (i = 0; i < g_adc_timed.channel_count; i++)
+  {
+    if (g_adc_timed.channels[i] == channel)
+    {
+      return i;
+    } /* if */
+  } /* for */
+
+  return -1;
+} /* ADC0_timed_slot */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//   This function returns the channel list and period of the last timed
+//   acquisition that was started. The period is the one TIMG6 achieves at
+//   the current bus clock, to the nearest microsecond.
+//
+// INPUT PARAMETERS:
+//   none
+//
+// OUTPUT PARAMETERS:
+//   channels  - the channel list, room for ADC0_STREAM_MAX_CHANNELS
+//   period_us - the period in microseconds
+//
+// RETURN:
+//   The number of channels
+// -----------------------------------------------------------------------------
+uint8_t ADC0_timed_get_config(uint8_t *channels, uint32_t *period_us)
+{
+  uint8_t i;
+
+  for (i = 0; i < g_adc_timed.channel_count; i++)
+  {
+    channels[i] = g_adc_timed.channels[i];
+  } /* for */
+  *period_us = g_adc_timed.period_us;
+
+  return g_adc_timed.channel_count;
+} /* ADC0_timed_get_config */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//   This function copies out the timed acquisition totals.
+//
+// INPUT PARAMETERS:
+//   none
+//
+// OUTPUT PARAMETERS:
+//   stats - the frame and drop counts since boot
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+void ADC0_timed_get_stats(adc_timed_stats_struct *stats)
+{
+  *stats = g_adc_timed_stats;
+} /* ADC0_timed_get_stats */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//   This function handles the ADC0 interrupt. In window monitoring it re-arms
+//   the window around the reading that left it. When a timed frame is 
+//   complete it moves the results into the ring, or drops the frame if the 
+//   ring is full, and signals KERNEL_EVENT_ADC_DATA. Call it from the ADC0 
+//   ISR.
+//
+// INPUT PARAMETERS:
+//   none
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+void ADC0_irq_handler(void)
+{
+  uint32_t flags = ADC0->ULLMEM.CPU_INT.MIS;
+  uint16_t head = g_adc_timed.head;
+  uint16_t used;
+  uint8_t i;
+
+  ADC0->ULLMEM.CPU_INT.ICLR = flags;
+
+  if (g_adc_window.busy)
+  {
+    if (flags & (ADC12_CPU_INT_MIS_LOWIFG_SET | ADC12_CPU_INT_MIS_HIGHIFG_SET))
+    {
+      adc0_window_rearm(ADC0->ULLMEM.MEMRES[0]);
+    } /* if */
+    return;
+  } /* if */
+
+  if (!g_adc_timed.busy)
+  {
+    return;
+  } /* if */
+
+  used = (head - g_adc_timed.tail) & ADC0_TIMED_RING_MASK;
+  if (used + g_adc_timed.channel_count >= ADC0_TIMED_RING_SIZE)
+  {
+    g_adc_timed_stats.dropped++;
+    return;
+  } /* if */
+
+  for (i = 0; i < g_adc_timed.channel_count; i++)
+  {
+    g_adc_timed.ring[head] = ADC0->ULLMEM.MEMRES[i];
+    head = (head + 1) & ADC0_TIMED_RING_MASK;
+  } /* for */
+
+  g_adc_timed.head = head;
+  g_adc_timed_stats.frames++;
+  kernel_signal_event(KERNEL_EVENT_ADC_DATA);
+} /* ADC0_irq_handler */
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//   This function starts watching one channel with the ADC window comparator.
+//   The ADC converts the channel over and over on its own, averaging 16 
+//   conversions per result to keep noise from tripping the window, and only
+//   interrupts when a result falls outside low..high. The ISR then records 
+//   the reading, moves the window so it is centred on it with the same 
+//   width, and signals KERNEL_EVENT_ADC_WINDOW. While readings stay in the
+//   band the CPU does nothing.
+//
+//   `ADC0_in`, streams and timed acquisition must not be used while it runs.
+//
+// INPUT PARAMETERS:
+//   channel - The ADC input channel to watch
+//   low     - Lowest in-band ADC code
+//   high    - Highest in-band ADC code (above low, at most ADC_MAX_CODE)
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   true  - if monitoring was started
+//   false - if the ADC is in use or the band is not valid
+// -----------------------------------------------------------------------------
+bool ADC0_window_start(uint8_t channel, uint16_t low, uint16_t high)
+{
+  if (ADC0_busy() || low >= high || high > ADC_MAX_CODE)
+  {
+    return false;
+  } /* if */
+
+  g_adc_window.channel = channel;
+  g_adc_window.half_width = (high - low) / 2;
+  g_adc_window.value = low + g_adc_window.half_width;
+  g_adc_window.low = low;
+  g_adc_window.high = high;
+  g_adc_window.events = 0;
+  g_adc_window.busy = true;
+
+  ADC0->ULLMEM.CTL1 = (ADC12_CTL1_AVGD_SHIFT4 | ADC12_CTL1_AVGN_AVG_16 |
+                       ADC12_CTL1_SAMPMODE_AUTO | 
+                       ADC12_CTL1_CONSEQ_REPEATSINGLE |
+                       ADC12_CTL1_SC_STOP | ADC12_CTL1_TRIGSRC_SOFTWARE);
+
+  ADC0->ULLMEM.CTL2 = (ADC12_CTL2_ENDADD_ADDR_00 | ADC12_CTL2_STARTADD_ADDR_00 |
+                       ADC12_CTL2_SAMPCNT_MIN | ADC12_CTL2_FIFOEN_DISABLE |
+                       ADC12_CTL2_DMAEN_DISABLE | ADC12_CTL2_RES_BIT_12 |
+                       ADC12_CTL2_DF_UNSIGNED);
+
+  ADC0->ULLMEM.MEMCTL[0] = ADC12_MEMCTL_WINCOMP_ENABLE | 
+                      ADC12_MEMCTL_TRIG_AUTO_NEXT | ADC12_MEMCTL_BCSEN_DISABLE | 
+                      ADC12_MEMCTL_AVGEN_ENABLE | ADC12_MEMCTL_STIME_SEL_SCOMP0 | 
+                      ADC12_MEMCTL_VRSEL_VDDA_VSSA | channel;
+
+  ADC0->ULLMEM.WCLOW = low;
+  ADC0->ULLMEM.WCHIGH = high;
+
+  ADC0->ULLMEM.CPU_INT.ICLR = 0xFFFFFFFF;
+  ADC0->ULLMEM.CPU_INT.IMASK = (ADC12_CPU_INT_IMASK_LOWIFG_SET | 
+                                ADC12_CPU_INT_IMASK_HIGHIFG_SET);
+  NVIC_EnableIRQ(ADC0_INT_IRQn);
+
+  ADC0->ULLMEM.CTL0 |= ADC12_CTL0_ENC_ON;
+  ADC0->ULLMEM.CTL1 |= ADC12_CTL1_SC_START; 
+
+  return true;
+} /* ADC0_window_start */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//   This function stops window monitoring and releases the ADC. Tasks 
+//   waiting on KERNEL_EVENT_ADC_WINDOW are woken so they notice.
+//
+// INPUT PARAMETERS:
+//   none
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+void ADC0_window_stop(void)
+{
+  volatile uint32_t *status_reg = (volatile uint32_t *)&(ADC0->ULLMEM.STATUS);
+
+  if (!g_adc_window.busy)
+  {
+    return;
+  } /* if */
+
+  ADC0->ULLMEM.CTL0 &= ~ADC12_CTL0_ENC_MASK;
+  while((*status_reg & ADC12_STATUS_BUSY_MASK) == ADC12_STATUS_BUSY_ACTIVE);
+
+  ADC0->ULLMEM.CPU_INT.IMASK = 0;
+  ADC0->ULLMEM.MEMCTL[0] &= ~ADC12_MEMCTL_WINCOMP_MASK;
+
+  g_adc_window.busy = false;
+  kernel_signal_event(KERNEL_EVENT_ADC_WINDOW);
+} /* ADC0_window_stop */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//   This function checks whether window monitoring is running.
+//
+// INPUT PARAMETERS:
+//   none
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   true  - if window monitoring is running
+//   false - otherwise
+// -----------------------------------------------------------------------------
+bool ADC0_window_busy(void)
+{
+  return g_adc_window.busy;
+} /* ADC0_window_busy */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//   This function returns the state of window monitoring: the last reading
+//   that left the band (the centre of the band until the first one), the
+//   band now armed around it and how many times it was re-armed.
+//
+// INPUT PARAMETERS:
+//   none
+//
+// OUTPUT PARAMETERS:
+//   status - the window monitoring state
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+void ADC0_window_get_status(adc_window_status_struct *status)
+{
+  uint32_t primask = __get_PRIMASK();
+
+  // The ISR updates these together
+  __disable_irq();
+  status->channel = g_adc_window.channel;
+  status->value = g_adc_window.value;
+  status->low = g_adc_window.low;
+  status->high = g_adc_window.high;
+  status->events = g_adc_window.events;
+  __set_PRIMASK(primask);
+} /* ADC0_window_get_status */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//   This function checks whether any part of ADC0 is taken by a stream, timed
+//   acquisition or window monitoring. `ADC0_in` may only be used when it is
+//   not.
+//
+// INPUT PARAMETERS:
+//   none
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   true  - if the ADC is in use
+//   false - otherwise
+// -----------------------------------------------------------------------------
+bool ADC0_busy(void)
+{
+  return g_adc_stream.busy || g_adc_timed.busy || g_adc_window.busy;
+} /* ADC0_busy */
+
+
+
 //-----------------------------------------------------------------------------
 // DESCRIPTION:
 //   This function calculates the temperature in degrees Celsius from the raw
@@ -251,6 +1205,9 @@ uint32_t ADC0_in(uint8_t channel)
 // RETURN:
 //   float - The calculated temperature in degrees Celsius based on the raw 
 //           ADC value.
+//
+// NOTE: This is the reference for thermistor_calc_temperature_x10(). It uses
+//       soft-float powf() and costs thousands of cycles per call on the M0+.
 // -----------------------------------------------------------------------------
 float thermistor_calc_temperature(int raw_ADC)
 {
@@ -287,3 +1244,87 @@ float thermistor_calc_temperature(int raw_ADC)
 } /* thermistor_calc_temperature */
 
 
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//   This function calculates the temperature from the raw ADC value of the
+//   TMP61 thermistor sensor using integer maths only. The two table entries
+//   around the ADC code are interpolated linearly, which stays within 0.2 
+//   degrees of thermistor_calc_temperature() over the whole 12-bit range.
+//
+// INPUT PARAMETERS:
+//   raw_ADC - The raw 12-bit ADC value from the TMP61 thermistor sensor.
+//             Larger values are clamped to 4095.
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   int16_t - The temperature in tenths of a degree Celsius
+// -----------------------------------------------------------------------------
+int16_t thermistor_calc_temperature_x10(uint16_t raw_ADC)
+{
+  uint16_t index;
+  uint16_t fraction;
+  int16_t  low;
+  int16_t  high;
+
+  if (raw_ADC > ADC_MAX_CODE)
+  {
+    raw_ADC = ADC_MAX_CODE;
+  } /* if */
+
+  index = raw_ADC / THERMISTOR_TABLE_STEP;
+  fraction = raw_ADC % THERMISTOR_TABLE_STEP;
+  low = g_thermistor_table[index];
+  high = g_thermistor_table[index + 1];
+
+  // The table only rises, so the difference is never negative and the
+  // division rounds to nearest
+  return low + (int16_t)(((uint32_t)(high - low) * fraction + 
+                          THERMISTOR_TABLE_STEP / 2) / THERMISTOR_TABLE_STEP);
+
+} /* thermistor_calc_temperature_x10 */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//   This function records a reading that left the monitoring window and 
+//   centres the window on it, clipped to the ADC range. Flags raised by
+//   conversions made before the move are cleared. Called from the ADC ISR.
+//
+// INPUT PARAMETERS:
+//   value - the ADC reading that left the window
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+static void adc0_window_rearm(uint16_t value)
+{
+  uint16_t low = 0;
+  uint16_t high = ADC_MAX_CODE;
+
+  if (value > g_adc_window.half_width)
+  {
+    low = value - g_adc_window.half_width;
+  } /* if */
+  if (value + g_adc_window.half_width < ADC_MAX_CODE)
+  {
+    high = value + g_adc_window.half_width;
+  } /* if */
+
+  ADC0->ULLMEM.WCLOW = low;
+  ADC0->ULLMEM.WCHIGH = high;
+  ADC0->ULLMEM.CPU_INT.ICLR = (ADC12_CPU_INT_ICLR_LOWIFG_CLR | 
+                               ADC12_CPU_INT_ICLR_HIGHIFG_CLR);
+
+  g_adc_window.value = value;
+  g_adc_window.low = low;
+  g_adc_window.high = high;
+  g_adc_window.events++;
+  kernel_signal_event(KERNEL_EVENT_ADC_WINDOW);
+} /* adc0_window_rearm */
@@ -60,6 +60,7 @@
 //-----------------------------------------------------------------------------
 // Load standard C include files
 //-----------------------------------------------------------------------------
+#include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
 
@@ -68,12 +69,92 @@
 //-----------------------------------------------------------------------------
 
 
+//-----------------------------------------------------------------------------
+// Define symbolic constants used by the program
+//-----------------------------------------------------------------------------
+#define ADC_MAX_CODE                                                      (4095)
+
+// Thermistor lookup table spacing in ADC codes (4096 / 64 segments)
+#define THERMISTOR_TABLE_STEP                                               (64)
+#define THERMISTOR_TABLE_SIZE                                                  \
+                                ((ADC_MAX_CODE + 1) / THERMISTOR_TABLE_STEP + 1)
+
+// DMA channel that drains the ADC0 FIFO while streaming (channel 0 is SPI1;
+// it must be a full channel for repeated transfers)
+#define ADC0_DMA_CHAN                                                        (1)
+
+// Most channels one stream can sample, one MEMCTL slot each
+#define ADC0_STREAM_MAX_CHANNELS                                            (12)
+
+// Most samples averaged in hardware per result, as a power of two (128)
+#define ADC0_STREAM_MAX_AVG_LOG2                                             (7)
+
+// Timed acquisition: TIMG6 ticks every ADC0_TIMED_TICK_US and publishes its
+// zero event on ADC0_TIMED_EVENT_CHAN, which ADC0 subscribes to
+#define ADC0_TIMED_EVENT_CHAN                                                (1)
+#define ADC0_TIMED_TICK_US                                                  (20)
+#define ADC0_TIMED_TICKS_PER_SEC                                         (50000)
+#define ADC0_TIMED_MIN_PERIOD_US                           (ADC0_TIMED_TICK_US)
+#define ADC0_TIMED_MAX_PERIOD_US                   (65536 * ADC0_TIMED_TICK_US)
+
+// Results buffered between the ADC ISR and the reader (power of 2)
+#define ADC0_TIMED_RING_SIZE                                               (256)
+#define ADC0_TIMED_RING_MASK                        (ADC0_TIMED_RING_SIZE - 1)
+
+
+//-----------------------------------------------------------------------------
+// Define the types used by the ADC driver
+//-----------------------------------------------------------------------------
+
+// Called from the DMA ISR each time half of the stream buffer has filled.
+// samples points at the finished half, count results interleaved in
+// channel list order. It must be done with them before the half refills.
+typedef void (*adc_stream_callback_t)(const uint16_t *samples, uint16_t count);
+
+// Running totals of timed acquisition, a frame being one result per channel
+typedef struct
+{
+  uint32_t frames;
+  uint32_t dropped;
+} adc_timed_stats_struct;
+
+// State of window monitoring, see ADC0_window_get_status
+typedef struct
+{
+  uint16_t value;
+  uint16_t low;
+  uint16_t high;
+  uint32_t events;
+  uint8_t  channel;
+} adc_window_status_struct;
+
 // ----------------------------------------------------------------------------
 // Prototype for support functions
 // ----------------------------------------------------------------------------
 void ADC0_init(uint32_t reference);
 float thermistor_calc_temperature(int raw_ADC);
+int16_t thermistor_calc_temperature_x10(uint16_t raw_ADC);
 uint32_t ADC0_in(uint8_t channel);
+bool ADC0_stream_start(const uint8_t *channels, uint8_t channel_count,
+                       uint16_t *buffer, uint16_t count, uint8_t avg_log2,
+                       adc_stream_callback_t callback);
+void ADC0_stream_stop(void);
+bool ADC0_stream_busy(void);
+void ADC0_dma_handler(bool half);
+bool ADC0_timed_start(const uint8_t *channels, uint8_t channel_count,
+                      uint32_t period_us);
+void ADC0_timed_stop(void);
+bool ADC0_timed_busy(void);
+uint16_t ADC0_timed_read(uint16_t *frames, uint16_t max_frames);
+int8_t ADC0_timed_slot(uint8_t channel);
+uint8_t ADC0_timed_get_config(uint8_t *channels, uint32_t *period_us);
+void ADC0_timed_get_stats(adc_timed_stats_struct *stats);
+void ADC0_irq_handler(void);
+bool ADC0_window_start(uint8_t channel, uint16_t low, uint16_t high);
+void ADC0_window_stop(void);
+bool ADC0_window_busy(void);
+void ADC0_window_get_status(adc_window_status_struct *status);
+bool ADC0_busy(void);
 
 
 
@@ -12,7 +12,7 @@
 //    This file contains a collection of functions for initializing and 
 //    configuring various hardware peripherals on the LP-MSPM0G3507 LaunchPad 
 //    These functions provide support for clock initialization, delay 
-//    generation, and SysTick timer setup.
+//    generation, a low-power sleep timer, and SysTick timer setup.
 //
 //    This code is based the the following Texas Instruments' LaunchPad 
 //    project templates for the LP-MSPM0G3507:
@@ -20,6 +20,8 @@
 //      - systick_periodic_timer_LP_MSPM0G3507_nortos_ticlang
 //      - sysctl_mclk_syspll_LP_MSPM0G3507_nortos_ticlang
 //
+//    The SYSPLL divider search, clock_solve, is in clock_pll.c.
+//
 //-----------------------------------------------------------------------------
 // DISCLAIMER
 //    This code was developed for educational purposes as part of the CSC202 
@@ -45,6 +47,7 @@
 // Load standard C include files
 //-----------------------------------------------------------------------------
 #include <stdint.h>
+#include <stdbool.h>
 
 //-----------------------------------------------------------------------------
 // Loads MSP launchpad board support macros and definitions
@@ -58,12 +61,36 @@
 #define MSEC_PER_SECOND                                                   (1000)
 #define USEC_PER_SECOND                                                (1000000)
 
+// MFCLK is 4 MHz; TIMG12 divides it by 4 to count microseconds
+#define TIME_BASE_CLOCK_DIV                      (GPTIMER_CLKDIV_RATIO_DIV_BY_4)
+
+// A count below this has wrapped more recently than one above it
+#define TIME_BASE_HALF_RANGE                                        (0x80000000)
+
 
 //-----------------------------------------------------------------------------
 // global signal to track status of bus clock
 //-----------------------------------------------------------------------------
 uint32_t volatile g_bus_clock_freq = 32000000; 
 
+//-----------------------------------------------------------------------------
+// time base state; the upper 32 bits are counted by the TIMG12 interrupt
+//-----------------------------------------------------------------------------
+static uint32_t volatile g_time_base_high = 0;
+static bool volatile g_time_base_running = false;
+
+//-----------------------------------------------------------------------------
+// drivers told about bus clock changes
+//-----------------------------------------------------------------------------
+static clock_notifier_t g_clock_notifiers[CLOCK_MAX_NOTIFIERS];
+static uint8_t g_clock_notifier_count = 0;
+
+
+//-----------------------------------------------------------------------------
+// Prototype for local functions
+//-----------------------------------------------------------------------------
+static void clock_apply_syspll(const clock_config_struct *config);
+
 //------------------------------------------------------------------------------
 // DESCRIPTION:
 //   This function returns current configured bus clock frequency for the 
@@ -314,6 +341,263 @@ void clock_init_80mhz(void)
 } /* clock_init_80mhz */
 
 
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function initializes the system clock to run MCLK from the SYSPLL
+//    at any frequency clock_solve can reach, in place of a hand-coded
+//    sequence such as clock_init_80mhz. ULPCLK is MCLK / 2 and the flash
+//    wait states suit the new frequency.
+//
+//    Drivers are not told about the change, so this is meant for start-up
+//    before they are initialized; use clock_set_freq once they are running.
+//
+// INPUT PARAMETERS:
+//   freq - the bus clock frequency in Hz
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   true  - if the bus clock now runs at freq
+//   false - if the SYSPLL cannot make freq; the clock is left unchanged
+// -----------------------------------------------------------------------------
+bool clock_init(uint32_t freq)
+{
+  clock_config_struct config;
+
+  if (!clock_solve(freq, &config))
+  {
+    return false;
+  } /* if */
+
+  clock_apply_syspll(&config);
+
+  // update the bus clock frequency
+  g_bus_clock_freq = freq;
+
+  return true;
+} /* clock_init */
+
+
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function adds a driver to those told when clock_set_freq changes
+//    the bus clock. Drivers register once, when they are initialized.
+//
+// INPUT PARAMETERS:
+//   notifier - the function to call at each stage of a change
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   true  - if the driver was added
+//   false - if CLOCK_MAX_NOTIFIERS are already registered
+// -----------------------------------------------------------------------------
+bool clock_register_notifier(clock_notifier_t notifier)
+{
+  if (g_clock_notifier_count >= CLOCK_MAX_NOTIFIERS)
+  {
+    return false;
+  } /* if */
+
+  g_clock_notifiers[g_clock_notifier_count++] = notifier;
+  return true;
+} /* clock_register_notifier */
+
+
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function changes the bus clock while the system runs, to any
+//    frequency clock_solve can reach. Every registered driver is first
+//    asked to finish what it has in flight. Then, with interrupts masked,
+//    the clock is switched and each driver reprograms its baud rate or
+//    prescaler for the new frequency before any interrupt can start a new
+//    transfer, so no link sees a byte at the wrong rate.
+//
+//    The caller must hold the kernel lock, so no task starts a transfer
+//    between the two stages.
+//
+// INPUT PARAMETERS:
+//   freq - the bus clock frequency in Hz
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   true  - if the bus clock now runs at freq
+//   false - if the SYSPLL cannot make freq; the clock is left unchanged
+// -----------------------------------------------------------------------------
+bool clock_set_freq(uint32_t freq)
+{
+  clock_config_struct config;
+  uint32_t primask;
+  uint8_t i;
+
+  if (!clock_solve(freq, &config))
+  {
+    return false;
+  } /* if */
+
+  if (freq == g_bus_clock_freq)
+  {
+    return true;
+  } /* if */
+
+  for (i = 0; i < g_clock_notifier_count; i++)
+  {
+    g_clock_notifiers[i](CLOCK_CHANGE_PREPARE, freq);
+  } /* for */
+
+  primask = __get_PRIMASK();
+  __disable_irq();
+
+  clock_apply_syspll(&config);
+  g_bus_clock_freq = freq;
+
+  for (i = 0; i < g_clock_notifier_count; i++)
+  {
+    g_clock_notifiers[i](CLOCK_CHANGE_COMMIT, freq);
+  } /* for */
+
+  __set_PRIMASK(primask);
+
+  return true;
+} /* clock_set_freq */
+
+
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function runs MCLK from the SYSPLL with the setting clock_solve
+//    found. The SYSPLL can only be reconfigured while it is off, so MCLK
+//    runs from SYSOSC (32 MHz) while the SYSPLL is stopped, given its new
+//    dividers and the factory parameters for its loop input, and restarted.
+//    ULPCLK is MCLK / 2. The flash wait states cover the faster of the two
+//    clocks MCLK runs from at each step: at least 1 while on SYSOSC, the
+//    new setting before MCLK moves to a faster SYSPLL, and they only drop
+//    to a lower setting once MCLK is back on HSCLK. The same steps bring
+//    the SYSPLL up the first time, when it is still off and MCLK is on
+//    SYSOSC.
+//
+//    NOTE: The function uses busy-wait loops to check the status of the
+//          clock sources. These loops may cause the program to be stuck in
+//          an infinite loop if the hardware status flags are not set as
+//          expected.
+//
+//    Interrupts must be masked if the system is running.
+//
+// INPUT PARAMETERS:
+//   config - the SYSPLL setting from clock_solve
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+static void clock_apply_syspll(const clock_config_struct *config)
+{
+  uint32_t loop_freq = SYSPLL_REF_FREQ >> config->pdiv;
+  uint32_t param;
+  uint32_t wait;
+
+  // SYSOSC runs at 32 MHz, above the limit for no wait states
+  wait = (SYSCTL->SOCLOCK.MCLKCFG & SYSCTL_MCLKCFG_FLASHWAIT_MASK) >>
+         SYSCTL_MCLKCFG_FLASHWAIT_OFS;
+  if (wait < 1)
+  {
+    SYSCTL->SOCLOCK.MCLKCFG &= ~SYSCTL_MCLKCFG_FLASHWAIT_MASK;
+    SYSCTL->SOCLOCK.MCLKCFG |= SYSCTL_MCLKCFG_FLASHWAIT_WAIT1;
+  } /* if */
+
+  // Run MCLK from SYSOSC while the SYSPLL is down
+  SYSCTL->SOCLOCK.MCLKCFG &= ~SYSCTL_MCLKCFG_USEHSCLK_MASK;
+  while ((SYSCTL->SOCLOCK.CLKSTATUS & SYSCTL_CLKSTATUS_HSCLKMUX_MASK) != 
+          SYSCTL_CLKSTATUS_HSCLKMUX_SYSOSC);
+
+  SYSCTL->SOCLOCK.HSCLKEN &= ~SYSCTL_HSCLKEN_SYSPLLEN_MASK;
+  while ((SYSCTL->SOCLOCK.CLKSTATUS & SYSCTL_CLKSTATUS_SYSPLLOFF_MASK) != 
+          SYSCTL_CLKSTATUS_SYSPLLOFF_TRUE);
+
+  // The SYSPLL needs SYSOSC at its base frequency, and uses it as reference
+  SYSCTL->SOCLOCK.SYSOSCCFG &= ~SYSCTL_SYSOSCCFG_FREQ_MASK;
+  SYSCTL->SOCLOCK.SYSOSCCFG |=  SYSCTL_SYSOSCCFG_FREQ_SYSOSCBASE;
+  SYSCTL->SOCLOCK.SYSPLLCFG0 &= ~SYSCTL_SYSPLLCFG0_SYSPLLREF_MASK;
+
+  // Predivider and feedback divider; the QDIV field holds the multiplier - 1
+  SYSCTL->SOCLOCK.SYSPLLCFG1 &= ~(SYSCTL_SYSPLLCFG1_PDIV_MASK |
+                                  SYSCTL_SYSPLLCFG1_QDIV_MASK);
+  SYSCTL->SOCLOCK.SYSPLLCFG1 |=
+            ((uint32_t) config->pdiv << SYSCTL_SYSPLLCFG1_PDIV_OFS) |
+            ((uint32_t) (config->qdiv - 1) << SYSCTL_SYSPLLCFG1_QDIV_OFS);
+
+  // Factory trim for the loop input range, read from the factory region
+  if (loop_freq >= 32000000)
+  {
+    param = SYSCTL_SYSPLL_INPUT_FREQ_32_48_MHZ;
+  } /* if */
+  else if (loop_freq >= 16000000)
+  {
+    param = SYSCTL_SYSPLL_INPUT_FREQ_16_32_MHZ;
+  } /* else if */
+  else if (loop_freq >= 8000000)
+  {
+    param = SYSCTL_SYSPLL_INPUT_FREQ_8_16_MHZ;
+  } /* else if */
+  else
+  {
+    param = SYSCTL_SYSPLL_INPUT_FREQ_4_8_MHZ;
+  } /* else */
+  SYSCTL->SOCLOCK.SYSPLLPARAM0 = *(volatile uint32_t *) param;
+  SYSCTL->SOCLOCK.SYSPLLPARAM1 = *(volatile uint32_t *) (param + 0x04);
+
+  // Output divider, and the output that feeds the HSCLK mux. SYSPLLCLK1
+  // stays enabled as clock_init_80mhz leaves it.
+  SYSCTL->SOCLOCK.SYSPLLCFG0 &= ~(SYSCTL_SYSPLLCFG0_RDIVCLK2X_MASK |
+                                  SYSCTL_SYSPLLCFG0_RDIVCLK0_MASK |
+                                  SYSCTL_SYSPLLCFG0_MCLK2XVCO_MASK);
+  if (config->use_clk2x)
+  {
+    SYSCTL->SOCLOCK.SYSPLLCFG0 |= 
+                 ((uint32_t) config->rdiv << SYSCTL_SYSPLLCFG0_RDIVCLK2X_OFS) |
+                 SYSCTL_SYSPLLCFG0_ENABLECLK2X_MASK |
+                 SYSCTL_SYSPLLCFG0_MCLK2XVCO_MASK;
+  } /* if */
+  else
+  {
+    SYSCTL->SOCLOCK.SYSPLLCFG0 |= 
+                 ((uint32_t) config->rdiv << SYSCTL_SYSPLLCFG0_RDIVCLK0_OFS) |
+                 SYSCTL_SYSPLLCFG0_ENABLECLK0_MASK;
+  } /* else */
+  SYSCTL->SOCLOCK.SYSPLLCFG0 |= SYSCTL_SYSPLLCFG0_ENABLECLK1_MASK;
+
+  // Raise the wait states now if the new frequency needs more than SYSOSC,
+  // lower them only once MCLK has left SYSOSC
+  wait = (config->flash_wait > 1) ? config->flash_wait : 1;
+  SYSCTL->SOCLOCK.MCLKCFG &= ~(SYSCTL_MCLKCFG_UDIV_MASK |
+                               SYSCTL_MCLKCFG_FLASHWAIT_MASK);
+  SYSCTL->SOCLOCK.MCLKCFG |= SYSCTL_MCLKCFG_UDIV_DIVIDE2 |
+                             (wait << SYSCTL_MCLKCFG_FLASHWAIT_OFS);
+
+  SYSCTL->SOCLOCK.HSCLKEN |= SYSCTL_HSCLKEN_SYSPLLEN_MASK;
+  while ((SYSCTL->SOCLOCK.CLKSTATUS & SYSCTL_CLKSTATUS_SYSPLLGOOD_MASK) != 
+          SYSCTL_CLKSTATUS_SYSPLLGOOD_TRUE);
+
+  // Back to HSCLK, now the SYSPLL at its new frequency
+  SYSCTL->SOCLOCK.HSCLKCFG &= ~SYSCTL_HSCLKCFG_HSCLKSEL_MASK;
+  SYSCTL->SOCLOCK.MCLKCFG |= SYSCTL_MCLKCFG_USEHSCLK_MASK;
+  while ((SYSCTL->SOCLOCK.CLKSTATUS & SYSCTL_CLKSTATUS_HSCLKMUX_MASK) != 
+          SYSCTL_CLKSTATUS_HSCLKMUX_HSCLK);
+
+  if (config->flash_wait < wait)
+  {
+    SYSCTL->SOCLOCK.MCLKCFG &= ~SYSCTL_MCLKCFG_FLASHWAIT_MASK;
+    SYSCTL->SOCLOCK.MCLKCFG |= 
+            ((uint32_t) config->flash_wait << SYSCTL_MCLKCFG_FLASHWAIT_OFS);
+  } /* if */
+} /* clock_apply_syspll */
+
+
 //-----------------------------------------------------------------------------
 // DESCRIPTION:
 //    This function provides a delay of approximately the specified number of 
@@ -365,15 +649,17 @@ void clock_delay(uint32_t cycles)
 //-----------------------------------------------------------------------------
 // DESCRIPTION:
 //    This function introduces a blocking delay for a specified number of
-//    milliseconds. It determines the number of clock cycles required to
+//    milliseconds. Once the time base is running, it waits on `now_us()`,
+//    so the delay does not depend on the bus clock and interrupts taken
+//    during it do not add to it. Before that, while the clocks are still
+//    being brought up, it determines the number of clock cycles required to
 //    approximate a 1 millisecond delay based on the system bus clock
-//    frequency (`g_bus_clock_freq`), then calls `clock_delay()` in a loop
-//    to achieve the total delay duration.
+//    frequency (`g_bus_clock_freq`), then calls `clock_delay()` in a loop.
 //
-//    The delay is approximate. Each call to `clock_delay()` is expected to
-//    consume `g_bus_clock_freq / 1000` cycles, approximating 1 ms assuming
-//    that `clock_delay()` introduces a 1 µs delay per cycle. Overhead from
-//    loop logic and function calls may add minor time.
+//    The cycle-counted delay is approximate. Each call to `clock_delay()` is
+//    expected to consume `g_bus_clock_freq / 1000` cycles. Overhead from
+//    loop logic and function calls, and time spent in interrupts, may add
+//    to it.
 //
 //    This method is suitable for coarse, non-time-critical delays such as
 //    initialization wait states or sensor stabilization periods.
@@ -398,6 +684,14 @@ void msec_delay(uint32_t ms_delay_count)
 {
   // each call to clock_delay is count cycles
   uint32_t count = g_bus_clock_freq / MSEC_PER_SECOND;
+  uint64_t start;
+
+  if (g_time_base_running)
+  {
+    start = now_us();
+    while (now_us() - start < (uint64_t)ms_delay_count * MSEC_PER_SECOND);
+    return;
+  } /* if */
   
   while(ms_delay_count)
   {
@@ -414,19 +708,17 @@ void msec_delay(uint32_t ms_delay_count)
 //
 // DESCRIPTION:
 //    This function introduces a blocking delay for a specified number of
-//    microseconds. It calculates the number of bus clock cycles required
-//    to approximate a 1 µs delay based on the system bus clock frequency
+//    microseconds. Once the time base is running, it waits on `now_us()`
+//    and is accurate to a microsecond plus the cost of one read. Before
+//    that, it calculates the number of bus clock cycles required to
+//    approximate a 1 µs delay based on the system bus clock frequency
 //    (`g_bus_clock_freq`), and repeatedly calls `clock_delay()` to produce
 //    the desired total delay.
 //
-//    The timing is approximate. Overhead from loop control and function calls
-//    may add minor additional delay. While generally suitable for short,
-//    non-critical timing requirements, this method is not appropriate for
-//    high-precision timing tasks.
-//
-//    As the delays drops under 100 µs, the overhead become more significant
-//    relative to the intended delay time. Consider using hardware timers or
-//    instruction-cycle-calibrated loops for higher precision.
+//    The cycle-counted timing is approximate. Overhead from loop control and
+//    function calls may add minor additional delay, and as the delays drops
+//    under 100 µs, the overhead become more significant relative to the
+//    intended delay time.
 //
 // NOTES:
 //    - For delay over 1000 microsecond (1 millisecond), use msec_delay().
@@ -446,6 +738,14 @@ void usec_delay(uint32_t us_delay_count)
 {
   // each call to clock_delay is count cycles
   uint32_t count = g_bus_clock_freq / USEC_PER_SECOND;
+  uint64_t start;
+
+  if (g_time_base_running)
+  {
+    start = now_us();
+    while (now_us() - start < us_delay_count);
+    return;
+  } /* if */
   
   // Due to the overhead, a divided by 2 was added as a manual adjustment 
   // to improve the delay accuracy based on testing with 40MHz system clock
@@ -460,6 +760,274 @@ void usec_delay(uint32_t us_delay_count)
 } /* usec_delay */
 
 
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function starts the sleep timer. TIMG0 counts LFCLK (32.768 kHz)
+//    up from 0 to 0xFFFF and wraps, forever. It is never stopped, so the
+//    difference between two counts is the time between them, even across
+//    a sleep. Its compare event on CC0 wakes the core at a chosen count.
+//
+// INPUT PARAMETERS:
+//   none
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+void sleep_timer_init(void)
+{
+  // Reset TIMG0
+  TIMG0->GPRCM.RSTCTL = (GPTIMER_RSTCTL_KEY_UNLOCK_W | 
+                         GPTIMER_RSTCTL_RESETSTKYCLR_CLR |
+                         GPTIMER_RSTCTL_RESETASSERT_ASSERT);
+
+  // Enable power to TIMG0
+  TIMG0->GPRCM.PWREN = (GPTIMER_PWREN_KEY_UNLOCK_W | 
+                        GPTIMER_PWREN_ENABLE_ENABLE);
+
+  clock_delay(24);
+
+  TIMG0->CLKSEL = (GPTIMER_CLKSEL_BUSCLK_SEL_DISABLE | 
+                   GPTIMER_CLKSEL_MFCLK_SEL_DISABLE |  
+                   GPTIMER_CLKSEL_LFCLK_SEL_ENABLE);
+  TIMG0->CLKDIV = GPTIMER_CLKDIV_RATIO_DIV_BY_1;
+  TIMG0->COMMONREGS.CPS = 0;
+
+  TIMG0->COUNTERREGS.LOAD = GPTIMER_LOAD_LD_MASK & 0xFFFF;
+  TIMG0->COUNTERREGS.CC_01[0] = 0;
+
+  // Interrupt on the compare, counting up
+  TIMG0->CPU_INT.ICLR = GPTIMER_CPU_INT_ICLR_CCU0_CLR;
+  TIMG0->CPU_INT.IMASK = GPTIMER_CPU_INT_IMASK_CCU0_SET;
+  NVIC_EnableIRQ(TIMG0_INT_IRQn);
+
+  // Count up from zero and wrap, forever
+  TIMG0->COUNTERREGS.CTRCTL = (GPTIMER_CTRCTL_CVAE_ZEROVAL | 
+                               GPTIMER_CTRCTL_REPEAT_REPEAT_1 | 
+                               GPTIMER_CTRCTL_CM_UP);
+
+  TIMG0->COMMONREGS.CCLKCTL = GPTIMER_CCLKCTL_CLKEN_ENABLED;
+  TIMG0->COUNTERREGS.CTRCTL |= GPTIMER_CTRCTL_EN_ENABLED;
+} /* sleep_timer_init */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function reads the sleep timer.
+//
+// INPUT PARAMETERS:
+//   none
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   The count, in 1/SLEEP_TIMER_FREQ of a second, modulo 2^16
+// -----------------------------------------------------------------------------
+uint16_t sleep_timer_count(void)
+{
+  return (uint16_t)TIMG0->COUNTERREGS.CTR;
+} /* sleep_timer_count */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function sets the count at which the sleep timer next interrupts,
+//    waking the core from WFI. The TIMG0 handler only clears the interrupt;
+//    the code that slept decides what to do about it.
+//
+// INPUT PARAMETERS:
+//   count - the count to wake at
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+void sleep_timer_set_wakeup(uint16_t count)
+{
+  TIMG0->COUNTERREGS.CC_01[0] = count;
+  TIMG0->CPU_INT.ICLR = GPTIMER_CPU_INT_ICLR_CCU0_CLR;
+} /* sleep_timer_set_wakeup */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function waits for a number of milliseconds with the core asleep.
+//    It sets the sleep timer to wake it at the end of the wait and sleeps
+//    with WFI; other interrupts that wake it are serviced and it goes back
+//    to sleep. Interrupts must be enabled.
+//
+//    This is for waits before the scheduler starts. Once it runs, the idle
+//    task owns the sleep timer, and tasks should use kernel_sleep instead.
+//
+// INPUT PARAMETERS:
+//   ms - the number of milliseconds to sleep
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+void msec_sleep(uint32_t ms)
+{
+  uint32_t chunk;
+  uint16_t counts;
+  uint16_t start;
+
+  while (ms > 0)
+  {
+    chunk = (ms > SLEEP_TIMER_MAX_MS) ? SLEEP_TIMER_MAX_MS : ms;
+    counts = (chunk * SLEEP_TIMER_FREQ + MSEC_PER_SECOND - 1) /
+             MSEC_PER_SECOND;
+
+    __disable_irq();
+    start = sleep_timer_count();
+    sleep_timer_set_wakeup(start + counts);
+
+    // WFI wakes on a pending interrupt even with PRIMASK set; open the mask
+    // briefly so the handler runs before checking again
+    while ((uint16_t)(sleep_timer_count() - start) < counts)
+    {
+      __WFI();
+      __enable_irq();
+      __disable_irq();
+    } /* while */
+    __enable_irq();
+
+    ms -= chunk;
+  } /* while */
+} /* msec_sleep */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function starts the time base. TIMG12 counts microseconds from
+//    MFCLK up from 0 to 0xFFFFFFFF and wraps, forever; its zero event, as
+//    it wraps, interrupts to count the upper 32 bits. MFCLK comes from
+//    SYSOSC, so call this after the clock is set up.
+//
+// INPUT PARAMETERS:
+//   none
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+void time_base_init(void)
+{
+  // MFCLK feeds the timer
+  SYSCTL->SOCLOCK.MCLKCFG |= SYSCTL_MCLKCFG_USEMFTICK_ENABLE;
+
+  // Reset TIMG12
+  TIMG12->GPRCM.RSTCTL = (GPTIMER_RSTCTL_KEY_UNLOCK_W | 
+                          GPTIMER_RSTCTL_RESETSTKYCLR_CLR |
+                          GPTIMER_RSTCTL_RESETASSERT_ASSERT);
+
+  // Enable power to TIMG12
+  TIMG12->GPRCM.PWREN = (GPTIMER_PWREN_KEY_UNLOCK_W | 
+                         GPTIMER_PWREN_ENABLE_ENABLE);
+
+  clock_delay(24);
+
+  TIMG12->CLKSEL = (GPTIMER_CLKSEL_BUSCLK_SEL_DISABLE | 
+                    GPTIMER_CLKSEL_MFCLK_SEL_ENABLE |  
+                    GPTIMER_CLKSEL_LFCLK_SEL_DISABLE);
+  TIMG12->CLKDIV = TIME_BASE_CLOCK_DIV;
+
+  TIMG12->COUNTERREGS.LOAD = GPTIMER_LOAD_LD_MASK;
+
+  // Count up from zero and wrap, forever
+  TIMG12->COUNTERREGS.CTRCTL = (GPTIMER_CTRCTL_CVAE_ZEROVAL | 
+                                GPTIMER_CTRCTL_REPEAT_REPEAT_1 | 
+                                GPTIMER_CTRCTL_CM_UP);
+
+  TIMG12->COMMONREGS.CCLKCTL = GPTIMER_CCLKCTL_CLKEN_ENABLED;
+  TIMG12->COUNTERREGS.CTRCTL |= GPTIMER_CTRCTL_EN_ENABLED;
+
+  // The count starts at zero, which is not a wrap
+  while (TIMG12->COUNTERREGS.CTR == 0);
+  TIMG12->CPU_INT.ICLR = GPTIMER_CPU_INT_ICLR_Z_CLR;
+  TIMG12->CPU_INT.IMASK = GPTIMER_CPU_INT_IMASK_Z_SET;
+  NVIC_EnableIRQ(TIMG12_INT_IRQn);
+
+  g_time_base_high = 0;
+  g_time_base_running = true;
+} /* time_base_init */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function reads the time base: microseconds since time_base_init.
+//    It takes no lock and can be called from any task or interrupt handler,
+//    including one that masks or outranks the TIMG12 interrupt; a wrap that
+//    has not been counted yet is allowed for from the raw interrupt status.
+//
+// INPUT PARAMETERS:
+//   none
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   The time in microseconds
+// -----------------------------------------------------------------------------
+uint64_t now_us(void)
+{
+  uint32_t high;
+  uint32_t low;
+  uint32_t wrapped;
+
+  // Re-read if the wrap interrupt runs part way through
+  do
+  {
+    high = g_time_base_high;
+    low = TIMG12->COUNTERREGS.CTR;
+    wrapped = TIMG12->CPU_INT.RIS & GPTIMER_CPU_INT_RIS_Z_MASK;
+  } while (high != g_time_base_high);
+
+  // A wrap is pending and the count read came after it
+  if ((wrapped != 0) && (low < TIME_BASE_HALF_RANGE))
+  {
+    high++;
+  } /* if */
+
+  return ((uint64_t)high << 32) | low;
+} /* now_us */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function counts a wrap of the time base. It is called by the
+//    TIMG12 handler. Clearing the interrupt and counting the wrap are done
+//    with interrupts masked, so no reader sees one without the other.
+//
+// INPUT PARAMETERS:
+//   none
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+void time_base_wrap(void)
+{
+  uint32_t primask = __get_PRIMASK();
+
+  __disable_irq();
+  TIMG12->CPU_INT.ICLR = GPTIMER_CPU_INT_ICLR_Z_CLR;
+  g_time_base_high++;
+  __set_PRIMASK(primask);
+} /* time_base_wrap */
+
+
 //-----------------------------------------------------------------------------
 // DESCRIPTION:
 //    Initializes the SysTick timer with a specified period for periodic 
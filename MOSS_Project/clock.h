@@ -49,17 +49,93 @@
 // Loads standard C include files
 //-----------------------------------------------------------------------------
 #include <stdint.h>
+#include <stdbool.h>
 
 
 //-----------------------------------------------------------------------------
 // Define symbolic constants used by the program
 //-----------------------------------------------------------------------------
+/*! PLL feedback loop input clock frequency [4MHz, 8MHz) */
+#define SYSCTL_SYSPLL_INPUT_FREQ_4_8_MHZ                 ((uint32_t) 0x41C4001C)
+/*! PLL feedback loop input clock frequency [8MHz, 16MHz) */
+#define SYSCTL_SYSPLL_INPUT_FREQ_8_16_MHZ                ((uint32_t) 0x41C40024)
 /*! PLL feedback loop input clock frequency [16MHz, 32MHz) */
 #define SYSCTL_SYSPLL_INPUT_FREQ_16_32_MHZ               ((uint32_t) 0x41C4002C)
+/*! PLL feedback loop input clock frequency [32MHz, 48MHz] */
+#define SYSCTL_SYSPLL_INPUT_FREQ_32_48_MHZ               ((uint32_t) 0x41C40034)
 #define Q_DIV                                                                (9)
 #define DIV_CLK_2X                                                           (3)
 #define DIV_CLK_1                                                            (1)
 #define DIV_CLK_0                                                            (0)
+
+// The sleep timer is TIMG0 counting LFCLK, which keeps running while the
+// core sleeps. Its 16-bit counter wraps every 2 s, so one wake-up is capped.
+#define SLEEP_TIMER_FREQ                                                 (32768)
+#define SLEEP_TIMER_MAX_MS                                                (1000)
+
+// The time base is TIMG12 counting MFCLK (4 MHz) divided down to 1 MHz. It
+// does not depend on MCLK, so it keeps its rate across clock changes. The
+// 32-bit counter wraps every 71 minutes and is extended to 64 bits in RAM.
+#define TIME_BASE_FREQ                                                 (1000000)
+
+// SYSPLL limits from the MSPM0G350x datasheet. The reference is SYSOSC,
+// divided by 1, 2, 4 or 8 (PDIV) into the loop input, which QDIV multiplies
+// up to the VCO frequency.
+#define SYSPLL_REF_FREQ                                               (32000000)
+#define SYSPLL_PDIV_MAX                                                      (3)
+#define SYSPLL_LOOPIN_MIN_FREQ                                         (4000000)
+#define SYSPLL_LOOPIN_MAX_FREQ                                        (48000000)
+#define SYSPLL_QDIV_MIN                                                      (2)
+#define SYSPLL_QDIV_MAX                                                    (127)
+#define SYSPLL_VCO_MIN_FREQ                                           (80000000)
+#define SYSPLL_VCO_MAX_FREQ                                          (400000000)
+#define SYSPLL_RDIV_COUNT                                                   (16)
+
+// Flash wait states needed by MCLK frequency
+#define FLASH_NO_WAIT_MAX_FREQ                                        (24000000)
+#define FLASH_ONE_WAIT_MAX_FREQ                                       (48000000)
+
+// Bus clock frequencies clock_init and clock_set_freq accept. ULPCLK is half
+// of MCLK, and below 8 MHz the I2C module clock cannot make 100 kHz SCL.
+#define CLOCK_MIN_FREQ                                                 (8000000)
+#define CLOCK_MAX_FREQ                                                (80000000)
+
+// clock_reachable_freqs lists whole MHz between the two
+#define CLOCK_FREQ_STEP                                                (1000000)
+#define CLOCK_MAX_REACHABLE                                                    \
+                      ((CLOCK_MAX_FREQ - CLOCK_MIN_FREQ) / CLOCK_FREQ_STEP + 1)
+
+// Drivers that can be told about bus clock changes
+#define CLOCK_MAX_NOTIFIERS                                                  (6)
+
+// Stages of a bus clock change, passed to each notifier
+#define CLOCK_CHANGE_PREPARE                                                 (0)
+#define CLOCK_CHANGE_COMMIT                                                  (1)
+
+
+//-----------------------------------------------------------------------------
+// Define the types used by the clock
+//-----------------------------------------------------------------------------
+// Called twice per bus clock change. At CLOCK_CHANGE_PREPARE, with
+// interrupts enabled, the driver lets any transfer in flight finish. At
+// CLOCK_CHANGE_COMMIT, with interrupts masked and the new clock running,
+// it reprograms its dividers for freq.
+typedef void (*clock_notifier_t)(uint8_t stage, uint32_t freq);
+
+// A SYSPLL setting found by clock_solve. The loop input is
+// SYSPLL_REF_FREQ >> pdiv and the VCO runs at qdiv times that. MCLK is
+// SYSPLLCLK2X, 2 * fVCO / (rdiv + 1), when use_clk2x is set, otherwise
+// SYSPLLCLK0, fVCO / (2 * (rdiv + 1)).
+typedef struct
+{
+  uint32_t freq;
+  uint32_t vco_freq;
+  uint8_t  pdiv;
+  uint8_t  qdiv;
+  uint8_t  rdiv;
+  uint8_t  flash_wait;
+  bool     use_clk2x;
+} clock_config_struct;
   
   
 // ----------------------------------------------------------------------------
@@ -67,14 +143,27 @@
 // ----------------------------------------------------------------------------
 void clock_init_80mhz(void);
 void clock_init_40mhz(void);
-void clock_init(uint32_t freq);
+bool clock_init(uint32_t freq);
+bool clock_solve(uint32_t freq, clock_config_struct *config);
+uint8_t clock_reachable_freqs(uint32_t *freqs, uint8_t max_count);
 
 uint32_t get_bus_clock_freq(void);
+bool clock_register_notifier(clock_notifier_t notifier);
+bool clock_set_freq(uint32_t freq);
 
 void clock_delay(uint32_t cycles) __attribute__((noinline));
 void msec_delay(uint32_t ms_delay_count);
 void usec_delay(uint32_t us_delay_count);
 
+void sleep_timer_init(void);
+uint16_t sleep_timer_count(void);
+void sleep_timer_set_wakeup(uint16_t count);
+void msec_sleep(uint32_t ms);
+
+void time_base_init(void);
+uint64_t now_us(void);
+void time_base_wrap(void);
+
 void sys_tick_init(uint32_t period);
 void sys_tick_disable(void);
 void sys_tick_reset(void);
@@ -0,0 +1,221 @@
+// *****************************************************************************
+// ***************************    C Source Code     ****************************
+// *****************************************************************************
+//   DESIGNER NAME:  Rafael Ortiz
+//
+//         VERSION:  1.0
+//
+//       FILE NAME:  clock_pll.c
+//
+//-----------------------------------------------------------------------------
+// DESCRIPTION
+//    This file contains the SYSPLL divider search behind clock_init and
+//    clock_set_freq. It only does arithmetic on the limits in clock.h and
+//    touches no registers, so the same file builds into the host tests.
+//
+//-----------------------------------------------------------------------------
+// DISCLAIMER
+//    This code was developed for educational purposes as part of the CSC202 
+//    course and is provided "as is" without warranties of any kind, whether 
+//    express, implied, or statutory.
+//
+//    The author and organization do not warrant the accuracy, completeness, or
+//    reliability of the code. The author and organization shall not be liable
+//    for any direct, indirect, incidental, special, exemplary, or consequential
+//    damages arising out of the use of or inability to use the code, even if
+//    advised of the possibility of such damages.
+//
+//    Use of this code is at your own risk, and it is recommended to validate
+//    and adapt the code for your specific application and hardware requirements.
+//
+// Copyright (c) 2024 by TBD
+//    You may use, edit, run or distribute this file as long as the above
+//    copyright notice remains
+// *****************************************************************************
+//******************************************************************************
+
+//-----------------------------------------------------------------------------
+// Load standard C include files
+//-----------------------------------------------------------------------------
+#include <stdint.h>
+#include <stdbool.h>
+
+//-----------------------------------------------------------------------------
+// Loads MSP launchpad board support macros and definitions
+//-----------------------------------------------------------------------------
+#include "clock.h"
+
+
+//-----------------------------------------------------------------------------
+// Prototype for local functions
+//-----------------------------------------------------------------------------
+static uint32_t clock_output_vco_freq(uint32_t freq, uint8_t rdiv,
+                                      bool use_clk2x);
+
+
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function finds the SYSPLL dividers that make exactly freq within
+//    the datasheet limits: a loop input of SYSPLL_LOOPIN_MIN_FREQ to
+//    SYSPLL_LOOPIN_MAX_FREQ, a QDIV of SYSPLL_QDIV_MIN to SYSPLL_QDIV_MAX and
+//    a VCO of SYSPLL_VCO_MIN_FREQ to SYSPLL_VCO_MAX_FREQ. Of the settings
+//    that work, the one with the slowest VCO is taken, as it draws the
+//    least current; ties go to the fastest loop input, which has the least
+//    jitter, and SYSPLLCLK2X is preferred over SYSPLLCLK0. Each of the 128
+//    divider choices is tried once, so the search is cheap enough to run
+//    at every clock change.
+//
+// INPUT PARAMETERS:
+//   freq - the bus clock frequency in Hz
+//
+// OUTPUT PARAMETERS:
+//   config - the SYSPLL setting, when one is found
+//
+// RETURN:
+//   true  - if freq is reachable
+//   false - if freq is outside CLOCK_MIN_FREQ to CLOCK_MAX_FREQ or no
+//           setting makes it exactly
+// -----------------------------------------------------------------------------
+bool clock_solve(uint32_t freq, clock_config_struct *config)
+{
+  uint32_t loop_freq;
+  uint32_t vco_freq;
+  uint8_t output;
+  uint8_t pdiv;
+  uint8_t rdiv;
+  bool found = false;
+
+  if ((freq < CLOCK_MIN_FREQ) || (freq > CLOCK_MAX_FREQ))
+  {
+    return false;
+  } /* if */
+
+  // SYSPLLCLK2X first, so it wins ties against SYSPLLCLK0
+  for (output = 0; output < 2; output++)
+  {
+    // Fastest loop input first, so it wins ties against slower ones
+    for (pdiv = 0; pdiv <= SYSPLL_PDIV_MAX; pdiv++)
+    {
+      loop_freq = SYSPLL_REF_FREQ >> pdiv;
+      if ((loop_freq < SYSPLL_LOOPIN_MIN_FREQ) ||
+          (loop_freq > SYSPLL_LOOPIN_MAX_FREQ))
+      {
+        continue;
+      } /* if */
+
+      for (rdiv = 0; rdiv < SYSPLL_RDIV_COUNT; rdiv++)
+      {
+        vco_freq = clock_output_vco_freq(freq, rdiv, (output == 0));
+
+        if ((vco_freq < SYSPLL_VCO_MIN_FREQ) ||
+            (vco_freq > SYSPLL_VCO_MAX_FREQ) ||
+            ((vco_freq % loop_freq) != 0) ||
+            (vco_freq / loop_freq < SYSPLL_QDIV_MIN) ||
+            (vco_freq / loop_freq > SYSPLL_QDIV_MAX))
+        {
+          continue;
+        } /* if */
+
+        if (!found || (vco_freq < config->vco_freq))
+        {
+          config->freq = freq;
+          config->vco_freq = vco_freq;
+          config->pdiv = pdiv;
+          config->qdiv = vco_freq / loop_freq;
+          config->rdiv = rdiv;
+          config->use_clk2x = (output == 0);
+          found = true;
+        } /* if */
+      } /* for */
+    } /* for */
+  } /* for */
+
+  if (found)
+  {
+    if (freq <= FLASH_NO_WAIT_MAX_FREQ)
+    {
+      config->flash_wait = 0;
+    } /* if */
+    else if (freq <= FLASH_ONE_WAIT_MAX_FREQ)
+    {
+      config->flash_wait = 1;
+    } /* else if */
+    else
+    {
+      config->flash_wait = 2;
+    } /* else */
+  } /* if */
+
+  return found;
+} /* clock_solve */
+
+
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function lists the bus clock frequencies clock_solve can reach,
+//    every CLOCK_FREQ_STEP from CLOCK_MIN_FREQ to CLOCK_MAX_FREQ, so a
+//    caller can trade speed against power without working out dividers.
+//
+// INPUT PARAMETERS:
+//   max_count - the number of entries freqs can hold; CLOCK_MAX_REACHABLE
+//               holds them all
+//
+// OUTPUT PARAMETERS:
+//   freqs - the reachable frequencies in Hz, slowest first
+//
+// RETURN:
+//   the number of frequencies stored in freqs
+// -----------------------------------------------------------------------------
+uint8_t clock_reachable_freqs(uint32_t *freqs, uint8_t max_count)
+{
+  clock_config_struct config;
+  uint32_t freq;
+  uint8_t count = 0;
+
+  for (freq = CLOCK_MIN_FREQ; (freq <= CLOCK_MAX_FREQ) && (count < max_count);
+       freq += CLOCK_FREQ_STEP)
+  {
+    if (clock_solve(freq, &config))
+    {
+      freqs[count++] = freq;
+    } /* if */
+  } /* for */
+
+  return count;
+} /* clock_reachable_freqs */
+
+
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function returns the VCO frequency a SYSPLL output divider needs
+//    to make freq. SYSPLLCLK2X is 2 * fVCO / (rdiv + 1) and SYSPLLCLK0 is
+//    fVCO / (2 * (rdiv + 1)).
+//
+// INPUT PARAMETERS:
+//   freq      - the output frequency in Hz, at most CLOCK_MAX_FREQ
+//   rdiv      - the RDIVCLK2X or RDIVCLK0 field value
+//   use_clk2x - true for SYSPLLCLK2X, false for SYSPLLCLK0
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   the VCO frequency in Hz, or 0 if no whole frequency in Hz works
+// -----------------------------------------------------------------------------
+static uint32_t clock_output_vco_freq(uint32_t freq, uint8_t rdiv,
+                                      bool use_clk2x)
+{
+  uint32_t divider = rdiv + 1;
+
+  if (!use_clk2x)
+  {
+    return freq * 2 * divider;
+  } /* if */
+
+  if (((freq * divider) % 2) != 0)
+  {
+    return 0;
+  } /* if */
+
+  return freq * divider / 2;
+} /* clock_output_vco_freq */
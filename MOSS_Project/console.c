@@ -0,0 +1,446 @@
+// *****************************************************************************
+// ***************************    C Source Code     ****************************
+// *****************************************************************************
+//   DESIGNER NAME:  Rafael Ortiz
+//
+//         VERSION:  1.0
+//
+//       FILE NAME:  console.c
+//
+//-----------------------------------------------------------------------------
+// DESCRIPTION
+//    This file contains a text-mode console for the ILI9341 LCD display. The
+//    console keeps a grid of character cells and their color attributes in
+//    SRAM and only redraws the cells that changed. Changed cells next to each
+//    other in a line are drawn through a single address window.
+//
+//    Text lines live in fixed slots of the display memory. When the cursor
+//    moves past the bottom line the oldest slot is cleared and reused as the
+//    new bottom line, and the ILI9341 vertical scroll start address moves so
+//    the text appears to scroll up.
+//
+//-----------------------------------------------------------------------------
+// DISCLAIMER
+//    This code was developed for educational purposes as part of the CSC202 
+//    course and is provided "as is" without warranties of any kind, whether 
+//    express, implied, or statutory.
+//
+//    The author and organization do not warrant the accuracy, completeness, or
+//    reliability of the code. The author and organization shall not be liable
+//    for any direct, indirect, incidental, special, exemplary, or consequential
+//    damages arising out of the use of or inability to use the code, even if
+//    advised of the possibility of such damages.
+//
+//    Use of this code is at your own risk, and it is recommended to validate
+//    and adapt the code for your specific application and hardware requirements.
+//
+// Copyright (c) 2024 by TBD
+//    You may use, edit, run or distribute this file as long as the above
+//    copyright notice remains
+// *****************************************************************************
+//******************************************************************************
+
+//-----------------------------------------------------------------------------
+// Load standard C include files
+//-----------------------------------------------------------------------------
+#include <stdint.h>
+#include <stdbool.h>
+
+
+//-----------------------------------------------------------------------------
+// Loads MSP launchpad board support macros and definitions
+//-----------------------------------------------------------------------------
+#include <ti/devices/msp/msp.h>
+#include "console.h"
+#include "ili9341.h"
+
+
+// The console's cells are the ones the glyph cache is sized for
+#if CONSOLE_LINE_HEIGHT > ILI9341_GLYPH_CACHE_MAX_CELL_H
+#error "Console lines are taller than the glyph cache cells"
+#endif
+
+
+//-----------------------------------------------------------------------------
+// Define global variables and structures here.
+// NOTE: when possible avoid using global variables
+//-----------------------------------------------------------------------------
+typedef struct
+{
+  char    c;
+  uint8_t attr;
+} console_cell_struct;
+
+// Cells are stored by display memory slot, not by screen line, so scrolling
+// never moves them. Each slot has a bitmask of cells not yet drawn.
+static console_cell_struct g_console_cells[CONSOLE_LINES][CONSOLE_COLUMNS];
+static uint32_t g_console_dirty[CONSOLE_LINES];
+
+// Display memory slot shown as the top line, and the cursor line and column
+static uint8_t g_console_top_slot = 0;
+static uint8_t g_console_row = 0;
+static uint8_t g_console_col = 0;
+static uint8_t g_console_attr = CONSOLE_DEFAULT_ATTR;
+
+static const uint16_t g_console_palette[16] = {
+  ILI9341_BLACK, ILI9341_NAVY, ILI9341_DARKGREEN, ILI9341_DARKCYAN,
+  ILI9341_MAROON, ILI9341_PURPLE, ILI9341_OLIVE, ILI9341_LIGHTGREY,
+  ILI9341_DARKGREY, ILI9341_BLUE, ILI9341_GREEN, ILI9341_CYAN,
+  ILI9341_RED, ILI9341_MAGENTA, ILI9341_YELLOW, ILI9341_WHITE
+};
+
+
+//-----------------------------------------------------------------------------
+// Prototype for local functions
+//-----------------------------------------------------------------------------
+static uint8_t console_row_slot(uint8_t row);
+static void console_set_cell(uint8_t slot, uint8_t col, char c, uint8_t attr);
+static void console_blank_slot(uint8_t slot);
+
+
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//  This function initializes the console. It sets up the ILI9341 scrolling
+//  area to cover the console lines and clears the screen.
+//
+// INPUT PARAMETERS:
+//  none
+//
+// OUTPUT PARAMETERS:
+//  none
+//
+// RETURN:
+//  none
+//------------------------------------------------------------------------------
+void console_init(void)
+{
+  ili9341_define_scroll_area(0, ILI9341_TFTHEIGHT - CONSOLE_HEIGHT);
+  console_clear();
+} /* console_init */
+
+
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//  This function clears the console to the current background color, resets
+//  the scroll position and moves the cursor to the start of the top line. The
+//  screen is cleared with one fill, so no cells are left to flush.
+//
+// INPUT PARAMETERS:
+//  none
+//
+// OUTPUT PARAMETERS:
+//  none
+//
+// RETURN:
+//  none
+//------------------------------------------------------------------------------
+void console_clear(void)
+{
+  uint8_t slot;
+  uint8_t col;
+
+  ili9341_fill_screen(g_console_palette[CONSOLE_ATTR_BG(g_console_attr)]);
+
+  for (slot = 0; slot < CONSOLE_LINES; slot++)
+  {
+    for (col = 0; col < CONSOLE_COLUMNS; col++)
+    {
+      g_console_cells[slot][col].c = ' ';
+      g_console_cells[slot][col].attr = g_console_attr;
+    } /* for */
+    g_console_dirty[slot] = 0;
+  } /* for */
+
+  g_console_top_slot = 0;
+  g_console_row = 0;
+  g_console_col = 0;
+  ili9341_scroll_to(0);
+} /* console_clear */
+
+
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//  This function writes a character at the cursor and moves the cursor right.
+//  A newline moves to the start of the next line and a carriage return to the
+//  start of the current line. A character written past the end of a line
+//  wraps to the next line. Nothing is drawn until console_flush is called.
+//
+// INPUT PARAMETERS:
+//  c - the character to write
+//
+// OUTPUT PARAMETERS:
+//  none
+//
+// RETURN:
+//  none
+//------------------------------------------------------------------------------
+void console_put_char(char c)
+{
+  if (c == '\n')
+  {
+    console_new_line();
+  } /* if */
+  else if (c == '\r')
+  {
+    g_console_col = 0;
+  } /* else if */
+  else
+  {
+    if (g_console_col >= CONSOLE_COLUMNS)
+    {
+      console_new_line();
+    } /* if */
+    console_set_cell(console_row_slot(g_console_row), g_console_col, c,
+                     g_console_attr);
+    g_console_col++;
+  } /* else */
+} /* console_put_char */
+
+
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//  This function writes a string at the cursor with console_put_char.
+//
+// INPUT PARAMETERS:
+//  str - the null terminated string to write
+//
+// OUTPUT PARAMETERS:
+//  none
+//
+// RETURN:
+//  none
+//------------------------------------------------------------------------------
+void console_write_string(const char *str)
+{
+  while (*str != '\0')
+  {
+    console_put_char(*str++);
+  } /* while */
+} /* console_write_string */
+
+
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//  This function moves the cursor back one cell, to the end of the previous
+//  line if it is at the start of a line, and blanks that cell.
+//
+// INPUT PARAMETERS:
+//  none
+//
+// OUTPUT PARAMETERS:
+//  none
+//
+// RETURN:
+//  none
+//------------------------------------------------------------------------------
+void console_backspace(void)
+{
+  if (g_console_col > 0)
+  {
+    g_console_col--;
+  } /* if */
+  else if (g_console_row > 0)
+  {
+    g_console_row--;
+    g_console_col = CONSOLE_COLUMNS - 1;
+  } /* else if */
+  else
+  {
+    return;
+  } /* else */
+
+  console_set_cell(console_row_slot(g_console_row), g_console_col, ' ',
+                   g_console_attr);
+} /* console_backspace */
+
+
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//  This function moves the cursor to the beginning of the next line. If the
+//  cursor is on the bottom line, the console scrolls up one line: the slot
+//  holding the oldest line is blanked and becomes the new bottom line, and the
+//  scroll start address moves past it. Only one line of pixels is rewritten.
+//
+// INPUT PARAMETERS:
+//  none
+//
+// OUTPUT PARAMETERS:
+//  none
+//
+// RETURN:
+//  none
+//------------------------------------------------------------------------------
+void console_new_line(void)
+{
+  g_console_col = 0;
+
+  if (g_console_row < CONSOLE_LINES - 1)
+  {
+    g_console_row++;
+  } /* if */
+  else
+  {
+    console_blank_slot(g_console_top_slot);
+    g_console_top_slot = (g_console_top_slot + 1) % CONSOLE_LINES;
+    ili9341_scroll_to(g_console_top_slot * CONSOLE_LINE_HEIGHT);
+  } /* else */
+} /* console_new_line */
+
+
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//  This function sets the colors used for characters written from now on.
+//
+// INPUT PARAMETERS:
+//  fg - foreground CONSOLE_COLOR_xxx index
+//  bg - background CONSOLE_COLOR_xxx index
+//
+// OUTPUT PARAMETERS:
+//  none
+//
+// RETURN:
+//  none
+//------------------------------------------------------------------------------
+void console_set_color(uint8_t fg, uint8_t bg)
+{
+  g_console_attr = CONSOLE_ATTR(fg & 0x0F, bg & 0x0F);
+} /* console_set_color */
+
+
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//  This function draws every cell that changed since the last flush. Changed
+//  cells next to each other in a line that share colors are drawn as one run
+//  through a single address window; unchanged cells are not touched.
+//
+// INPUT PARAMETERS:
+//  none
+//
+// OUTPUT PARAMETERS:
+//  none
+//
+// RETURN:
+//  none
+//------------------------------------------------------------------------------
+void console_flush(void)
+{
+  char text[CONSOLE_COLUMNS];
+  uint32_t dirty;
+  uint8_t attr;
+  uint8_t slot;
+  uint8_t start;
+  uint8_t col;
+
+  for (slot = 0; slot < CONSOLE_LINES; slot++)
+  {
+    dirty = g_console_dirty[slot];
+    g_console_dirty[slot] = 0;
+
+    col = 0;
+    while (dirty >> col)
+    {
+      if ((dirty & (1UL << col)) == 0)
+      {
+        col++;
+        continue;
+      } /* if */
+
+      start = col;
+      attr = g_console_cells[slot][start].attr;
+      while (col < CONSOLE_COLUMNS && (dirty & (1UL << col)) &&
+             g_console_cells[slot][col].attr == attr)
+      {
+        text[col - start] = g_console_cells[slot][col].c;
+        col++;
+      } /* while */
+
+      ili9341_set_text_color(g_console_palette[CONSOLE_ATTR_FG(attr)],
+                             g_console_palette[CONSOLE_ATTR_BG(attr)]);
+      ili9341_draw_text_cells(text, col - start, start * GLYPH_WIDTH,
+                              slot * CONSOLE_LINE_HEIGHT, CONSOLE_LINE_HEIGHT,
+                              CONSOLE_BASELINE);
+    } /* while */
+  } /* for */
+} /* console_flush */
+
+
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//  This function returns the display memory slot that holds a screen line,
+//  taking the current scroll position into account.
+//
+// INPUT PARAMETERS:
+//  row - line counted from the top of the screen
+//
+// OUTPUT PARAMETERS:
+//  none
+//
+// RETURN:
+//  The slot index
+//------------------------------------------------------------------------------
+static uint8_t console_row_slot(uint8_t row)
+{
+  return (g_console_top_slot + row) % CONSOLE_LINES;
+} /* console_row_slot */
+
+
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//  This function stores a character and attribute in a cell. The cell is only
+//  marked for redraw if it actually changed.
+//
+// INPUT PARAMETERS:
+//  slot - display memory slot of the cell
+//  col  - column of the cell
+//  c    - character to store
+//  attr - attribute to store
+//
+// OUTPUT PARAMETERS:
+//  none
+//
+// RETURN:
+//  none
+//------------------------------------------------------------------------------
+static void console_set_cell(uint8_t slot, uint8_t col, char c, uint8_t attr)
+{
+  console_cell_struct *cell = &g_console_cells[slot][col];
+
+  if (cell->c != c || cell->attr != attr)
+  {
+    cell->c = c;
+    cell->attr = attr;
+    g_console_dirty[slot] |= 1UL << col;
+  } /* if */
+} /* console_set_cell */
+
+
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//  This function blanks every cell of a slot in the current colors. The slot
+//  is cleared on the panel with one fill straight away, so its cells are left
+//  clean instead of being redrawn one by one.
+//
+// INPUT PARAMETERS:
+//  slot - display memory slot to blank
+//
+// OUTPUT PARAMETERS:
+//  none
+//
+// RETURN:
+//  none
+//------------------------------------------------------------------------------
+static void console_blank_slot(uint8_t slot)
+{
+  uint8_t col;
+
+  for (col = 0; col < CONSOLE_COLUMNS; col++)
+  {
+    g_console_cells[slot][col].c = ' ';
+    g_console_cells[slot][col].attr = g_console_attr;
+  } /* for */
+  g_console_dirty[slot] = 0;
+
+  ili9341_fill_rect(0, slot * CONSOLE_LINE_HEIGHT, ILI9341_TFTWIDTH,
+                    CONSOLE_LINE_HEIGHT,
+                    g_console_palette[CONSOLE_ATTR_BG(g_console_attr)]);
+} /* console_blank_slot */
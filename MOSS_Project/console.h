@@ -0,0 +1,106 @@
+// *****************************************************************************
+// ***************************    C Source Code     ****************************
+// *****************************************************************************
+//   DESIGNER NAME:  Rafael Ortiz
+//
+//         VERSION:  1.0
+//
+//       FILE NAME:  console.h
+//
+//-----------------------------------------------------------------------------
+// DESCRIPTION
+//    This file contains a text-mode console for the ILI9341 LCD display. The
+//    console keeps a grid of character cells and their color attributes in
+//    SRAM and only redraws the cells that changed. Changed cells next to each
+//    other in a line are drawn through a single address window.
+//
+//    Text lines live in fixed slots of the display memory. When the cursor
+//    moves past the bottom line the oldest slot is cleared and reused as the
+//    new bottom line, and the ILI9341 vertical scroll start address moves so
+//    the text appears to scroll up.
+//
+//-----------------------------------------------------------------------------
+// DISCLAIMER
+//    This code was developed for educational purposes as part of the CSC202 
+//    course and is provided "as is" without warranties of any kind, whether 
+//    express, implied, or statutory.
+//
+//    The author and organization do not warrant the accuracy, completeness, or
+//    reliability of the code. The author and organization shall not be liable
+//    for any direct, indirect, incidental, special, exemplary, or consequential
+//    damages arising out of the use of or inability to use the code, even if
+//    advised of the possibility of such damages.
+//
+//    Use of this code is at your own risk, and it is recommended to validate
+//    and adapt the code for your specific application and hardware requirements.
+//
+// Copyright (c) 2024 by TBD
+//    You may use, edit, run or distribute this file as long as the above
+//    copyright notice remains
+// *****************************************************************************
+//******************************************************************************
+
+#ifndef __CONSOLE_H__
+#define __CONSOLE_H__
+
+//-----------------------------------------------------------------------------
+// Loads standard C include files
+//-----------------------------------------------------------------------------
+#include <stdint.h>
+
+
+#include "ili9341.h"
+
+
+//-----------------------------------------------------------------------------
+// Define symbolic constants used by the program
+//-----------------------------------------------------------------------------
+// The console scrolls a whole number of text lines in hardware; the leftover
+// panel lines at the bottom are a fixed area. Glyphs reach 23 pixels above
+// and 4 below the baseline, so a 28 pixel line never bleeds into the next.
+#define CONSOLE_LINE_HEIGHT                                                 (28)
+#define CONSOLE_BASELINE                                                    (23)
+#define CONSOLE_COLUMNS                         (ILI9341_TFTWIDTH / GLYPH_WIDTH)
+#define CONSOLE_LINES                  (ILI9341_TFTHEIGHT / CONSOLE_LINE_HEIGHT)
+#define CONSOLE_HEIGHT                     (CONSOLE_LINES * CONSOLE_LINE_HEIGHT)
+
+// Color indexes for console_set_color, in the same order as ili9341.h
+#define CONSOLE_COLOR_BLACK                                                  (0)
+#define CONSOLE_COLOR_NAVY                                                   (1)
+#define CONSOLE_COLOR_DARKGREEN                                              (2)
+#define CONSOLE_COLOR_DARKCYAN                                               (3)
+#define CONSOLE_COLOR_MAROON                                                 (4)
+#define CONSOLE_COLOR_PURPLE                                                 (5)
+#define CONSOLE_COLOR_OLIVE                                                  (6)
+#define CONSOLE_COLOR_LIGHTGREY                                              (7)
+#define CONSOLE_COLOR_DARKGREY                                               (8)
+#define CONSOLE_COLOR_BLUE                                                   (9)
+#define CONSOLE_COLOR_GREEN                                                 (10)
+#define CONSOLE_COLOR_CYAN                                                  (11)
+#define CONSOLE_COLOR_RED                                                   (12)
+#define CONSOLE_COLOR_MAGENTA                                               (13)
+#define CONSOLE_COLOR_YELLOW                                                (14)
+#define CONSOLE_COLOR_WHITE                                                 (15)
+
+// A cell attribute holds the foreground index in the high nibble and the
+// background index in the low nibble
+#define CONSOLE_ATTR(fg, bg)                     ((uint8_t)(((fg) << 4) | (bg)))
+#define CONSOLE_ATTR_FG(attr)                                      ((attr) >> 4)
+#define CONSOLE_ATTR_BG(attr)                                    ((attr) & 0x0F)
+#define CONSOLE_DEFAULT_ATTR                                                   \
+                        (CONSOLE_ATTR(CONSOLE_COLOR_BLACK, CONSOLE_COLOR_WHITE))
+
+
+// ----------------------------------------------------------------------------
+// Prototype for support functions
+// ----------------------------------------------------------------------------
+void console_init(void);
+void console_clear(void);
+void console_put_char(char c);
+void console_write_string(const char *str);
+void console_backspace(void);
+void console_new_line(void);
+void console_set_color(uint8_t fg, uint8_t bg);
+void console_flush(void);
+
+#endif /* __CONSOLE_H__ */
@@ -0,0 +1,530 @@
+// *****************************************************************************
+// ***************************    C Source Code     ****************************
+// *****************************************************************************
+//   DESIGNER NAME:  Rafael Ortiz
+//
+//         VERSION:  1.0
+//
+//       FILE NAME:  filter.c
+//
+//-----------------------------------------------------------------------------
+// DESCRIPTION
+//    This file contains integer-only filter stages for streams of sensor
+//    samples: a boxcar moving average, an exponential IIR low-pass, a
+//    median-of-N and a CIC decimator. Stages are chained per channel and the
+//    chain is fed one sample at a time, so it can run from an ADC ISR or DMA
+//    callback. Every stage costs a bounded number of cycles per sample, set
+//    by its length, and never divides.
+//
+//    The boxcar, IIR and median stages start from the first sample they see
+//    as if it had always been the input, so they do not ramp up from zero.
+//    Scaling uses arithmetic right shifts, which round toward minus infinity.
+//
+//-----------------------------------------------------------------------------
+// DISCLAIMER
+//    This code was developed for educational purposes as part of the CSC202
+//    course and is provided "as is" without warranties of any kind, whether
+//    express, implied, or statutory.
+//
+//    The author and organization do not warrant the accuracy, completeness, or
+//    reliability of the code. The author and organization shall not be liable
+//    for any direct, indirect, incidental, special, exemplary, or consequential
+//    damages arising out of the use of or inability to use the code, even if
+//    advised of the possibility of such damages.
+//
+//    Use of this code is at your own risk, and it is recommended to validate
+//    and adapt the code for your specific application and hardware requirements.
+//
+// Copyright (c) 2024 by TBD
+//    You may use, edit, run or distribute this file as long as the above
+//    copyright notice remains
+// *****************************************************************************
+//******************************************************************************
+
+//-----------------------------------------------------------------------------
+// Load standard C include files
+//-----------------------------------------------------------------------------
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+
+//-----------------------------------------------------------------------------
+// Loads MSP launchpad board support macros and definitions
+//-----------------------------------------------------------------------------
+#include "filter.h"
+
+
+//-----------------------------------------------------------------------------
+// Prototype for local functions
+//-----------------------------------------------------------------------------
+static filter_stage_struct *filter_chain_new_stage(filter_chain_struct *chain,
+                                                   uint8_t type);
+static int32_t filter_boxcar_process(filter_stage_struct *stage,
+                                     int32_t sample);
+static int32_t filter_iir_process(filter_stage_struct *stage, int32_t sample);
+static int32_t filter_median_process(filter_stage_struct *stage,
+                                     int32_t sample);
+static bool filter_cic_process(filter_stage_struct *stage, int32_t sample,
+                               int32_t *output);
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function empties a filter chain. A chain with no stages passes
+//    samples through unchanged.
+//
+// INPUT PARAMETERS:
+//   none
+//
+// OUTPUT PARAMETERS:
+//   chain - the chain to empty
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+void filter_chain_init(filter_chain_struct *chain)
+{
+  chain->stage_count = 0;
+} /* filter_chain_init */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function appends a boxcar moving average over the last
+//    2^length_log2 samples. It keeps a running sum, so each sample costs one
+//    add, one subtract and a shift whatever the length.
+//
+// INPUT PARAMETERS:
+//   length_log2 - log2 of the averaging length (0 to FILTER_BOXCAR_MAX_LOG2)
+//
+// OUTPUT PARAMETERS:
+//   chain - the chain to add the stage to
+//
+// RETURN:
+//   true  - if the stage was added
+//   false - if the chain is full or the length is out of range
+// -----------------------------------------------------------------------------
+bool filter_chain_add_boxcar(filter_chain_struct *chain, uint8_t length_log2)
+{
+  filter_stage_struct *stage;
+
+  if (length_log2 > FILTER_BOXCAR_MAX_LOG2)
+  {
+    return false;
+  } /* if */
+
+  stage = filter_chain_new_stage(chain, FILTER_TYPE_BOXCAR);
+  if (stage == NULL)
+  {
+    return false;
+  } /* if */
+
+  stage->param = length_log2;
+  return true;
+} /* filter_chain_add_boxcar */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function appends an exponential IIR low-pass, y += (x - y) / 2^shift.
+//    The state keeps shift extra fraction bits so small steps are not lost.
+//    Inputs must fit in 31 - shift bits.
+//
+// INPUT PARAMETERS:
+//   shift - smoothing, 1 (light) to FILTER_IIR_MAX_SHIFT (heavy)
+//
+// OUTPUT PARAMETERS:
+//   chain - the chain to add the stage to
+//
+// RETURN:
+//   true  - if the stage was added
+//   false - if the chain is full or the shift is out of range
+// -----------------------------------------------------------------------------
+bool filter_chain_add_iir(filter_chain_struct *chain, uint8_t shift)
+{
+  filter_stage_struct *stage;
+
+  if (shift == 0 || shift > FILTER_IIR_MAX_SHIFT)
+  {
+    return false;
+  } /* if */
+
+  stage = filter_chain_new_stage(chain, FILTER_TYPE_IIR);
+  if (stage == NULL)
+  {
+    return false;
+  } /* if */
+
+  stage->param = shift;
+  return true;
+} /* filter_chain_add_iir */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function appends a running median of the last length samples,
+//    which removes single-sample spikes without smearing steps. A sorted
+//    copy of the window is kept, so each sample costs at most length moves.
+//
+// INPUT PARAMETERS:
+//   length - window length, odd, 3 to FILTER_MEDIAN_MAX_LENGTH
+//
+// OUTPUT PARAMETERS:
+//   chain - the chain to add the stage to
+//
+// RETURN:
+//   true  - if the stage was added
+//   false - if the chain is full or the length is not valid
+// -----------------------------------------------------------------------------
+bool filter_chain_add_median(filter_chain_struct *chain, uint8_t length)
+{
+  filter_stage_struct *stage;
+
+  if (length < 3 || length > FILTER_MEDIAN_MAX_LENGTH || (length % 2) == 0)
+  {
+    return false;
+  } /* if */
+
+  stage = filter_chain_new_stage(chain, FILTER_TYPE_MEDIAN);
+  if (stage == NULL)
+  {
+    return false;
+  } /* if */
+
+  stage->param = length;
+  return true;
+} /* filter_chain_add_median */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function appends a CIC decimator: order integrators running at the
+//    input rate, then order combs running at 1/2^factor_log2 of it. It
+//    outputs one sample for every 2^factor_log2 inputs, scaled back to the
+//    input range. Order 1 is a plain integrate-and-dump average.
+//
+// INPUT PARAMETERS:
+//   factor_log2 - log2 of the decimation factor (1 to
+//                 FILTER_CIC_MAX_FACTOR_LOG2)
+//   order       - number of sections (1 to FILTER_CIC_MAX_ORDER)
+//
+// OUTPUT PARAMETERS:
+//   chain - the chain to add the stage to
+//
+// RETURN:
+//   true  - if the stage was added
+//   false - if the chain is full or a parameter is out of range
+// -----------------------------------------------------------------------------
+bool filter_chain_add_cic(filter_chain_struct *chain, uint8_t factor_log2,
+                          uint8_t order)
+{
+  filter_stage_struct *stage;
+
+  if (factor_log2 == 0 || factor_log2 > FILTER_CIC_MAX_FACTOR_LOG2 ||
+      order == 0 || order > FILTER_CIC_MAX_ORDER)
+  {
+    return false;
+  } /* if */
+
+  stage = filter_chain_new_stage(chain, FILTER_TYPE_CIC);
+  if (stage == NULL)
+  {
+    return false;
+  } /* if */
+
+  stage->param = factor_log2;
+  stage->order = order;
+  return true;
+} /* filter_chain_add_cic */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function clears the history of every stage in a chain, keeping the
+//    stages themselves. The next sample starts the chain afresh.
+//
+// INPUT PARAMETERS:
+//   none
+//
+// OUTPUT PARAMETERS:
+//   chain - the chain to reset
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+void filter_chain_reset(filter_chain_struct *chain)
+{
+  uint8_t i;
+
+  for (i = 0; i < chain->stage_count; i++)
+  {
+    memset(&chain->stages[i].state, 0, sizeof(chain->stages[i].state));
+    chain->stages[i].primed = false;
+  } /* for */
+} /* filter_chain_reset */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function feeds one sample through a chain. Each stage passes its
+//    output to the next. A decimating stage that has not finished its block
+//    ends the pass early, so the chain only has an output on some samples.
+//
+// INPUT PARAMETERS:
+//   sample - the new input sample
+//
+// OUTPUT PARAMETERS:
+//   chain  - the chain, whose state is updated
+//   output - the filtered sample, when there is one
+//
+// RETURN:
+//   true  - if output holds a new filtered sample
+//   false - if a decimator swallowed the sample
+// -----------------------------------------------------------------------------
+bool filter_chain_process(filter_chain_struct *chain, int32_t sample,
+                          int32_t *output)
+{
+  filter_stage_struct *stage;
+  uint8_t i;
+
+  for (i = 0; i < chain->stage_count; i++)
+  {
+    stage = &chain->stages[i];
+
+    switch (stage->type)
+    {
+      case FILTER_TYPE_BOXCAR:
+        sample = filter_boxcar_process(stage, sample);
+        break;
+      case FILTER_TYPE_IIR:
+        sample = filter_iir_process(stage, sample);
+        break;
+      case FILTER_TYPE_MEDIAN:
+        sample = filter_median_process(stage, sample);
+        break;
+      case FILTER_TYPE_CIC:
+        if (!filter_cic_process(stage, sample, &sample))
+        {
+          return false;
+        } /* if */
+        break;
+      default:
+        break;
+    } /* switch */
+  } /* for */
+
+  *output = sample;
+  return true;
+} /* filter_chain_process */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function claims the next free stage of a chain and clears it.
+//
+// INPUT PARAMETERS:
+//   type - FILTER_TYPE_xxx of the new stage
+//
+// OUTPUT PARAMETERS:
+//   chain - the chain to add the stage to
+//
+// RETURN:
+//   The new stage, or NULL if the chain is full
+// -----------------------------------------------------------------------------
+static filter_stage_struct *filter_chain_new_stage(filter_chain_struct *chain,
+                                                   uint8_t type)
+{
+  filter_stage_struct *stage;
+
+  if (chain->stage_count >= FILTER_MAX_STAGES)
+  {
+    return NULL;
+  } /* if */
+
+  stage = &chain->stages[chain->stage_count++];
+  memset(stage, 0, sizeof(*stage));
+  stage->type = type;
+
+  return stage;
+} /* filter_chain_new_stage */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function runs one sample through a boxcar stage.
+//
+// INPUT PARAMETERS:
+//   sample - the input sample
+//
+// OUTPUT PARAMETERS:
+//   stage - the stage, whose state is updated
+//
+// RETURN:
+//   The mean of the last 2^param samples
+// -----------------------------------------------------------------------------
+static int32_t filter_boxcar_process(filter_stage_struct *stage,
+                                     int32_t sample)
+{
+  filter_boxcar_struct *boxcar = &stage->state.boxcar;
+  uint8_t length = 1 << stage->param;
+  uint8_t i;
+
+  if (!stage->primed)
+  {
+    for (i = 0; i < length; i++)
+    {
+      boxcar->history[i] = sample;
+    } /* for */
+    boxcar->sum = sample * length;
+    stage->primed = true;
+  } /* if */
+
+  boxcar->sum += sample - boxcar->history[boxcar->index];
+  boxcar->history[boxcar->index] = sample;
+  boxcar->index = (boxcar->index + 1) & (length - 1);
+
+  return boxcar->sum >> stage->param;
+} /* filter_boxcar_process */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function runs one sample through an exponential IIR stage.
+//
+// INPUT PARAMETERS:
+//   sample - the input sample
+//
+// OUTPUT PARAMETERS:
+//   stage - the stage, whose state is updated
+//
+// RETURN:
+//   The smoothed sample
+// -----------------------------------------------------------------------------
+static int32_t filter_iir_process(filter_stage_struct *stage, int32_t sample)
+{
+  filter_iir_struct *iir = &stage->state.iir;
+
+  if (!stage->primed)
+  {
+    iir->acc = sample * (1L << stage->param);
+    stage->primed = true;
+  } /* if */
+
+  // acc holds y * 2^shift
+  iir->acc += sample - (iir->acc >> stage->param);
+
+  return iir->acc >> stage->param;
+} /* filter_iir_process */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function runs one sample through a median stage. The oldest sample
+//    is found in the sorted window and the new one slides into its place,
+//    moving only the values between the two.
+//
+// INPUT PARAMETERS:
+//   sample - the input sample
+//
+// OUTPUT PARAMETERS:
+//   stage - the stage, whose state is updated
+//
+// RETURN:
+//   The median of the last param samples
+// -----------------------------------------------------------------------------
+static int32_t filter_median_process(filter_stage_struct *stage,
+                                     int32_t sample)
+{
+  filter_median_struct *median = &stage->state.median;
+  uint8_t length = stage->param;
+  int32_t oldest;
+  uint8_t i;
+
+  if (!stage->primed)
+  {
+    for (i = 0; i < length; i++)
+    {
+      median->history[i] = sample;
+      median->sorted[i] = sample;
+    } /* for */
+    stage->primed = true;
+  } /* if */
+
+  oldest = median->history[median->index];
+  median->history[median->index] = sample;
+  if (++median->index >= length)
+  {
+    median->index = 0;
+  } /* if */
+
+  i = 0;
+  while (median->sorted[i] != oldest)
+  {
+    i++;
+  } /* while */
+
+  // Shift the values between the old and new positions over by one
+  while ((i + 1 < length) && (median->sorted[i + 1] < sample))
+  {
+    median->sorted[i] = median->sorted[i + 1];
+    i++;
+  } /* while */
+  while ((i > 0) && (median->sorted[i - 1] > sample))
+  {
+    median->sorted[i] = median->sorted[i - 1];
+    i--;
+  } /* while */
+  median->sorted[i] = sample;
+
+  return median->sorted[length / 2];
+} /* filter_median_process */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function runs one sample through a CIC decimator stage. Every
+//    sample goes through the integrators; once per block the combs run and
+//    the result is scaled by the CIC gain, 2^(order * factor_log2).
+//
+// INPUT PARAMETERS:
+//   sample - the input sample
+//
+// OUTPUT PARAMETERS:
+//   stage  - the stage, whose state is updated
+//   output - the decimated sample, at the end of a block
+//
+// RETURN:
+//   true  - if output holds a new sample
+//   false - if the block is not finished yet
+// -----------------------------------------------------------------------------
+static bool filter_cic_process(filter_stage_struct *stage, int32_t sample,
+                               int32_t *output)
+{
+  filter_cic_struct *cic = &stage->state.cic;
+  uint32_t value = (uint32_t)sample;
+  uint32_t delayed;
+  uint8_t i;
+
+  for (i = 0; i < stage->order; i++)
+  {
+    cic->integrator[i] += value;
+    value = cic->integrator[i];
+  } /* for */
+
+  if (++cic->phase < (1 << stage->param))
+  {
+    return false;
+  } /* if */
+  cic->phase = 0;
+
+  for (i = 0; i < stage->order; i++)
+  {
+    delayed = cic->comb[i];
+    cic->comb[i] = value;
+    value -= delayed;
+  } /* for */
+
+  *output = (int32_t)value >> (stage->order * stage->param);
+  return true;
+} /* filter_cic_process */
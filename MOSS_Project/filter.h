@@ -0,0 +1,146 @@
+// *****************************************************************************
+// ***************************    C Source Code     ****************************
+// *****************************************************************************
+//   DESIGNER NAME:  Rafael Ortiz
+//
+//         VERSION:  1.0
+//
+//       FILE NAME:  filter.h
+//
+//-----------------------------------------------------------------------------
+// DESCRIPTION
+//    This file contains integer-only filter stages for streams of sensor
+//    samples: a boxcar moving average, an exponential IIR low-pass, a
+//    median-of-N and a CIC decimator. Stages are chained per channel and the
+//    chain is fed one sample at a time, so it can run from an ADC ISR or DMA
+//    callback. Every stage costs a bounded number of cycles per sample, set
+//    by its length, and never divides.
+//
+//-----------------------------------------------------------------------------
+// DISCLAIMER
+//    This code was developed for educational purposes as part of the CSC202
+//    course and is provided "as is" without warranties of any kind, whether
+//    express, implied, or statutory.
+//
+//    The author and organization do not warrant the accuracy, completeness, or
+//    reliability of the code. The author and organization shall not be liable
+//    for any direct, indirect, incidental, special, exemplary, or consequential
+//    damages arising out of the use of or inability to use the code, even if
+//    advised of the possibility of such damages.
+//
+//    Use of this code is at your own risk, and it is recommended to validate
+//    and adapt the code for your specific application and hardware requirements.
+//
+// Copyright (c) 2024 by TBD
+//    You may use, edit, run or distribute this file as long as the above
+//    copyright notice remains
+// *****************************************************************************
+//******************************************************************************
+
+#ifndef __FILTER_H__
+#define __FILTER_H__
+
+//-----------------------------------------------------------------------------
+// Loads standard C include files
+//-----------------------------------------------------------------------------
+#include <stdbool.h>
+#include <stdint.h>
+
+
+//-----------------------------------------------------------------------------
+// Define symbolic constants used by the program
+//-----------------------------------------------------------------------------
+#define FILTER_MAX_STAGES                                                    (4)
+
+// Boxcar length is 2^length_log2 samples
+#define FILTER_BOXCAR_MAX_LOG2                                               (4)
+#define FILTER_BOXCAR_MAX_LENGTH                   (1 << FILTER_BOXCAR_MAX_LOG2)
+
+// Median length must be odd
+#define FILTER_MEDIAN_MAX_LENGTH                                             (9)
+
+// IIR smoothing: y += (x - y) / 2^shift
+#define FILTER_IIR_MAX_SHIFT                                                (12)
+
+// CIC decimation is by 2^factor_log2 with 1 to FILTER_CIC_MAX_ORDER sections.
+// The integrators grow by order * factor_log2 bits, which must leave room in
+// 32 bits for the input.
+#define FILTER_CIC_MAX_ORDER                                                 (3)
+#define FILTER_CIC_MAX_FACTOR_LOG2                                           (6)
+
+// Stage types
+#define FILTER_TYPE_BOXCAR                                                   (0)
+#define FILTER_TYPE_IIR                                                      (1)
+#define FILTER_TYPE_MEDIAN                                                   (2)
+#define FILTER_TYPE_CIC                                                      (3)
+
+
+//-----------------------------------------------------------------------------
+// Define the types used by the filters
+//-----------------------------------------------------------------------------
+typedef struct
+{
+  int32_t history[FILTER_BOXCAR_MAX_LENGTH];
+  int32_t sum;
+  uint8_t index;
+} filter_boxcar_struct;
+
+typedef struct
+{
+  int32_t acc;
+} filter_iir_struct;
+
+// history is in arrival order (a ring), sorted holds the same values in order
+typedef struct
+{
+  int32_t history[FILTER_MEDIAN_MAX_LENGTH];
+  int32_t sorted[FILTER_MEDIAN_MAX_LENGTH];
+  uint8_t index;
+} filter_median_struct;
+
+// Wrapping unsigned maths keeps the integrator overflow harmless
+typedef struct
+{
+  uint32_t integrator[FILTER_CIC_MAX_ORDER];
+  uint32_t comb[FILTER_CIC_MAX_ORDER];
+  uint8_t  phase;
+} filter_cic_struct;
+
+// One stage of a chain. param is the length (log2 for the boxcar and CIC),
+// order is only used by the CIC. primed is false until the first sample.
+typedef struct
+{
+  union
+  {
+    filter_boxcar_struct boxcar;
+    filter_iir_struct    iir;
+    filter_median_struct median;
+    filter_cic_struct    cic;
+  } state;
+  uint8_t type;
+  uint8_t param;
+  uint8_t order;
+  bool    primed;
+} filter_stage_struct;
+
+typedef struct
+{
+  filter_stage_struct stages[FILTER_MAX_STAGES];
+  uint8_t             stage_count;
+} filter_chain_struct;
+
+
+// ----------------------------------------------------------------------------
+// Prototype for support functions
+// ----------------------------------------------------------------------------
+void filter_chain_init(filter_chain_struct *chain);
+bool filter_chain_add_boxcar(filter_chain_struct *chain, uint8_t length_log2);
+bool filter_chain_add_iir(filter_chain_struct *chain, uint8_t shift);
+bool filter_chain_add_median(filter_chain_struct *chain, uint8_t length);
+bool filter_chain_add_cic(filter_chain_struct *chain, uint8_t factor_log2,
+                          uint8_t order);
+void filter_chain_reset(filter_chain_struct *chain);
+bool filter_chain_process(filter_chain_struct *chain, int32_t sample,
+                          int32_t *output);
+
+#endif /* __FILTER_H__ */
@@ -0,0 +1,235 @@
+// *****************************************************************************
+// ***************************    C Source Code     ****************************
+// *****************************************************************************
+//   DESIGNER NAME:  Rafael Ortiz
+//
+//         VERSION:  1.0
+//
+//       FILE NAME:  flash.c
+//
+//-----------------------------------------------------------------------------
+// DESCRIPTION
+//    This file contains the driver for the storage area of the on-chip flash.
+//    It erases sectors and programs flash words through the FLASHCTL command
+//    interface and reads the area straight from the memory map.
+//
+//    The MSPM0G3507 has a single flash bank, so the CPU stalls on any fetch
+//    from flash while a command runs. That includes interrupt handlers: a
+//    sector erase holds off everything for a few milliseconds.
+//
+//-----------------------------------------------------------------------------
+// DISCLAIMER
+//    This code was developed for educational purposes as part of the CSC202
+//    course and is provided "as is" without warranties of any kind, whether
+//    express, implied, or statutory.
+//
+//    The author and organization do not warrant the accuracy, completeness, or
+//    reliability of the code. The author and organization shall not be liable
+//    for any direct, indirect, incidental, special, exemplary, or consequential
+//    damages arising out of the use of or inability to use the code, even if
+//    advised of the possibility of such damages.
+//
+//    Use of this code is at your own risk, and it is recommended to validate
+//    and adapt the code for your specific application and hardware requirements.
+//
+// Copyright (c) 2024 by TBD
+//    You may use, edit, run or distribute this file as long as the above
+//    copyright notice remains
+// *****************************************************************************
+//******************************************************************************
+
+//-----------------------------------------------------------------------------
+// Load standard C include files
+//-----------------------------------------------------------------------------
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+
+//-----------------------------------------------------------------------------
+// Loads MSP launchpad board support macros and definitions
+//-----------------------------------------------------------------------------
+#include <ti/devices/msp/msp.h>
+#include "flash.h"
+
+
+//-----------------------------------------------------------------------------
+// Define symbolic constants used by the program
+//-----------------------------------------------------------------------------
+// The eight data bytes of a flash word plus its ECC byte
+#define FLASH_BYTE_ENABLE_WORD                                           (0x1FF)
+
+
+//-----------------------------------------------------------------------------
+// Prototype for local functions
+//-----------------------------------------------------------------------------
+static bool flash_execute(void);
+static bool flash_erase_sector(uint16_t sector);
+static bool flash_program(uint32_t offset, const void *data, uint16_t length);
+static void flash_read(uint32_t offset, void *data, uint16_t length);
+
+
+//-----------------------------------------------------------------------------
+// Define global variables and structures here.
+// NOTE: when possible avoid using global variables
+//-----------------------------------------------------------------------------
+static const flash_dev_struct g_flash_device =
+{
+  flash_erase_sector,
+  flash_program,
+  flash_read,
+  FLASH_STORE_SECTORS
+};
+
+
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//  This function returns the on-chip storage area as a flash device.
+//
+// INPUT PARAMETERS:
+//  none
+//
+// OUTPUT PARAMETERS:
+//  none
+//
+// RETURN:
+//  The flash device
+//------------------------------------------------------------------------------
+const flash_dev_struct *flash_get_device(void)
+{
+  return &g_flash_device;
+} /* flash_get_device */
+
+
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//  This function runs the command set up in the FLASHCTL command registers
+//  and waits for it to finish. Write/erase protection re-arms after every
+//  command, so the main flash is unprotected just before each one; the
+//  command address alone decides what changes.
+//
+// INPUT PARAMETERS:
+//  none
+//
+// OUTPUT PARAMETERS:
+//  none
+//
+// RETURN:
+//  true  - if the command passed
+//  false - if the flash controller reported a failure
+//------------------------------------------------------------------------------
+static bool flash_execute(void)
+{
+  FLASHCTL->GEN.CMDWEPROTA = 0;
+  FLASHCTL->GEN.CMDWEPROTB = 0;
+
+  FLASHCTL->GEN.CMDEXEC = FLASHCTL_CMDEXEC_VAL_EXECUTE;
+
+  while ((FLASHCTL->GEN.STATCMD & FLASHCTL_STATCMD_CMDDONE_MASK) !=
+         FLASHCTL_STATCMD_CMDDONE_STATDONE);
+
+  return (FLASHCTL->GEN.STATCMD & FLASHCTL_STATCMD_CMDPASS_MASK) ==
+         FLASHCTL_STATCMD_CMDPASS_STATPASS;
+} /* flash_execute */
+
+
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//  This function erases one sector of the storage area to all 0xFF.
+//
+// INPUT PARAMETERS:
+//  sector - the sector (0 to FLASH_STORE_SECTORS - 1)
+//
+// OUTPUT PARAMETERS:
+//  none
+//
+// RETURN:
+//  true  - if the sector was erased
+//  false - if the sector is out of range or the erase failed
+//------------------------------------------------------------------------------
+static bool flash_erase_sector(uint16_t sector)
+{
+  if (sector >= FLASH_STORE_SECTORS)
+  {
+    return false;
+  } /* if */
+
+  FLASHCTL->GEN.CMDTYPE = FLASHCTL_CMDTYPE_COMMAND_ERASE |
+                          FLASHCTL_CMDTYPE_SIZE_SECTOR;
+  FLASHCTL->GEN.CMDCTL = FLASHCTL_CMDCTL_REGIONSEL_MAIN;
+  FLASHCTL->GEN.CMDADDR = FLASH_STORE_BASE + sector * FLASH_SECTOR_SIZE;
+
+  return flash_execute();
+} /* flash_erase_sector */
+
+
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//  This function programs whole flash words of the storage area, one word
+//  per command. The flash computes the ECC byte of each word itself.
+//
+// INPUT PARAMETERS:
+//  offset - where to program, a multiple of FLASH_WORD_SIZE
+//  data   - the bytes to program
+//  length - how many bytes, a multiple of FLASH_WORD_SIZE
+//
+// OUTPUT PARAMETERS:
+//  none
+//
+// RETURN:
+//  true  - if every word was programmed
+//  false - if the request is misaligned or out of range, or a word failed
+//------------------------------------------------------------------------------
+static bool flash_program(uint32_t offset, const void *data, uint16_t length)
+{
+  const uint8_t *bytes = data;
+  uint32_t word[FLASH_WORD_SIZE / sizeof(uint32_t)];
+  uint16_t i;
+
+  if ((offset % FLASH_WORD_SIZE) != 0 || (length % FLASH_WORD_SIZE) != 0 ||
+      offset + length > FLASH_STORE_SECTORS * FLASH_SECTOR_SIZE)
+  {
+    return false;
+  } /* if */
+
+  for (i = 0; i < length; i += FLASH_WORD_SIZE)
+  {
+    // The caller's bytes need not be word aligned
+    memcpy(word, &bytes[i], FLASH_WORD_SIZE);
+
+    FLASHCTL->GEN.CMDTYPE = FLASHCTL_CMDTYPE_COMMAND_PROGRAM |
+                            FLASHCTL_CMDTYPE_SIZE_ONEWORD;
+    FLASHCTL->GEN.CMDCTL = FLASHCTL_CMDCTL_REGIONSEL_MAIN;
+    FLASHCTL->GEN.CMDADDR = FLASH_STORE_BASE + offset + i;
+    FLASHCTL->GEN.CMDBYTEN = FLASH_BYTE_ENABLE_WORD;
+    FLASHCTL->GEN.CMDDATA0 = word[0];
+    FLASHCTL->GEN.CMDDATA1 = word[1];
+
+    if (!flash_execute())
+    {
+      return false;
+    } /* if */
+  } /* for */
+
+  return true;
+} /* flash_program */
+
+
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//  This function reads bytes of the storage area from the memory map.
+//
+// INPUT PARAMETERS:
+//  offset - where to start reading
+//  length - how many bytes to read
+//
+// OUTPUT PARAMETERS:
+//  data - the bytes read
+//
+// RETURN:
+//  none
+//------------------------------------------------------------------------------
+static void flash_read(uint32_t offset, void *data, uint16_t length)
+{
+  memcpy(data, (const void *)(FLASH_STORE_BASE + offset), length);
+} /* flash_read */
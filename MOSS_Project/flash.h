@@ -0,0 +1,86 @@
+// *****************************************************************************
+// ***************************    C Source Code     ****************************
+// *****************************************************************************
+//   DESIGNER NAME:  Rafael Ortiz
+//
+//         VERSION:  1.0
+//
+//       FILE NAME:  flash.h
+//
+//-----------------------------------------------------------------------------
+// DESCRIPTION
+//    This file contains the interface to the flash that holds the persistent
+//    store. Storage code reaches the flash only through a flash_dev_struct,
+//    which erases whole sectors, programs whole flash words and reads back
+//    bytes, all by offset from the start of the storage area. flash.c fills
+//    one in for the on-chip flash of the MSPM0G3507; any other model of a
+//    flash that follows the same rules can be dropped in instead.
+//
+//-----------------------------------------------------------------------------
+// DISCLAIMER
+//    This code was developed for educational purposes as part of the CSC202
+//    course and is provided "as is" without warranties of any kind, whether
+//    express, implied, or statutory.
+//
+//    The author and organization do not warrant the accuracy, completeness, or
+//    reliability of the code. The author and organization shall not be liable
+//    for any direct, indirect, incidental, special, exemplary, or consequential
+//    damages arising out of the use of or inability to use the code, even if
+//    advised of the possibility of such damages.
+//
+//    Use of this code is at your own risk, and it is recommended to validate
+//    and adapt the code for your specific application and hardware requirements.
+//
+// Copyright (c) 2024 by TBD
+//    You may use, edit, run or distribute this file as long as the above
+//    copyright notice remains
+// *****************************************************************************
+//******************************************************************************
+
+#ifndef __FLASH_H__
+#define __FLASH_H__
+
+//-----------------------------------------------------------------------------
+// Loads standard C include files
+//-----------------------------------------------------------------------------
+#include <stdbool.h>
+#include <stdint.h>
+
+
+//-----------------------------------------------------------------------------
+// Define symbolic constants used by the program
+//-----------------------------------------------------------------------------
+// Erase works on 1 KB sectors, programming on 64-bit flash words. A word
+// can be programmed once after each erase; erased flash reads as 0xFF.
+#define FLASH_SECTOR_SIZE                                                 (1024)
+#define FLASH_WORD_SIZE                                                      (8)
+#define FLASH_ERASED_BYTE                                                 (0xFF)
+
+// The top 8 KB of the main flash, kept out of the FLASH region in
+// mspm0g3507.cmd so the linker never places code there
+#define FLASH_STORE_BASE                                           (0x0001E000)
+#define FLASH_STORE_SECTORS                                                  (8)
+
+
+//-----------------------------------------------------------------------------
+// Define the types used by the flash
+//-----------------------------------------------------------------------------
+// A flash the store can run on. Offsets count from the start of the storage
+// area. program takes word-aligned offsets and a length that is a multiple
+// of FLASH_WORD_SIZE. erase and program return false if the flash reports
+// that the command failed.
+typedef struct
+{
+  bool (*erase)(uint16_t sector);
+  bool (*program)(uint32_t offset, const void *data, uint16_t length);
+  void (*read)(uint32_t offset, void *data, uint16_t length);
+  uint16_t sector_count;
+} flash_dev_struct;
+
+
+// ----------------------------------------------------------------------------
+// Prototype for support functions
+// ----------------------------------------------------------------------------
+const flash_dev_struct *flash_get_device(void);
+
+#endif /* __FLASH_H__ */
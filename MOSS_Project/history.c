@@ -0,0 +1,602 @@
+// *****************************************************************************
+// ***************************    C Source Code     ****************************
+// *****************************************************************************
+//   DESIGNER NAME:  Rafael Ortiz
+//
+//         VERSION:  1.0
+//
+//       FILE NAME:  history.c
+//
+//-----------------------------------------------------------------------------
+// DESCRIPTION
+//    This file contains a compressed in-RAM history of timestamped samples.
+//    Each channel is a chain of fixed-size blocks taken from a shared pool.
+//    A block starts with the absolute time and value of its first sample;
+//    every later sample is stored as varint-coded deltas, so a slowly
+//    changing reading taken at the channel's period costs one byte. When the
+//    pool runs out, the oldest block of any channel is reused, so the
+//    history always covers the most recent span of time.
+//
+//    Block layout:
+//      varint(time) varint(zigzag(value))          first sample
+//      varint(zigzag(dv) << 1 | late) [varint(dt)]  every later sample
+//    where dv and dt are the changes from the previous sample and late is
+//    set when dt is not the channel period, in which case dt follows.
+//
+//    Varints are little-endian base 128 (7 bits per byte, high bit set on
+//    all but the last byte). Zigzag maps signed values to unsigned ones so
+//    small changes either way stay small: 0, -1, 1, -2 become 0, 1, 2, 3.
+//
+//    Samples are added by one task and read by another. A writer fills in
+//    the bytes before publishing the new length or block link, so a reader
+//    never sees half a sample; a reader whose block is reused jumps to the
+//    oldest block still held.
+//
+//-----------------------------------------------------------------------------
+// DISCLAIMER
+//    This code was developed for educational purposes as part of the CSC202
+//    course and is provided "as is" without warranties of any kind, whether
+//    express, implied, or statutory.
+//
+//    The author and organization do not warrant the accuracy, completeness, or
+//    reliability of the code. The author and organization shall not be liable
+//    for any direct, indirect, incidental, special, exemplary, or consequential
+//    damages arising out of the use of or inability to use the code, even if
+//    advised of the possibility of such damages.
+//
+//    Use of this code is at your own risk, and it is recommended to validate
+//    and adapt the code for your specific application and hardware requirements.
+//
+// Copyright (c) 2024 by TBD
+//    You may use, edit, run or distribute this file as long as the above
+//    copyright notice remains
+// *****************************************************************************
+//******************************************************************************
+
+//-----------------------------------------------------------------------------
+// Load standard C include files
+//-----------------------------------------------------------------------------
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+
+//-----------------------------------------------------------------------------
+// Loads MSP launchpad board support macros and definitions
+//-----------------------------------------------------------------------------
+#include "history.h"
+
+
+//-----------------------------------------------------------------------------
+// Define global variables and structures here.
+// NOTE: when possible avoid using global variables
+//-----------------------------------------------------------------------------
+// One block of the pool. seq grows every time a block is taken, so the
+// oldest block is the one with the lowest seq.
+typedef struct
+{
+  uint8_t           data[HISTORY_BLOCK_SIZE];
+  uint32_t          seq;
+  volatile uint16_t used;
+  uint16_t          samples;
+  uint8_t           channel;
+  volatile uint8_t  next;
+} history_block_struct;
+
+typedef struct
+{
+  uint32_t         period;
+  uint32_t         last_time;
+  int32_t          last_value;
+  uint32_t         samples;
+  volatile uint8_t first;
+  uint8_t          last;
+  bool             active;
+} history_channel_struct;
+
+static history_block_struct g_history_blocks[HISTORY_BLOCKS];
+static history_channel_struct g_history_channels[HISTORY_MAX_CHANNELS];
+static uint8_t g_history_free = HISTORY_NO_BLOCK;
+static uint32_t g_history_seq = 0;
+static history_block_callback_t g_history_block_callback = NULL;
+
+
+//-----------------------------------------------------------------------------
+// Prototype for local functions
+//-----------------------------------------------------------------------------
+static uint8_t history_alloc_block(void);
+static void history_free_chain(uint8_t block);
+static uint16_t history_put_varint(uint8_t *data, uint32_t value);
+static uint16_t history_get_varint(const uint8_t *data, uint32_t *value);
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function empties the history: every block goes back to the pool
+//    and no channel is recorded.
+//
+// INPUT PARAMETERS:
+//   none
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+void history_init(void)
+{
+  uint8_t i;
+
+  for (i = 0; i < HISTORY_MAX_CHANNELS; i++)
+  {
+    g_history_channels[i].active = false;
+    g_history_channels[i].first = HISTORY_NO_BLOCK;
+    g_history_channels[i].last = HISTORY_NO_BLOCK;
+    g_history_channels[i].samples = 0;
+  } /* for */
+
+  for (i = 0; i < HISTORY_BLOCKS; i++)
+  {
+    g_history_blocks[i].next = (i + 1 < HISTORY_BLOCKS) ? i + 1 :
+                                                          HISTORY_NO_BLOCK;
+  } /* for */
+  g_history_free = 0;
+} /* history_init */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function starts (or restarts) recording a channel. Any samples it
+//    already held are dropped.
+//
+// INPUT PARAMETERS:
+//   channel - the channel to record (0 to HISTORY_MAX_CHANNELS - 1)
+//   period  - the usual time between samples; samples that arrive exactly
+//             one period apart do not need to store the time
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   true  - if the channel was started
+//   false - if the channel or period is not valid
+// -----------------------------------------------------------------------------
+bool history_start_channel(uint8_t channel, uint32_t period)
+{
+  history_channel_struct *chan;
+
+  if (channel >= HISTORY_MAX_CHANNELS || period == 0)
+  {
+    return false;
+  } /* if */
+
+  chan = &g_history_channels[channel];
+  chan->active = false;
+  history_free_chain(chan->first);
+
+  chan->first = HISTORY_NO_BLOCK;
+  chan->last = HISTORY_NO_BLOCK;
+  chan->period = period;
+  chan->samples = 0;
+  chan->active = true;
+
+  return true;
+} /* history_start_channel */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function appends a sample to a channel. It goes into the channel's
+//    newest block as deltas from the previous sample, or starts a new block
+//    when that one is full, reusing the oldest block in the pool if needed.
+//
+// INPUT PARAMETERS:
+//   channel - the channel to add to
+//   time    - the time of the sample, in the units of the channel period
+//   value   - the sample
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   true  - if the sample was stored
+//   false - if the channel is not being recorded
+// -----------------------------------------------------------------------------
+bool history_add(uint8_t channel, uint32_t time, int32_t value)
+{
+  history_channel_struct *chan;
+  history_block_struct *block = NULL;
+  uint32_t delta_time;
+  uint32_t delta_value;
+  uint32_t zigzag;
+  uint16_t used;
+  uint8_t index;
+
+  if (channel >= HISTORY_MAX_CHANNELS || !g_history_channels[channel].active)
+  {
+    return false;
+  } /* if */
+
+  chan = &g_history_channels[channel];
+  delta_time = time - chan->last_time;
+
+  // The change wraps modulo 2^32 like the time, so a swing from one end of
+  // the int32_t range to the other is a small change the reader undoes
+  delta_value = (uint32_t)value - (uint32_t)chan->last_value;
+  zigzag = (delta_value << 1) ^ (uint32_t)((int32_t)delta_value >> 31);
+
+  if (chan->last != HISTORY_NO_BLOCK)
+  {
+    block = &g_history_blocks[chan->last];
+  } /* if */
+
+  // Deltas that leave no room for the late flag start a new block too
+  if (block != NULL &&
+      block->used + HISTORY_RECORD_MAX <= HISTORY_BLOCK_SIZE &&
+      zigzag < 0x80000000)
+  {
+    used = block->used;
+    used += history_put_varint(&block->data[used],
+                               (zigzag << 1) | (delta_time != chan->period));
+    if (delta_time != chan->period)
+    {
+      used += history_put_varint(&block->data[used], delta_time);
+    } /* if */
+    block->samples++;
+    block->used = used;
+  } /* if */
+  else
+  {
+    // The newest block is full, so hand it on before starting another
+    if (block != NULL && g_history_block_callback != NULL)
+    {
+      g_history_block_callback(channel, block->data, block->used);
+    } /* if */
+
+    index = history_alloc_block();
+    block = &g_history_blocks[index];
+    block->channel = channel;
+    block->next = HISTORY_NO_BLOCK;
+    block->samples = 1;
+
+    used = history_put_varint(block->data, time);
+    used += history_put_varint(&block->data[used],
+                               ((uint32_t)value << 1) ^
+                               (uint32_t)(value >> 31));
+    block->used = used;
+
+    // Publish the block only once it holds its first sample
+    if (chan->last == HISTORY_NO_BLOCK)
+    {
+      chan->first = index;
+    } /* if */
+    else
+    {
+      g_history_blocks[chan->last].next = index;
+    } /* else */
+    chan->last = index;
+  } /* else */
+
+  chan->last_time = time;
+  chan->last_value = value;
+  chan->samples++;
+
+  return true;
+} /* history_add */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function sets up an iterator at the oldest sample of a channel.
+//
+// INPUT PARAMETERS:
+//   channel - the channel to walk
+//
+// OUTPUT PARAMETERS:
+//   iter - the iterator
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+void history_iter_begin(history_iter_struct *iter, uint8_t channel)
+{
+  iter->channel = channel;
+  iter->block = HISTORY_NO_BLOCK;
+  iter->offset = 0;
+
+  if (channel < HISTORY_MAX_CHANNELS)
+  {
+    iter->block = g_history_channels[channel].first;
+  } /* if */
+
+  if (iter->block != HISTORY_NO_BLOCK)
+  {
+    iter->seq = g_history_blocks[iter->block].seq;
+  } /* if */
+} /* history_iter_begin */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function decodes the next sample of a channel, oldest first.
+//    Samples added while iterating are returned too.
+//
+// INPUT PARAMETERS:
+//   none
+//
+// OUTPUT PARAMETERS:
+//   iter  - the iterator, moved past the sample
+//   time  - the time of the sample
+//   value - the sample
+//
+// RETURN:
+//   true  - if a sample was decoded
+//   false - if there are no more samples
+// -----------------------------------------------------------------------------
+bool history_iter_next(history_iter_struct *iter, uint32_t *time,
+                       int32_t *value)
+{
+  history_block_struct *block;
+  uint32_t delta_time;
+  uint32_t word;
+
+  while (iter->block != HISTORY_NO_BLOCK)
+  {
+    block = &g_history_blocks[iter->block];
+
+    // The block was reused under us; carry on from the oldest one left
+    if (block->seq != iter->seq)
+    {
+      iter->block = g_history_channels[iter->channel].first;
+      iter->offset = 0;
+      if (iter->block != HISTORY_NO_BLOCK)
+      {
+        iter->seq = g_history_blocks[iter->block].seq;
+      } /* if */
+      continue;
+    } /* if */
+
+    if (iter->offset == 0)
+    {
+      iter->offset = history_get_varint(block->data, &iter->time);
+      iter->offset += history_get_varint(&block->data[iter->offset], &word);
+      iter->value = (int32_t)(word >> 1) ^ -(int32_t)(word & 1);
+    } /* if */
+    else if (iter->offset < block->used)
+    {
+      iter->offset += history_get_varint(&block->data[iter->offset], &word);
+      if (word & 1)
+      {
+        iter->offset += history_get_varint(&block->data[iter->offset],
+                                           &delta_time);
+        iter->time += delta_time;
+      } /* if */
+      else
+      {
+        iter->time += g_history_channels[iter->channel].period;
+      } /* else */
+      word >>= 1;
+      iter->value = (int32_t)((uint32_t)iter->value +
+                              ((word >> 1) ^ (0U - (word & 1))));
+    } /* else if */
+    else
+    {
+      if (block->next == HISTORY_NO_BLOCK)
+      {
+        return false;
+      } /* if */
+      iter->block = block->next;
+      iter->seq = g_history_blocks[iter->block].seq;
+      iter->offset = 0;
+      continue;
+    } /* else */
+
+    *time = iter->time;
+    *value = iter->value;
+    return true;
+  } /* while */
+
+  return false;
+} /* history_iter_next */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function reports how many samples a channel holds and how much of
+//    the pool they take.
+//
+// INPUT PARAMETERS:
+//   channel - the channel
+//
+// OUTPUT PARAMETERS:
+//   stats - the sample, block and byte counts
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+void history_get_stats(uint8_t channel, history_stats_struct *stats)
+{
+  uint8_t block = HISTORY_NO_BLOCK;
+
+  stats->samples = 0;
+  stats->bytes = 0;
+  stats->blocks = 0;
+
+  if (channel < HISTORY_MAX_CHANNELS)
+  {
+    stats->samples = g_history_channels[channel].samples;
+    block = g_history_channels[channel].first;
+  } /* if */
+
+  while (block != HISTORY_NO_BLOCK)
+  {
+    stats->blocks++;
+    stats->bytes += g_history_blocks[block].used;
+    block = g_history_blocks[block].next;
+  } /* while */
+} /* history_get_stats */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function sets the function called with each block as it fills,
+//    from the context that adds the sample that overflows it. The block is
+//    still held in RAM when the call is made.
+//
+// INPUT PARAMETERS:
+//   callback - the function to call, or NULL for none
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+void history_set_block_callback(history_block_callback_t callback)
+{
+  g_history_block_callback = callback;
+} /* history_set_block_callback */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function takes a block from the pool. When the pool is empty the
+//    oldest block of any channel is unlinked from its channel and reused.
+//
+// INPUT PARAMETERS:
+//   none
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   The index of the block
+// -----------------------------------------------------------------------------
+static uint8_t history_alloc_block(void)
+{
+  history_channel_struct *chan;
+  history_channel_struct *oldest = NULL;
+  uint8_t index;
+  uint8_t i;
+
+  if (g_history_free == HISTORY_NO_BLOCK)
+  {
+    for (i = 0; i < HISTORY_MAX_CHANNELS; i++)
+    {
+      chan = &g_history_channels[i];
+      if (chan->first != HISTORY_NO_BLOCK &&
+          (oldest == NULL ||
+           (int32_t)(g_history_blocks[chan->first].seq -
+                     g_history_blocks[oldest->first].seq) < 0))
+      {
+        oldest = chan;
+      } /* if */
+    } /* for */
+
+    index = oldest->first;
+    oldest->samples -= g_history_blocks[index].samples;
+    oldest->first = g_history_blocks[index].next;
+    if (oldest->first == HISTORY_NO_BLOCK)
+    {
+      oldest->last = HISTORY_NO_BLOCK;
+    } /* if */
+  } /* if */
+  else
+  {
+    index = g_history_free;
+    g_history_free = g_history_blocks[index].next;
+  } /* else */
+
+  g_history_blocks[index].seq = ++g_history_seq;
+  g_history_blocks[index].used = 0;
+
+  return index;
+} /* history_alloc_block */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function returns a chain of blocks to the pool.
+//
+// INPUT PARAMETERS:
+//   block - the first block of the chain, or HISTORY_NO_BLOCK
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+static void history_free_chain(uint8_t block)
+{
+  uint8_t next;
+
+  while (block != HISTORY_NO_BLOCK)
+  {
+    next = g_history_blocks[block].next;
+    g_history_blocks[block].seq = ++g_history_seq;
+    g_history_blocks[block].next = g_history_free;
+    g_history_free = block;
+    block = next;
+  } /* while */
+} /* history_free_chain */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function writes a value as a varint.
+//
+// INPUT PARAMETERS:
+//   value - the value to write
+//
+// OUTPUT PARAMETERS:
+//   data - where to write it, room for HISTORY_VARINT_MAX bytes
+//
+// RETURN:
+//   The number of bytes written
+// -----------------------------------------------------------------------------
+static uint16_t history_put_varint(uint8_t *data, uint32_t value)
+{
+  uint16_t count = 0;
+
+  while (value >= 0x80)
+  {
+    data[count++] = (uint8_t)(value | 0x80);
+    value >>= 7;
+  } /* while */
+  data[count++] = (uint8_t)value;
+
+  return count;
+} /* history_put_varint */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function reads a varint.
+//
+// INPUT PARAMETERS:
+//   data - the varint bytes
+//
+// OUTPUT PARAMETERS:
+//   value - the value read
+//
+// RETURN:
+//   The number of bytes read
+// -----------------------------------------------------------------------------
+static uint16_t history_get_varint(const uint8_t *data, uint32_t *value)
+{
+  uint16_t count = 0;
+  uint8_t shift = 0;
+  uint8_t byte;
+
+  *value = 0;
+  do
+  {
+    byte = data[count++];
+    *value |= (uint32_t)(byte & 0x7F) << shift;
+    shift += 7;
+  } while ((byte & 0x80) && (count < HISTORY_VARINT_MAX));
+
+  return count;
+} /* history_get_varint */
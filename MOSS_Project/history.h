@@ -0,0 +1,112 @@
+// *****************************************************************************
+// ***************************    C Source Code     ****************************
+// *****************************************************************************
+//   DESIGNER NAME:  Rafael Ortiz
+//
+//         VERSION:  1.0
+//
+//       FILE NAME:  history.h
+//
+//-----------------------------------------------------------------------------
+// DESCRIPTION
+//    This file contains a compressed in-RAM history of timestamped samples.
+//    Each channel is a chain of fixed-size blocks taken from a shared pool.
+//    A block starts with the absolute time and value of its first sample;
+//    every later sample is stored as varint-coded deltas, so a slowly
+//    changing reading taken at the channel's period costs one byte. When the
+//    pool runs out, the oldest block of any channel is reused, so the
+//    history always covers the most recent span of time.
+//
+//-----------------------------------------------------------------------------
+// DISCLAIMER
+//    This code was developed for educational purposes as part of the CSC202
+//    course and is provided "as is" without warranties of any kind, whether
+//    express, implied, or statutory.
+//
+//    The author and organization do not warrant the accuracy, completeness, or
+//    reliability of the code. The author and organization shall not be liable
+//    for any direct, indirect, incidental, special, exemplary, or consequential
+//    damages arising out of the use of or inability to use the code, even if
+//    advised of the possibility of such damages.
+//
+//    Use of this code is at your own risk, and it is recommended to validate
+//    and adapt the code for your specific application and hardware requirements.
+//
+// Copyright (c) 2024 by TBD
+//    You may use, edit, run or distribute this file as long as the above
+//    copyright notice remains
+// *****************************************************************************
+//******************************************************************************
+
+#ifndef __HISTORY_H__
+#define __HISTORY_H__
+
+//-----------------------------------------------------------------------------
+// Loads standard C include files
+//-----------------------------------------------------------------------------
+#include <stdbool.h>
+#include <stdint.h>
+
+
+//-----------------------------------------------------------------------------
+// Define symbolic constants used by the program
+//-----------------------------------------------------------------------------
+// Pool of HISTORY_BLOCKS blocks of HISTORY_BLOCK_SIZE bytes shared by all
+// channels (4 KB, a bit over an hour of one 1 Hz channel)
+#define HISTORY_MAX_CHANNELS                                                 (2)
+#define HISTORY_BLOCKS                                                      (16)
+#define HISTORY_BLOCK_SIZE                                                 (256)
+
+// Channels recorded by MOSS
+#define HISTORY_CHANNEL_TEMP                                                 (0)
+
+// Longest varint a 32-bit value can take, and the most one sample can add
+#define HISTORY_VARINT_MAX                                                   (5)
+#define HISTORY_RECORD_MAX                            (2 * HISTORY_VARINT_MAX)
+
+// Marks the end of a chain of blocks
+#define HISTORY_NO_BLOCK                                                  (0xFF)
+
+
+//-----------------------------------------------------------------------------
+// Define the types used by the history
+//-----------------------------------------------------------------------------
+// Walks the samples of one channel from oldest to newest. seq is the
+// sequence number of the block being read, so a block reused under the
+// reader is noticed.
+typedef struct
+{
+  uint32_t time;
+  int32_t  value;
+  uint32_t seq;
+  uint16_t offset;
+  uint8_t  channel;
+  uint8_t  block;
+} history_iter_struct;
+
+// Called with each block of a channel as it fills up
+typedef void (*history_block_callback_t)(uint8_t channel, const uint8_t *data,
+                                         uint16_t length);
+
+// Occupancy of one channel
+typedef struct
+{
+  uint32_t samples;
+  uint16_t bytes;
+  uint8_t  blocks;
+} history_stats_struct;
+
+
+// ----------------------------------------------------------------------------
+// Prototype for support functions
+// ----------------------------------------------------------------------------
+void history_init(void);
+bool history_start_channel(uint8_t channel, uint32_t period);
+bool history_add(uint8_t channel, uint32_t time, int32_t value);
+void history_iter_begin(history_iter_struct *iter, uint8_t channel);
+bool history_iter_next(history_iter_struct *iter, uint32_t *time,
+                       int32_t *value);
+void history_get_stats(uint8_t channel, history_stats_struct *stats);
+void history_set_block_callback(history_block_callback_t callback);
+
+#endif /* __HISTORY_H__ */
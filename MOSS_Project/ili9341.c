@@ -37,7 +37,9 @@
 //-----------------------------------------------------------------------------
 // Load standard C include files
 //-----------------------------------------------------------------------------
-
+#include <stddef.h>
+#include <stdbool.h>
+#include <string.h>
 
 //-----------------------------------------------------------------------------
 // Loads MSP launchpad board support macros and definitions
@@ -57,6 +59,95 @@ struct position {
 
 struct position g_cursor_pos = {0, 25};
 
+// Where one glyph sits inside its character cell, used by text runs. rows
+// points at the cell's row masks in the glyph cache, or is NULL.
+typedef struct
+{
+  const uint8_t  *bitmap;
+  const uint16_t *rows;
+  int16_t         top;
+  int8_t          left;
+  uint8_t         box_w;
+  uint8_t         box_h;
+  uint8_t         glyph_index;
+} glyph_cell_struct;
+
+#if ILI9341_GLYPH_CACHE_ENTRIES > 0
+#if GLYPH_WIDTH > 16
+#error "Glyph cache row masks hold at most 16 pixels"
+#endif
+
+// A text cell for one cell geometry, as one mask per pixel row with the
+// leftmost pixel in the top bit; a set bit is a glyph pixel
+typedef struct
+{
+  uint32_t last_used;
+  uint8_t  cell_h;
+  uint8_t  baseline;
+  uint8_t  glyph_index;
+  uint16_t rows[ILI9341_GLYPH_CACHE_MAX_CELL_H];
+} glyph_cache_entry_struct;
+
+static glyph_cache_entry_struct g_glyph_cache[ILI9341_GLYPH_CACHE_ENTRIES];
+
+// Stamp of the text run being drawn; entries carrying it are not evicted
+static uint32_t g_glyph_cache_clock = 0;
+#endif
+
+static glyph_cache_stats_struct g_glyph_cache_stats = {0};
+
+// Draw operations the band renderer queues between begin and end
+#define STRIP_OP_FILL                                                        (0)
+#define STRIP_OP_TEXT                                                        (1)
+
+// A draw operation queued for the band renderer, in screen coordinates. Text
+// is positioned by its baseline and h is unused.
+typedef struct
+{
+  const char *text;
+  int16_t     x;
+  int16_t     y;
+  uint16_t    w;
+  uint16_t    h;
+  uint16_t    color;
+  uint8_t     type;
+} strip_op_struct;
+
+// The region the band renderer is composing and the operations queued in it
+typedef struct
+{
+  uint16_t        x;
+  uint16_t        y;
+  uint16_t        w;
+  uint16_t        h;
+  uint16_t        bg_color;
+  uint8_t         op_count;
+  strip_op_struct ops[ILI9341_STRIP_MAX_OPS];
+} strip_struct;
+
+static strip_struct g_strip = {0};
+
+// Two halves of the strip; DMA sends one band while the next is drawn
+static uint16_t g_strip_buffer[2][ILI9341_STRIP_HALF_PIXELS];
+
+
+//-----------------------------------------------------------------------------
+// Prototype for local functions
+//-----------------------------------------------------------------------------
+static uint16_t ili9341_cell_pixel(const glyph_cell_struct *cell, uint16_t row,
+                                   uint8_t col);
+static const uint16_t *ili9341_glyph_cache_get(const glyph_cell_struct *cell,
+                                               uint16_t cell_h,
+                                               uint16_t baseline);
+static void ili9341_strip_render_band(uint16_t *band, uint16_t band_y,
+                                      uint16_t lines);
+
+static uint16_t g_text_fg_color = ILI9341_BLACK;
+static uint16_t g_text_bg_color = ILI9341_WHITE;
+
+// Number of commands sent, used to measure driver throughput
+static uint32_t g_cmd_count = 0;
+
 
 //------------------------------------------------------------------------------
 // DESCRIPTION:
@@ -109,7 +200,7 @@ void ili9341_init(void)
     ILI9341_PWCTR2  , 1, 0x10,             // Power control SAP[2:0];BT[3:0]
     ILI9341_VMCTR1  , 2, 0x3e, 0x28,       // VCM control
     ILI9341_VMCTR2  , 1, 0x86,             // VCM control2
-    ILI9341_MADCTL  , 1, 0xE8,             // Memory Access Control
+    ILI9341_MADCTL  , 1, 0x48,             // Memory Access Control (portrait)
     ILI9341_VSCRSADD, 1, 0x00,             // Vertical scroll zero
     ILI9341_PIXFMT  , 1, 0x55,
     ILI9341_FRMCTR1 , 2, 0x00, 0x18,
@@ -144,7 +235,7 @@ void ili9341_init(void)
     }
 
     if (x & 0x80) {
-      msec_delay(150);
+      msec_sleep(150);
     }
   }
 } /* ili9341_init */
@@ -166,11 +257,11 @@ void ili9341_init(void)
 void ili9341_reset(void)
 {
   GPIOA->DOUTCLR31_0 = RESET_MASK;
-  msec_delay(200);
+  msec_sleep(200);
   GPIOA->DOUTSET31_0 = RESET_MASK;
-  msec_delay(200);
+  msec_sleep(200);
   ili9341_write_command(ILI9341_SWRESET);
-  msec_delay(200);
+  msec_sleep(200);
 } /* ili9341_reset */
 
 
@@ -189,6 +280,9 @@ void ili9341_reset(void)
 //  none
 //------------------------------------------------------------------------------
 void ili9341_write_command(uint8_t cmd) {
+  spi1_wait_async();
+  spi1_set_frame_size(SPI1_FRAME_8BIT);
+  g_cmd_count++;
   GPIOA->DOUT31_0 &= ~DC_MASK;
   spi1_write_data(cmd);
   while (!spi1_xfer_done());
@@ -210,6 +304,8 @@ void ili9341_write_command(uint8_t cmd) {
 //  none
 //------------------------------------------------------------------------------
 void ili9341_write_data8(uint8_t data) {
+  spi1_wait_async();
+  spi1_set_frame_size(SPI1_FRAME_8BIT);
   GPIOA->DOUT31_0 |= DC_MASK;
   spi1_write_data(data);
   while (!spi1_xfer_done());
@@ -231,6 +327,8 @@ void ili9341_write_data8(uint8_t data) {
 //  none
 //------------------------------------------------------------------------------
 void ili9341_write_data16(uint16_t data) {
+  spi1_wait_async();
+  spi1_set_frame_size(SPI1_FRAME_8BIT);
   GPIOA->DOUT31_0 |= DC_MASK;
   spi1_write_data((data >> 8) & 0xFF);
   while (!spi1_xfer_done());
@@ -254,6 +352,8 @@ void ili9341_write_data16(uint16_t data) {
 //  none
 //------------------------------------------------------------------------------
 void ili9341_write_data32(uint32_t data) {
+  spi1_wait_async();
+  spi1_set_frame_size(SPI1_FRAME_8BIT);
   GPIOA->DOUT31_0 |= DC_MASK;
   spi1_write_data((data >> 24) & 0xFF);
   while (!spi1_xfer_done());
@@ -268,8 +368,58 @@ void ili9341_write_data32(uint32_t data) {
 
 //------------------------------------------------------------------------------
 // DESCRIPTION:
-//  This function sends 8-bit data to the ILI9341 LCD display via SPI. The DC
-//  pin is set high to indicate that the data being sent is data.
+//  This function sets the address window of the ILI9341 LCD display to the
+//  given rectangle and starts a memory write. Every pixel sent afterwards
+//  fills the window left to right, top to bottom. The DC pin is left high so
+//  the caller can stream pixel data directly with ili9341_write_pixels.
+//
+// INPUT PARAMETERS:
+//  x - The starting X coordinate of the window
+//  y - The starting Y coordinate of the window
+//  w - The width of the window
+//  h - The height of the window
+//
+// OUTPUT PARAMETERS:
+//  none
+//
+// RETURN:
+//  none
+//------------------------------------------------------------------------------
+void ili9341_set_addr_window(uint16_t x, uint16_t y, uint16_t w, uint16_t h)
+{
+  uint16_t x_end = x + w - 1;
+  uint16_t y_end = y + h - 1;
+
+  // Set column address (X)
+  ili9341_write_command(ILI9341_CASET);
+  GPIOA->DOUT31_0 |= DC_MASK;
+  spi1_write_data(x >> 8);
+  spi1_write_data(x);
+  spi1_write_data(x_end >> 8);
+  spi1_write_data(x_end);
+  while (!spi1_xfer_done());
+
+  // Set page address (Y)
+  ili9341_write_command(ILI9341_PASET);
+  GPIOA->DOUT31_0 |= DC_MASK;
+  spi1_write_data(y >> 8);
+  spi1_write_data(y);
+  spi1_write_data(y_end >> 8);
+  spi1_write_data(y_end);
+  while (!spi1_xfer_done());
+
+  // Write to RAM
+  ili9341_write_command(ILI9341_RAMWR);
+  GPIOA->DOUT31_0 |= DC_MASK;
+} /* ili9341_set_addr_window */
+
+
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//  This function fills a rectangle on the ILI9341 LCD display with the
+//  specified color, as one pixel run through ili9341_write_pixel_run, so no
+//  pattern buffer is needed in SRAM. It returns while the run is still being
+//  sent; the next command sent to the display waits for it to finish.
 //
 // INPUT PARAMETERS:
 //  x - The starting X coordinate of the rectangle
@@ -286,26 +436,12 @@ void ili9341_write_data32(uint32_t data) {
 //------------------------------------------------------------------------------
 void ili9341_fill_rect(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t color)
 {
-  // Set column address (X)
-  ili9341_write_command(0x2A);
-  ili9341_write_data16(x);
-  ili9341_write_data16(x + w - 1);
+  uint32_t pixel_count = (uint32_t)w * h;
 
-  // Set page address (Y)
-  ili9341_write_command(0x2B);
-  ili9341_write_data16(y);
-  ili9341_write_data16(y + h - 1);
+  if (pixel_count == 0) return;
 
-  // Write to RAM
-  ili9341_write_command(0x2C);
-
-  GPIOA->DOUT31_0 |= DC_MASK;
-  // Fill rectangle with color
-  for (uint32_t i = 0; i < (w * h); i++) {
-    spi1_write_data(color >> 8);
-    spi1_write_data(color);
-    while (!spi1_xfer_done());
-  } /* for */
+  ili9341_set_addr_window(x, y, w, h);
+  ili9341_write_pixel_run(color, pixel_count);
 } /* ili9341_fill_rect */
 
 
@@ -327,6 +463,130 @@ void ili9341_fill_screen(uint16_t color) {
 } /* ili9341_fill_screen */
 
 
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//  This function streams RGB565 pixels into the address window opened by
+//  ili9341_set_addr_window. SPI1 is switched to 16-bit frames, so each pixel
+//  is one FIFO push, and it stays in 16-bit frames until the next command,
+//  so back to back calls continue the same burst without draining the bus.
+//
+// INPUT PARAMETERS:
+//  pixels - The RGB565 pixels to send
+//  count  - The number of pixels
+//
+// OUTPUT PARAMETERS:
+//  none
+//
+// RETURN:
+//  none
+//------------------------------------------------------------------------------
+void ili9341_write_pixels(const uint16_t *pixels, uint32_t count)
+{
+  spi1_set_frame_size(SPI1_FRAME_16BIT);
+
+  while (count-- > 0)
+  {
+    spi1_write_data16(*pixels++);
+  } /* while */
+} /* ili9341_write_pixels */
+
+
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//  This function streams RGB565 pixels into the open address window using
+//  the SPI1 DMA engine and returns while they are still being sent. The
+//  pixels must stay unchanged until the next command sent to the display,
+//  which waits for the transfer to finish.
+//
+// INPUT PARAMETERS:
+//  pixels - The RGB565 pixels to send
+//  count  - The number of pixels (1 to 65535)
+//
+// OUTPUT PARAMETERS:
+//  none
+//
+// RETURN:
+//  none
+//------------------------------------------------------------------------------
+void ili9341_write_pixels_async(const uint16_t *pixels, uint16_t count)
+{
+  spi1_set_frame_size(SPI1_FRAME_16BIT);
+  spi1_write_buffer16_async(pixels, count, NULL);
+} /* ili9341_write_pixels_async */
+
+
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//  This function streams count pixels of one color into the open address
+//  window and returns while they are still being sent. The SPI repeat
+//  transmit hardware replicates the color and the SPI1 ISR reloads it, so
+//  the CPU only writes a few registers per run and is free in between.
+//
+// INPUT PARAMETERS:
+//  color - The RGB565 color to send
+//  count - The number of pixels
+//
+// OUTPUT PARAMETERS:
+//  none
+//
+// RETURN:
+//  none
+//------------------------------------------------------------------------------
+void ili9341_write_pixel_run(uint16_t color, uint32_t count)
+{
+  spi1_wait_async();
+  spi1_set_frame_size(SPI1_FRAME_16BIT);
+  spi1_write_repeat16_async(color, count, NULL);
+} /* ili9341_write_pixel_run */
+
+
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//  This function defines the vertical scrolling area of the ILI9341 LCD
+//  display. The top and bottom fixed areas never move and the lines between
+//  them scroll as a ring when ili9341_scroll_to is called.
+//
+// INPUT PARAMETERS:
+//  top_fixed    - Number of lines in the fixed area at the top
+//  bottom_fixed - Number of lines in the fixed area at the bottom
+//
+// OUTPUT PARAMETERS:
+//  none
+//
+// RETURN:
+//  none
+//------------------------------------------------------------------------------
+void ili9341_define_scroll_area(uint16_t top_fixed, uint16_t bottom_fixed)
+{
+  ili9341_write_command(ILI9341_VSCRDEF);
+  ili9341_write_data16(top_fixed);
+  ili9341_write_data16(ILI9341_TFTHEIGHT - top_fixed - bottom_fixed);
+  ili9341_write_data16(bottom_fixed);
+} /* ili9341_define_scroll_area */
+
+
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//  This function sets which memory line is shown at the top of the vertical
+//  scrolling area. Only the start address changes; no pixels are rewritten.
+//
+// INPUT PARAMETERS:
+//  line - The memory line to show first, counted from the top of the panel
+//         and inside the area set by ili9341_define_scroll_area
+//
+// OUTPUT PARAMETERS:
+//  none
+//
+// RETURN:
+//  none
+//------------------------------------------------------------------------------
+void ili9341_scroll_to(uint16_t line)
+{
+  ili9341_write_command(ILI9341_VSCRSADD);
+  ili9341_write_data16(line);
+} /* ili9341_scroll_to */
+
+
 //------------------------------------------------------------------------------
 // DESCRIPTION:
 //  This function draws a single pixel on the ILI9341 LCD display at the 
@@ -344,22 +604,7 @@ void ili9341_fill_screen(uint16_t color) {
 //  none
 //------------------------------------------------------------------------------
 void ili9341_draw_pixel(uint16_t x, uint16_t y, uint16_t color) {
-  // Set column address (X)
-  ili9341_write_command(0x2A);
-  ili9341_write_data8(x >> 8);
-  ili9341_write_data8(x & 0xFF);
-  ili9341_write_data8(x >> 8);
-  ili9341_write_data8(x & 0xFF);
-
-  // Set page address (Y)
-  ili9341_write_command(0x2B);
-  ili9341_write_data8(y >> 8);
-  ili9341_write_data8(y & 0xFF);
-  ili9341_write_data8(y >> 8);
-  ili9341_write_data8(y & 0xFF);
-
-  // Write to RAM
-  ili9341_write_command(0x2C);
+  ili9341_set_addr_window(x, y, 1, 1);
 
   // Write pixel color
   ili9341_write_data16(color);
@@ -369,8 +614,9 @@ void ili9341_draw_pixel(uint16_t x, uint16_t y, uint16_t color) {
 //------------------------------------------------------------------------------
 // DESCRIPTION:
 //  This function draws a character on the ILI9341 LCD display at the specified
-//  coordinates using the JetBrains Mono font. The character is drawn using the
-//  draw_pixel function.
+//  coordinates using the JetBrains Mono font. A single address window the size
+//  of the glyph box is opened and the whole glyph, foreground and background,
+//  is streamed as one RAMWR burst in the current text colors.
 //
 // INPUT PARAMETERS:
 //  c - The character to draw
@@ -389,24 +635,130 @@ void ili9341_draw_char(char c, uint16_t x, uint16_t y)
 
   const glyph_dsc_t *glyph = &font_dsc.glyph_dsc[c - 32 + 1];
   const uint8_t *bitmap = &font_dsc.glyph_bitmap[glyph->bitmap_index];
+  uint16_t pixel_count = glyph->box_w * glyph->box_h;
+
+  if (pixel_count == 0) return; // Nothing to draw (e.g. space)
 
   int16_t top_y = y - (glyph->box_h + glyph->ofs_y);
 
-  for (uint8_t row = 0; row < glyph->box_h; row++)
+  ili9341_set_addr_window(x + glyph->ofs_x, top_y, glyph->box_w,
+                          glyph->box_h);
+
+  // The bitmap is packed MSB first with rows back to back, which is the same
+  // order the window is filled in, so it can be walked bit by bit and sent
+  // a buffer of pixels at a time
+  uint16_t pixels[GLYPH_WIDTH];
+  uint8_t bits = 0;
+  uint8_t bit_mask = 0;
+  uint8_t count = 0;
+  for (uint16_t i = 0; i < pixel_count; i++)
+  {
+    if (bit_mask == 0)
+    {
+      bits = *bitmap++;
+      bit_mask = 0x80;
+    } /* if */
+
+    pixels[count++] = (bits & bit_mask) ? g_text_fg_color : g_text_bg_color;
+    bit_mask >>= 1;
+
+    if (count == GLYPH_WIDTH || i == pixel_count - 1)
+    {
+      ili9341_write_pixels(pixels, count);
+      count = 0;
+    } /* if */
+  } /* for */
+} /* ili9341_draw_char */
+
+
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//  This function draws a run of fixed-width character cells on the ILI9341 LCD
+//  display in the current text colors. Unlike ili9341_draw_char it paints the
+//  whole cell, so the background around the glyph is redrawn too and nothing
+//  has to be erased first. The run is sent through one address window, one
+//  pixel row across all the cells at a time. Rows of cells found in the glyph
+//  cache are expanded from their masks; the rest are decoded from the font
+//  bitmap.
+//
+// INPUT PARAMETERS:
+//  text     - The characters to draw, one per cell (not null terminated)
+//  count    - The number of cells, at most ILI9341_MAX_TEXT_CELLS
+//  x        - The X coordinate of the left edge of the first cell
+//  y        - The Y coordinate of the top edge of the cells
+//  cell_h   - The height of a cell in pixels
+//  baseline - The distance from the top of a cell to the glyph baseline
+//
+// OUTPUT PARAMETERS:
+//  none
+//
+// RETURN:
+//  none
+//------------------------------------------------------------------------------
+void ili9341_draw_text_cells(const char *text, uint8_t count, uint16_t x,
+                             uint16_t y, uint16_t cell_h, uint16_t baseline)
+{
+  glyph_cell_struct cells[ILI9341_MAX_TEXT_CELLS];
+  const glyph_dsc_t *glyph;
+  uint16_t line[GLYPH_WIDTH];
+  uint16_t mask;
+  uint16_t row;
+  uint8_t i;
+  uint8_t col;
+
+  if (count > ILI9341_MAX_TEXT_CELLS)
   {
-    for (uint8_t col = 0; col < glyph->box_w; col++)
+    count = ILI9341_MAX_TEXT_CELLS;
+  } /* if */
+  if (count == 0 || cell_h == 0) return;
+
+#if ILI9341_GLYPH_CACHE_ENTRIES > 0
+  g_glyph_cache_clock++;
+#endif
+
+  // Unsupported characters are drawn as blank cells
+  for (i = 0; i < count; i++)
+  {
+    cells[i].glyph_index = 0;
+    if (text[i] >= 32 && text[i] <= 126)
     {
-      uint8_t byte_index = (col + row * glyph->box_w) / 8;
-      uint8_t bit_index = 7 - ((col + row * glyph->box_w) % 8);
-      bool pixel_on = (bitmap[byte_index] >> bit_index) & 0x01;
+      cells[i].glyph_index = text[i] - 32 + 1;
+    } /* if */
+    glyph = &font_dsc.glyph_dsc[cells[i].glyph_index];
+    cells[i].bitmap = &font_dsc.glyph_bitmap[glyph->bitmap_index];
+    cells[i].top = baseline - (glyph->box_h + glyph->ofs_y);
+    cells[i].left = glyph->ofs_x;
+    cells[i].box_w = glyph->box_w;
+    cells[i].box_h = glyph->box_h;
+    cells[i].rows = ili9341_glyph_cache_get(&cells[i], cell_h, baseline);
+  } /* for */
 
-      if (pixel_on)
+  ili9341_set_addr_window(x, y, count * GLYPH_WIDTH, cell_h);
+
+  for (row = 0; row < cell_h; row++)
+  {
+    for (i = 0; i < count; i++)
+    {
+      if (cells[i].rows != NULL)
       {
-        ili9341_draw_pixel(x + glyph->ofs_x + col, top_y + row, ILI9341_BLACK);
+        mask = cells[i].rows[row];
+        for (col = 0; col < GLYPH_WIDTH; col++)
+        {
+          line[col] = (mask & 0x8000) ? g_text_fg_color : g_text_bg_color;
+          mask <<= 1;
+        } /* for */
       } /* if */
+      else
+      {
+        for (col = 0; col < GLYPH_WIDTH; col++)
+        {
+          line[col] = ili9341_cell_pixel(&cells[i], row, col);
+        } /* for */
+      } /* else */
+      ili9341_write_pixels(line, GLYPH_WIDTH);
     } /* for */
   } /* for */
-} /* ili9341_draw_char */
+} /* ili9341_draw_text_cells */
 
 
 //------------------------------------------------------------------------------
@@ -513,3 +865,532 @@ void get_cursor_position(uint16_t* x, uint16_t* y)
   *x = g_cursor_pos.x;
   *y = g_cursor_pos.y;
 } /* get_cursor_position */
+
+
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//  This function sets the foreground and background colors used when drawing
+//  characters. The background color fills the unlit pixels of the glyph box.
+//
+// INPUT PARAMETERS:
+//  fg_color - The color of the character pixels
+//  bg_color - The color behind the character pixels
+//
+// OUTPUT PARAMETERS:
+//  none
+//
+// RETURN:
+//  none
+//------------------------------------------------------------------------------
+void ili9341_set_text_color(uint16_t fg_color, uint16_t bg_color)
+{
+  g_text_fg_color = fg_color;
+  g_text_bg_color = bg_color;
+} /* ili9341_set_text_color */
+
+
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//  This function returns the number of commands sent to the ILI9341 since
+//  startup or the last call to ili9341_clear_cmd_count(). Each command marks
+//  a DC transition, so this is the number of command/data round trips.
+//
+// INPUT PARAMETERS:
+//  none
+//
+// OUTPUT PARAMETERS:
+//  none
+//
+// RETURN:
+//  The number of commands sent
+//------------------------------------------------------------------------------
+uint32_t ili9341_get_cmd_count(void)
+{
+  return g_cmd_count;
+} /* ili9341_get_cmd_count */
+
+
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//  This function resets the ILI9341 command count to zero.
+//
+// INPUT PARAMETERS:
+//  none
+//
+// OUTPUT PARAMETERS:
+//  none
+//
+// RETURN:
+//  none
+//------------------------------------------------------------------------------
+void ili9341_clear_cmd_count(void)
+{
+  g_cmd_count = 0;
+} /* ili9341_clear_cmd_count */
+
+
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//  This function copies the glyph cache activity counted since startup or the
+//  last call to ili9341_clear_glyph_cache_stats().
+//
+// INPUT PARAMETERS:
+//  none
+//
+// OUTPUT PARAMETERS:
+//  stats - the glyph cache hits, misses and evictions
+//
+// RETURN:
+//  none
+//------------------------------------------------------------------------------
+void ili9341_get_glyph_cache_stats(glyph_cache_stats_struct *stats)
+{
+  *stats = g_glyph_cache_stats;
+} /* ili9341_get_glyph_cache_stats */
+
+
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//  This function resets the glyph cache activity counters to zero. The cached
+//  cells themselves are kept.
+//
+// INPUT PARAMETERS:
+//  none
+//
+// OUTPUT PARAMETERS:
+//  none
+//
+// RETURN:
+//  none
+//------------------------------------------------------------------------------
+void ili9341_clear_glyph_cache_stats(void)
+{
+  g_glyph_cache_stats.hits = 0;
+  g_glyph_cache_stats.misses = 0;
+  g_glyph_cache_stats.evictions = 0;
+} /* ili9341_clear_glyph_cache_stats */
+
+
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//  This function starts composing a region of the ILI9341 LCD display in the
+//  band renderer. Draw operations queued with ili9341_strip_fill_rect and
+//  ili9341_strip_draw_text are clipped to the region and are not sent until
+//  ili9341_strip_end is called. Pixels no operation covers are painted in the
+//  background color. The region is clipped to the panel.
+//
+// INPUT PARAMETERS:
+//  x        - The X coordinate of the left edge of the region
+//  y        - The Y coordinate of the top edge of the region
+//  w        - The width of the region
+//  h        - The height of the region
+//  bg_color - The color of pixels no operation covers
+//
+// OUTPUT PARAMETERS:
+//  none
+//
+// RETURN:
+//  none
+//------------------------------------------------------------------------------
+void ili9341_strip_begin(uint16_t x, uint16_t y, uint16_t w, uint16_t h,
+                         uint16_t bg_color)
+{
+  if (x >= ILI9341_TFTWIDTH || y >= ILI9341_TFTHEIGHT)
+  {
+    w = 0;
+    h = 0;
+  } /* if */
+  if (w > ILI9341_TFTWIDTH - x)
+  {
+    w = ILI9341_TFTWIDTH - x;
+  } /* if */
+  if (h > ILI9341_TFTHEIGHT - y)
+  {
+    h = ILI9341_TFTHEIGHT - y;
+  } /* if */
+
+  g_strip.x = x;
+  g_strip.y = y;
+  g_strip.w = w;
+  g_strip.h = h;
+  g_strip.bg_color = bg_color;
+  g_strip.op_count = 0;
+} /* ili9341_strip_begin */
+
+
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//  This function queues a solid rectangle in the region being composed. Later
+//  operations are drawn on top of earlier ones.
+//
+// INPUT PARAMETERS:
+//  x     - The X coordinate of the left edge of the rectangle
+//  y     - The Y coordinate of the top edge of the rectangle
+//  w     - The width of the rectangle
+//  h     - The height of the rectangle
+//  color - The color to fill the rectangle with
+//
+// OUTPUT PARAMETERS:
+//  none
+//
+// RETURN:
+//  true  - if the operation was queued
+//  false - if ILI9341_STRIP_MAX_OPS operations are already queued
+//------------------------------------------------------------------------------
+bool ili9341_strip_fill_rect(int16_t x, int16_t y, uint16_t w, uint16_t h,
+                             uint16_t color)
+{
+  strip_op_struct *op;
+
+  if (g_strip.op_count >= ILI9341_STRIP_MAX_OPS) return false;
+
+  op = &g_strip.ops[g_strip.op_count++];
+  op->type = STRIP_OP_FILL;
+  op->text = NULL;
+  op->x = x;
+  op->y = y;
+  op->w = w;
+  op->h = h;
+  op->color = color;
+
+  return true;
+} /* ili9341_strip_fill_rect */
+
+
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//  This function queues a line of text in the region being composed. Only
+//  the glyph pixels are drawn, so the text shows over whatever earlier
+//  operations put underneath it. Characters are placed GLYPH_WIDTH apart and
+//  unsupported characters leave a gap.
+//
+// INPUT PARAMETERS:
+//  text  - The null terminated text. It is read when the region is sent, so
+//          it must stay unchanged until ili9341_strip_end returns.
+//  x     - The X coordinate of the left edge of the first character cell
+//  y     - The Y coordinate of the text baseline
+//  color - The color of the text
+//
+// OUTPUT PARAMETERS:
+//  none
+//
+// RETURN:
+//  true  - if the operation was queued
+//  false - if ILI9341_STRIP_MAX_OPS operations are already queued
+//------------------------------------------------------------------------------
+bool ili9341_strip_draw_text(const char *text, int16_t x, int16_t y,
+                             uint16_t color)
+{
+  strip_op_struct *op;
+
+  if (g_strip.op_count >= ILI9341_STRIP_MAX_OPS) return false;
+
+  op = &g_strip.ops[g_strip.op_count++];
+  op->type = STRIP_OP_TEXT;
+  op->text = text;
+  op->x = x;
+  op->y = y;
+  op->w = strlen(text) * GLYPH_WIDTH;
+  op->h = 0;
+  op->color = color;
+
+  return true;
+} /* ili9341_strip_draw_text */
+
+
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//  This function sends the region being composed to the ILI9341 LCD display.
+//  One address window covers the whole region. The queued operations are
+//  drawn into one half of the strip buffer a band of lines at a time, and
+//  each finished band is handed to the SPI1 DMA engine while the next band is
+//  drawn into the other half. Every pixel of the region crosses SPI exactly
+//  once. The function returns while the last band is still being sent; the
+//  next command sent to the display waits for it. The queued operations are
+//  discarded.
+//
+// INPUT PARAMETERS:
+//  none
+//
+// OUTPUT PARAMETERS:
+//  none
+//
+// RETURN:
+//  none
+//------------------------------------------------------------------------------
+void ili9341_strip_end(void)
+{
+  uint16_t band_lines;
+  uint16_t band_y = 0;
+  uint16_t lines;
+  uint8_t half = 0;
+
+  if (g_strip.w == 0 || g_strip.h == 0)
+  {
+    g_strip.op_count = 0;
+    return;
+  } /* if */
+
+  // Narrow regions get more lines per band
+  band_lines = ILI9341_STRIP_HALF_PIXELS / g_strip.w;
+
+  // Setting the window also waits for any earlier band still being sent
+  ili9341_set_addr_window(g_strip.x, g_strip.y, g_strip.w, g_strip.h);
+
+  while (band_y < g_strip.h)
+  {
+    lines = g_strip.h - band_y;
+    if (lines > band_lines)
+    {
+      lines = band_lines;
+    } /* if */
+
+    ili9341_strip_render_band(g_strip_buffer[half], band_y, lines);
+
+    // The other half may still be going out
+    while (spi1_async_busy());
+    ili9341_write_pixels_async(g_strip_buffer[half], lines * g_strip.w);
+
+    band_y += lines;
+    half ^= 1;
+  } /* while */
+
+  g_strip.op_count = 0;
+} /* ili9341_strip_end */
+
+
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//  This function returns the color of one pixel of a text cell in the current
+//  text colors, decoding it from the 1-bpp font bitmap.
+//
+// INPUT PARAMETERS:
+//  cell - The glyph placement inside the cell
+//  row  - The pixel row inside the cell
+//  col  - The pixel column inside the cell
+//
+// OUTPUT PARAMETERS:
+//  none
+//
+// RETURN:
+//  The RGB565 color of the pixel
+//------------------------------------------------------------------------------
+static uint16_t ili9341_cell_pixel(const glyph_cell_struct *cell, uint16_t row,
+                                   uint8_t col)
+{
+  int16_t glyph_row = row - cell->top;
+  int16_t glyph_col = col - cell->left;
+  uint16_t bit_pos;
+
+  if (glyph_row >= 0 && glyph_row < cell->box_h &&
+      glyph_col >= 0 && glyph_col < cell->box_w)
+  {
+    bit_pos = glyph_row * cell->box_w + glyph_col;
+    if (cell->bitmap[bit_pos >> 3] & (0x80 >> (bit_pos & 7)))
+    {
+      return g_text_fg_color;
+    } /* if */
+  } /* if */
+
+  return g_text_bg_color;
+} /* ili9341_cell_pixel */
+
+
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//  This function looks a text cell up in the glyph cache. On a miss the least
+//  recently used entry is replaced by the cell's row masks, decoded from the
+//  font bitmap. Entries already used by the run being drawn are never
+//  evicted; if every entry is in use the cell is not cached.
+//
+// INPUT PARAMETERS:
+//  cell     - The glyph placement inside the cell
+//  cell_h   - The height of the cell in pixels
+//  baseline - The distance from the top of the cell to the glyph baseline
+//
+// OUTPUT PARAMETERS:
+//  none
+//
+// RETURN:
+//  The cell's row masks, top row first, or NULL if not cached
+//------------------------------------------------------------------------------
+static const uint16_t *ili9341_glyph_cache_get(const glyph_cell_struct *cell,
+                                               uint16_t cell_h,
+                                               uint16_t baseline)
+{
+#if ILI9341_GLYPH_CACHE_ENTRIES > 0
+  glyph_cache_entry_struct *entry;
+  glyph_cache_entry_struct *victim = NULL;
+  int16_t glyph_row;
+  uint16_t bit_pos;
+  uint16_t mask;
+  uint16_t row;
+  uint8_t col;
+  uint8_t i;
+
+  if (cell_h > ILI9341_GLYPH_CACHE_MAX_CELL_H || baseline > UINT8_MAX)
+  {
+    return NULL;
+  } /* if */
+
+  for (i = 0; i < ILI9341_GLYPH_CACHE_ENTRIES; i++)
+  {
+    entry = &g_glyph_cache[i];
+    if (entry->last_used != 0 && entry->glyph_index == cell->glyph_index &&
+        entry->cell_h == cell_h && entry->baseline == baseline)
+    {
+      entry->last_used = g_glyph_cache_clock;
+      g_glyph_cache_stats.hits++;
+      return entry->rows;
+    } /* if */
+
+    if (entry->last_used != g_glyph_cache_clock &&
+        (victim == NULL || entry->last_used < victim->last_used))
+    {
+      victim = entry;
+    } /* if */
+  } /* for */
+
+  g_glyph_cache_stats.misses++;
+  if (victim == NULL)
+  {
+    return NULL;
+  } /* if */
+  if (victim->last_used != 0)
+  {
+    g_glyph_cache_stats.evictions++;
+  } /* if */
+
+  victim->last_used = g_glyph_cache_clock;
+  victim->glyph_index = cell->glyph_index;
+  victim->cell_h = cell_h;
+  victim->baseline = baseline;
+
+  for (row = 0; row < cell_h; row++)
+  {
+    mask = 0;
+    glyph_row = row - cell->top;
+    if (glyph_row >= 0 && glyph_row < cell->box_h)
+    {
+      bit_pos = glyph_row * cell->box_w;
+      for (col = 0; col < cell->box_w; col++, bit_pos++)
+      {
+        // Pixels outside the cell are clipped, as ili9341_cell_pixel does
+        if (cell->left + col >= 0 && cell->left + col < GLYPH_WIDTH &&
+            (cell->bitmap[bit_pos >> 3] & (0x80 >> (bit_pos & 7))))
+        {
+          mask |= 0x8000 >> (cell->left + col);
+        } /* if */
+      } /* for */
+    } /* if */
+    victim->rows[row] = mask;
+  } /* for */
+
+  return victim->rows;
+#else
+  g_glyph_cache_stats.misses++;
+  return NULL;
+#endif
+} /* ili9341_glyph_cache_get */
+
+
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//  This function draws one band of the region being composed into a strip
+//  buffer half: the background first, then every queued operation in order,
+//  each clipped to the band and to the region.
+//
+// INPUT PARAMETERS:
+//  band   - The strip buffer half to draw into
+//  band_y - The first line of the band, relative to the top of the region
+//  lines  - The number of lines in the band
+//
+// OUTPUT PARAMETERS:
+//  none
+//
+// RETURN:
+//  none
+//------------------------------------------------------------------------------
+static void ili9341_strip_render_band(uint16_t *band, uint16_t band_y,
+                                      uint16_t lines)
+{
+  const strip_op_struct *op;
+  const glyph_dsc_t *glyph;
+  const uint8_t *bitmap;
+  int16_t top = g_strip.y + band_y;
+  int16_t bottom = top + lines;
+  int16_t left = g_strip.x;
+  int16_t right = left + g_strip.w;
+  int16_t x0;
+  int16_t x1;
+  int16_t y0;
+  int16_t y1;
+  int16_t gx;
+  int16_t gy;
+  uint16_t bit_pos;
+  uint16_t i;
+  uint16_t *pixel;
+  uint8_t op_idx;
+  const char *c;
+  int16_t row;
+  int16_t col;
+
+  pixel = band;
+  for (i = 0; i < lines * g_strip.w; i++)
+  {
+    *pixel++ = g_strip.bg_color;
+  } /* for */
+
+  for (op_idx = 0; op_idx < g_strip.op_count; op_idx++)
+  {
+    op = &g_strip.ops[op_idx];
+
+    if (op->type == STRIP_OP_FILL)
+    {
+      x0 = (op->x > left) ? op->x : left;
+      x1 = (op->x + op->w < right) ? op->x + op->w : right;
+      y0 = (op->y > top) ? op->y : top;
+      y1 = (op->y + op->h < bottom) ? op->y + op->h : bottom;
+
+      for (row = y0; row < y1; row++)
+      {
+        pixel = band + (row - top) * g_strip.w + (x0 - left);
+        for (col = x0; col < x1; col++)
+        {
+          *pixel++ = op->color;
+        } /* for */
+      } /* for */
+    } /* if */
+    else
+    {
+      if (op->x >= right || op->x + (int16_t)op->w <= left) continue;
+
+      gx = op->x;
+      for (c = op->text; *c != '\0'; c++, gx += GLYPH_WIDTH)
+      {
+        if (*c < 32 || *c > 126) continue;
+
+        glyph = &font_dsc.glyph_dsc[*c - 32 + 1];
+        bitmap = &font_dsc.glyph_bitmap[glyph->bitmap_index];
+        gy = op->y - (glyph->box_h + glyph->ofs_y);
+
+        y0 = (gy > top) ? gy : top;
+        y1 = (gy + glyph->box_h < bottom) ? gy + glyph->box_h : bottom;
+        for (row = y0; row < y1; row++)
+        {
+          for (col = 0; col < glyph->box_w; col++)
+          {
+            x0 = gx + glyph->ofs_x + col;
+            if (x0 < left || x0 >= right) continue;
+
+            bit_pos = (row - gy) * glyph->box_w + col;
+            if (bitmap[bit_pos >> 3] & (0x80 >> (bit_pos & 7)))
+            {
+              band[(row - top) * g_strip.w + (x0 - left)] = op->color;
+            } /* if */
+          } /* for */
+        } /* for */
+      } /* for */
+    } /* else */
+  } /* for */
+} /* ili9341_strip_render_band */
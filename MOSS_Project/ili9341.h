@@ -38,6 +38,7 @@
 // Loads standard C include files
 //-----------------------------------------------------------------------------
 #include <stdint.h>
+#include <stdbool.h>
 
 
 //-----------------------------------------------------------------------------
@@ -54,10 +55,36 @@
 
 #define GLYPH_WIDTH                                                         (14)
 
+// Most character cells that fit across the panel in one text run
+#define ILI9341_MAX_TEXT_CELLS                  (ILI9341_TFTWIDTH / GLYPH_WIDTH)
+
+// SRAM budget in bytes for cached text cells (0 disables the cache). A cell
+// is kept as one 1-bit mask per pixel row, so an entry does not depend on the
+// text colors; it costs 2 bytes a row plus 8 for its key and LRU stamp.
+// Cells taller than the max height are always drawn from the bitmap; the max
+// is the console line height, the only cell height drawn. At 2 KB, 85% of the
+// lookups in test_glyph_cache's shell session hit.
+#define ILI9341_GLYPH_CACHE_SIZE                                          (2048)
+#define ILI9341_GLYPH_CACHE_MAX_CELL_H                                      (28)
+#define ILI9341_GLYPH_CACHE_ENTRY_SIZE                                         \
+                                       (ILI9341_GLYPH_CACHE_MAX_CELL_H * 2 + 8)
+#define ILI9341_GLYPH_CACHE_ENTRIES                                            \
+                   (ILI9341_GLYPH_CACHE_SIZE / ILI9341_GLYPH_CACHE_ENTRY_SIZE)
+
+// The band renderer composes a region into a strip of ILI9341_STRIP_LINES
+// full-width lines (two halves that ping-pong with DMA) before sending it,
+// so the strip costs ILI9341_TFTWIDTH * ILI9341_STRIP_LINES * 2 bytes SRAM
+#define ILI9341_STRIP_LINES                                                 (16)
+#define ILI9341_STRIP_HALF_PIXELS                                              \
+                               (ILI9341_TFTWIDTH * (ILI9341_STRIP_LINES / 2))
+#define ILI9341_STRIP_MAX_OPS                                               (24)
+
 
 // https://github.com/adafruit/Adafruit_ILI9341
-#define ILI9341_TFTWIDTH 320  ///< ILI9341 max TFT width
-#define ILI9341_TFTHEIGHT 240 ///< ILI9341 max TFT height
+// The panel runs in portrait so the vertical scroll registers, which always
+// act along the 320 line gate axis, scroll the text console up the screen
+#define ILI9341_TFTWIDTH 240  ///< ILI9341 max TFT width
+#define ILI9341_TFTHEIGHT 320 ///< ILI9341 max TFT height
 
 #define ILI9341_NOP 0x00     ///< No-op register
 #define ILI9341_SWRESET 0x01 ///< Software reset register
@@ -117,6 +144,14 @@
 #define ILI9341_GMCTRN1 0xE1 ///< Negative Gamma Correction
 // #define ILI9341_PWCTR6     0xFC
 
+// Glyph cache activity, used to size the cache
+typedef struct
+{
+  uint32_t hits;
+  uint32_t misses;
+  uint32_t evictions;
+} glyph_cache_stats_struct;
+
 // Color definitions
 #define ILI9341_BLACK 0x0000       ///<   0,   0,   0
 #define ILI9341_NAVY 0x000F        ///<   0,   0, 123
@@ -148,13 +183,33 @@ void ili9341_write_command(uint8_t cmd);
 void ili9341_write_data8(uint8_t data);
 void ili9341_write_data16(uint16_t data);
 void ili9341_write_data32(uint32_t data);
+void ili9341_set_addr_window(uint16_t x, uint16_t y, uint16_t w, uint16_t h);
 void ili9341_fill_rect(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t color);
 void ili9341_fill_screen(uint16_t color);
+void ili9341_write_pixels(const uint16_t *pixels, uint32_t count);
+void ili9341_write_pixels_async(const uint16_t *pixels, uint16_t count);
+void ili9341_write_pixel_run(uint16_t color, uint32_t count);
+void ili9341_define_scroll_area(uint16_t top_fixed, uint16_t bottom_fixed);
+void ili9341_scroll_to(uint16_t line);
 void ili9341_draw_pixel(uint16_t x, uint16_t y, uint16_t color);
 void ili9341_draw_char(char c, uint16_t x, uint16_t y);
+void ili9341_draw_text_cells(const char *text, uint8_t count, uint16_t x,
+                             uint16_t y, uint16_t cell_h, uint16_t baseline);
 void ili9341_erase_char(char c, uint16_t color);
 void ili9341_draw_char_at_cursor(char c);
 void set_cursor_position(uint16_t x, uint16_t y);
 void get_cursor_position(uint16_t* x, uint16_t* y);
+void ili9341_set_text_color(uint16_t fg_color, uint16_t bg_color);
+uint32_t ili9341_get_cmd_count(void);
+void ili9341_clear_cmd_count(void);
+void ili9341_get_glyph_cache_stats(glyph_cache_stats_struct *stats);
+void ili9341_clear_glyph_cache_stats(void);
+void ili9341_strip_begin(uint16_t x, uint16_t y, uint16_t w, uint16_t h,
+                         uint16_t bg_color);
+bool ili9341_strip_fill_rect(int16_t x, int16_t y, uint16_t w, uint16_t h,
+                             uint16_t color);
+bool ili9341_strip_draw_text(const char *text, int16_t x, int16_t y,
+                             uint16_t color);
+void ili9341_strip_end(void);
 
 #endif /* __ILI9341_H__ */
\ No newline at end of file
@@ -44,15 +44,18 @@
 #include <ti/devices/msp/msp.h>
 #include "isr.h"
 #include "LaunchPad.h"
-#include "lcd1602.h"
+#include "clock.h"
 #include "adc.h"
+#include "kernel.h"
+#include "spi.h"
+#include "uart.h"
 
 
 //------------------------------------------------------------------------------
 // DESCRIPTION:
 //  This function represents the ISR (Interrupt Service Routine) for the SysTick
 //  timer. It is called at regular intervals based on the configured SysTick
-//  period.
+//  period. It drives the kernel scheduler tick.
 //
 // INPUT PARAMETERS:
 //  none
@@ -65,26 +68,58 @@
 //------------------------------------------------------------------------------
 void SysTick_Handler(void)
 {
-  static bool on = false;
-  
-  if (!on)
-  {
-    lp_leds_on(LP_RED_LED1_IDX);
-  } /* if */
-  else
-  {
-    lp_leds_off(LP_RED_LED1_IDX);
-  } /* else */
-
-  on = !on;
+  kernel_tick();
 } /* SysTick_Handler */
 
 
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//  This function represents the ISR (Interrupt Service Routine) for TIMG0,
+//  the sleep timer. Its compare only exists to wake the core from WFI, and
+//  the code that slept checks the time itself, so the handler just clears
+//  the interrupt.
+//
+// INPUT PARAMETERS:
+//  none
+//
+// OUTPUT PARAMETERS:
+//  none
+//
+// RETURN:
+//  none
+//------------------------------------------------------------------------------
+void TIMG0_IRQHandler(void)
+{
+  TIMG0->CPU_INT.ICLR = GPTIMER_CPU_INT_ICLR_CCU0_CLR;
+} /* TIMG0_IRQHandler */
+
+
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//  This function represents the ISR (Interrupt Service Routine) for TIMG12,
+//  the time base. It runs when the 32-bit counter wraps and counts the wrap
+//  in the upper half of the time.
+//
+// INPUT PARAMETERS:
+//  none
+//
+// OUTPUT PARAMETERS:
+//  none
+//
+// RETURN:
+//  none
+//------------------------------------------------------------------------------
+void TIMG12_IRQHandler(void)
+{
+  time_base_wrap();
+} /* TIMG12_IRQHandler */
+
+
 //------------------------------------------------------------------------------
 // DESCRIPTION:
 //  This function represents the ISR (Interrupt Service Routine) for the RTC.
-//  Every second the LCD time display updates and every 10 seconds the LCD
-//  temperature display updates.
+//  Every second it signals KERNEL_EVENT_RTC_SECOND so the LCD task can update
+//  the time and temperature display outside of interrupt context.
 //
 // INPUT PARAMETERS:
 //  none
@@ -102,19 +137,128 @@ void RTC_IRQHandler(void)
   {
     case RTC_CPU_INT_IIDX_STAT_RTCRDY:
       RTC->CPU_INT.ICLR = RTC_CPU_INT_ICLR_RTCRDY_CLR;
-      if (RTC->SEC % 10 == 0)
-      {
-        uint16_t adc_temp_result = ADC0_in(TEMP_SENSOR_CHANNEL);
-        uint8_t temperature_c = thermistor_calc_temperature(adc_temp_result);
-        uint8_t temperature_f = CONVERT_TO_FAHRENHEIT(temperature_c);
-
-        lcd_set_ddram_addr(LCD_LINE1_ADDR + LCD_CHAR_POSITION_12);
-        lcd_write_temp(temperature_f);
-      } /* if */
-      lcd_set_ddram_addr(LCD_LINE1_ADDR);
-      lcd_write_time(RTC->HOUR, RTC->MIN, RTC->SEC);
+      kernel_signal_event(KERNEL_EVENT_RTC_SECOND);
       break;
     default:
       break;
   } /* switch */
-} /* RTC_IRQHandler */
\ No newline at end of file
+} /* RTC_IRQHandler */
+
+
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//  This function represents the ISR (Interrupt Service Routine) for the DMA.
+//  All DMA channels share this interrupt, so it hands each finished channel
+//  to the driver that owns it.
+//
+// INPUT PARAMETERS:
+//  none
+//
+// OUTPUT PARAMETERS:
+//  none
+//
+// RETURN:
+//  none
+//------------------------------------------------------------------------------
+void DMA_IRQHandler(void)
+{
+  uint32_t iidx = DMA->CPU_INT.IIDX;   // Read (clears)
+  switch (iidx)
+  {
+    case DMA_CPU_INT_IIDX_STAT_DMACH0:
+      spi1_dma_handler();
+      break;
+    case DMA_CPU_INT_IIDX_STAT_PREIRQCH1:
+      ADC0_dma_handler(true);
+      break;
+    case DMA_CPU_INT_IIDX_STAT_DMACH1:
+      ADC0_dma_handler(false);
+      break;
+    default:
+      break;
+  } /* switch */
+} /* DMA_IRQHandler */
+
+
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//  This function represents the ISR (Interrupt Service Routine) for ADC0. It
+//  hands the interrupt to the ADC driver, which moves a timed frame of
+//  results into its ring buffer.
+//
+// INPUT PARAMETERS:
+//  none
+//
+// OUTPUT PARAMETERS:
+//  none
+//
+// RETURN:
+//  none
+//------------------------------------------------------------------------------
+void ADC0_IRQHandler(void)
+{
+  ADC0_irq_handler();
+} /* ADC0_IRQHandler */
+
+
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//  This function represents the ISR (Interrupt Service Routine) for UART0. It
+//  hands the interrupt to the UART driver, which moves bytes between the
+//  FIFOs and its ring buffers.
+//
+// INPUT PARAMETERS:
+//  none
+//
+// OUTPUT PARAMETERS:
+//  none
+//
+// RETURN:
+//  none
+//------------------------------------------------------------------------------
+void UART0_IRQHandler(void)
+{
+  UART_irq_handler();
+} /* UART0_IRQHandler */
+
+
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//  This function represents the ISR (Interrupt Service Routine) for I2C1. It
+//  hands the interrupt to the I2C driver, which feeds and drains the FIFOs
+//  and finishes the transfer in flight.
+//
+// INPUT PARAMETERS:
+//  none
+//
+// OUTPUT PARAMETERS:
+//  none
+//
+// RETURN:
+//  none
+//------------------------------------------------------------------------------
+void I2C_INST_IRQHandler(void)
+{
+  I2C_irq_handler();
+} /* I2C_INST_IRQHandler */
+
+
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//  This function represents the ISR (Interrupt Service Routine) for SPI1. It
+//  hands the interrupt to the SPI driver, which loads the next run of an
+//  async repeat transmit when the bus goes idle.
+//
+// INPUT PARAMETERS:
+//  none
+//
+// OUTPUT PARAMETERS:
+//  none
+//
+// RETURN:
+//  none
+//------------------------------------------------------------------------------
+void SPI1_IRQHandler(void)
+{
+  spi1_irq_handler();
+} /* SPI1_IRQHandler */
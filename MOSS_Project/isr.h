@@ -51,6 +51,13 @@
 // Prototype for support functions
 // ----------------------------------------------------------------------------
 void SysTick_Handler(void);
+void TIMG0_IRQHandler(void);
+void TIMG12_IRQHandler(void);
 void RTC_IRQHandler(void);
+void DMA_IRQHandler(void);
+void ADC0_IRQHandler(void);
+void UART0_IRQHandler(void);
+void I2C1_IRQHandler(void);
+void SPI1_IRQHandler(void);
 
 #endif /* __ISR_H__ */
\ No newline at end of file
@@ -12,6 +12,13 @@
 //    This file contains a collection of functions for initializing the basic
 //    kernel created for the CSC202 final project.
 //
+//    The kernel also provides a small preemptive round-robin scheduler. Each
+//    task gets a stack carved from a static pool and runs for a time slice of
+//    KERNEL_TIME_SLICE_TICKS SysTick periods. SysTick decides when to switch
+//    and pends PendSV, which saves and restores the task registers at the
+//    lowest interrupt priority. Tasks can sleep, yield, or block on event
+//    flags that ISRs signal, and an idle task runs when nothing else is ready.
+//
 //-----------------------------------------------------------------------------
 // DISCLAIMER
 //    This code was developed for educational purposes as part of the CSC202 
@@ -37,6 +44,8 @@
 // Load standard C include files
 //-----------------------------------------------------------------------------
 #include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
 
 
 //-----------------------------------------------------------------------------
@@ -57,12 +66,70 @@
 //-----------------------------------------------------------------------------
 // Define symbolic constants used by the program
 //-----------------------------------------------------------------------------
+// Words in the initial stack frame: r4-r11 saved by PendSV, then the
+// r0-r3, r12, lr, pc and xpsr frame the hardware pops on exception return
+#define TASK_FRAME_WORDS                                                    (16)
+#define TASK_FRAME_LR                                                       (13)
+#define TASK_FRAME_PC                                                       (14)
+#define TASK_FRAME_XPSR                                                     (15)
+#define TASK_INITIAL_XPSR                                          (0x01000000U)
+
+// PendSV is PRI_14 field (bits 23:16) of SHP[1], set to the lowest priority
+#define PENDSV_PRIORITY_MASK                                       (0x00C00000U)
+
+#define MSEC_PER_SECOND                                                   (1000)
+
+// measure_clock counts core cycles over this much of the time base
+#define MEASURE_CLOCK_WINDOW_US                                         (100000)
+
+
+//-----------------------------------------------------------------------------
+// Define global variables and structures here.
+// NOTE: when possible avoid using global variables
+//-----------------------------------------------------------------------------
+static task_struct g_tasks[KERNEL_MAX_TASKS];
+static uint64_t g_stack_pool[KERNEL_STACK_POOL_SIZE / sizeof(uint64_t)];
+static uint32_t g_stack_pool_used = 0;
+static uint8_t g_task_count = 0;
+static int8_t g_current_task = KERNEL_INVALID_TASK;
+static int8_t g_idle_task = KERNEL_INVALID_TASK;
+static volatile uint32_t g_kernel_ticks = 0;
+static volatile uint32_t g_slice_ticks = 0;
+static volatile uint32_t g_lock_count = 0;
+static volatile bool g_switch_deferred = false;
+static volatile uint32_t g_pending_events = 0;
+static bool g_kernel_running = false;
+
+// Sleep accounting. Time asleep is kept in sleep timer counts. Tickless
+// sleeps are turned into ticks in units of 1/(SLEEP_TIMER_FREQ * 1000) of a
+// second, and g_tick_remainder carries what is left over to the next one.
+static uint32_t g_tick_remainder = 0;
+static volatile uint32_t g_sleep_counts = 0;
+static volatile uint32_t g_idle_wakeups = 0;
+static volatile uint32_t g_idle_stats_start = 0;
+
+// Scratch frame PendSV saves into on the very first switch
+static uint32_t g_boot_frame[TASK_FRAME_WORDS];
+
+
+//-----------------------------------------------------------------------------
+// Prototype for local functions
+//-----------------------------------------------------------------------------
+static void kernel_idle_task(void);
+static void kernel_task_exit(void);
+static void kernel_request_switch(void);
+static bool kernel_wake_sleepers(void);
+static uint32_t kernel_ticks_to_wake(void);
+static void kernel_idle_sleep(void);
+static void kernel_clock_changed(uint8_t stage, uint32_t freq);
 
 
 //------------------------------------------------------------------------------
 // DESCRIPTION:
 //  This function initializes the basic kernel components. It sets up the clock,
-//  GPIO, I2C, LCD, ADC, LEDs, RTC, SysTick, SPI, and ILI9341 components.
+//  time base, sleep timer, GPIO, I2C, LCD, ADC, LEDs, RTC, SysTick, SPI, and
+//  ILI9341 components. The sleep timer comes before the LCD, whose init
+//  waits through kernel_sleep and so through msec_sleep.
 //
 // INPUT PARAMETERS:
 //  none
@@ -77,6 +144,8 @@ void kernel_init(void)
 {
   clock_init_80mhz();
   // clock_init_40mhz();
+  time_base_init();
+  sleep_timer_init();
   launchpad_gpio_init();
   I2C_init();
   lcd1602_init();
@@ -84,7 +153,9 @@ void kernel_init(void)
   lp_leds_init();
   RTC_init();
   sys_tick_init(SYST_TICK_PERIOD_COUNT);
+  clock_register_notifier(kernel_clock_changed);
   spi1_init_40mhz();
+  spi1_dma_init();
   ili9341_init();
   ili9341_fill_screen(ILI9341_WHITE);
 } /* kernel_init */
@@ -92,8 +163,12 @@ void kernel_init(void)
 
 //------------------------------------------------------------------------------
 // DESCRIPTION:
-//  This function attempts to measure the clock frequency by using the SysTick
-//  timer and a known time delay.
+//  This function measures the clock frequency by counting SysTick cycles
+//  across 100 ms of the time base, which runs from SYSOSC rather than MCLK.
+//  It reads the running tick count and the SysTick current value before and
+//  after instead of reprogramming the timer, so the scheduler tick keeps
+//  running. The scheduler is locked so the shell is not switched out
+//  between reading the time base and reading SysTick.
 //
 // INPUT PARAMETERS:
 //  none
@@ -107,15 +182,862 @@ void kernel_init(void)
 //------------------------------------------------------------------------------
 uint32_t measure_clock(void)
 {
-    SysTick->CTRL = 0;
-    SysTick->LOAD = 0xFFFFFF;  // max load
-    SysTick->VAL  = 0;
-    SysTick->CTRL = SysTick_CTRL_ENABLE_Msk | SysTick_CTRL_CLKSOURCE_Msk;
+  uint32_t start_ticks;
+  uint32_t start_val;
+  uint32_t end_ticks;
+  uint32_t end_val;
+  uint32_t period = SysTick->LOAD + 1;
+  uint64_t start_us;
+
+  kernel_lock();
+
+  // Re-read if a tick lands between reading the count and the timer
+  do
+  {
+    start_ticks = g_kernel_ticks;
+    start_val = SysTick->VAL;
+    start_us = now_us();
+  } while (start_ticks != g_kernel_ticks);
+
+  while (now_us() - start_us < MEASURE_CLOCK_WINDOW_US);
+
+  do
+  {
+    end_ticks = g_kernel_ticks;
+    end_val = SysTick->VAL;
+  } while (end_ticks != g_kernel_ticks);
+
+  kernel_unlock();
+
+  // SysTick counts down, so cycles within a period are start_val - end_val
+  return (end_ticks - start_ticks) * period + start_val - end_val;
+} /* measure_clock */
+
+
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//  This function creates a task and adds it to the round-robin schedule. The
+//  task stack is carved from the static stack pool and primed with a frame
+//  that makes the first switch to the task look like a return from PendSV.
+//  Tasks must be created before kernel_start is called.
+//
+// INPUT PARAMETERS:
+//  entry      - function the task runs
+//  stack_size - size of the task stack in bytes (rounded up to 8 bytes)
+//  name       - name of the task, used for debugging
+//
+// OUTPUT PARAMETERS:
+//  none
+//
+// RETURN:
+//  The task index, or KERNEL_INVALID_TASK if there is no room for the task
+//------------------------------------------------------------------------------
+int8_t kernel_create_task(task_entry_t entry, uint16_t stack_size,
+                          const char *name)
+{
+  uint32_t stack_words;
+  uint32_t *stack_top;
+  uint32_t *frame;
+  task_struct *task;
+  uint8_t i;
+
+  // Keep stacks 8 byte aligned as the AAPCS requires
+  stack_size = (stack_size + 7) & ~7;
+
+  if ((g_task_count >= KERNEL_MAX_TASKS) || g_kernel_running ||
+      (stack_size < TASK_FRAME_WORDS * sizeof(uint32_t)) ||
+      (g_stack_pool_used + stack_size > sizeof(g_stack_pool)))
+  {
+    return KERNEL_INVALID_TASK;
+  } /* if */
+
+  g_stack_pool_used += stack_size;
+  stack_words = g_stack_pool_used / sizeof(uint32_t);
+  stack_top = (uint32_t *)g_stack_pool + stack_words;
+
+  // Build the frame that PendSV_Handler unstacks on the first switch
+  frame = stack_top - TASK_FRAME_WORDS;
+  for (i = 0; i < TASK_FRAME_WORDS; i++)
+  {
+    frame[i] = 0;
+  } /* for */
+  frame[TASK_FRAME_LR] = (uint32_t)kernel_task_exit;
+  frame[TASK_FRAME_PC] = (uint32_t)entry & ~1U;
+  frame[TASK_FRAME_XPSR] = TASK_INITIAL_XPSR;
+
+  task = &g_tasks[g_task_count];
+  task->stack_ptr = frame;
+  task->wake_tick = 0;
+  task->wait_mask = 0;
+  task->wait_timed = false;
+  task->name = name;
+  task->state = TASK_READY;
+
+  return g_task_count++;
+} /* kernel_create_task */
+
+
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//  This function starts the scheduler. It creates the idle task, drops
+//  PendSV to the lowest priority and pends the first context switch. It does
+//  not return; from here on main only runs again if no task was created.
+//
+// INPUT PARAMETERS:
+//  none
+//
+// OUTPUT PARAMETERS:
+//  none
+//
+// RETURN:
+//  none
+//------------------------------------------------------------------------------
+void kernel_start(void)
+{
+  g_idle_task = kernel_create_task(kernel_idle_task, KERNEL_IDLE_STACK_SIZE,
+                                   "idle");
+  if (g_idle_task == KERNEL_INVALID_TASK)
+  {
+    return;
+  } /* if */
+
+  SCB->SHP[1] |= PENDSV_PRIORITY_MASK;
+
+  // The first PendSV saves main's registers into a scratch frame
+  __set_PSP((uint32_t)&g_boot_frame[TASK_FRAME_WORDS]);
+
+  __disable_irq();
+  g_slice_ticks = 0;
+  g_kernel_running = true;
+  __enable_irq();
+
+  kernel_request_switch();
+
+  // The switch happens as soon as PendSV is taken
+  while (1)
+  {
+    __WFI();
+  } /* while */
+} /* kernel_start */
+
+
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//  This function advances the kernel tick. It is called from the SysTick ISR
+//  every SYST_TICK_PERIOD, except while the idle task has SysTick stopped;
+//  the idle task adds the skipped ticks itself when it wakes. It wakes
+//  sleeping tasks whose delay has expired and pends a context switch when
+//  the running task's time slice is used up, or when the idle task is
+//  running and another task has become ready.
+//
+// INPUT PARAMETERS:
+//  none
+//
+// OUTPUT PARAMETERS:
+//  none
+//
+// RETURN:
+//  none
+//------------------------------------------------------------------------------
+void kernel_tick(void)
+{
+  bool task_woke;
+
+  g_kernel_ticks++;
+
+  if (!g_kernel_running)
+  {
+    return;
+  } /* if */
+
+  task_woke = kernel_wake_sleepers();
+
+  if (++g_slice_ticks >= KERNEL_TIME_SLICE_TICKS ||
+      (task_woke && g_current_task == g_idle_task))
+  {
+    kernel_request_switch();
+  } /* if */
+} /* kernel_tick */
+
+
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//  This function gives up the rest of the running task's time slice.
+//
+// INPUT PARAMETERS:
+//  none
+//
+// OUTPUT PARAMETERS:
+//  none
+//
+// RETURN:
+//  none
+//------------------------------------------------------------------------------
+void kernel_yield(void)
+{
+  kernel_request_switch();
+} /* kernel_yield */
+
+
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//  This function blocks the running task for at least the given number of
+//  milliseconds. Other tasks run in the meantime. Before the scheduler has
+//  started it sleeps the core on the sleep timer instead.
+//
+// INPUT PARAMETERS:
+//  ms - number of milliseconds to sleep
+//
+// OUTPUT PARAMETERS:
+//  none
+//
+// RETURN:
+//  none
+//------------------------------------------------------------------------------
+void kernel_sleep(uint32_t ms)
+{
+  uint32_t primask;
+
+  if (!g_kernel_running)
+  {
+    msec_sleep(ms);
+    return;
+  } /* if */
+
+  primask = __get_PRIMASK();
+  __disable_irq();
+  g_tasks[g_current_task].wake_tick = g_kernel_ticks + ms;
+  g_tasks[g_current_task].state = TASK_SLEEPING;
+  __set_PRIMASK(primask);
+
+  kernel_request_switch();
+} /* kernel_sleep */
 
-    msec_delay(100);
 
-    uint32_t elapsed = 0xFFFFFF - SysTick->VAL;
-    SysTick->CTRL = 0;
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//  This function blocks the running task until one of the events in the mask
+//  is signaled. Events signaled while nobody was waiting are latched, so a
+//  matching pending event returns at once. The events that woke the task are
+//  returned and cleared. Before the scheduler has started it busy-waits for
+//  the events instead.
+//
+// INPUT PARAMETERS:
+//  mask - bitmask of KERNEL_EVENT_xxx flags to wait for
+//
+// OUTPUT PARAMETERS:
+//  none
+//
+// RETURN:
+//  The events from the mask that were signaled
+//------------------------------------------------------------------------------
+uint32_t kernel_wait_event(uint32_t mask)
+{
+  return kernel_wait_event_timeout(mask, KERNEL_WAIT_FOREVER);
+} /* kernel_wait_event */
+
 
-    return elapsed;
-}
\ No newline at end of file
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//  This function is kernel_wait_event with a limit on how long to wait. The
+//  task is woken by the tick, like a sleeping task, if none of the events
+//  arrives within the timeout.
+//
+// INPUT PARAMETERS:
+//  mask - bitmask of KERNEL_EVENT_xxx flags to wait for
+//  ms   - the longest time to wait in milliseconds, 0 to only check for
+//         pending events, or KERNEL_WAIT_FOREVER
+//
+// OUTPUT PARAMETERS:
+//  none
+//
+// RETURN:
+//  The events from the mask that were signaled, or 0 on timeout
+//------------------------------------------------------------------------------
+uint32_t kernel_wait_event_timeout(uint32_t mask, uint32_t ms)
+{
+  task_struct *task;
+  uint32_t events;
+  uint32_t primask;
+  uint32_t start_ticks = g_kernel_ticks;
+
+  if (!g_kernel_running)
+  {
+    while (((g_pending_events & mask) == 0) &&
+           ((ms == KERNEL_WAIT_FOREVER) ||
+            (g_kernel_ticks - start_ticks < ms)));
+  } /* if */
+
+  primask = __get_PRIMASK();
+  __disable_irq();
+  events = g_pending_events & mask;
+  if (events != 0 || ms == 0 || !g_kernel_running)
+  {
+    g_pending_events &= ~events;
+    __set_PRIMASK(primask);
+    return events;
+  } /* if */
+  task = &g_tasks[g_current_task];
+  task->wait_mask = mask;
+  task->wake_tick = g_kernel_ticks + ms;
+  task->wait_timed = (ms != KERNEL_WAIT_FOREVER);
+  task->state = TASK_WAITING;
+  __set_PRIMASK(primask);
+
+  kernel_request_switch();
+
+  // Only returns once kernel_signal_event or the tick made the task ready
+  while (task->state != TASK_READY);
+
+  return task->wait_mask;
+} /* kernel_wait_event_timeout */
+
+
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//  This function signals events to the tasks waiting on them. It is safe to
+//  call from an ISR. Each waiting task whose mask matches is made ready and
+//  its mask is replaced by the events it received. Events nobody is waiting
+//  for are latched until a task waits on them.
+//
+// INPUT PARAMETERS:
+//  events - bitmask of KERNEL_EVENT_xxx flags to signal
+//
+// OUTPUT PARAMETERS:
+//  none
+//
+// RETURN:
+//  none
+//------------------------------------------------------------------------------
+void kernel_signal_event(uint32_t events)
+{
+  uint32_t delivered = 0;
+  bool task_woke = false;
+  uint32_t primask;
+  uint8_t i;
+
+  primask = __get_PRIMASK();
+  __disable_irq();
+  for (i = 0; i < g_task_count; i++)
+  {
+    if ((g_tasks[i].state == TASK_WAITING) &&
+        (g_tasks[i].wait_mask & events))
+    {
+      g_tasks[i].wait_mask &= events;
+      g_tasks[i].state = TASK_READY;
+      delivered |= g_tasks[i].wait_mask;
+      task_woke = true;
+    } /* if */
+  } /* for */
+  g_pending_events |= events & ~delivered;
+  __set_PRIMASK(primask);
+
+  if (task_woke && g_current_task == g_idle_task)
+  {
+    kernel_request_switch();
+  } /* if */
+} /* kernel_signal_event */
+
+
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//  This function locks the scheduler so the running task keeps the CPU until
+//  kernel_unlock is called. Interrupts still run. Locks nest. Use it around
+//  short sections that share a peripheral between tasks, and do not sleep or
+//  wait for an event while holding it.
+//
+// INPUT PARAMETERS:
+//  none
+//
+// OUTPUT PARAMETERS:
+//  none
+//
+// RETURN:
+//  none
+//------------------------------------------------------------------------------
+void kernel_lock(void)
+{
+  uint32_t primask = __get_PRIMASK();
+
+  __disable_irq();
+  g_lock_count++;
+  __set_PRIMASK(primask);
+} /* kernel_lock */
+
+
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//  This function releases one level of scheduler lock. A switch that was
+//  deferred while the lock was held happens when the last level is released.
+//
+// INPUT PARAMETERS:
+//  none
+//
+// OUTPUT PARAMETERS:
+//  none
+//
+// RETURN:
+//  none
+//------------------------------------------------------------------------------
+void kernel_unlock(void)
+{
+  bool do_switch = false;
+  uint32_t primask = __get_PRIMASK();
+
+  __disable_irq();
+  if (g_lock_count > 0)
+  {
+    g_lock_count--;
+  } /* if */
+  if (g_lock_count == 0 && g_switch_deferred)
+  {
+    g_switch_deferred = false;
+    do_switch = true;
+  } /* if */
+  __set_PRIMASK(primask);
+
+  if (do_switch)
+  {
+    kernel_request_switch();
+  } /* if */
+} /* kernel_unlock */
+
+
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//  This function returns the number of kernel ticks since SysTick started.
+//  One tick is SYST_TICK_PERIOD (1 ms).
+//
+// INPUT PARAMETERS:
+//  none
+//
+// OUTPUT PARAMETERS:
+//  none
+//
+// RETURN:
+//  The kernel tick count
+//------------------------------------------------------------------------------
+uint32_t kernel_get_ticks(void)
+{
+  return g_kernel_ticks;
+} /* kernel_get_ticks */
+
+
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//  This function reports how much of the time since the idle stats were last
+//  cleared the core spent asleep in the idle task, and how often it woke.
+//
+// INPUT PARAMETERS:
+//  none
+//
+// OUTPUT PARAMETERS:
+//  stats - the idle figures
+//
+// RETURN:
+//  none
+//------------------------------------------------------------------------------
+void kernel_get_idle_stats(kernel_idle_stats_struct *stats)
+{
+  uint32_t primask = __get_PRIMASK();
+
+  __disable_irq();
+  stats->elapsed_ms = g_kernel_ticks - g_idle_stats_start;
+  stats->asleep_ms = (uint64_t)g_sleep_counts * MSEC_PER_SECOND /
+                     SLEEP_TIMER_FREQ;
+  stats->wakeups = g_idle_wakeups;
+  __set_PRIMASK(primask);
+} /* kernel_get_idle_stats */
+
+
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//  This function clears the idle stats, starting a new measurement window.
+//
+// INPUT PARAMETERS:
+//  none
+//
+// OUTPUT PARAMETERS:
+//  none
+//
+// RETURN:
+//  none
+//------------------------------------------------------------------------------
+void kernel_clear_idle_stats(void)
+{
+  uint32_t primask = __get_PRIMASK();
+
+  __disable_irq();
+  g_idle_stats_start = g_kernel_ticks;
+  g_sleep_counts = 0;
+  g_idle_wakeups = 0;
+  __set_PRIMASK(primask);
+} /* kernel_clear_idle_stats */
+
+
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//  This function picks the next task to run. It is called from PendSV_Handler
+//  with the stack pointer of the task being switched out and returns the
+//  stack pointer of the task to switch in. Tasks are taken round-robin; the
+//  idle task only runs when no other task is ready. While the scheduler is
+//  locked the running task keeps the CPU and the switch is deferred.
+//
+// INPUT PARAMETERS:
+//  stack_ptr - saved process stack pointer of the task being switched out
+//
+// OUTPUT PARAMETERS:
+//  none
+//
+// RETURN:
+//  The process stack pointer of the task to run next
+//------------------------------------------------------------------------------
+__attribute__((used)) uint32_t *kernel_switch_context(uint32_t *stack_ptr)
+{
+  int8_t next = g_idle_task;
+  uint8_t i;
+
+  if (g_current_task == KERNEL_INVALID_TASK)
+  {
+    g_current_task = g_idle_task;
+  } /* if */
+  else
+  {
+    g_tasks[g_current_task].stack_ptr = stack_ptr;
+
+    if (g_lock_count > 0 && g_tasks[g_current_task].state == TASK_READY)
+    {
+      g_switch_deferred = true;
+      return stack_ptr;
+    } /* if */
+  } /* else */
+
+  for (i = 1; i <= g_task_count; i++)
+  {
+    int8_t candidate = (g_current_task + i) % g_task_count;
+
+    if (candidate != g_idle_task && g_tasks[candidate].state == TASK_READY)
+    {
+      next = candidate;
+      break;
+    } /* if */
+  } /* for */
+
+  g_current_task = next;
+  g_slice_ticks = 0;
+
+  return g_tasks[next].stack_ptr;
+} /* kernel_switch_context */
+
+
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//  This function represents the ISR for PendSV and performs the context
+//  switch. The hardware has already stacked r0-r3, r12, lr, pc and xpsr on the
+//  process stack; this handler stacks r4-r11 below them, lets
+//  kernel_switch_context choose the next task, then unstacks that task's
+//  r4-r11 and returns to it on the process stack. Cortex-M0+ can only store
+//  r4-r7 with stm, so r8-r11 go through the low registers. Interrupts are
+//  masked while the task table is being changed.
+//
+// INPUT PARAMETERS:
+//  none
+//
+// OUTPUT PARAMETERS:
+//  none
+//
+// RETURN:
+//  none
+//------------------------------------------------------------------------------
+__attribute__((naked)) void PendSV_Handler(void)
+{
+  __asm(
+#ifdef __GNUC__
+      "    .syntax unified\n"
+#endif
+      "    cpsid i\n"
+      "    mrs   r0, psp\n"
+      "    subs  r0, #32\n"
+      "    mov   r1, r0\n"
+      "    stmia r1!, {r4-r7}\n"
+      "    mov   r4, r8\n"
+      "    mov   r5, r9\n"
+      "    mov   r6, r10\n"
+      "    mov   r7, r11\n"
+      "    stmia r1!, {r4-r7}\n"
+      "    bl    kernel_switch_context\n"
+      "    adds  r0, #16\n"
+      "    ldmia r0!, {r4-r7}\n"
+      "    mov   r8, r4\n"
+      "    mov   r9, r5\n"
+      "    mov   r10, r6\n"
+      "    mov   r11, r7\n"
+      "    msr   psp, r0\n"
+      "    subs  r0, #32\n"
+      "    ldmia r0!, {r4-r7}\n"
+      "    cpsie i\n"
+      "    movs  r0, #2\n"
+      "    mvns  r0, r0\n"
+      "    bx    r0\n");
+} /* PendSV_Handler */
+
+
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//  This function is the idle task. It runs whenever no other task is ready
+//  and puts the core to sleep until the next interrupt.
+//
+// INPUT PARAMETERS:
+//  none
+//
+// OUTPUT PARAMETERS:
+//  none
+//
+// RETURN:
+//  none
+//------------------------------------------------------------------------------
+static void kernel_idle_task(void)
+{
+  while (1)
+  {
+    kernel_idle_sleep();
+  } /* while */
+} /* kernel_idle_task */
+
+
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//  This function sleeps the core once, with WFI. If no task is due to wake
+//  for KERNEL_TICKLESS_MIN_TICKS or more, SysTick is stopped and the sleep
+//  timer is set to wake the core when the first sleeping task is due, so an
+//  idle system is not woken every tick. On waking, for any reason, the ticks
+//  that were skipped are added back from the sleep timer, the same as if
+//  SysTick had kept running, and SysTick is restarted.
+//
+//  Interrupts stay masked across the sleep. WFI still wakes on a pending
+//  interrupt, and its handler runs only once the tick count is caught up.
+//
+// INPUT PARAMETERS:
+//  none
+//
+// OUTPUT PARAMETERS:
+//  none
+//
+// RETURN:
+//  none
+//------------------------------------------------------------------------------
+static void kernel_idle_sleep(void)
+{
+  uint32_t sleep_ticks;
+  uint32_t load;
+  uint32_t millis;
+  uint16_t start;
+  uint16_t elapsed;
+  bool tickless;
+
+  __disable_irq();
+
+  // A task made ready since idle was switched in is about to be switched to
+  if (SCB->ICSR & SCB_ICSR_PENDSVSET_Msk)
+  {
+    __enable_irq();
+    return;
+  } /* if */
+
+  sleep_ticks = kernel_ticks_to_wake();
+  tickless = (sleep_ticks >= KERNEL_TICKLESS_MIN_TICKS);
+  start = sleep_timer_count();
+
+  if (tickless)
+  {
+    if (sleep_ticks > SLEEP_TIMER_MAX_MS)
+    {
+      sleep_ticks = SLEEP_TIMER_MAX_MS;
+    } /* if */
+
+    // Stop SysTick and bank the part of the current tick already counted
+    SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
+    load = SysTick->LOAD + 1;
+    g_tick_remainder += (load - SysTick->VAL) * SLEEP_TIMER_FREQ / load;
+
+    sleep_timer_set_wakeup(start + sleep_ticks * SLEEP_TIMER_FREQ /
+                                   MSEC_PER_SECOND);
+  } /* if */
+
+  __WFI();
+
+  elapsed = sleep_timer_count() - start;
+  g_sleep_counts += elapsed;
+  g_idle_wakeups++;
+
+  if (tickless)
+  {
+    millis = g_tick_remainder + (uint32_t)elapsed * MSEC_PER_SECOND;
+    g_tick_remainder = millis % SLEEP_TIMER_FREQ;
+    g_kernel_ticks += millis / SLEEP_TIMER_FREQ;
+
+    if (kernel_wake_sleepers())
+    {
+      kernel_request_switch();
+    } /* if */
+
+    SysTick->VAL = 0;
+    SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+  } /* if */
+
+  __enable_irq();
+} /* kernel_idle_sleep */
+
+
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//  This function makes ready every sleeping task whose wake tick has come,
+//  and every task whose wait for events has timed out; those get no events.
+//  Interrupts must be masked or the caller must be the SysTick ISR.
+//
+// INPUT PARAMETERS:
+//  none
+//
+// OUTPUT PARAMETERS:
+//  none
+//
+// RETURN:
+//  true  - if a task was woken
+//  false - otherwise
+//------------------------------------------------------------------------------
+static bool kernel_wake_sleepers(void)
+{
+  bool task_woke = false;
+  uint8_t i;
+
+  for (i = 0; i < g_task_count; i++)
+  {
+    if (((g_tasks[i].state == TASK_SLEEPING) ||
+         ((g_tasks[i].state == TASK_WAITING) && g_tasks[i].wait_timed)) &&
+        ((int32_t)(g_kernel_ticks - g_tasks[i].wake_tick) >= 0))
+    {
+      if (g_tasks[i].state == TASK_WAITING)
+      {
+        g_tasks[i].wait_mask = 0;
+      } /* if */
+      g_tasks[i].state = TASK_READY;
+      task_woke = true;
+    } /* if */
+  } /* for */
+
+  return task_woke;
+} /* kernel_wake_sleepers */
+
+
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//  This function finds how many ticks remain until the first sleeping task,
+//  or task waiting with a timeout, is due to wake.
+//
+// INPUT PARAMETERS:
+//  none
+//
+// OUTPUT PARAMETERS:
+//  none
+//
+// RETURN:
+//  The number of ticks, 0 if a task is already due, or UINT32_MAX if no
+//  task has a wake tick
+//------------------------------------------------------------------------------
+static uint32_t kernel_ticks_to_wake(void)
+{
+  uint32_t ticks = UINT32_MAX;
+  int32_t remaining;
+  uint8_t i;
+
+  for (i = 0; i < g_task_count; i++)
+  {
+    if ((g_tasks[i].state == TASK_SLEEPING) ||
+        ((g_tasks[i].state == TASK_WAITING) && g_tasks[i].wait_timed))
+    {
+      remaining = (int32_t)(g_tasks[i].wake_tick - g_kernel_ticks);
+      if (remaining <= 0)
+      {
+        return 0;
+      } /* if */
+      if ((uint32_t)remaining < ticks)
+      {
+        ticks = remaining;
+      } /* if */
+    } /* if */
+  } /* for */
+
+  return ticks;
+} /* kernel_ticks_to_wake */
+
+
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//  This function is where a task goes if its entry function returns. The
+//  task is marked done and never scheduled again.
+//
+// INPUT PARAMETERS:
+//  none
+//
+// OUTPUT PARAMETERS:
+//  none
+//
+// RETURN:
+//  none
+//------------------------------------------------------------------------------
+static void kernel_task_exit(void)
+{
+  __disable_irq();
+  g_tasks[g_current_task].state = TASK_DONE;
+  __enable_irq();
+
+  kernel_request_switch();
+
+  while (1);
+} /* kernel_task_exit */
+
+
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//  This function pends PendSV so a context switch happens once no other
+//  interrupt is active.
+//
+// INPUT PARAMETERS:
+//  none
+//
+// OUTPUT PARAMETERS:
+//  none
+//
+// RETURN:
+//  none
+//------------------------------------------------------------------------------
+static void kernel_request_switch(void)
+{
+  SCB->ICSR = SCB_ICSR_PENDSVSET_Msk;
+} /* kernel_request_switch */
+
+
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//  This function keeps the tick at SYST_TICK_PERIOD across a bus clock
+//  change by reloading SysTick for the new frequency. The tick in progress
+//  starts over, so it runs a little long once.
+//
+// INPUT PARAMETERS:
+//  stage - CLOCK_CHANGE_PREPARE or CLOCK_CHANGE_COMMIT
+//  freq  - the new bus clock frequency in Hz
+//
+// OUTPUT PARAMETERS:
+//  none
+//
+// RETURN:
+//  none
+//------------------------------------------------------------------------------
+static void kernel_clock_changed(uint8_t stage, uint32_t freq)
+{
+  if (stage == CLOCK_CHANGE_COMMIT)
+  {
+    SysTick->LOAD = freq / MSEC_PER_SECOND - 1;
+    SysTick->VAL = 0;
+  } /* if */
+} /* kernel_clock_changed */
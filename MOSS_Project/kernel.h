@@ -9,6 +9,9 @@
 //
 //-----------------------------------------------------------------------------
 // DESCRIPTION
+//    This file contains the definitions for the basic kernel created for the
+//    CSC202 final project: hardware start-up and a small preemptive
+//    round-robin task scheduler driven by SysTick.
 //
 //-----------------------------------------------------------------------------
 // DISCLAIMER
@@ -38,15 +41,74 @@
 // Loads standard C include files
 //-----------------------------------------------------------------------------
 #include <stdint.h>
+#include <stdbool.h>
 
 
 //-----------------------------------------------------------------------------
 // Define symbolic constants used by the program
 //-----------------------------------------------------------------------------
 #define MSPM0_CLOCK_FREQUENCY                                             (80E6)
-#define SYST_TICK_PERIOD                                                   (1E3)
+#define SYST_TICK_PERIOD                                                  (1E-3)
 #define SYST_TICK_PERIOD_COUNT        (SYST_TICK_PERIOD * MSPM0_CLOCK_FREQUENCY)
 
+// Scheduler configuration (one kernel tick is one SysTick period, 1 ms)
+#define KERNEL_MAX_TASKS                                                     (6)
+#define KERNEL_STACK_POOL_SIZE                                            (6144)
+#define KERNEL_IDLE_STACK_SIZE                                             (256)
+#define KERNEL_TIME_SLICE_TICKS                                             (10)
+#define KERNEL_INVALID_TASK                                                 (-1)
+
+// The idle task stops SysTick and sleeps on the sleep timer when no task is
+// due to wake for at least this many ticks
+#define KERNEL_TICKLESS_MIN_TICKS                                            (2)
+
+// Task states
+#define TASK_READY                                                           (0)
+#define TASK_SLEEPING                                                        (1)
+#define TASK_WAITING                                                         (2)
+#define TASK_DONE                                                            (3)
+
+// Event flags that ISRs signal and tasks wait on
+#define KERNEL_EVENT_RTC_SECOND                                         (1 << 0)
+#define KERNEL_EVENT_UART_RX                                            (1 << 1)
+#define KERNEL_EVENT_UART_TX                                            (1 << 2)
+#define KERNEL_EVENT_LCD_DIRTY                                          (1 << 3)
+#define KERNEL_EVENT_I2C_DONE                                           (1 << 4)
+#define KERNEL_EVENT_ADC_DATA                                           (1 << 5)
+#define KERNEL_EVENT_ADC_WINDOW                                         (1 << 6)
+#define KERNEL_EVENT_TIMER                                              (1 << 7)
+#define KERNEL_EVENT_LCD_TEMP                                           (1 << 8)
+
+// Timeout for kernel_wait_event_timeout that never expires
+#define KERNEL_WAIT_FOREVER                                         (0xFFFFFFFF)
+
+
+//-----------------------------------------------------------------------------
+// Define the types used by the kernel
+//-----------------------------------------------------------------------------
+typedef void (*task_entry_t)(void);
+
+// How long the idle task kept the core asleep, since the stats were cleared
+typedef struct
+{
+  uint32_t elapsed_ms;
+  uint32_t asleep_ms;
+  uint32_t wakeups;
+} kernel_idle_stats_struct;
+
+// Task control block. stack_ptr holds the task's saved stack pointer while
+// it is switched out; PendSV_Handler reaches it only through
+// kernel_switch_context, so the fields can be in any order.
+typedef struct
+{
+  uint32_t    *stack_ptr;
+  uint32_t     wake_tick;
+  uint32_t     wait_mask;
+  const char  *name;
+  uint8_t      state;
+  bool         wait_timed;
+} task_struct;
+
 
 // ----------------------------------------------------------------------------
 // Prototype for support functions
@@ -54,4 +116,21 @@
 void kernel_init(void);
 uint32_t measure_clock(void);
 
+int8_t kernel_create_task(task_entry_t entry, uint16_t stack_size,
+                          const char *name);
+void kernel_start(void);
+void kernel_tick(void);
+void kernel_yield(void);
+void kernel_sleep(uint32_t ms);
+uint32_t kernel_wait_event(uint32_t mask);
+uint32_t kernel_wait_event_timeout(uint32_t mask, uint32_t ms);
+void kernel_signal_event(uint32_t events);
+void kernel_lock(void);
+void kernel_unlock(void);
+uint32_t kernel_get_ticks(void);
+void kernel_get_idle_stats(kernel_idle_stats_struct *stats);
+void kernel_clear_idle_stats(void);
+uint32_t *kernel_switch_context(uint32_t *stack_ptr);
+void PendSV_Handler(void);
+
 #endif /* __KERNEL_H__ */
\ No newline at end of file
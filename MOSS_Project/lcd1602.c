@@ -15,6 +15,12 @@
 //    setting the cursor, writing the time, temperature characters and strings,
 //    and clearing the display. 
 //
+//    Cursor moves, character writes and clears only update a shadow copy of
+//    the display RAM. lcd1602_flush compares the shadow with what the panel
+//    shows and sends just the changed characters, all of them in one I2C
+//    burst. Writes signal KERNEL_EVENT_LCD_DIRTY so a background task can
+//    flush them.
+//
 //    NOTE: This code assumes that the IIC address is 0x27.
 //
 //-----------------------------------------------------------------------------
@@ -50,12 +56,31 @@
 #include "clock.h"
 #include "lcd1602.h"
 #include "LaunchPad.h"
+#include "kernel.h"
 
 //-----------------------------------------------------------------------------
 // global signal to track status of backlight of LCD module
 //-----------------------------------------------------------------------------
 static uint8_t g_lcd_backlight_mode = 0;
 
+//-----------------------------------------------------------------------------
+// Shadow display RAM written by the lcd_ functions, the characters the panel
+// is known to show, and the shadow cursor (a DDRAM address)
+//-----------------------------------------------------------------------------
+static char g_lcd_shadow[LINES_PER_LCD][CHARACTERS_PER_LCD_LINE];
+static char g_lcd_panel[LINES_PER_LCD][CHARACTERS_PER_LCD_LINE];
+static uint8_t g_lcd_cursor = LCD_LINE1_ADDR;
+static volatile bool g_lcd_dirty = false;
+
+// Port expander bytes of the burst being built by lcd1602_flush
+static uint8_t g_lcd_flush_buffer[LCD1602_FLUSH_BUFFER_SIZE];
+
+//-----------------------------------------------------------------------------
+// Prototype for local functions
+//-----------------------------------------------------------------------------
+static uint8_t lcd1602_pack(uint8_t *buffer, uint8_t data, uint8_t reg_select);
+static void lcd1602_mark_dirty(void);
+
 
 //-----------------------------------------------------------------------------
 // DESCRIPTION:
@@ -104,11 +129,11 @@ uint32_t lcd1602_init(void)
   {
     status |= I2C_send1(LCD_IIC_ADDRESS, lcd_init_code[index] |
                       LATCH_ENABLE | WRITE_ENABLE | LCD_INSTR_REG);
-    msec_delay(IIC_TIME_DELAY_2MS);
+    kernel_sleep(IIC_TIME_DELAY_2MS);
 
     status |= I2C_send1(LCD_IIC_ADDRESS, lcd_init_code[index] |
                         WRITE_ENABLE | LCD_INSTR_REG);
-    msec_delay(IIC_TIME_DELAY_2MS);
+    kernel_sleep(IIC_TIME_DELAY_2MS);
   } /* for */
 
   // Send the first 4 commands as a two I2C transfer
@@ -116,9 +141,19 @@ uint32_t lcd1602_init(void)
   {
     status |= lcd1602_write(LCD_IIC_ADDRESS, lcd_init_code[index], 
                           LCD_INSTR_REG);
-    msec_delay(IIC_TIME_DELAY_2MS);
   } /* for */
 
+  // The clear command above left the panel blank
+  for (uint8_t line = 0; line < LINES_PER_LCD; line++)
+  {
+    for (uint8_t pos = 0; pos < CHARACTERS_PER_LCD_LINE; pos++)
+    {
+      g_lcd_shadow[line][pos] = ' ';
+      g_lcd_panel[line][pos] = ' ';
+    } /* for */
+  } /* for */
+  g_lcd_cursor = LCD_LINE1_ADDR;
+
   lcd_set_backlight_on();
 
   return (status);
@@ -127,85 +162,142 @@ uint32_t lcd1602_init(void)
 
 //-----------------------------------------------------------------------------
 // DESCRIPTION:
-//    This function sends byte (command or data) to the LCD1602 display over 
-//    I2C, using the 4-bit interface protocol. The byte is split into upper 
-//    and lower 4-bit nibbles, each transmitted separately. The Enable (E) 
-//    line is pulsed for each nibble to latch the data. The RS (Register Select) 
-//    bit determines whether the byte is a command (0) or display data (1). 
-//    The current backlight setting is included with each transmission.
-//
-//    NOTE:
-//        The HD44780-based LCD1602 specifies nanosecond-scale timing for 
-//        control signal setup and hold (e.g., Enable pulse width ~450 ns),
-//        but command execution times are much longer — up to 1.53 ms for 
-//        commands like Clear Display or Return Home.
-//
-//        In a parallel interface, the busy flag (BF) can be polled to know 
-//        when the LCD is ready for the next command. However, with I2C (like 
-//        we are using) reading from the LCD is not feasible, so we use 
-//        fixed delays instead.
-//
-//        These delays (typically 1–2 ms) are intentionally conservative to 
-//        ensure correct operation, especially after slow commands. Without 
-//        them, the LCD may receive new instructions before it's ready, 
-//        leading to display glitches or lockups.
+//    This function sends one byte straight to the LCD instruction or data
+//    register, bypassing the shadow buffer. Both nibbles and the R/W release
+//    go out as a single I2C burst; at 100 kHz each I2C byte already lasts
+//    longer than the enable setup, pulse and hold times. Only the clear and
+//    home instructions need extra time, and the task sleeps through it.
 //
 // INPUT PARAMETERS:
-//    iic_addr   - the 8-bit I2C address of the LCD1602 display.
-//    data       - the byte of data to be sent to the LCD.
-//    reg_select - an 8-bit value to indicate whether the data is to be written 
-//                 to the instruction registers (0) or data registers (1).
+//    iic_addr   - I2C address of the LCD module
+//    data       - byte to send
+//    reg_select - LCD_INSTR_REG or LCD_DATA_REG
 //
 // OUTPUT PARAMETERS:
 //    none
 //
 // RETURN:
-//    uint32_t - Status code indicating success or failure of the operation.
-//        0 if successful
-//        1 if failure
+//    1 if the byte was sent, 0 if the I2C transfer failed
 // -----------------------------------------------------------------------------
 uint32_t lcd1602_write(uint8_t iic_addr, uint8_t data, uint8_t reg_select)
 {
-  uint32_t status = 0;
-  uint8_t  upper_nibble = (data & UPPER_NIBBLE_MASK);
-  uint8_t  lower_nibble = (data & LOWER_NIBBLE_MASK) << NIBBLE_SHIFT;
+  uint8_t  buffer[LCD1602_BYTES_PER_WRITE + 1];
+  uint8_t  count;
+  uint32_t status;
 
-  upper_nibble |= g_lcd_backlight_mode | WRITE_ENABLE | reg_select;
-  lower_nibble |= g_lcd_backlight_mode | WRITE_ENABLE | reg_select;
+  count = lcd1602_pack(buffer, data, reg_select);
 
-  // Send upper nibble
-  // Set RS and R/W with data
-  status |= I2C_send1(iic_addr, upper_nibble);
-  usec_delay(LCD1602_E_SETUP_DELAY);
-  
-  // Set Enable high
-  status |= I2C_send1(iic_addr, upper_nibble | LATCH_ENABLE);
-  usec_delay(LCD1602_E_PULSE_WIDTH);
-  
-  // Set Enable low
-  status |= I2C_send1(iic_addr, upper_nibble);
-  usec_delay(LCD1602_HOLD_DELAY);
+  // De-assert R/W
+  buffer[count++] = g_lcd_backlight_mode | READ_ENABLE;
+
+  status = I2C_send(iic_addr, buffer, count);
+
+  // Give LCD module time to complete the slow commands (clear and home)
+  if ((reg_select == LCD_INSTR_REG) && (data < LCD_ENTRY_MODE_SET_CMD))
+  {
+    kernel_sleep(IIC_TIME_DELAY_2MS);
+  } /* if */
+
+  return (status);
+} /* lcd1602_write */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function brings the panel up to date with the shadow buffer. Runs
+//    of changed characters are each preceded by a set DDRAM address command,
+//    and every run on both lines goes out in one I2C burst. Nothing is sent if
+//    nothing changed. If the transfer fails the panel contents are unknown,
+//    so the next flush rewrites every character.
+//
+// INPUT PARAMETERS:
+//    none
+//
+// OUTPUT PARAMETERS:
+//    none
+//
+// RETURN:
+//    1 if the panel is up to date, 0 if the I2C transfer failed
+// -----------------------------------------------------------------------------
+uint32_t lcd1602_flush(void)
+{
+  static const uint8_t line_addr[LINES_PER_LCD] = {LCD_LINE1_ADDR,
+                                                   LCD_LINE2_ADDR};
+  uint16_t count = 0;
+  uint32_t status;
+  uint8_t  line;
+  uint8_t  pos;
 
-  // send lower nibble
-  // Set RS and R/W with data
-  status |= I2C_send1(iic_addr, lower_nibble);
-  usec_delay(LCD1602_E_SETUP_DELAY);
+  g_lcd_dirty = false;
 
-  // Set Enable high
-  status |= I2C_send1(iic_addr, lower_nibble | LATCH_ENABLE);
-  usec_delay(LCD1602_E_PULSE_WIDTH);
+  for (line = 0; line < LINES_PER_LCD; line++)
+  {
+    pos = 0;
+    while (pos < CHARACTERS_PER_LCD_LINE)
+    {
+      if (g_lcd_shadow[line][pos] == g_lcd_panel[line][pos])
+      {
+        pos++;
+        continue;
+      } /* if */
+
+      count += lcd1602_pack(&g_lcd_flush_buffer[count],
+                            LCD_SET_DDRAM_ADDR_CMD | (line_addr[line] + pos),
+                            LCD_INSTR_REG);
+      while ((pos < CHARACTERS_PER_LCD_LINE) &&
+             (g_lcd_shadow[line][pos] != g_lcd_panel[line][pos]))
+      {
+        g_lcd_panel[line][pos] = g_lcd_shadow[line][pos];
+        count += lcd1602_pack(&g_lcd_flush_buffer[count],
+                              g_lcd_panel[line][pos], LCD_DATA_REG);
+        pos++;
+      } /* while */
+    } /* while */
+  } /* for */
 
-  status |= I2C_send1(iic_addr, lower_nibble);
-  usec_delay(LCD1602_HOLD_DELAY);
+  if (count == 0)
+  {
+    return 1;
+  } /* if */
 
   // De-assert R/W
-  status |= I2C_send1(iic_addr, g_lcd_backlight_mode | READ_ENABLE);
+  g_lcd_flush_buffer[count++] = g_lcd_backlight_mode | READ_ENABLE;
 
-  // Give LCD module time to complete command
-  msec_delay(IIC_TIME_DELAY_2MS);
+  status = I2C_send(LCD_IIC_ADDRESS, g_lcd_flush_buffer, count);
+  if (status == 0)
+  {
+    for (line = 0; line < LINES_PER_LCD; line++)
+    {
+      for (pos = 0; pos < CHARACTERS_PER_LCD_LINE; pos++)
+      {
+        g_lcd_panel[line][pos] = 0;
+      } /* for */
+    } /* for */
+    lcd1602_mark_dirty();
+  } /* if */
 
   return (status);
-} /* lcd1602_write */
+} /* lcd1602_flush */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function reports whether the shadow buffer has changes that have
+//    not been flushed to the panel yet.
+//
+// INPUT PARAMETERS:
+//    none
+//
+// OUTPUT PARAMETERS:
+//    none
+//
+// RETURN:
+//    true if lcd1602_flush has work to do
+// -----------------------------------------------------------------------------
+bool lcd1602_is_dirty(void)
+{
+  return g_lcd_dirty;
+} /* lcd1602_is_dirty */
 
 
 //-----------------------------------------------------------------------------
@@ -230,7 +322,6 @@ void lcd_set_backlight_off(void)
   g_lcd_backlight_mode &= ~LCD_BACKLIGHT_BIT_MASK;
 
   (void)I2C_send1(LCD_IIC_ADDRESS, g_lcd_backlight_mode);
-  msec_delay(IIC_TIME_DELAY_1MS);
 
 } /* lcd_set_backlight_off */
 
@@ -255,7 +346,6 @@ void lcd_set_backlight_on(void)
   g_lcd_backlight_mode |= LCD_BACKLIGHT_BIT_MASK;
 
   (void)I2C_send1(LCD_IIC_ADDRESS, g_lcd_backlight_mode);
-  msec_delay(IIC_TIME_DELAY_1MS);
 
 } /* lcd_set_backlight_on */
 
@@ -280,9 +370,8 @@ void lcd_set_backlight_on(void)
 // -----------------------------------------------------------------------------
 void lcd_set_ddram_addr(uint8_t address)
 {
-  uint8_t command = address | LCD_SET_DDRAM_ADDR_CMD;
-
-  (void)lcd1602_write(LCD_IIC_ADDRESS, command, LCD_INSTR_REG);
+  // Only the shadow cursor moves; the flush sends the addresses it needs
+  g_lcd_cursor = address & ~LCD_SET_DDRAM_ADDR_CMD;
 
 } /* lcd_set_ddram_addr */
 
@@ -307,8 +396,19 @@ void lcd_set_ddram_addr(uint8_t address)
 // -----------------------------------------------------------------------------
 void lcd_write_char(uint8_t character)
 {
-
-  (void)lcd1602_write(LCD_IIC_ADDRESS, character, LCD_DATA_REG);
+  uint8_t line = (g_lcd_cursor >= LCD_LINE2_ADDR) ? LCD_LINE_NUM_2 :
+                                                    LCD_LINE_NUM_1;
+  uint8_t pos = g_lcd_cursor - ((line == LCD_LINE_NUM_2) ? LCD_LINE2_ADDR :
+                                                           LCD_LINE1_ADDR);
+
+  // Addresses past the visible 16 characters are kept but not shown
+  if ((pos < CHARACTERS_PER_LCD_LINE) &&
+      (g_lcd_shadow[line][pos] != (char)character))
+  {
+    g_lcd_shadow[line][pos] = character;
+    lcd1602_mark_dirty();
+  } /* if */
+  g_lcd_cursor++;
 
 } /* lcd_write_char */
 
@@ -359,8 +459,16 @@ void lcd_write_string(const char *string)
 // -----------------------------------------------------------------------------
 void lcd_clear(void)
 {
-
-  (void)lcd1602_write(LCD_IIC_ADDRESS, LCD_CLEAR_DISPLAY_CMD, LCD_INSTR_REG);
+  // Blank the shadow; the flush only rewrites characters that were not blank
+  for (uint8_t line = 0; line < LINES_PER_LCD; line++)
+  {
+    for (uint8_t pos = 0; pos < CHARACTERS_PER_LCD_LINE; pos++)
+    {
+      g_lcd_shadow[line][pos] = ' ';
+    } /* for */
+  } /* for */
+  g_lcd_cursor = LCD_LINE1_ADDR;
+  lcd1602_mark_dirty();
 
 } /* lcd_clear */
 
@@ -695,4 +803,63 @@ void lcd_write_temp(uint8_t temperature_f)
   lcd_write_byte(temperature_f);
   lcd_write_char(DEGREE_SYMBOL);
   lcd_write_char('F');
-} /* show_temp */
\ No newline at end of file
+} /* show_temp */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function packs the port expander bytes that clock one byte into the
+//    LCD in 4-bit mode: for each nibble, data with enable low, high, then low
+//    again.
+//
+// INPUT PARAMETERS:
+//    data       - byte to send
+//    reg_select - LCD_INSTR_REG or LCD_DATA_REG
+//
+// OUTPUT PARAMETERS:
+//    buffer - receives LCD1602_BYTES_PER_WRITE port expander bytes
+//
+// RETURN:
+//    The number of bytes written to buffer
+// -----------------------------------------------------------------------------
+static uint8_t lcd1602_pack(uint8_t *buffer, uint8_t data, uint8_t reg_select)
+{
+  uint8_t  upper_nibble = (data & UPPER_NIBBLE_MASK);
+  uint8_t  lower_nibble = (data & LOWER_NIBBLE_MASK) << NIBBLE_SHIFT;
+
+  upper_nibble |= g_lcd_backlight_mode | WRITE_ENABLE | reg_select;
+  lower_nibble |= g_lcd_backlight_mode | WRITE_ENABLE | reg_select;
+
+  buffer[0] = upper_nibble;
+  buffer[1] = upper_nibble | LATCH_ENABLE;
+  buffer[2] = upper_nibble;
+  buffer[3] = lower_nibble;
+  buffer[4] = lower_nibble | LATCH_ENABLE;
+  buffer[5] = lower_nibble;
+
+  return LCD1602_BYTES_PER_WRITE;
+} /* lcd1602_pack */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function records that the shadow buffer changed. The first change
+//    after a flush signals KERNEL_EVENT_LCD_DIRTY to wake the flushing task.
+//
+// INPUT PARAMETERS:
+//    none
+//
+// OUTPUT PARAMETERS:
+//    none
+//
+// RETURN:
+//    none
+// -----------------------------------------------------------------------------
+static void lcd1602_mark_dirty(void)
+{
+  if (!g_lcd_dirty)
+  {
+    g_lcd_dirty = true;
+    kernel_signal_event(KERNEL_EVENT_LCD_DIRTY);
+  } /* if */
+} /* lcd1602_mark_dirty */
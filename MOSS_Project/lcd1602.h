@@ -47,6 +47,7 @@
 //-----------------------------------------------------------------------------
 #include <stdint.h>
 #include <stdio.h>
+#include <stdbool.h>
 
 //-----------------------------------------------------------------------------
 // Loads MSP launchpad board support macros and definitions
@@ -167,6 +168,13 @@
 
 #define DEGREE_SYMBOL                                               (0b11011111)
 
+// Port expander bytes needed to clock one byte into the LCD in 4-bit mode.
+// A flush sends at most 17 writes per line (changed characters plus an
+// address command per run of them) and one byte to release R/W.
+#define LCD1602_BYTES_PER_WRITE                                              (6)
+#define LCD1602_LINE_BURST_SIZE              ((CHARACTERS_PER_LCD_LINE + 1) * 6)
+#define LCD1602_FLUSH_BUFFER_SIZE  (LINES_PER_LCD * LCD1602_LINE_BURST_SIZE + 1)
+
 // ----------------------------------------------------------------------------
 // Prototype for support functions
 // ----------------------------------------------------------------------------
@@ -176,6 +184,8 @@ void lcd_set_ddram_addr(uint8_t address);
 void lcd_write_char(uint8_t character);
 void lcd_write_string(const char *string);
 uint32_t lcd1602_write(uint8_t iic_addr, uint8_t data, uint8_t reg_select);
+uint32_t lcd1602_flush(void);
+bool lcd1602_is_dirty(void);
 void lcd_set_backlight_on(void);
 void lcd_set_backlight_off(void);
 void hex_to_lcd(uint8_t hex_value);
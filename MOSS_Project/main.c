@@ -20,37 +20,78 @@
 // Loads standard C include files
 //------------------------------------------------------------------------------
 #include <stdio.h>
+#include <string.h>
 
 //------------------------------------------------------------------------------
 // Loads MSP launchpad board support macros and definitions
 //------------------------------------------------------------------------------
 #include <ti/devices/msp/msp.h>
+#include "LaunchPad.h"
 #include "kernel.h"
 #include "shell.h"
+#include "isr.h"
+#include "adc.h"
+#include "lcd1602.h"
+#include "filter.h"
+#include "history.h"
+#include "flash.h"
+#include "store.h"
+#include "timer.h"
 
 //------------------------------------------------------------------------------
 // Define function prototypes used by the program
 //------------------------------------------------------------------------------
 void system_init(void);
+void lcd_task(void);
+void sensor_task(void);
+void history_save_block(uint8_t channel, const uint8_t *data,
+                        uint16_t length);
+bool load_setting_u16(uint8_t key, uint16_t *value);
+void heartbeat_toggle(void *arg);
+void lcd_temp_due(void *arg);
 
 
 //------------------------------------------------------------------------------
 // Define symbolic constants used by the program
 //------------------------------------------------------------------------------
+#define SHELL_TASK_STACK_SIZE                                             (2048)
+#define LCD_TASK_STACK_SIZE                                               (1024)
+#define SENSOR_TASK_STACK_SIZE                                            (1024)
+#define TIMER_TASK_STACK_SIZE                                              (512)
+#define SENSOR_SAMPLE_PERIOD_MS                                           (1000)
+#define LCD_TEMP_UPDATE_MS                                               (10000)
+#define HEARTBEAT_TOGGLE_MS                                                (250)
+#define SENSOR_MEDIAN_LENGTH                                                 (5)
+#define SENSOR_IIR_SHIFT                                                     (2)
+
+// Save one full history block in this many to the store. A block holds about
+// 4 minutes of samples and a sector 3 blocks, so saving every block would
+// erase each of the 8 sectors some 5000 times a year. One in 8 keeps a 4
+// minute window of every half hour and about 650 erases per sector a year,
+// some 15 years of the 10000-cycle flash endurance.
+#define HISTORY_SAVE_EVERY_BLOCKS                                            (8)
 
 
 //------------------------------------------------------------------------------
 // Define global variables and structures here.
 // NOTE: when possible avoid using global variables
 //------------------------------------------------------------------------------
+// Latest thermistor reading from the sensor task, shown by the LCD task
+static volatile uint16_t g_adc_temp_result = 0;
+
+static timer_struct g_heartbeat_timer;
+static timer_struct g_lcd_temp_timer;
 
 
 int main(void)
 {
   system_init();
   
-  // Endless loop to prevent program from ending
-  while (1);
+  // Endless loop to prevent program from ending, asleep between interrupts
+  while (1)
+  {
+    __WFI();
+  } /* while */
 
 } /* main */
 
@@ -58,7 +99,11 @@ int main(void)
 //------------------------------------------------------------------------------
 // DESCRIPTION:
 //  This function initializes the system by calling the initialization functions
-//  for the kernel and shell. It also starts the shell loop.
+//  for the kernel and shell, mounts the flash store and starts the temperature
+//  history, one in HISTORY_SAVE_EVERY_BLOCKS of whose full blocks is saved to
+//  the store. A thermistor band saved before the last reset is armed again. It then starts the heartbeat and LCD
+//  temperature timers, creates the shell, LCD, sensor and timer tasks and
+//  starts the scheduler, which does not return.
 //
 // INPUT PARAMETERS:
 //  none
@@ -71,7 +116,280 @@ int main(void)
 //------------------------------------------------------------------------------
 void system_init(void)
 {
+  uint16_t band_low;
+  uint16_t band_high;
+
   kernel_init();
   shell_init();
-  shell_loop();
+  store_init(flash_get_device());
+
+  // The LCD task records the temperature every second
+  history_init();
+  history_start_channel(HISTORY_CHANNEL_TEMP, 1);
+  history_set_block_callback(history_save_block);
+
+  if (load_setting_u16(STORE_KEY_BAND_LOW, &band_low) &&
+      load_setting_u16(STORE_KEY_BAND_HIGH, &band_high))
+  {
+    ADC0_window_start(TEMP_SENSOR_CHANNEL, band_low, band_high);
+  } /* if */
+
+  timer_init();
+  timer_start(&g_heartbeat_timer, HEARTBEAT_TOGGLE_MS, HEARTBEAT_TOGGLE_MS,
+              heartbeat_toggle, NULL);
+  timer_start(&g_lcd_temp_timer, LCD_TEMP_UPDATE_MS, LCD_TEMP_UPDATE_MS,
+              lcd_temp_due, NULL);
+
+  kernel_create_task(shell_loop, SHELL_TASK_STACK_SIZE, "shell");
+  kernel_create_task(lcd_task, LCD_TASK_STACK_SIZE, "lcd");
+  kernel_create_task(sensor_task, SENSOR_TASK_STACK_SIZE, "sensor");
+  kernel_create_task(timer_task, TIMER_TASK_STACK_SIZE, "timer");
+  kernel_start();
 } /* system_init */
+
+
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//  This task updates the LCD. Every second, when the RTC signals, it writes
+//  the time, and every 10 seconds, when the LCD temperature timer signals, it
+//  writes the latest temperature sampled by the sensor task. The writes only
+//  change the LCD shadow buffer; the task then flushes whatever changed,
+//  including writes made by other tasks.
+//
+// INPUT PARAMETERS:
+//  none
+//
+// OUTPUT PARAMETERS:
+//  none
+//
+// RETURN:
+//  none
+//------------------------------------------------------------------------------
+void lcd_task(void)
+{
+  uint32_t events;
+
+  while (1)
+  {
+    events = kernel_wait_event(KERNEL_EVENT_RTC_SECOND |
+                               KERNEL_EVENT_LCD_TEMP |
+                               KERNEL_EVENT_LCD_DIRTY);
+
+    if (events & KERNEL_EVENT_RTC_SECOND)
+    {
+      history_add(HISTORY_CHANNEL_TEMP,
+                  RTC->HOUR * 3600 + RTC->MIN * 60 + RTC->SEC,
+                  thermistor_calc_temperature_x10(g_adc_temp_result));
+
+      lcd_set_ddram_addr(LCD_LINE1_ADDR);
+      lcd_write_time(RTC->HOUR, RTC->MIN, RTC->SEC);
+    } /* if */
+
+    if (events & KERNEL_EVENT_LCD_TEMP)
+    {
+      uint8_t temperature_c =
+                      thermistor_calc_temperature_x10(g_adc_temp_result) / 10;
+      uint8_t temperature_f = CONVERT_TO_FAHRENHEIT(temperature_c);
+
+      lcd_set_ddram_addr(LCD_LINE1_ADDR + LCD_CHAR_POSITION_12);
+      lcd_write_temp(temperature_f);
+    } /* if */
+
+    if (lcd1602_is_dirty())
+    {
+      lcd1602_flush();
+    } /* if */
+  } /* while */
+} /* lcd_task */
+
+
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//  This task keeps the latest thermistor reading. Normally it samples the
+//  thermistor once a second. While timed acquisition is running it instead
+//  drains the frames the ADC collects, filtering the thermistor results when
+//  the channel is in the list, and while the thermistor is watched with the
+//  window comparator it only wakes when the reading leaves the band. The ADC
+//  is shared with the shell temp and sample commands, so the scheduler is
+//  locked during a conversion.
+//
+// INPUT PARAMETERS:
+//  none
+//
+// OUTPUT PARAMETERS:
+//  none
+//
+// RETURN:
+//  none
+//------------------------------------------------------------------------------
+void sensor_task(void)
+{
+  uint16_t frame[ADC0_STREAM_MAX_CHANNELS];
+  adc_window_status_struct status;
+  filter_chain_struct chain;
+  int32_t filtered;
+  int8_t slot;
+
+  // Timed readings lose single-sample spikes, then get smoothed
+  filter_chain_init(&chain);
+  filter_chain_add_median(&chain, SENSOR_MEDIAN_LENGTH);
+  filter_chain_add_iir(&chain, SENSOR_IIR_SHIFT);
+
+  while (1)
+  {
+    if (ADC0_timed_busy())
+    {
+      kernel_wait_event(KERNEL_EVENT_ADC_DATA);
+
+      slot = ADC0_timed_slot(TEMP_SENSOR_CHANNEL);
+      while (ADC0_timed_read(frame, 1) > 0)
+      {
+        if ((slot >= 0) &&
+            filter_chain_process(&chain, frame[slot], &filtered))
+        {
+          g_adc_temp_result = filtered;
+        } /* if */
+      } /* while */
+      continue;
+    } /* if */
+
+    if (ADC0_window_busy())
+    {
+      // Only woken when the reading has moved out of the band
+      kernel_wait_event(KERNEL_EVENT_ADC_WINDOW);
+
+      ADC0_window_get_status(&status);
+      if (status.channel == TEMP_SENSOR_CHANNEL)
+      {
+        g_adc_temp_result = status.value;
+      } /* if */
+      continue;
+    } /* if */
+
+    // Leave the ADC alone while the shell is using it
+    kernel_lock();
+    if (!ADC0_busy())
+    {
+      g_adc_temp_result = ADC0_in(TEMP_SENSOR_CHANNEL);
+    } /* if */
+    kernel_unlock();
+
+    kernel_sleep(SENSOR_SAMPLE_PERIOD_MS);
+  } /* while */
+} /* sensor_task */
+
+
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//  This function reads a 16-bit setting from the flash store. The value is
+//  read into a buffer that takes any stored length, and only a value of the
+//  expected size is used.
+//
+// INPUT PARAMETERS:
+//  key - the setting
+//
+// OUTPUT PARAMETERS:
+//  value - the setting, if it is set and 16 bits long
+//
+// RETURN:
+//  true  - if the setting was read
+//  false - if it is not set or has the wrong length
+//------------------------------------------------------------------------------
+bool load_setting_u16(uint8_t key, uint16_t *value)
+{
+  uint8_t buffer[STORE_VALUE_MAX];
+  uint8_t length;
+
+  if (!store_get(key, buffer, &length) || length != sizeof(*value))
+  {
+    return false;
+  } /* if */
+
+  memcpy(value, buffer, sizeof(*value));
+
+  return true;
+} /* load_setting_u16 */
+
+
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//  This function saves full blocks of the history to the flash store. It is
+//  called by the history from the LCD task. Only one block in
+//  HISTORY_SAVE_EVERY_BLOCKS is written, to spread the flash wear over the
+//  life of the part; the RAM history keeps every recent block. The shell
+//  uses the store too, so the scheduler is held while the block is written.
+//
+// INPUT PARAMETERS:
+//  channel - the history channel the block belongs to
+//  data    - the encoded block
+//  length  - the length of the block in bytes
+//
+// OUTPUT PARAMETERS:
+//  none
+//
+// RETURN:
+//  none
+//------------------------------------------------------------------------------
+void history_save_block(uint8_t channel, const uint8_t *data,
+                        uint16_t length)
+{
+  static uint8_t skipped = HISTORY_SAVE_EVERY_BLOCKS - 1;
+
+  if (++skipped < HISTORY_SAVE_EVERY_BLOCKS)
+  {
+    return;
+  } /* if */
+  skipped = 0;
+
+  kernel_lock();
+  store_append_block(channel, data, length);
+  kernel_unlock();
+} /* history_save_block */
+
+
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//  This timer callback blinks the red LED as a heartbeat.
+//
+// INPUT PARAMETERS:
+//  arg - not used
+//
+// OUTPUT PARAMETERS:
+//  none
+//
+// RETURN:
+//  none
+//------------------------------------------------------------------------------
+void heartbeat_toggle(void *arg)
+{
+  static bool led_on = false;
+
+  led_on = !led_on;
+  if (led_on)
+  {
+    lp_leds_on(LP_RED_LED1_IDX);
+  } /* if */
+  else
+  {
+    lp_leds_off(LP_RED_LED1_IDX);
+  } /* else */
+} /* heartbeat_toggle */
+
+
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//  This timer callback tells the LCD task to write the temperature.
+//
+// INPUT PARAMETERS:
+//  arg - not used
+//
+// OUTPUT PARAMETERS:
+//  none
+//
+// RETURN:
+//  none
+//------------------------------------------------------------------------------
+void lcd_temp_due(void *arg)
+{
+  kernel_signal_event(KERNEL_EVENT_LCD_TEMP);
+} /* lcd_temp_due */
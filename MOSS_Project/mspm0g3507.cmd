@@ -35,7 +35,8 @@
 
 MEMORY
 {
-    FLASH           (RX)  : origin = 0x00000000, length = 0x00020000
+    FLASH           (RX)  : origin = 0x00000000, length = 0x0001E000
+    FLASH_STORE     (R)   : origin = 0x0001E000, length = 0x00002000
     SRAM            (RWX) : origin = 0x20200000, length = 0x00008000
     BCR_CONFIG      (R)   : origin = 0x41C00000, length = 0x00000080
     BSL_CONFIG      (R)   : origin = 0x41C00100, length = 0x00000080
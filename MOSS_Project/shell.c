@@ -13,8 +13,12 @@
 //    to interact with a microcontroller. The shell supports basic commands 
 //    such as displaying help, measuring clock speed, reading temperature from
 //    a thermistor, displaying the current RTC time, running LCD color test,
-//    and clearing the terminal. The shell uses UART for communication and 
-//    displays output to both the UART and an LCD display.
+//    clearing the terminal and showing driver traffic counters. The shell 
+//    uses UART for communication and displays output to both the UART and an
+//    LCD display.
+//
+//    The LCD side goes through the text-mode console in console.c, which
+//    keeps the characters on screen and only redraws cells that changed.
 //
 //-----------------------------------------------------------------------------
 // DISCLAIMER
@@ -39,6 +43,8 @@
 
 #include <ti/devices/msp/msp.h>
 #include <ti/devices/msp/m0p/mspm0g350x.h>
+#include <math.h>
+#include <stdlib.h>
 #include <string.h>
 #include "shell.h"
 #include "uart.h"
@@ -47,12 +53,46 @@
 #include "clock.h"
 #include "adc.h"
 #include "ili9341.h"
+#include "spi.h"
+#include "LaunchPad.h"
+#include "console.h"
+#include "filter.h"
+#include "history.h"
+#include "store.h"
+
+
+//-----------------------------------------------------------------------------
+// Define global variables and structures here.
+// NOTE: when possible avoid using global variables
+//-----------------------------------------------------------------------------
+
+// Results gathered by the sample command from the ADC stream callback. Each
+// result also goes through a filter chain that drops spikes and decimates.
+typedef struct
+{
+  volatile uint32_t   count;
+  volatile uint32_t   sum;
+  volatile uint32_t   filtered_count;
+  volatile int32_t    filtered;
+  filter_chain_struct chain;
+} shell_sample_struct;
+
+static shell_sample_struct g_shell_sample = {0};
+
+// Stream buffer for the sample command, both halves
+static uint16_t g_shell_sample_buffer[SHELL_SAMPLE_BUFFER_SIZE];
+
+
+//-----------------------------------------------------------------------------
+// Prototype for local functions
+//-----------------------------------------------------------------------------
+static void shell_sample_callback(const uint16_t *samples, uint16_t count);
 
 
 //------------------------------------------------------------------------------
 // DESCRIPTION:
-//  This function initializes the shell by initializing the UART and writing a
-//  welcome message to the UART.
+//  This function initializes the shell by initializing the UART, setting up the
+//  LCD console and writing a welcome message to the UART.
 //
 // INPUT PARAMETERS:
 //  none
@@ -66,6 +106,7 @@
 void shell_init(void)
 {
   UART_init(BAUD_RATE);
+  console_init();
   UART_write_string("\nWelcome back!\n");
 } /* shell_init */
 
@@ -106,7 +147,7 @@ void shell_loop(void)
         if (buffer_index > 0)
         {
           buffer_index--;
-          shell_erase_char(buffer[buffer_index]);
+          shell_erase_char();
         } /* if */
       } /* else if */
       else {
@@ -146,31 +187,58 @@ void shell_handle_input(char* input)
   {
     UART_write_string("Available commands:\r\n");
     UART_write_string("  help  - Show this help message\r\n");
-    UART_write_string("  clock - Measure clock speed\r\n");
+    UART_write_string("  clock [list | <MHz>] - Measure, list or set clock\r\n");
     UART_write_string("  temp  - Read temperature from thermistor\r\n");
     UART_write_string("  time  - Display current RTC time\r\n");
     UART_write_string("  color - Run LCD color test\r\n");
     UART_write_string("  clear - Clear the terminal\r\n");
+    UART_write_string("  stats - Show driver traffic since last stats\r\n");
+    UART_write_string("  scroll - Time console scrolling\r\n");
+    UART_write_string("  cache - Show glyph cache hit rate\r\n");
+    UART_write_string("  strip - Time the band renderer\r\n");
+    UART_write_string("  tconv - Check the temperature conversion\r\n");
+    UART_write_string("  sample - Stream the thermistor for a second\r\n");
+    UART_write_string("  acq [stop | <period_us> <ch> ...] - Timed ADC\r\n");
+    UART_write_string("  band [stop | <low> <high>] - Watch thermistor\r\n");
+    UART_write_string("  history - Dump the temperature history\r\n");
+    UART_write_string("  store - Show flash store usage and wear\r\n");
     shell_draw_string("Available commands:\r\n");
     shell_draw_string("help - Show this help message\r\n");
-    shell_draw_string("clock - Measure clock speed\r\n");
+    shell_draw_string("clock - Measure/set clock\r\n");
     shell_draw_string("temp - Read temperature from thermistor\r\n");
     shell_draw_string("time - Display current RTC time\r\n");
     shell_draw_string("color - Run LCD color test\r\n");
     shell_draw_string("clear - Clear the terminal\r\n");
+    shell_draw_string("stats - Show driver traffic\r\n");
+    shell_draw_string("scroll - Time console scrolling\r\n");
+    shell_draw_string("cache - Show glyph cache hit rate\r\n");
+    shell_draw_string("strip - Time the band renderer\r\n");
+    shell_draw_string("tconv - Check temperature conversion\r\n");
+    shell_draw_string("sample - Stream the thermistor\r\n");
+    shell_draw_string("acq - Timed ADC acquisition\r\n");
+    shell_draw_string("band - Watch thermistor band\r\n");
+    shell_draw_string("history - Dump temperature log\r\n");
+    shell_draw_string("store - Show flash store\r\n");
   } /* if */
-  else if (strcmp(input, "clock") == 0)
+  else if ((strncmp(input, "clock", 5) == 0) &&
+           ((input[5] == ' ') || (input[5] == NULL_CHAR)))
   {
-    uint32_t clock_measurement = measure_clock();
-    char output_buffer[50];
-    sprintf(output_buffer, "Clock cycles in 100ms: %u\r\n", clock_measurement);
-    UART_write_string(output_buffer);
-    shell_draw_string(output_buffer);
+    shell_clock_command(input + 5);
+  } /* else if */
+  else if ((strcmp(input, "temp") == 0) && ADC0_busy())
+  {
+    // Timed acquisition or window monitoring owns the ADC until stopped
+    UART_write_string("ADC busy, run acq stop or band stop\r\n");
+    shell_draw_string("ADC busy\r\n");
   } /* else if */
   else if (strcmp(input, "temp") == 0)
   {
+    // The sensor task samples the ADC too, so hold the scheduler meanwhile
+    kernel_lock();
     uint16_t adc_temp_result = ADC0_in(TEMP_SENSOR_CHANNEL);
-    uint8_t temperature_c = thermistor_calc_temperature(adc_temp_result);
+    kernel_unlock();
+    uint8_t temperature_c = thermistor_calc_temperature_x10(adc_temp_result) /
+                            10;
     uint8_t temperature_f = CONVERT_TO_FAHRENHEIT(temperature_c);
     char output_buffer[50];
     sprintf(output_buffer, "Temperature: %dC / %dF\r\n", temperature_c, 
@@ -188,22 +256,73 @@ void shell_handle_input(char* input)
   } /* else if */
   else if (strcmp(input, "color") == 0)
   {
-    ili9341_fill_screen(ILI9341_BLACK);
-    msec_delay(500);
-    ili9341_fill_screen(ILI9341_RED);
-    msec_delay(500);
-    ili9341_fill_screen(ILI9341_GREEN);
-    msec_delay(500);
-    ili9341_fill_screen(ILI9341_BLUE);
-    msec_delay(500);
-    ili9341_fill_screen(ILI9341_WHITE);
-    msec_delay(500);
+    static const uint16_t test_colors[] = {ILI9341_BLACK, ILI9341_RED,
+                                           ILI9341_GREEN, ILI9341_BLUE};
+    uint32_t fill_ms = 0;
+    uint32_t start_ticks;
+
+    for (uint8_t i = 0; i < SHELL_COLOR_TEST_COUNT; i++)
+    {
+      start_ticks = kernel_get_ticks();
+      ili9341_fill_screen(test_colors[i]);
+      spi1_wait_async();
+      fill_ms += kernel_get_ticks() - start_ticks;
+      kernel_sleep(500);
+    } /* for */
+    console_clear();
+    shell_show_fill_time(fill_ms / SHELL_COLOR_TEST_COUNT);
   } /* else if */
   else if (strcmp(input, "clear") == 0)
   {
+    uint32_t start_ticks;
+
     UART_write_string("\033[2J\033[H");
-    ili9341_fill_screen(ILI9341_WHITE);
-    set_cursor_position(0, SHELL_LINE_HEIGHT);
+    start_ticks = kernel_get_ticks();
+    console_clear();
+    spi1_wait_async();
+    shell_show_fill_time(kernel_get_ticks() - start_ticks);
+  } /* else if */
+  else if (strcmp(input, "stats") == 0)
+  {
+    shell_show_stats();
+  } /* else if */
+  else if (strcmp(input, "scroll") == 0)
+  {
+    shell_scroll_test();
+  } /* else if */
+  else if (strcmp(input, "cache") == 0)
+  {
+    shell_show_glyph_cache();
+  } /* else if */
+  else if (strcmp(input, "strip") == 0)
+  {
+    shell_strip_test();
+  } /* else if */
+  else if (strcmp(input, "tconv") == 0)
+  {
+    shell_temp_conv_test();
+  } /* else if */
+  else if (strcmp(input, "sample") == 0)
+  {
+    shell_sample_test();
+  } /* else if */
+  else if ((strncmp(input, "acq", 3) == 0) &&
+           ((input[3] == ' ') || (input[3] == NULL_CHAR)))
+  {
+    shell_acq_command(input + 3);
+  } /* else if */
+  else if ((strncmp(input, "band", 4) == 0) &&
+           ((input[4] == ' ') || (input[4] == NULL_CHAR)))
+  {
+    shell_band_command(input + 4);
+  } /* else if */
+  else if (strcmp(input, "history") == 0)
+  {
+    shell_history_command();
+  } /* else if */
+  else if (strcmp(input, "store") == 0)
+  {
+    shell_show_store();
   } /* else if */
   else
   {
@@ -219,7 +338,8 @@ void shell_handle_input(char* input)
 // DESCRIPTION:
 //  This function draws a single character on the LCD display at the current
 //  cursor position and then moves the cursor to the next position. If the
-//  cursor reaches the end of the line, it moves to the next line.
+//  cursor reaches the end of the line, it moves to the next line. A newline
+//  moves to the next console line and a carriage return to its start.
 //
 // INPUT PARAMETERS:
 //  c - the character to draw on the LCD
@@ -232,24 +352,19 @@ void shell_handle_input(char* input)
 //------------------------------------------------------------------------------
 void shell_draw_char(char c)
 {
-  ili9341_draw_char_at_cursor(c);
-  uint16_t x, y;
-  get_cursor_position(&x, &y);
-  if (x > ILI9341_TFTWIDTH - GLYPH_WIDTH)
-  {
-    shell_new_line();
-  } /* if */
+  console_put_char(c);
+  console_flush();
 } /*shell_draw_char */
 
 
 //------------------------------------------------------------------------------
 // DESCRIPTION:
-//  This function erases a single character on the LCD display at the current
-//  cursor position and then moves the cursor to the previous position. If the
-//  cursor reaches the beginning of the line, it moves to the previous line.
+//  This function erases the character before the cursor on the LCD display
+//  and moves the cursor back onto it. If the cursor is at the beginning of
+//  the line, it moves to the end of the previous line.
 //
 // INPUT PARAMETERS:
-//  c - the character to erase from the LCD
+//  none
 //
 // OUTPUT PARAMETERS:
 //  none
@@ -257,22 +372,10 @@ void shell_draw_char(char c)
 // RETURN:
 //  none
 //------------------------------------------------------------------------------
-void shell_erase_char(char c)
+void shell_erase_char(void)
 {
-  uint16_t x, y;
-  get_cursor_position(&x, &y);
-
-  if (x == 0 && y >= SHELL_LINE_HEIGHT)
-  {
-    set_cursor_position(
-      (SHELL_CHAR_PER_LINE - 1) * GLYPH_WIDTH, y - SHELL_LINE_HEIGHT
-    );
-  } /* if */
-  else if (x >= GLYPH_WIDTH)
-  {
-    set_cursor_position(x - GLYPH_WIDTH, y);
-  } /* else if */
-  ili9341_erase_char(c, ILI9341_WHITE);
+  console_backspace();
+  console_flush();
 } /* shell_erase_char */
 
 
@@ -280,7 +383,8 @@ void shell_erase_char(char c)
 // DESCRIPTION:
 //  This function draws a string of characters on the LCD display at the current
 //  cursor position and then moves the cursor to the next position. If the cursor
-//  reaches the end of the line, it moves to the next line.
+//  reaches the end of the line, it moves to the next line. The changed cells
+//  are drawn once the whole string is in the console.
 //
 // INPUT PARAMETERS:
 //  str - the string of characters to draw on the LCD
@@ -293,42 +397,818 @@ void shell_erase_char(char c)
 //------------------------------------------------------------------------------
 void shell_draw_string(char* str)
 {
-  while (*str != '\0')
+  console_write_string(str);
+  console_flush();
+} /* shell_draw_string */
+
+
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//  This function moves the cursor to the beginning of the next line on the LCD
+//  display. If the cursor is on the bottom line, the console scrolls up.
+//
+// INPUT PARAMETERS:
+//  none
+//
+// OUTPUT PARAMETERS:
+//  none
+//
+// RETURN:
+//  none
+//------------------------------------------------------------------------------
+void shell_new_line(void)
+{
+  console_new_line();
+  console_flush();
+} /* shell_new_line */
+
+
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//  This function measures how fast the LCD console scrolls. It prints a number
+//  of lines, each forcing a scroll, and reports lines per second. For
+//  comparison it also times one full-screen repaint, which is what every
+//  scroll used to cost.
+//
+// INPUT PARAMETERS:
+//  none
+//
+// OUTPUT PARAMETERS:
+//  none
+//
+// RETURN:
+//  none
+//------------------------------------------------------------------------------
+void shell_scroll_test(void)
+{
+  char output_buffer[50];
+  uint32_t start_ticks;
+  uint32_t scroll_ms;
+  uint32_t repaint_ms;
+  uint8_t i;
+
+  start_ticks = kernel_get_ticks();
+  for (i = 0; i < SHELL_SCROLL_TEST_LINES; i++)
+  {
+    sprintf(output_buffer, "line %u\r\n", i);
+    shell_draw_string(output_buffer);
+  } /* for */
+  spi1_wait_async();
+  scroll_ms = kernel_get_ticks() - start_ticks;
+
+  start_ticks = kernel_get_ticks();
+  ili9341_fill_screen(ILI9341_WHITE);
+  spi1_wait_async();
+  repaint_ms = kernel_get_ticks() - start_ticks;
+  console_clear();
+
+  if (scroll_ms == 0)
+  {
+    scroll_ms = 1;
+  } /* if */
+  sprintf(output_buffer, "Scroll: %u lines/s\r\n",
+          SHELL_SCROLL_TEST_LINES * 1000 / scroll_ms);
+  UART_write_string(output_buffer);
+  shell_draw_string(output_buffer);
+  sprintf(output_buffer, "Full repaint: %u ms\r\n", repaint_ms);
+  UART_write_string(output_buffer);
+  shell_draw_string(output_buffer);
+} /* shell_scroll_test */
+
+
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//  This function shows how much traffic each driver has moved, and how much
+//  of the time the core slept, since the last time it was called, then
+//  clears the counters. Running a command between two stats commands
+//  measures the cost of that command.
+//
+// INPUT PARAMETERS:
+//  none
+//
+// OUTPUT PARAMETERS:
+//  none
+//
+// RETURN:
+//  none
+//------------------------------------------------------------------------------
+void shell_show_stats(void)
+{
+  spi1_stats_struct spi_stats;
+  uart_stats_struct uart_stats;
+  i2c_stats_struct i2c_stats;
+  kernel_idle_stats_struct idle_stats;
+  uint32_t tft_cmds = ili9341_get_cmd_count();
+  uint32_t asleep_permille;
+  char output_buffer[60];
+
+  // Snapshot and clear first so the output below counts toward the next run
+  spi1_get_stats(&spi_stats);
+  UART_get_stats(&uart_stats);
+  I2C_get_stats(&i2c_stats);
+  kernel_get_idle_stats(&idle_stats);
+  spi1_clear_stats();
+  UART_clear_stats();
+  I2C_clear_stats();
+  ili9341_clear_cmd_count();
+  kernel_clear_idle_stats();
+
+  sprintf(output_buffer, "SPI1: %u bytes, %u DMA\r\n", spi_stats.tx_bytes,
+          spi_stats.dma_xfers);
+  UART_write_string(output_buffer);
+  shell_draw_string(output_buffer);
+  sprintf(output_buffer, "TFT: %u commands\r\n", tft_cmds);
+  UART_write_string(output_buffer);
+  shell_draw_string(output_buffer);
+  sprintf(output_buffer, "UART0: %u tx, %u rx, %u drop\r\n",
+          uart_stats.tx_bytes, uart_stats.rx_bytes, uart_stats.rx_dropped);
+  UART_write_string(output_buffer);
+  shell_draw_string(output_buffer);
+  sprintf(output_buffer, "I2C1: %u xfers, %u nack, %u arb\r\n",
+          i2c_stats.xfers, i2c_stats.nacks, i2c_stats.arb_lost);
+  UART_write_string(output_buffer);
+  shell_draw_string(output_buffer);
+
+  asleep_permille = idle_stats.elapsed_ms ?
+                    (uint64_t)idle_stats.asleep_ms * 1000 /
+                    idle_stats.elapsed_ms : 0;
+  sprintf(output_buffer, "CPU: asleep %u.%u%% of %u ms, %u wakes\r\n",
+          asleep_permille / 10, asleep_permille % 10, idle_stats.elapsed_ms,
+          idle_stats.wakeups);
+  UART_write_string(output_buffer);
+  shell_draw_string(output_buffer);
+} /* shell_show_stats */
+
+
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//  This function times the band renderer. It composes a full-screen test card
+//  of colored bars with labels and a panel overlapping them, which would take
+//  several SPI passes per pixel if drawn directly, and sends it in one pass.
+//  The card stays up for a second before the console is cleared and the
+//  time is shown.
+//
+// INPUT PARAMETERS:
+//  none
+//
+// OUTPUT PARAMETERS:
+//  none
+//
+// RETURN:
+//  none
+//------------------------------------------------------------------------------
+void shell_strip_test(void)
+{
+  static const uint16_t bar_colors[] = {ILI9341_RED, ILI9341_GREEN,
+                                        ILI9341_BLUE, ILI9341_YELLOW};
+  static const char *bar_names[] = {"RED", "GREEN", "BLUE", "YELLOW"};
+  char output_buffer[50];
+  uint32_t start_ticks;
+  uint32_t strip_ms;
+  uint16_t bar_h = ILI9341_TFTHEIGHT / SHELL_STRIP_TEST_BARS;
+  uint8_t i;
+
+  // The card is drawn in panel memory order, so undo any console scroll
+  ili9341_scroll_to(0);
+
+  start_ticks = kernel_get_ticks();
+  ili9341_strip_begin(0, 0, ILI9341_TFTWIDTH, ILI9341_TFTHEIGHT,
+                      ILI9341_BLACK);
+  for (i = 0; i < SHELL_STRIP_TEST_BARS; i++)
+  {
+    ili9341_strip_fill_rect(0, i * bar_h, ILI9341_TFTWIDTH, bar_h,
+                            bar_colors[i]);
+    ili9341_strip_draw_text(bar_names[i], GLYPH_WIDTH, i * bar_h +
+                            CONSOLE_BASELINE, ILI9341_BLACK);
+  } /* for */
+  ili9341_strip_fill_rect(ILI9341_TFTWIDTH / 4, ILI9341_TFTHEIGHT / 4 + 8,
+                          ILI9341_TFTWIDTH / 2, ILI9341_TFTHEIGHT / 2,
+                          ILI9341_WHITE);
+  ili9341_strip_draw_text("STRIP", ILI9341_TFTWIDTH / 2 - 2 * GLYPH_WIDTH -
+                          GLYPH_WIDTH / 2, ILI9341_TFTHEIGHT / 2 + 8,
+                          ILI9341_BLACK);
+  ili9341_strip_end();
+  spi1_wait_async();
+  strip_ms = kernel_get_ticks() - start_ticks;
+
+  kernel_sleep(1000);
+  console_clear();
+
+  sprintf(output_buffer, "Strip: %u ms\r\n", strip_ms);
+  UART_write_string(output_buffer);
+  shell_draw_string(output_buffer);
+} /* shell_strip_test */
+
+
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//  This function checks the table-based temperature conversion against the
+//  polynomial it was generated from. It runs both over every 12-bit ADC code,
+//  reports the worst error in tenths of a degree and the average number of
+//  CPU cycles each conversion takes.
+//
+// INPUT PARAMETERS:
+//  none
+//
+// OUTPUT PARAMETERS:
+//  none
+//
+// RETURN:
+//  none
+//------------------------------------------------------------------------------
+void shell_temp_conv_test(void)
+{
+  char output_buffer[50];
+  uint64_t start_us;
+  uint32_t float_us;
+  uint32_t fixed_us;
+  uint32_t cycles_per_us = get_bus_clock_freq() / TIME_BASE_FREQ;
+  volatile int32_t sink = 0;
+  int32_t error;
+  int32_t max_error = 0;
+  uint16_t code;
+
+  for (code = 0; code <= ADC_MAX_CODE; code++)
+  {
+    error = thermistor_calc_temperature_x10(code) -
+            (int32_t)lroundf(thermistor_calc_temperature(code) * 10);
+    if (error < 0)
+    {
+      error = -error;
+    } /* if */
+    if (error > max_error)
+    {
+      max_error = error;
+    } /* if */
+  } /* for */
+
+  start_us = now_us();
+  for (code = 0; code <= ADC_MAX_CODE; code++)
+  {
+    sink += (int32_t)thermistor_calc_temperature(code);
+  } /* for */
+  float_us = now_us() - start_us;
+
+  start_us = now_us();
+  for (code = 0; code <= ADC_MAX_CODE; code++)
+  {
+    sink += thermistor_calc_temperature_x10(code);
+  } /* for */
+  fixed_us = now_us() - start_us;
+
+  sprintf(output_buffer, "Max error: %d tenths\r\n", max_error);
+  UART_write_string(output_buffer);
+  shell_draw_string(output_buffer);
+  sprintf(output_buffer, "Float: %u cycles\r\n",
+          float_us * cycles_per_us / (ADC_MAX_CODE + 1));
+  UART_write_string(output_buffer);
+  shell_draw_string(output_buffer);
+  sprintf(output_buffer, "Table: %u cycles\r\n",
+          fixed_us * cycles_per_us / (ADC_MAX_CODE + 1));
+  UART_write_string(output_buffer);
+  shell_draw_string(output_buffer);
+} /* shell_temp_conv_test */
+
+
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//  This function streams the thermistor channel through the ADC FIFO and DMA
+//  for a second, with 4x hardware averaging, and reports the sustained
+//  result rate and the mean temperature. The CPU only runs once per half
+//  buffer. The results are also run through a median and CIC decimator
+//  chain and the last filtered temperature is shown.
+//
+// INPUT PARAMETERS:
+//  none
+//
+// OUTPUT PARAMETERS:
+//  none
+//
+// RETURN:
+//  none
+//------------------------------------------------------------------------------
+void shell_sample_test(void)
+{
+  static const uint8_t channels[] = {TEMP_SENSOR_CHANNEL};
+  char output_buffer[50];
+  uint32_t count;
+  int16_t temperature;
+  bool started;
+
+  g_shell_sample.count = 0;
+  g_shell_sample.sum = 0;
+  g_shell_sample.filtered_count = 0;
+  g_shell_sample.filtered = 0;
+  filter_chain_init(&g_shell_sample.chain);
+  filter_chain_add_median(&g_shell_sample.chain, SHELL_SAMPLE_MEDIAN_LENGTH);
+  filter_chain_add_cic(&g_shell_sample.chain, SHELL_SAMPLE_DECIMATE_LOG2,
+                       SHELL_SAMPLE_CIC_ORDER);
+
+  kernel_lock();
+  started = ADC0_stream_start(channels, sizeof(channels),
+                              g_shell_sample_buffer, SHELL_SAMPLE_BUFFER_SIZE,
+                              SHELL_SAMPLE_AVG_LOG2, shell_sample_callback);
+  kernel_unlock();
+
+  if (!started)
+  {
+    UART_write_string("ADC busy\r\n");
+    shell_draw_string("ADC busy\r\n");
+    return;
+  } /* if */
+
+  kernel_sleep(1000);
+  ADC0_stream_stop();
+
+  count = g_shell_sample.count;
+  if (count == 0)
+  {
+    count = 1;
+  } /* if */
+  temperature = thermistor_calc_temperature_x10(g_shell_sample.sum / count);
+
+  sprintf(output_buffer, "Sampled: %u results/s\r\n", g_shell_sample.count);
+  UART_write_string(output_buffer);
+  shell_draw_string(output_buffer);
+  sprintf(output_buffer, "Mean: %d.%dC\r\n", temperature / 10,
+          temperature % 10);
+  UART_write_string(output_buffer);
+  shell_draw_string(output_buffer);
+
+  temperature = thermistor_calc_temperature_x10(g_shell_sample.filtered);
+  sprintf(output_buffer, "Filtered: %d.%dC (%u out)\r\n", temperature / 10,
+          temperature % 10, g_shell_sample.filtered_count);
+  UART_write_string(output_buffer);
+  shell_draw_string(output_buffer);
+} /* shell_sample_test */
+
+
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//  This function handles the acq command, which controls timed ADC
+//  acquisition. With a period in microseconds and a list of channels it
+//  (re)starts acquisition, "stop" stops it, and with no arguments it shows
+//  the current setup and how many frames were taken and dropped. The sensor
+//  task consumes the frames.
+//
+// INPUT PARAMETERS:
+//  args - the rest of the command line after "acq"
+//
+// OUTPUT PARAMETERS:
+//  none
+//
+// RETURN:
+//  none
+//------------------------------------------------------------------------------
+void shell_acq_command(char *args)
+{
+  uint8_t channels[ADC0_STREAM_MAX_CHANNELS];
+  adc_timed_stats_struct stats;
+  char output_buffer[80];
+  uint32_t period_us;
+  uint8_t channel_count = 0;
+  char *end;
+  bool started;
+  uint8_t i;
+
+  while (*args == ' ')
+  {
+    args++;
+  } /* while */
+
+  if (*args == NULL_CHAR)
+  {
+    ADC0_timed_get_stats(&stats);
+    channel_count = ADC0_timed_get_config(channels, &period_us);
+    sprintf(output_buffer, "Acq %s, %u us, ch",
+            ADC0_timed_busy() ? "on" : "off", period_us);
+    for (i = 0; i < channel_count; i++)
+    {
+      sprintf(output_buffer + strlen(output_buffer), " %u", channels[i]);
+    } /* for */
+    strcat(output_buffer, "\r\n");
+    UART_write_string(output_buffer);
+    shell_draw_string(output_buffer);
+    sprintf(output_buffer, "%u frames, %u dropped\r\n", stats.frames,
+            stats.dropped);
+    UART_write_string(output_buffer);
+    shell_draw_string(output_buffer);
+    return;
+  } /* if */
+
+  if (strcmp(args, "stop") == 0)
+  {
+    ADC0_timed_stop();
+    return;
+  } /* if */
+
+  period_us = strtoul(args, &end, 10);
+  args = end;
+  while (*args != NULL_CHAR && channel_count < ADC0_STREAM_MAX_CHANNELS)
   {
-    ili9341_draw_char_at_cursor(*str++);
-    uint16_t x, y;
-    get_cursor_position(&x, &y);
-    if (x > ILI9341_TFTWIDTH - GLYPH_WIDTH)
+    channels[channel_count] = strtoul(args, &end, 10);
+    if (end == args)
     {
-      shell_new_line();
+      break;
     } /* if */
+    channel_count++;
+    args = end;
   } /* while */
-} /* shell_draw_string */
+
+  // Restarting with a new setup, so let go of the old one first
+  kernel_lock();
+  ADC0_timed_stop();
+  started = ADC0_timed_start(channels, channel_count, period_us);
+  kernel_unlock();
+
+  if (!started)
+  {
+    sprintf(output_buffer, "Usage: acq <%u-%u us> <ch> ...\r\n",
+            ADC0_TIMED_MIN_PERIOD_US, ADC0_TIMED_MAX_PERIOD_US);
+    UART_write_string(output_buffer);
+    shell_draw_string(output_buffer);
+  } /* if */
+} /* shell_acq_command */
 
 
 //------------------------------------------------------------------------------
 // DESCRIPTION:
-//  This function moves the cursor to the beginning of the next line on the LCD
-//  display. If the cursor reaches the bottom of the display, it clears the
-//  display and resets the cursor to the top.
+//  This function handles the clock command. With no argument it measures the
+//  core clock against the time base. "list" shows the bus clock speeds the
+//  SYSPLL can reach, in MHz. With one of them it switches the bus clock to
+//  that many MHz; the UART, SPI, I2C, ADC timer and SysTick follow the
+//  change, so the terminal and display keep working.
 //
 // INPUT PARAMETERS:
+//  args - the rest of the command line after "clock"
+//
+// OUTPUT PARAMETERS:
 //  none
 //
+// RETURN:
+//  none
+//------------------------------------------------------------------------------
+void shell_clock_command(char *args)
+{
+  char output_buffer[50];
+  uint32_t freqs[CLOCK_MAX_REACHABLE];
+  uint32_t mhz;
+  uint8_t count;
+  uint8_t length;
+  uint8_t i;
+  bool changed;
+
+  while (*args == ' ')
+  {
+    args++;
+  } /* while */
+
+  if (*args == NULL_CHAR)
+  {
+    sprintf(output_buffer, "Clock cycles in 100ms: %u\r\n", measure_clock());
+    UART_write_string(output_buffer);
+    shell_draw_string(output_buffer);
+    return;
+  } /* if */
+
+  if (strcmp(args, "list") == 0)
+  {
+    count = clock_reachable_freqs(freqs, CLOCK_MAX_REACHABLE);
+    length = 0;
+    for (i = 0; i < count; i++)
+    {
+      length += sprintf(output_buffer + length, "%3u",
+                        freqs[i] / 1000000);
+      if (((i + 1) % SHELL_CLOCK_LIST_PER_LINE == 0) || (i + 1 == count))
+      {
+        sprintf(output_buffer + length, "\r\n");
+        UART_write_string(output_buffer);
+        shell_draw_string(output_buffer);
+        length = 0;
+      } /* if */
+    } /* for */
+    return;
+  } /* if */
+
+  mhz = strtoul(args, NULL, 10);
+
+  // No task may start a transfer while the drivers are retuned
+  kernel_lock();
+  changed = clock_set_freq(mhz * 1000000);
+  kernel_unlock();
+
+  if (changed)
+  {
+    sprintf(output_buffer, "Bus clock: %u MHz\r\n",
+            get_bus_clock_freq() / 1000000);
+  } /* if */
+  else
+  {
+    sprintf(output_buffer, "No SYSPLL setting for %u MHz\r\n", mhz);
+  } /* else */
+  UART_write_string(output_buffer);
+  shell_draw_string(output_buffer);
+} /* shell_clock_command */
+
+
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//  This function handles the band command, which watches the thermistor with
+//  the ADC window comparator. With low and high ADC codes it (re)starts
+//  monitoring with that band and saves it to the flash store, so it is armed
+//  again after a reset; "stop" stops it and forgets it. With no arguments it
+//  shows the band now armed, the last out-of-band reading and how often the
+//  band has moved.
+//
+// INPUT PARAMETERS:
+//  args - the rest of the command line after "band"
+//
 // OUTPUT PARAMETERS:
 //  none
 //
 // RETURN:
 //  none
 //------------------------------------------------------------------------------
-void shell_new_line(void)
+void shell_band_command(char *args)
 {
-  uint16_t x, y;
-  get_cursor_position(&x, &y);
-  set_cursor_position(0, y + SHELL_LINE_HEIGHT);
-  if (y + SHELL_LINE_HEIGHT > ILI9341_TFTHEIGHT)
+  adc_window_status_struct status;
+  char output_buffer[50];
+  uint32_t low;
+  uint32_t high;
+  uint16_t band_low;
+  uint16_t band_high;
+  int16_t temperature;
+  char *end;
+  bool started;
+
+  while (*args == ' ')
   {
-    ili9341_fill_screen(ILI9341_WHITE);
-    set_cursor_position(0, SHELL_LINE_HEIGHT);
-  }
-} /* shell_new_line */
\ No newline at end of file
+    args++;
+  } /* while */
+
+  if (*args == NULL_CHAR)
+  {
+    ADC0_window_get_status(&status);
+    temperature = thermistor_calc_temperature_x10(status.value);
+    sprintf(output_buffer, "Band %s, %u-%u, %u moves\r\n",
+            ADC0_window_busy() ? "on" : "off", status.low, status.high,
+            status.events);
+    UART_write_string(output_buffer);
+    shell_draw_string(output_buffer);
+    sprintf(output_buffer, "Last: %u (%d.%dC)\r\n", status.value,
+            temperature / 10, temperature % 10);
+    UART_write_string(output_buffer);
+    shell_draw_string(output_buffer);
+    return;
+  } /* if */
+
+  if (strcmp(args, "stop") == 0)
+  {
+    kernel_lock();
+    ADC0_window_stop();
+    store_delete(STORE_KEY_BAND_LOW);
+    store_delete(STORE_KEY_BAND_HIGH);
+    kernel_unlock();
+    return;
+  } /* if */
+
+  low = strtoul(args, &end, 10);
+  high = strtoul(end, &end, 10);
+
+  // Restarting with a new band, so let go of the old one first
+  kernel_lock();
+  ADC0_window_stop();
+  started = (high <= ADC_MAX_CODE) &&
+            ADC0_window_start(TEMP_SENSOR_CHANNEL, low, high);
+
+  // Keep the band across resets
+  if (started)
+  {
+    band_low = low;
+    band_high = high;
+    store_set(STORE_KEY_BAND_LOW, &band_low, sizeof(band_low));
+    store_set(STORE_KEY_BAND_HIGH, &band_high, sizeof(band_high));
+  } /* if */
+  kernel_unlock();
+
+  if (!started)
+  {
+    sprintf(output_buffer, "Usage: band <low> <high> (0-%u)\r\n",
+            ADC_MAX_CODE);
+    UART_write_string(output_buffer);
+    shell_draw_string(output_buffer);
+  } /* if */
+} /* shell_band_command */
+
+
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//  This function handles the history command. It shows how much of the
+//  temperature history is held and how well it packs, then dumps every
+//  sample, oldest first, to the UART as "HH:MM:SS,degrees" lines that can be
+//  pasted into a spreadsheet. Lines are gathered into a buffer so the UART
+//  is written in a few large chunks rather than once per sample.
+//
+// INPUT PARAMETERS:
+//  none
+//
+// OUTPUT PARAMETERS:
+//  none
+//
+// RETURN:
+//  none
+//------------------------------------------------------------------------------
+void shell_history_command(void)
+{
+  history_stats_struct stats;
+  history_iter_struct iter;
+  char output_buffer[50];
+  char dump_buffer[SHELL_HISTORY_DUMP_SIZE];
+  uint16_t length = 0;
+  uint32_t time;
+  int32_t value;
+  uint32_t magnitude;
+
+  history_get_stats(HISTORY_CHANNEL_TEMP, &stats);
+  sprintf(output_buffer, "History: %u samples in %u blocks\r\n",
+          stats.samples, stats.blocks);
+  UART_write_string(output_buffer);
+  shell_draw_string(output_buffer);
+  sprintf(output_buffer, "%u bytes, %u.%02u bytes/sample\r\n", stats.bytes,
+          stats.samples ? stats.bytes / stats.samples : 0,
+          stats.samples ? (stats.bytes * 100 / stats.samples) % 100 : 0);
+  UART_write_string(output_buffer);
+  shell_draw_string(output_buffer);
+
+  history_iter_begin(&iter, HISTORY_CHANNEL_TEMP);
+  while (history_iter_next(&iter, &time, &value))
+  {
+    magnitude = (value < 0) ? -value : value;
+    length += sprintf(&dump_buffer[length], "%02u:%02u:%02u,%s%u.%u\r\n",
+                      time / 3600, (time / 60) % 60, time % 60,
+                      (value < 0) ? "-" : "", magnitude / 10,
+                      magnitude % 10);
+
+    // Flush before the next line could overrun the buffer
+    if (length > SHELL_HISTORY_DUMP_SIZE - SHELL_HISTORY_LINE_MAX)
+    {
+      UART_write_string(dump_buffer);
+      length = 0;
+    } /* if */
+  } /* while */
+
+  if (length > 0)
+  {
+    UART_write_string(dump_buffer);
+  } /* if */
+} /* shell_history_command */
+
+
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//  This function shows what the flash store holds, how evenly its sectors
+//  have been erased, and the write amplification since boot: the bytes
+//  programmed to flash, headers and padding included, per byte stored.
+//
+// INPUT PARAMETERS:
+//  none
+//
+// OUTPUT PARAMETERS:
+//  none
+//
+// RETURN:
+//  none
+//------------------------------------------------------------------------------
+void shell_show_store(void)
+{
+  store_stats_struct stats;
+  char output_buffer[80];
+  uint32_t amplification;
+
+  kernel_lock();
+  store_get_stats(&stats);
+  kernel_unlock();
+
+  sprintf(output_buffer, "Store: %u sectors, %u settings, %u blocks\r\n",
+          stats.sectors_used, stats.settings, stats.blocks);
+  UART_write_string(output_buffer);
+  shell_draw_string(output_buffer);
+  sprintf(output_buffer, "Erases: %u-%u per sector, %u since boot\r\n",
+          stats.erase_min, stats.erase_max, stats.erases);
+  UART_write_string(output_buffer);
+  shell_draw_string(output_buffer);
+
+  amplification = stats.user_bytes ? stats.flash_bytes * 100 /
+                                     stats.user_bytes : 0;
+  sprintf(output_buffer, "Wrote %u B for %u B (x%u.%02u)\r\n",
+          stats.flash_bytes, stats.user_bytes, amplification / 100,
+          amplification % 100);
+  UART_write_string(output_buffer);
+  shell_draw_string(output_buffer);
+} /* shell_show_store */
+
+
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//  This function shows how long a full-screen fill took, so the fill path can
+//  be compared between builds.
+//
+// INPUT PARAMETERS:
+//  fill_ms - time of one full-screen fill in milliseconds
+//
+// OUTPUT PARAMETERS:
+//  none
+//
+// RETURN:
+//  none
+//------------------------------------------------------------------------------
+void shell_show_fill_time(uint32_t fill_ms)
+{
+  char output_buffer[50];
+
+  sprintf(output_buffer, "Fill: %u ms\r\n", fill_ms);
+  UART_write_string(output_buffer);
+  shell_draw_string(output_buffer);
+} /* shell_show_fill_time */
+
+
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//  This function shows the glyph cache hit rate since the last time it was
+//  called, then clears the counters.
+//
+// INPUT PARAMETERS:
+//  none
+//
+// OUTPUT PARAMETERS:
+//  none
+//
+// RETURN:
+//  none
+//------------------------------------------------------------------------------
+void shell_show_glyph_cache(void)
+{
+  glyph_cache_stats_struct cache_stats;
+  uint32_t lookups;
+  uint32_t hit_rate = 0;
+  char output_buffer[50];
+
+  // Snapshot and clear first so the output below counts toward the next run
+  ili9341_get_glyph_cache_stats(&cache_stats);
+  ili9341_clear_glyph_cache_stats();
+
+  lookups = cache_stats.hits + cache_stats.misses;
+  if (lookups > 0)
+  {
+    hit_rate = cache_stats.hits * 100 / lookups;
+  } /* if */
+
+  sprintf(output_buffer, "Glyph cache: %u%% hit\r\n", hit_rate);
+  UART_write_string(output_buffer);
+  shell_draw_string(output_buffer);
+  sprintf(output_buffer, "%u hit, %u miss\r\n", cache_stats.hits,
+          cache_stats.misses);
+  UART_write_string(output_buffer);
+  shell_draw_string(output_buffer);
+  sprintf(output_buffer, "%u evict, %u slots\r\n", cache_stats.evictions,
+          ILI9341_GLYPH_CACHE_ENTRIES);
+  UART_write_string(output_buffer);
+  shell_draw_string(output_buffer);
+} /* shell_show_glyph_cache */
+
+
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//  This function is the ADC stream callback for the sample command. It runs
+//  in the DMA ISR, adds each half buffer of results to the totals and feeds
+//  them through the filter chain.
+//
+// INPUT PARAMETERS:
+//  samples - the results that just arrived
+//  count   - the number of results
+//
+// OUTPUT PARAMETERS:
+//  none
+//
+// RETURN:
+//  none
+//------------------------------------------------------------------------------
+static void shell_sample_callback(const uint16_t *samples, uint16_t count)
+{
+  uint32_t sum = 0;
+  int32_t filtered;
+  uint16_t i;
+
+  for (i = 0; i < count; i++)
+  {
+    sum += samples[i];
+    if (filter_chain_process(&g_shell_sample.chain, samples[i], &filtered))
+    {
+      g_shell_sample.filtered = filtered;
+      g_shell_sample.filtered_count++;
+    } /* if */
+  } /* for */
+
+  g_shell_sample.sum += sum;
+  g_shell_sample.count += count;
+} /* shell_sample_callback */
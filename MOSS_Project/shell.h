@@ -13,8 +13,9 @@
 //    to interact with a microcontroller. The shell supports basic commands 
 //    such as displaying help, measuring clock speed, reading temperature from
 //    a thermistor, displaying the current RTC time, running LCD color test,
-//    and clearing the terminal. The shell uses UART for communication and 
-//    displays output to both the UART and an LCD display.
+//    clearing the terminal and showing driver traffic counters. The shell 
+//    uses UART for communication and displays output to both the UART and an
+//    LCD display.
 //
 //-----------------------------------------------------------------------------
 // DISCLAIMER
@@ -47,14 +48,25 @@
 
 
 #include "ili9341.h"
+#include "console.h"
 
 
 //-----------------------------------------------------------------------------
 // Define symbolic constants used by the program
 //-----------------------------------------------------------------------------
 #define SHELL_MAX_INPUT_LENGTH                                             (128)
-#define SHELL_LINE_HEIGHT                                                   (25)
-#define SHELL_CHAR_PER_LINE                     (ILI9341_TFTWIDTH / GLYPH_WIDTH)
+#define SHELL_CHAR_PER_LINE                                    (CONSOLE_COLUMNS)
+#define SHELL_SCROLL_TEST_LINES                                             (50)
+#define SHELL_COLOR_TEST_COUNT                                               (4)
+#define SHELL_STRIP_TEST_BARS                                                (4)
+#define SHELL_SAMPLE_BUFFER_SIZE                                           (256)
+#define SHELL_SAMPLE_AVG_LOG2                                                (2)
+#define SHELL_SAMPLE_MEDIAN_LENGTH                                           (3)
+#define SHELL_SAMPLE_DECIMATE_LOG2                                           (5)
+#define SHELL_SAMPLE_CIC_ORDER                                               (2)
+#define SHELL_HISTORY_DUMP_SIZE                                            (256)
+#define SHELL_HISTORY_LINE_MAX                                              (24)
+#define SHELL_CLOCK_LIST_PER_LINE                                            (8)
 #define CARRIAGE_RETURN_CHAR                                              ('\r')
 #define NULL_CHAR                                                         ('\0')
 #define BACKSPACE_CHAR                                                    ('\b')
@@ -70,8 +82,20 @@ void shell_init(void);
 void shell_loop(void);
 void shell_handle_input(char* input);
 void shell_draw_char(char c);
-void shell_erase_char(char c);
+void shell_erase_char(void);
 void shell_draw_string(char* str);
 void shell_new_line(void);
+void shell_scroll_test(void);
+void shell_strip_test(void);
+void shell_temp_conv_test(void);
+void shell_sample_test(void);
+void shell_clock_command(char *args);
+void shell_acq_command(char *args);
+void shell_band_command(char *args);
+void shell_history_command(void);
+void shell_show_store(void);
+void shell_show_fill_time(uint32_t fill_ms);
+void shell_show_glyph_cache(void);
+void shell_show_stats(void);
 
 #endif /* __SHELL_H__ */
\ No newline at end of file
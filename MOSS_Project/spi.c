@@ -46,6 +46,7 @@
 //-----------------------------------------------------------------------------
 // Load standard C include files
 //-----------------------------------------------------------------------------
+#include <stddef.h>
 
 //-----------------------------------------------------------------------------
 // Loads MSP launchpad board support macros and definitions
@@ -57,6 +58,13 @@
 #include "spi.h"
 
 
+//-----------------------------------------------------------------------------
+// Define symbolic constants used by the program
+//-----------------------------------------------------------------------------
+// SPI1 clock kept across bus clock changes, the rate spi1_init_40mhz gives
+// at 80 MHz
+#define SPI1_BIT_RATE                                                 (20000000)
+
 
 // Define a structure to hold led configuration data
 typedef struct
@@ -77,6 +85,46 @@ const spi_struct lp_spi_config_data[] = {
 };
 
 
+// Define a structure to hold the state of the async DMA transmit
+typedef struct
+{
+  const void     *buffer;
+  uint16_t        count;
+  uint32_t        width;
+  uint32_t        remaining;
+  spi1_callback_t callback;
+  volatile bool   busy;
+} spi1_dma_xfer_struct;
+
+static spi1_dma_xfer_struct g_spi1_dma_xfer = {0};
+
+// Define a structure to hold the state of the async repeat transmit
+typedef struct
+{
+  uint32_t        remaining;
+  uint16_t        data;
+  spi1_callback_t callback;
+  volatile bool   busy;
+} spi1_repeat_xfer_struct;
+
+static spi1_repeat_xfer_struct g_spi1_repeat_xfer = {0};
+
+static spi1_stats_struct g_spi1_stats = {0};
+
+// Bits per frame SPI1 is currently set up for
+static uint8_t g_spi1_frame_bits = SPI1_FRAME_8BIT;
+
+
+//-----------------------------------------------------------------------------
+// Prototype for local functions
+//-----------------------------------------------------------------------------
+static bool spi1_dma_start(const void *buffer, uint16_t count,
+                           uint32_t total_count, uint32_t width,
+                           spi1_callback_t callback);
+static void spi1_clock_changed(uint8_t stage, uint32_t freq);
+static void spi1_repeat_start_chunk(void);
+
+
 
 //-----------------------------------------------------------------------------
 // DESCRIPTION:
@@ -162,6 +210,7 @@ void spi1_init(void)
                 SPI_CTL0_SPH_FIRST | SPI_CTL0_SPO_LOW | 
                 SPI_CTL0_PACKEN_DISABLED | SPI_CTL0_FRF_MOTOROLA_4WIRE | 
                 SPI_CTL0_DSS_DSS_8);
+  g_spi1_frame_bits = SPI1_FRAME_8BIT;
 
   // Configure SPI control register 1
   SPI1->CTL1 = (SPI_CTL1_RXTIMEOUT_MINIMUM | SPI_CTL1_REPEATTX_DISABLE |
@@ -189,6 +238,9 @@ void spi1_init(void)
 //    - Clock source: System clock
 //    - Clock division: 2
 //
+//    It also registers for bus clock changes, after which the SPI clock is
+//    set back to SPI1_BIT_RATE.
+//
 // INPUT PARAMETERS:
 //   none
 //
@@ -245,6 +297,7 @@ void spi1_init_40mhz(void)
                 SPI_CTL0_SPH_FIRST | SPI_CTL0_SPO_LOW | 
                 SPI_CTL0_PACKEN_DISABLED | SPI_CTL0_FRF_MOTOROLA_4WIRE | 
                 SPI_CTL0_DSS_DSS_8);
+  g_spi1_frame_bits = SPI1_FRAME_8BIT;
 
   // Configure SPI control register 1
   SPI1->CTL1 = (SPI_CTL1_RXTIMEOUT_MINIMUM | SPI_CTL1_REPEATTX_DISABLE |
@@ -254,9 +307,50 @@ void spi1_init_40mhz(void)
                 SPI_CTL1_POD_DISABLE | SPI_CTL1_CP_ENABLE | 
                 SPI_CTL1_LBM_DISABLE | SPI_CTL1_ENABLE_ENABLE);
 
+  clock_register_notifier(spi1_clock_changed);
+
 } /* spi1_init_80mhz */
 
 
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function keeps the SPI1 clock at SPI1_BIT_RATE across a bus clock
+//    change. Before the change it lets any async DMA transmit finish and
+//    the bus go idle. After it, SPI1 is briefly disabled while the clock
+//    divider and prescaler are set for the new bus clock:
+//    SPIClk = BusClock / (CLKDIV * (SCR + 1) * 2), with CLKDIV = 1.
+//
+// INPUT PARAMETERS:
+//   stage - CLOCK_CHANGE_PREPARE or CLOCK_CHANGE_COMMIT
+//   freq  - the new bus clock frequency in Hz
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+static void spi1_clock_changed(uint8_t stage, uint32_t freq)
+{
+  uint32_t scr;
+
+  if (stage == CLOCK_CHANGE_PREPARE)
+  {
+    spi1_wait_async();
+    return;
+  } /* if */
+
+  // Round the divide up, so the SPI clock never goes over the rate
+  scr = (freq / PD1_CPUCLK_CLKDIV + 2 * SPI1_BIT_RATE - 1) /
+        (2 * SPI1_BIT_RATE) - 1;
+
+  SPI1->CTL1 &= ~SPI_CTL1_ENABLE_MASK;
+  SPI1->CLKDIV = SPI_CLKDIV_RATIO_DIV_BY_1;
+  SPI1->CLKCTL = scr;
+  SPI1->CTL1 |= SPI_CTL1_ENABLE_ENABLE;
+} /* spi1_clock_changed */
+
+
 
 //-----------------------------------------------------------------------------
 // DESCRIPTION:
@@ -299,9 +393,70 @@ void spi1_write_data(uint8_t data)
   // Wait here until TX FIFO is not full
   while((SPI1->STAT & SPI_STAT_TNF_MASK) == SPI_STAT_TNF_FULL); 
   SPI1->TXDATA = data;
+  g_spi1_stats.tx_bytes++;
 } /* spi1_write_data */
 
 
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function writes one 16-bit frame to the SPI1 data register, waiting
+//    until the transmit FIFO is not full. SPI1 must be set to 16-bit frames
+//    with spi1_set_frame_size(). Each pixel of an RGB565 stream then costs
+//    one FIFO push and one status poll instead of two.
+//
+// INPUT PARAMETERS:
+//   data - the 16-bit frame to write, sent MSB first
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+void spi1_write_data16(uint16_t data)
+{
+  // Wait here until TX FIFO is not full
+  while((SPI1->STAT & SPI_STAT_TNF_MASK) == SPI_STAT_TNF_FULL); 
+  SPI1->TXDATA = data;
+  g_spi1_stats.tx_bytes += 2;
+} /* spi1_write_data16 */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function sets the number of bits SPI1 sends per frame. Commands go
+//    out as 8-bit frames and pixel streams as 16-bit frames. The function 
+//    waits for the bus to go idle and disables the module while the frame 
+//    size changes. It returns right away if the size is already set.
+//
+// INPUT PARAMETERS:
+//   bits - SPI1_FRAME_8BIT or SPI1_FRAME_16BIT
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+void spi1_set_frame_size(uint8_t bits)
+{
+  if (bits == g_spi1_frame_bits)
+  {
+    return;
+  } /* if */
+
+  spi1_wait_async();
+
+  SPI1->CTL1 &= ~SPI_CTL1_ENABLE_MASK;
+  SPI1->CTL0 = (SPI1->CTL0 & ~SPI_CTL0_DSS_MASK) | 
+               ((bits == SPI1_FRAME_16BIT) ? SPI_CTL0_DSS_DSS_16 : 
+                                             SPI_CTL0_DSS_DSS_8);
+  SPI1->CTL1 |= SPI_CTL1_ENABLE_ENABLE;
+
+  g_spi1_frame_bits = bits;
+} /* spi1_set_frame_size */
+
+
 //-----------------------------------------------------------------------------
 // DESCRIPTION:
 //    This function checks whether the SPI1 transmit FIFO is empty and the
@@ -376,3 +531,486 @@ bool spi1_received_data_ready(void)
   return (SPI1->STAT & SPI_STAT_RFE_MASK) != SPI_STAT_RFE_NOT_EMPTY;
 } /* spi1_received_data_ready */
 
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function configures the DMA channel used to feed the SPI1 transmit
+//    FIFO. The channel is triggered by the SPI1 TX DMA event whenever the TX
+//    FIFO drops below half full, moves one byte per trigger from an 
+//    incrementing source address to the fixed TXDATA register, and raises 
+//    the DMA interrupt when its block is done. It also enables the SPI1
+//    interrupt, which reloads the repeat counter during async repeat
+//    transmits. SPI1 must be initialized first.
+//
+// INPUT PARAMETERS:
+//   none
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+void spi1_dma_init(void)
+{
+  g_spi1_dma_xfer.busy = false;
+
+  // Raise the TX DMA trigger while the TX FIFO is half empty or more
+  SPI1->IFLS = (SPI1->IFLS & ~SPI_IFLS_TXIFLSEL_MASK) | 
+               SPI_IFLS_TXIFLSEL_LVL_1_2;
+  SPI1->DMA_TRIG_TX.IMASK = SPI_DMA_TRIG_TX_IMASK_TX_SET;
+
+  // Route the SPI1 TX event to the channel
+  DMA->DMATRIG[SPI1_DMA_TX_CHAN].DMATCTL = (DMA_DMATCTL_DMATINT_EXTERNAL |
+                                            DMA_SPI1_TX_TRIG);
+
+  DMA->DMACHAN[SPI1_DMA_TX_CHAN].DMADA = (uint32_t)&SPI1->TXDATA;
+  DMA->DMACHAN[SPI1_DMA_TX_CHAN].DMACTL = (DMA_DMACTL_DMATM_SINGLE | 
+                DMA_DMACTL_DMADSTINCR_UNCHANGED | 
+                DMA_DMACTL_DMASRCINCR_INCREMENT |
+                DMA_DMACTL_DMADSTWDTH_BYTE | DMA_DMACTL_DMASRCWDTH_BYTE |
+                DMA_DMACTL_DMAEM_NORMAL);
+
+  DMA->CPU_INT.ICLR = DMA_CPU_INT_ICLR_DMACH0_CLR;
+  DMA->CPU_INT.IMASK |= DMA_CPU_INT_IMASK_DMACH0_SET;
+  NVIC_EnableIRQ(DMA_INT_IRQn);
+
+  // The IDLE interrupt is only unmasked while a repeat transmit runs
+  g_spi1_repeat_xfer.busy = false;
+  SPI1->CPU_INT.IMASK &= ~SPI_CPU_INT_IMASK_IDLE_MASK;
+  NVIC_EnableIRQ(SPI1_INT_IRQn);
+} /* spi1_dma_init */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function arms the SPI1 DMA channel with the next chunk of the
+//    current transfer. A chunk is at most one pass through the source buffer.
+//
+// INPUT PARAMETERS:
+//   none
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+static void spi1_dma_start_chunk(void)
+{
+  uint16_t chunk = g_spi1_dma_xfer.count;
+
+  if (g_spi1_dma_xfer.remaining < chunk)
+  {
+    chunk = g_spi1_dma_xfer.remaining;
+  } /* if */
+  g_spi1_dma_xfer.remaining -= chunk;
+
+  DMA->DMACHAN[SPI1_DMA_TX_CHAN].DMASA = (uint32_t)g_spi1_dma_xfer.buffer;
+  DMA->DMACHAN[SPI1_DMA_TX_CHAN].DMASZ = chunk;
+  DMA->DMACHAN[SPI1_DMA_TX_CHAN].DMACTL =
+                (DMA->DMACHAN[SPI1_DMA_TX_CHAN].DMACTL &
+                 ~(DMA_DMACTL_DMASRCWDTH_MASK | DMA_DMACTL_DMADSTWDTH_MASK)) |
+                g_spi1_dma_xfer.width | DMA_DMACTL_DMAEN_ENABLE;
+} /* spi1_dma_start_chunk */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function starts a non-blocking transmit of a buffer over SPI1 using
+//    DMA and returns right away. The buffer must stay unchanged until the
+//    transfer completes. The callback (if not NULL) is called from the DMA 
+//    ISR once every byte has been written to the TX FIFO; the last few bytes
+//    may still be shifting out, so use spi1_wait_async() before changing 
+//    anything that depends on the bus being idle (e.g. a DC pin).
+//
+// INPUT PARAMETERS:
+//   buffer   - pointer to the bytes to transmit
+//   count    - number of bytes to transmit (1 to 65535)
+//   callback - function to call on completion, or NULL
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   true  - if the transfer was started
+//   false - if a transfer is already running or count is 0
+// -----------------------------------------------------------------------------
+bool spi1_write_buffer_async(const uint8_t *buffer, uint16_t count,
+                             spi1_callback_t callback)
+{
+  return spi1_write_buffer_repeat_async(buffer, count, count, callback);
+} /* spi1_write_buffer_async */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function starts a non-blocking transmit of total_count bytes over 
+//    SPI1 by sending the same buffer over and over, which lets a short 
+//    pattern (e.g. a run of pixels of one color) fill a much larger area 
+//    without a full size copy in SRAM. Each pass through the buffer is one 
+//    DMA block and the DMA ISR re-arms the channel until total_count bytes 
+//    have been queued. The last pass is cut short if total_count is not a 
+//    multiple of count. See spi1_write_buffer_async() for the completion 
+//    rules.
+//
+// INPUT PARAMETERS:
+//   buffer      - pointer to the bytes to transmit
+//   count       - number of bytes in the buffer (1 to 65535)
+//   total_count - total number of bytes to transmit
+//   callback    - function to call on completion, or NULL
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   true  - if the transfer was started
+//   false - if a transfer is already running or a count is 0
+// -----------------------------------------------------------------------------
+bool spi1_write_buffer_repeat_async(const uint8_t *buffer, uint16_t count,
+                                    uint32_t total_count,
+                                    spi1_callback_t callback)
+{
+  if (!spi1_dma_start(buffer, count, total_count,
+                      DMA_DMACTL_DMADSTWDTH_BYTE | DMA_DMACTL_DMASRCWDTH_BYTE,
+                      callback))
+  {
+    return false;
+  } /* if */
+
+  g_spi1_stats.tx_bytes += total_count;
+  return true;
+} /* spi1_write_buffer_repeat_async */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function starts a non-blocking transmit of a buffer of 16-bit 
+//    frames over SPI1 using DMA, one halfword per trigger. SPI1 must be set
+//    to 16-bit frames with spi1_set_frame_size(). See 
+//    spi1_write_buffer_async() for the completion rules.
+//
+// INPUT PARAMETERS:
+//   buffer   - pointer to the frames to transmit, each sent MSB first
+//   count    - number of frames to transmit (1 to 65535)
+//   callback - function to call on completion, or NULL
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   true  - if the transfer was started
+//   false - if a transfer is already running or count is 0
+// -----------------------------------------------------------------------------
+bool spi1_write_buffer16_async(const uint16_t *buffer, uint16_t count,
+                               spi1_callback_t callback)
+{
+  if (!spi1_dma_start(buffer, count, count,
+                      DMA_DMACTL_DMADSTWDTH_HALF | DMA_DMACTL_DMASRCWDTH_HALF,
+                      callback))
+  {
+    return false;
+  } /* if */
+
+  g_spi1_stats.tx_bytes += (uint32_t)count * 2;
+  return true;
+} /* spi1_write_buffer16_async */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function checks whether an async DMA or repeat transmit is still
+//    running.
+//
+// INPUT PARAMETERS:
+//   none
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   true  - if the DMA is still moving bytes into the TX FIFO or a repeat
+//           transmit still has runs to send
+//   false - if no async transmit is running
+// -----------------------------------------------------------------------------
+bool spi1_async_busy(void)
+{
+  return (g_spi1_dma_xfer.busy || g_spi1_repeat_xfer.busy);
+} /* spi1_async_busy */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function waits until any async DMA or repeat transmit has finished
+//    and SPI1 has shifted out the last byte, so the bus is idle. It returns
+//    right away if nothing is running.
+//
+// INPUT PARAMETERS:
+//   none
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+void spi1_wait_async(void)
+{
+  while (spi1_async_busy());
+  while (!spi1_xfer_done());
+} /* spi1_wait_async */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function handles the DMA interrupt for the SPI1 transmit channel.
+//    It starts the next chunk if bytes remain, otherwise it ends the
+//    transfer and calls the completion callback. An interrupt with no
+//    transfer running is ignored. Call it from the DMA ISR.
+//
+// INPUT PARAMETERS:
+//   none
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+void spi1_dma_handler(void)
+{
+  if (!g_spi1_dma_xfer.busy)
+  {
+    return;
+  } /* if */
+
+  if (g_spi1_dma_xfer.remaining > 0)
+  {
+    spi1_dma_start_chunk();
+  } /* if */
+  else
+  {
+    g_spi1_dma_xfer.busy = false;
+    if (g_spi1_dma_xfer.callback != NULL)
+    {
+      g_spi1_dma_xfer.callback();
+    } /* if */
+  } /* else */
+} /* spi1_dma_handler */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function starts a non-blocking transmit of the same 16-bit value
+//    count times using the SPI repeat transmit feature and returns right
+//    away. One TXDATA write sends a run of up to SPI1_REPEATTX_MAX + 1
+//    frames, and the SPI1 IDLE interrupt loads the next run once the last
+//    one has gone out, so a long run of one pixel color costs a few register
+//    writes per run and no CPU time in between. SPI1 must be set to 16-bit
+//    frames with spi1_set_frame_size(). The callback (if not NULL) is called
+//    from the SPI1 ISR once the last frame has been sent, so the bus is
+//    already idle.
+//
+// INPUT PARAMETERS:
+//   data     - the 16-bit value to transmit, sent MSB first
+//   count    - number of times to transmit it
+//   callback - function to call on completion, or NULL
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   true  - if the transfer was started
+//   false - if a transfer is already running or count is 0
+// -----------------------------------------------------------------------------
+bool spi1_write_repeat16_async(uint16_t data, uint32_t count,
+                               spi1_callback_t callback)
+{
+  if (spi1_async_busy() || count == 0)
+  {
+    return false;
+  } /* if */
+
+  g_spi1_repeat_xfer.data = data;
+  g_spi1_repeat_xfer.remaining = count;
+  g_spi1_repeat_xfer.callback = callback;
+  g_spi1_repeat_xfer.busy = true;
+
+  g_spi1_stats.tx_bytes += count * 2;
+
+  // An IDLE event left over from an earlier write must not reload the
+  // counter while the first run is still going out
+  while (!spi1_xfer_done());
+  SPI1->CPU_INT.ICLR = SPI_CPU_INT_ICLR_IDLE_CLR;
+  SPI1->CPU_INT.IMASK |= SPI_CPU_INT_IMASK_IDLE_SET;
+
+  spi1_repeat_start_chunk();
+
+  return true;
+} /* spi1_write_repeat16_async */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function sends the next run of the async repeat transmit. The
+//    repeat counter can only be reloaded once the previous run has gone
+//    out, so it is called when SPI1 is idle.
+//
+// INPUT PARAMETERS:
+//   none
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+static void spi1_repeat_start_chunk(void)
+{
+  uint32_t chunk = g_spi1_repeat_xfer.remaining;
+
+  if (chunk > SPI1_REPEATTX_MAX + 1)
+  {
+    chunk = SPI1_REPEATTX_MAX + 1;
+  } /* if */
+  g_spi1_repeat_xfer.remaining -= chunk;
+
+  // One write sends the frame, the hardware repeats it chunk - 1 times
+  SPI1->CTL1 = (SPI1->CTL1 & ~SPI_CTL1_REPEATTX_MASK) |
+               ((chunk - 1) << SPI_CTL1_REPEATTX_OFS);
+  SPI1->TXDATA = g_spi1_repeat_xfer.data;
+} /* spi1_repeat_start_chunk */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function handles the SPI1 interrupt. While an async repeat
+//    transmit runs, each IDLE event means a run has gone out: the next run
+//    is started, or after the last one the repeat feature is turned off,
+//    the transfer ends and the completion callback is called. Call it from
+//    the SPI1 ISR.
+//
+// INPUT PARAMETERS:
+//   none
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+void spi1_irq_handler(void)
+{
+  switch (SPI1->CPU_INT.IIDX)  // Read (clears)
+  {
+    case SPI_CPU_INT_IIDX_STAT_IDLE_EVT:
+      if (!g_spi1_repeat_xfer.busy)
+      {
+        break;
+      } /* if */
+
+      if (g_spi1_repeat_xfer.remaining > 0)
+      {
+        spi1_repeat_start_chunk();
+        break;
+      } /* if */
+
+      SPI1->CPU_INT.IMASK &= ~SPI_CPU_INT_IMASK_IDLE_MASK;
+      SPI1->CTL1 = (SPI1->CTL1 & ~SPI_CTL1_REPEATTX_MASK) |
+                   SPI_CTL1_REPEATTX_DISABLE;
+      g_spi1_repeat_xfer.busy = false;
+      if (g_spi1_repeat_xfer.callback != NULL)
+      {
+        g_spi1_repeat_xfer.callback();
+      } /* if */
+      break;
+
+    default:
+      break;
+  } /* switch */
+} /* spi1_irq_handler */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function copies the SPI1 traffic totals counted since startup or 
+//    the last call to spi1_clear_stats(). Bytes sent by DMA are counted when
+//    the transfer is started.
+//
+// INPUT PARAMETERS:
+//   none
+//
+// OUTPUT PARAMETERS:
+//   stats - the SPI1 traffic totals
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+void spi1_get_stats(spi1_stats_struct *stats)
+{
+  *stats = g_spi1_stats;
+} /* spi1_get_stats */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function resets the SPI1 traffic totals to zero.
+//
+// INPUT PARAMETERS:
+//   none
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+void spi1_clear_stats(void)
+{
+  g_spi1_stats.tx_bytes = 0;
+  g_spi1_stats.dma_xfers = 0;
+} /* spi1_clear_stats */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function starts a DMA transmit of total_count elements over SPI1,
+//    passing through the buffer as many times as needed. It holds the common
+//    part of the byte and halfword async writes.
+//
+// INPUT PARAMETERS:
+//   buffer      - pointer to the elements to transmit
+//   count       - number of elements in the buffer (1 to 65535)
+//   total_count - total number of elements to transmit
+//   width       - DMA_DMACTL_DMASRCWDTH_xxx | DMA_DMACTL_DMADSTWDTH_xxx
+//   callback    - function to call on completion, or NULL
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   true  - if the transfer was started
+//   false - if a transfer is already running or a count is 0
+// -----------------------------------------------------------------------------
+static bool spi1_dma_start(const void *buffer, uint16_t count,
+                           uint32_t total_count, uint32_t width,
+                           spi1_callback_t callback)
+{
+  if (spi1_async_busy() || count == 0 || total_count == 0)
+  {
+    return false;
+  } /* if */
+
+  g_spi1_dma_xfer.buffer = buffer;
+  g_spi1_dma_xfer.count = count;
+  g_spi1_dma_xfer.width = width;
+  g_spi1_dma_xfer.remaining = total_count;
+  g_spi1_dma_xfer.callback = callback;
+  g_spi1_dma_xfer.busy = true;
+
+  g_spi1_stats.dma_xfers++;
+
+  spi1_dma_start_chunk();
+
+  return true;
+} /* spi1_dma_start */
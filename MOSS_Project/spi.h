@@ -51,6 +51,7 @@
 // Loads standard C include files
 //-----------------------------------------------------------------------------
 #include <stdint.h>
+#include <stdbool.h>
 
 
 #define GPIO_PORTA                                                           (0)
@@ -76,6 +77,28 @@
 #define LP_SPI_CS0_IOMUX                                         (IOMUX_PINCM23)
 #define LP_SPI_CS0_PFMODE                                                    (3)
 
+// Defines for the DMA channel that feeds the SPI1 transmit FIFO
+#define SPI1_DMA_TX_CHAN                                                     (0)
+#define SPI1_DMA_MAX_XFER_SIZE                                           (65535)
+
+// Frame sizes for spi1_set_frame_size
+#define SPI1_FRAME_8BIT                                                      (8)
+#define SPI1_FRAME_16BIT                                                    (16)
+
+// Most repeats one TXDATA write can trigger (8-bit CTL1 REPEATTX field)
+#define SPI1_REPEATTX_MAX                                                  (255)
+
+// Called from the DMA ISR once every byte of an async write is in the FIFO,
+// or from the SPI1 ISR once an async repeat write has gone out
+typedef void (*spi1_callback_t)(void);
+
+// Running totals of SPI1 traffic, used to measure driver throughput
+typedef struct
+{
+  uint32_t tx_bytes;
+  uint32_t dma_xfers;
+} spi1_stats_struct;
+
 
 // ----------------------------------------------------------------------------
 // Prototype for support functions
@@ -83,10 +106,29 @@
 void spi1_init(void);
 void spi1_init_40mhz(void);
 void spi1_write_data(uint8_t data);
+void spi1_write_data16(uint16_t data);
+void spi1_set_frame_size(uint8_t bits);
 uint8_t  spi1_read_data(void);
 void spi1_disable(void);
 bool spi1_xfer_done (void);
 bool spi1_received_data_ready(void);
 
+void spi1_dma_init(void);
+bool spi1_write_buffer_async(const uint8_t *buffer, uint16_t count,
+                             spi1_callback_t callback);
+bool spi1_write_buffer_repeat_async(const uint8_t *buffer, uint16_t count,
+                                    uint32_t total_count,
+                                    spi1_callback_t callback);
+bool spi1_write_buffer16_async(const uint16_t *buffer, uint16_t count,
+                               spi1_callback_t callback);
+bool spi1_async_busy(void);
+void spi1_wait_async(void);
+void spi1_dma_handler(void);
+bool spi1_write_repeat16_async(uint16_t data, uint32_t count,
+                               spi1_callback_t callback);
+void spi1_irq_handler(void);
+void spi1_get_stats(spi1_stats_struct *stats);
+void spi1_clear_stats(void);
+
 
 #endif /* __SPI_H__ */
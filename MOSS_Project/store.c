@@ -0,0 +1,1043 @@
+// *****************************************************************************
+// ***************************    C Source Code     ****************************
+// *****************************************************************************
+//   DESIGNER NAME:  Rafael Ortiz
+//
+//         VERSION:  1.0
+//
+//       FILE NAME:  store.c
+//
+//-----------------------------------------------------------------------------
+// DESCRIPTION
+//    This file contains the log-structured flash store. Each sector starts
+//    with a header holding a sequence number, which orders the sectors from
+//    oldest to newest, and the number of times the sector has been erased.
+//    Records follow, each a one-word header and a payload padded to whole
+//    flash words:
+//
+//      type | key | length | payload CRC | header CRC | payload ...
+//
+//    The header is programmed before the payload. A header that fails its
+//    CRC was cut short by a reset and closes the sector; a payload that fails
+//    its CRC is skipped, and the record before it stays current.
+//
+//-----------------------------------------------------------------------------
+// DISCLAIMER
+//    This code was developed for educational purposes as part of the CSC202
+//    course and is provided "as is" without warranties of any kind, whether
+//    express, implied, or statutory.
+//
+//    The author and organization do not warrant the accuracy, completeness, or
+//    reliability of the code. The author and organization shall not be liable
+//    for any direct, indirect, incidental, special, exemplary, or consequential
+//    damages arising out of the use of or inability to use the code, even if
+//    advised of the possibility of such damages.
+//
+//    Use of this code is at your own risk, and it is recommended to validate
+//    and adapt the code for your specific application and hardware requirements.
+//
+// Copyright (c) 2024 by TBD
+//    You may use, edit, run or distribute this file as long as the above
+//    copyright notice remains
+// *****************************************************************************
+//******************************************************************************
+
+//-----------------------------------------------------------------------------
+// Load standard C include files
+//-----------------------------------------------------------------------------
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+
+//-----------------------------------------------------------------------------
+// Loads MSP launchpad board support macros and definitions
+//-----------------------------------------------------------------------------
+#include "store.h"
+
+
+//-----------------------------------------------------------------------------
+// Define symbolic constants used by the program
+//-----------------------------------------------------------------------------
+#define STORE_MAGIC                                                 (0x4C534F4D)
+#define STORE_CRC_INIT                                                  (0xFFFF)
+#define STORE_NO_RECORD                                                 (0xFFFF)
+#define STORE_ERASED_HALF                                               (0xFFFF)
+
+// Sizes of the sector and record headers below
+#define STORE_SECTOR_HEADER                                                 (16)
+#define STORE_RECORD_HEADER                                                  (8)
+
+#define STORE_ROUND_UP(x)   (((x) + FLASH_WORD_SIZE - 1) &                     \
+                             ~(FLASH_WORD_SIZE - 1))
+
+// A freshly opened sector must take every current setting plus the largest
+// record, so a record always fits once a new sector is opened
+#if (STORE_MAX_KEYS * (STORE_RECORD_HEADER + STORE_ROUND_UP(STORE_VALUE_MAX)) \
+     + STORE_RECORD_HEADER + STORE_ROUND_UP(STORE_BLOCK_MAX)                  \
+     > FLASH_SECTOR_SIZE - STORE_SECTOR_HEADER)
+#error "Store settings and blocks do not fit in one sector"
+#endif
+
+
+//-----------------------------------------------------------------------------
+// Define the types used by the store
+//-----------------------------------------------------------------------------
+// Two flash words at the start of every sector in use
+typedef struct
+{
+  uint32_t magic;
+  uint32_t seq;
+  uint32_t erase_count;
+  uint16_t reserved;
+  uint16_t crc;
+} store_sector_struct;
+
+// One flash word in front of every record
+typedef struct
+{
+  uint8_t  type;
+  uint8_t  key;
+  uint16_t length;
+  uint16_t data_crc;
+  uint16_t head_crc;
+} store_record_struct;
+
+
+//-----------------------------------------------------------------------------
+// Define global variables and structures here.
+// NOTE: when possible avoid using global variables
+//-----------------------------------------------------------------------------
+// CRC-16/CCITT, a nibble at a time
+static const uint16_t g_store_crc_table[16] =
+{
+  0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+  0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF
+};
+
+static const flash_dev_struct *g_store_dev = NULL;
+static uint8_t g_store_sectors = 0;
+static uint8_t g_store_head = STORE_NO_SECTOR;
+static uint32_t g_store_next_seq = 1;
+
+// Per sector. seq is 0 for a sector holding nothing, blank when it is known
+// to be erased, used is how far records reach.
+static uint32_t g_store_seq[STORE_MAX_SECTORS];
+static uint32_t g_store_erase_count[STORE_MAX_SECTORS];
+static uint16_t g_store_used[STORE_MAX_SECTORS];
+static uint16_t g_store_blocks[STORE_MAX_SECTORS];
+static bool g_store_blank[STORE_MAX_SECTORS];
+
+// Where the newest record of each setting starts
+static uint16_t g_store_keys[STORE_MAX_KEYS];
+
+static uint32_t g_store_user_bytes = 0;
+static uint32_t g_store_flash_bytes = 0;
+static uint32_t g_store_erases = 0;
+
+
+//-----------------------------------------------------------------------------
+// Prototype for local functions
+//-----------------------------------------------------------------------------
+static uint16_t store_crc16(uint16_t crc, const void *data, uint16_t length);
+static bool store_sector_is_blank(uint8_t sector);
+static void store_scan_sector(uint8_t sector);
+static void store_index(void);
+static bool store_finish_reclaim(void);
+static bool store_erase(uint8_t sector);
+static bool store_open_sector(void);
+static bool store_program_record(uint8_t type, uint8_t key, const void *data,
+                                 uint16_t length);
+static bool store_append(uint8_t type, uint8_t key, const void *data,
+                         uint16_t length);
+static uint8_t store_next_sector(uint32_t seq);
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function mounts the store on a flash. It reads the header of every
+//    sector, then walks the sectors from oldest to newest, building the index
+//    of settings and finding where the newest sector ends. Flash that does
+//    not hold a store is left alone until it is needed.
+//
+// INPUT PARAMETERS:
+//   dev - the flash to keep the store on
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   true  - if the store is ready
+//   false - if the flash has too few sectors for the store
+// -----------------------------------------------------------------------------
+bool store_init(const flash_dev_struct *dev)
+{
+  store_sector_struct header;
+  uint32_t max_erases = 0;
+  uint32_t max_seq = 0;
+  uint8_t i;
+
+  g_store_dev = NULL;
+  if (dev->sector_count < 3 || dev->sector_count > STORE_MAX_SECTORS)
+  {
+    return false;
+  } /* if */
+
+  g_store_dev = dev;
+  g_store_sectors = dev->sector_count;
+
+  for (i = 0; i < g_store_sectors; i++)
+  {
+    dev->read(i * FLASH_SECTOR_SIZE, &header, sizeof(header));
+
+    g_store_seq[i] = 0;
+    g_store_used[i] = STORE_SECTOR_HEADER;
+    g_store_blocks[i] = 0;
+    g_store_blank[i] = false;
+
+    if (header.magic == STORE_MAGIC && header.seq != 0 &&
+        header.crc == store_crc16(STORE_CRC_INIT, &header,
+                                  offsetof(store_sector_struct, crc)))
+    {
+      g_store_seq[i] = header.seq;
+      g_store_erase_count[i] = header.erase_count;
+      if (header.erase_count > max_erases)
+      {
+        max_erases = header.erase_count;
+      } /* if */
+      if (header.seq > max_seq)
+      {
+        max_seq = header.seq;
+      } /* if */
+    } /* if */
+    else
+    {
+      g_store_blank[i] = store_sector_is_blank(i);
+    } /* else */
+  } /* for */
+
+  // A sector without a header has lost its count; assume it is as worn as
+  // the most worn sector
+  for (i = 0; i < g_store_sectors; i++)
+  {
+    if (g_store_seq[i] == 0)
+    {
+      g_store_erase_count[i] = max_erases;
+    } /* if */
+  } /* for */
+
+  store_index();
+
+  g_store_next_seq = max_seq + 1;
+  g_store_user_bytes = 0;
+  g_store_flash_bytes = 0;
+  g_store_erases = 0;
+
+  return true;
+} /* store_init */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function sets a setting. Nothing is written if the setting already
+//    holds the same value.
+//
+// INPUT PARAMETERS:
+//   key    - the setting (0 to STORE_MAX_KEYS - 1)
+//   value  - the new value
+//   length - the length of the value in bytes (1 to STORE_VALUE_MAX)
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   true  - if the setting holds the value
+//   false - if the key or length is not valid or the flash failed
+// -----------------------------------------------------------------------------
+bool store_set(uint8_t key, const void *value, uint8_t length)
+{
+  uint8_t current[STORE_VALUE_MAX];
+  uint8_t current_length;
+
+  if (key >= STORE_MAX_KEYS || length == 0 || length > STORE_VALUE_MAX)
+  {
+    return false;
+  } /* if */
+
+  if (store_get(key, current, &current_length) && current_length == length &&
+      memcmp(current, value, length) == 0)
+  {
+    return true;
+  } /* if */
+
+  return store_append(STORE_TYPE_SETTING, key, value, length);
+} /* store_set */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function reads a setting.
+//
+// INPUT PARAMETERS:
+//   key - the setting
+//
+// OUTPUT PARAMETERS:
+//   value  - the value, up to STORE_VALUE_MAX bytes
+//   length - the length of the value in bytes
+//
+// RETURN:
+//   true  - if the setting is set
+//   false - if it is not, or the key is not valid
+// -----------------------------------------------------------------------------
+bool store_get(uint8_t key, void *value, uint8_t *length)
+{
+  store_record_struct record;
+
+  if (g_store_dev == NULL || key >= STORE_MAX_KEYS ||
+      g_store_keys[key] == STORE_NO_RECORD)
+  {
+    return false;
+  } /* if */
+
+  g_store_dev->read(g_store_keys[key], &record, sizeof(record));
+
+  // A zero-length record marks a deleted setting
+  if (record.length == 0)
+  {
+    return false;
+  } /* if */
+
+  g_store_dev->read(g_store_keys[key] + STORE_RECORD_HEADER, value,
+                    record.length);
+  *length = record.length;
+
+  return true;
+} /* store_get */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function deletes a setting by appending an empty record for it.
+//    The empty record is carried forward like a value, so an older value
+//    can never reappear.
+//
+// INPUT PARAMETERS:
+//   key - the setting
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   true  - if the setting is not set
+//   false - if the key is not valid or the flash failed
+// -----------------------------------------------------------------------------
+bool store_delete(uint8_t key)
+{
+  uint8_t current[STORE_VALUE_MAX];
+  uint8_t current_length;
+
+  if (key >= STORE_MAX_KEYS)
+  {
+    return false;
+  } /* if */
+
+  if (!store_get(key, current, &current_length))
+  {
+    return true;
+  } /* if */
+
+  return store_append(STORE_TYPE_SETTING, key, NULL, 0);
+} /* store_delete */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function appends a block of time-series data to a channel. Blocks
+//    are kept until their sector is reclaimed, so the store holds the most
+//    recent blocks that fit.
+//
+// INPUT PARAMETERS:
+//   channel - the channel the block belongs to
+//   data    - the block
+//   length  - the length of the block in bytes (1 to STORE_BLOCK_MAX)
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   true  - if the block was stored
+//   false - if the length is not valid or the flash failed
+// -----------------------------------------------------------------------------
+bool store_append_block(uint8_t channel, const void *data, uint16_t length)
+{
+  if (length == 0 || length > STORE_BLOCK_MAX)
+  {
+    return false;
+  } /* if */
+
+  return store_append(STORE_TYPE_BLOCK, channel, data, length);
+} /* store_append_block */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function sets up an iterator at the oldest block of a channel.
+//
+// INPUT PARAMETERS:
+//   channel - the channel to walk
+//
+// OUTPUT PARAMETERS:
+//   iter - the iterator
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+void store_iter_begin(store_iter_struct *iter, uint8_t channel)
+{
+  iter->channel = channel;
+  iter->sector = STORE_NO_SECTOR;
+  iter->offset = STORE_SECTOR_HEADER;
+  iter->seq = 0;
+
+  if (g_store_dev != NULL)
+  {
+    iter->sector = store_next_sector(0);
+  } /* if */
+
+  if (iter->sector != STORE_NO_SECTOR)
+  {
+    iter->seq = g_store_seq[iter->sector];
+  } /* if */
+} /* store_iter_begin */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function reads the next block of a channel, oldest first. Blocks
+//    whose CRC does not match are skipped. If the sector being walked is
+//    reclaimed in between, the walk carries on at the next newer sector.
+//
+// INPUT PARAMETERS:
+//   iter - the iterator
+//
+// OUTPUT PARAMETERS:
+//   iter   - the iterator, moved past the block
+//   data   - the block, up to STORE_BLOCK_MAX bytes
+//   length - the length of the block in bytes
+//
+// RETURN:
+//   true  - if a block was read
+//   false - if there are no more blocks
+// -----------------------------------------------------------------------------
+bool store_iter_next(store_iter_struct *iter, void *data, uint16_t *length)
+{
+  store_record_struct record;
+  uint32_t base;
+
+  while (iter->sector != STORE_NO_SECTOR)
+  {
+    if (g_store_seq[iter->sector] != iter->seq ||
+        iter->offset >= g_store_used[iter->sector])
+    {
+      iter->sector = store_next_sector(iter->seq);
+      iter->offset = STORE_SECTOR_HEADER;
+      if (iter->sector != STORE_NO_SECTOR)
+      {
+        iter->seq = g_store_seq[iter->sector];
+      } /* if */
+      continue;
+    } /* if */
+
+    base = iter->sector * FLASH_SECTOR_SIZE;
+    g_store_dev->read(base + iter->offset, &record, sizeof(record));
+    iter->offset += STORE_RECORD_HEADER + STORE_ROUND_UP(record.length);
+
+    if (record.type == STORE_TYPE_BLOCK && record.key == iter->channel &&
+        record.length <= STORE_BLOCK_MAX)
+    {
+      g_store_dev->read(base + iter->offset - STORE_ROUND_UP(record.length),
+                        data, record.length);
+      if (store_crc16(STORE_CRC_INIT, data, record.length) == record.data_crc)
+      {
+        *length = record.length;
+        return true;
+      } /* if */
+    } /* if */
+  } /* while */
+
+  return false;
+} /* store_iter_next */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function reports what the store holds, how evenly the sectors are
+//    worn and how many bytes have been programmed and erased since boot.
+//
+// INPUT PARAMETERS:
+//   none
+//
+// OUTPUT PARAMETERS:
+//   stats - the figures
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+void store_get_stats(store_stats_struct *stats)
+{
+  uint8_t i;
+
+  memset(stats, 0, sizeof(*stats));
+  stats->user_bytes = g_store_user_bytes;
+  stats->flash_bytes = g_store_flash_bytes;
+  stats->erases = g_store_erases;
+  stats->erase_min = UINT32_MAX;
+
+  for (i = 0; i < g_store_sectors; i++)
+  {
+    if (g_store_seq[i] != 0)
+    {
+      stats->sectors_used++;
+      stats->blocks += g_store_blocks[i];
+    } /* if */
+    if (g_store_erase_count[i] < stats->erase_min)
+    {
+      stats->erase_min = g_store_erase_count[i];
+    } /* if */
+    if (g_store_erase_count[i] > stats->erase_max)
+    {
+      stats->erase_max = g_store_erase_count[i];
+    } /* if */
+  } /* for */
+
+  if (g_store_sectors == 0)
+  {
+    stats->erase_min = 0;
+  } /* if */
+
+  for (i = 0; i < STORE_MAX_KEYS; i++)
+  {
+    uint8_t value[STORE_VALUE_MAX];
+    uint8_t length;
+
+    if (store_get(i, value, &length))
+    {
+      stats->settings++;
+    } /* if */
+  } /* for */
+} /* store_get_stats */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function runs a CRC-16/CCITT over a buffer, a nibble at a time.
+//
+// INPUT PARAMETERS:
+//   crc    - the CRC so far, STORE_CRC_INIT to start
+//   data   - the bytes to add
+//   length - how many bytes
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   The updated CRC
+// -----------------------------------------------------------------------------
+static uint16_t store_crc16(uint16_t crc, const void *data, uint16_t length)
+{
+  const uint8_t *bytes = data;
+
+  while (length-- > 0)
+  {
+    crc = (crc << 4) ^ g_store_crc_table[(crc >> 12) ^ (*bytes >> 4)];
+    crc = (crc << 4) ^ g_store_crc_table[(crc >> 12) ^ (*bytes & 0x0F)];
+    bytes++;
+  } /* while */
+
+  return crc;
+} /* store_crc16 */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function checks whether every byte of a sector is erased.
+//
+// INPUT PARAMETERS:
+//   sector - the sector
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   true  - if the sector can be programmed without erasing it
+//   false - otherwise
+// -----------------------------------------------------------------------------
+static bool store_sector_is_blank(uint8_t sector)
+{
+  uint8_t chunk[STORE_RECORD_HEADER];
+  uint16_t offset;
+  uint8_t i;
+
+  for (offset = 0; offset < FLASH_SECTOR_SIZE; offset += sizeof(chunk))
+  {
+    g_store_dev->read(sector * FLASH_SECTOR_SIZE + offset, chunk,
+                      sizeof(chunk));
+    for (i = 0; i < sizeof(chunk); i++)
+    {
+      if (chunk[i] != FLASH_ERASED_BYTE)
+      {
+        return false;
+      } /* if */
+    } /* for */
+  } /* for */
+
+  return true;
+} /* store_sector_is_blank */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function walks the record headers of a sector in use. It points
+//    the index at every good setting it finds, counts the blocks and notes
+//    where the records end. Only setting payloads, which are small, have
+//    their CRC checked here.
+//
+// INPUT PARAMETERS:
+//   sector - the sector
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+static void store_scan_sector(uint8_t sector)
+{
+  store_record_struct record;
+  uint8_t value[STORE_VALUE_MAX];
+  uint32_t base = sector * FLASH_SECTOR_SIZE;
+  uint16_t offset = STORE_SECTOR_HEADER;
+  uint16_t size;
+
+  while (offset + STORE_RECORD_HEADER <= FLASH_SECTOR_SIZE)
+  {
+    g_store_dev->read(base + offset, &record, sizeof(record));
+
+    if (record.type == STORE_TYPE_NONE && record.key == FLASH_ERASED_BYTE &&
+        record.length == STORE_ERASED_HALF &&
+        record.data_crc == STORE_ERASED_HALF &&
+        record.head_crc == STORE_ERASED_HALF)
+    {
+      break;
+    } /* if */
+
+    size = STORE_RECORD_HEADER + STORE_ROUND_UP(record.length);
+
+    // A torn header leaves nothing after it to trust
+    if (record.head_crc != store_crc16(STORE_CRC_INIT, &record,
+                                       offsetof(store_record_struct,
+                                                head_crc)) ||
+        offset + size > FLASH_SECTOR_SIZE)
+    {
+      offset = FLASH_SECTOR_SIZE;
+      break;
+    } /* if */
+
+    if (record.type == STORE_TYPE_SETTING && record.key < STORE_MAX_KEYS &&
+        record.length <= STORE_VALUE_MAX)
+    {
+      g_store_dev->read(base + offset + STORE_RECORD_HEADER, value,
+                        record.length);
+      if (store_crc16(STORE_CRC_INIT, value, record.length) ==
+          record.data_crc)
+      {
+        g_store_keys[record.key] = base + offset;
+      } /* if */
+    } /* if */
+    else if (record.type == STORE_TYPE_BLOCK)
+    {
+      g_store_blocks[sector]++;
+    } /* else if */
+
+    offset += size;
+  } /* while */
+
+  g_store_used[sector] = offset;
+} /* store_scan_sector */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function builds the index of settings and the block counts from
+//    the sectors in use, and makes the newest of them the head.
+//
+// INPUT PARAMETERS:
+//   none
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+static void store_index(void)
+{
+  uint8_t sector;
+  uint8_t i;
+
+  for (i = 0; i < STORE_MAX_KEYS; i++)
+  {
+    g_store_keys[i] = STORE_NO_RECORD;
+  } /* for */
+
+  for (i = 0; i < g_store_sectors; i++)
+  {
+    g_store_used[i] = STORE_SECTOR_HEADER;
+    g_store_blocks[i] = 0;
+  } /* for */
+
+  // Newer records of a setting replace older ones, so scan oldest first
+  g_store_head = STORE_NO_SECTOR;
+  sector = store_next_sector(0);
+  while (sector != STORE_NO_SECTOR)
+  {
+    store_scan_sector(sector);
+    g_store_head = sector;
+    sector = store_next_sector(g_store_seq[sector]);
+  } /* while */
+} /* store_index */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function finishes a reclaim cut short by a reset or a flash
+//    failure. Once a sector is opened the one after it is always erased, so
+//    a sector in use there means its settings were still being carried or
+//    it was still being erased. If no setting is left in it only the erase
+//    is repeated. Otherwise the newest sector holds nothing but copies of
+//    settings that are still in it, so the newest sector is dropped and the
+//    next one opened reclaims it again from the start.
+//
+// INPUT PARAMETERS:
+//   none
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   true  - if no reclaim is left unfinished
+//   false - if the flash failed
+// -----------------------------------------------------------------------------
+static bool store_finish_reclaim(void)
+{
+  uint8_t target;
+  uint32_t base;
+  uint8_t i;
+
+  if (g_store_head == STORE_NO_SECTOR)
+  {
+    return true;
+  } /* if */
+
+  target = (g_store_head + 1) % g_store_sectors;
+  if (g_store_seq[target] == 0)
+  {
+    return true;
+  } /* if */
+
+  base = target * FLASH_SECTOR_SIZE;
+  for (i = 0; i < STORE_MAX_KEYS; i++)
+  {
+    if (g_store_keys[i] != STORE_NO_RECORD &&
+        g_store_keys[i] >= base &&
+        g_store_keys[i] < base + FLASH_SECTOR_SIZE)
+    {
+      break;
+    } /* if */
+  } /* for */
+
+  if (i == STORE_MAX_KEYS)
+  {
+    return store_erase(target);
+  } /* if */
+
+  if (!store_erase(g_store_head))
+  {
+    return false;
+  } /* if */
+
+  store_index();
+
+  return true;
+} /* store_finish_reclaim */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function erases a sector and forgets what it held.
+//
+// INPUT PARAMETERS:
+//   sector - the sector
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   true  - if the sector was erased
+//   false - if the erase failed
+// -----------------------------------------------------------------------------
+static bool store_erase(uint8_t sector)
+{
+  g_store_seq[sector] = 0;
+  g_store_used[sector] = STORE_SECTOR_HEADER;
+  g_store_blocks[sector] = 0;
+  g_store_erase_count[sector]++;
+  g_store_erases++;
+
+  g_store_blank[sector] = g_store_dev->erase(sector);
+
+  return g_store_blank[sector];
+} /* store_erase */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function opens the next sector in the ring as the newest one, then
+//    reclaims the sector after it so it is erased before it is needed. The
+//    settings still current in the reclaimed sector are copied into the one
+//    just opened; blocks in it are dropped, oldest data first.
+//
+// INPUT PARAMETERS:
+//   none
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   true  - if a sector was opened
+//   false - if the flash failed
+// -----------------------------------------------------------------------------
+static bool store_open_sector(void)
+{
+  store_sector_struct header;
+  uint8_t value[STORE_VALUE_MAX];
+  store_record_struct record;
+  uint8_t sector;
+  uint8_t target;
+  uint32_t base;
+  uint8_t i;
+
+  if (!store_finish_reclaim())
+  {
+    return false;
+  } /* if */
+
+  sector = (g_store_head == STORE_NO_SECTOR) ? 0 :
+                                               (g_store_head + 1) %
+                                               g_store_sectors;
+
+  // Only reached on a fresh flash or after a failure; the spare is normally
+  // erased already
+  if (!g_store_blank[sector] && !store_erase(sector))
+  {
+    return false;
+  } /* if */
+
+  header.magic = STORE_MAGIC;
+  header.seq = g_store_next_seq++;
+  header.erase_count = g_store_erase_count[sector];
+  header.reserved = STORE_ERASED_HALF;
+  header.crc = store_crc16(STORE_CRC_INIT, &header,
+                           offsetof(store_sector_struct, crc));
+
+  g_store_blank[sector] = false;
+  g_store_flash_bytes += sizeof(header);
+  if (!g_store_dev->program(sector * FLASH_SECTOR_SIZE, &header,
+                            sizeof(header)))
+  {
+    return false;
+  } /* if */
+
+  g_store_seq[sector] = header.seq;
+  g_store_used[sector] = STORE_SECTOR_HEADER;
+  g_store_blocks[sector] = 0;
+  g_store_head = sector;
+
+  target = (sector + 1) % g_store_sectors;
+  if (g_store_seq[target] != 0)
+  {
+    base = target * FLASH_SECTOR_SIZE;
+    for (i = 0; i < STORE_MAX_KEYS; i++)
+    {
+      if (g_store_keys[i] != STORE_NO_RECORD &&
+          g_store_keys[i] >= base &&
+          g_store_keys[i] < base + FLASH_SECTOR_SIZE)
+      {
+        g_store_dev->read(g_store_keys[i], &record, sizeof(record));
+        g_store_dev->read(g_store_keys[i] + STORE_RECORD_HEADER, value,
+                          record.length);
+        if (!store_program_record(STORE_TYPE_SETTING, i, value,
+                                  record.length))
+        {
+          return false;
+        } /* if */
+      } /* if */
+    } /* for */
+  } /* if */
+
+  if (!g_store_blank[target])
+  {
+    store_erase(target);
+  } /* if */
+
+  return true;
+} /* store_open_sector */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function programs a record at the end of the newest sector, which
+//    must have room for it. The header goes first, so a reset part way
+//    through leaves a record that is skipped rather than one that swallows
+//    the records after it.
+//
+// INPUT PARAMETERS:
+//   type   - STORE_TYPE_SETTING or STORE_TYPE_BLOCK
+//   key    - the setting or channel
+//   data   - the payload
+//   length - the length of the payload in bytes
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   true  - if the record was programmed
+//   false - if the flash failed
+// -----------------------------------------------------------------------------
+static bool store_program_record(uint8_t type, uint8_t key, const void *data,
+                                 uint16_t length)
+{
+  store_record_struct record;
+  uint8_t tail[FLASH_WORD_SIZE];
+  uint32_t address;
+  uint16_t whole = length & ~(FLASH_WORD_SIZE - 1);
+  bool ok;
+
+  record.type = type;
+  record.key = key;
+  record.length = length;
+  record.data_crc = store_crc16(STORE_CRC_INIT, data, length);
+  record.head_crc = store_crc16(STORE_CRC_INIT, &record,
+                                offsetof(store_record_struct, head_crc));
+
+  address = g_store_head * FLASH_SECTOR_SIZE + g_store_used[g_store_head];
+  g_store_used[g_store_head] += STORE_RECORD_HEADER + STORE_ROUND_UP(length);
+  g_store_flash_bytes += STORE_RECORD_HEADER + STORE_ROUND_UP(length);
+
+  ok = g_store_dev->program(address, &record, sizeof(record));
+  if (ok && whole > 0)
+  {
+    ok = g_store_dev->program(address + STORE_RECORD_HEADER, data, whole);
+  } /* if */
+  if (ok && whole < length)
+  {
+    memset(tail, FLASH_ERASED_BYTE, sizeof(tail));
+    memcpy(tail, (const uint8_t *)data + whole, length - whole);
+    ok = g_store_dev->program(address + STORE_RECORD_HEADER + whole, tail,
+                              sizeof(tail));
+  } /* if */
+
+  // Nothing more can go in a sector the flash failed on
+  if (!ok)
+  {
+    g_store_used[g_store_head] = FLASH_SECTOR_SIZE;
+    return false;
+  } /* if */
+
+  if (type == STORE_TYPE_SETTING)
+  {
+    g_store_keys[key] = address;
+  } /* if */
+  else
+  {
+    g_store_blocks[g_store_head]++;
+  } /* else */
+
+  return true;
+} /* store_program_record */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function appends a record, first opening a new sector if the
+//    newest one has no room for it.
+//
+// INPUT PARAMETERS:
+//   type   - STORE_TYPE_SETTING or STORE_TYPE_BLOCK
+//   key    - the setting or channel
+//   data   - the payload
+//   length - the length of the payload in bytes
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   true  - if the record was stored
+//   false - if the store is not mounted or the flash failed
+// -----------------------------------------------------------------------------
+static bool store_append(uint8_t type, uint8_t key, const void *data,
+                         uint16_t length)
+{
+  uint16_t size = STORE_RECORD_HEADER + STORE_ROUND_UP(length);
+
+  if (g_store_dev == NULL)
+  {
+    return false;
+  } /* if */
+
+  g_store_user_bytes += length;
+
+  if (g_store_head == STORE_NO_SECTOR ||
+      g_store_used[g_store_head] + size > FLASH_SECTOR_SIZE)
+  {
+    if (!store_open_sector())
+    {
+      return false;
+    } /* if */
+  } /* if */
+
+  return store_program_record(type, key, data, length);
+} /* store_append */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function finds the oldest sector in use that is newer than a given
+//    sequence number.
+//
+// INPUT PARAMETERS:
+//   seq - the sequence number to start after, 0 for the oldest sector
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   The sector, or STORE_NO_SECTOR if there is none
+// -----------------------------------------------------------------------------
+static uint8_t store_next_sector(uint32_t seq)
+{
+  uint8_t sector = STORE_NO_SECTOR;
+  uint8_t i;
+
+  for (i = 0; i < g_store_sectors; i++)
+  {
+    if (g_store_seq[i] > seq &&
+        (sector == STORE_NO_SECTOR || g_store_seq[i] < g_store_seq[sector]))
+    {
+      sector = i;
+    } /* if */
+  } /* for */
+
+  return sector;
+} /* store_next_sector */
@@ -0,0 +1,117 @@
+// *****************************************************************************
+// ***************************    C Source Code     ****************************
+// *****************************************************************************
+//   DESIGNER NAME:  Rafael Ortiz
+//
+//         VERSION:  1.0
+//
+//       FILE NAME:  store.h
+//
+//-----------------------------------------------------------------------------
+// DESCRIPTION
+//    This file contains a log-structured store for flash. Small key/value
+//    settings and larger time-series blocks are appended as CRC-checked
+//    records to the newest sector; nothing is ever rewritten in place. When
+//    a sector fills, the next one in the ring is opened, and the sector after
+//    that is reclaimed: the settings still current in it are copied forward
+//    and it is erased, ready to be the next one opened. Sectors are used in
+//    strict rotation, so every sector is erased the same number of times.
+//
+//    At boot, the store reads the sector headers and record headers to find
+//    the newest copy of each setting. Block payloads are only read, and
+//    their CRC checked, when they are walked.
+//
+//    The store is not reentrant; tasks that share it must hold the kernel
+//    lock around calls.
+//
+//-----------------------------------------------------------------------------
+// DISCLAIMER
+//    This code was developed for educational purposes as part of the CSC202
+//    course and is provided "as is" without warranties of any kind, whether
+//    express, implied, or statutory.
+//
+//    The author and organization do not warrant the accuracy, completeness, or
+//    reliability of the code. The author and organization shall not be liable
+//    for any direct, indirect, incidental, special, exemplary, or consequential
+//    damages arising out of the use of or inability to use the code, even if
+//    advised of the possibility of such damages.
+//
+//    Use of this code is at your own risk, and it is recommended to validate
+//    and adapt the code for your specific application and hardware requirements.
+//
+// Copyright (c) 2024 by TBD
+//    You may use, edit, run or distribute this file as long as the above
+//    copyright notice remains
+// *****************************************************************************
+//******************************************************************************
+
+#ifndef __STORE_H__
+#define __STORE_H__
+
+//-----------------------------------------------------------------------------
+// Loads standard C include files
+//-----------------------------------------------------------------------------
+#include <stdbool.h>
+#include <stdint.h>
+#include "flash.h"
+
+
+//-----------------------------------------------------------------------------
+// Define symbolic constants used by the program
+//-----------------------------------------------------------------------------
+#define STORE_MAX_SECTORS                                                    (8)
+#define STORE_MAX_KEYS                                                      (16)
+#define STORE_VALUE_MAX                                                     (16)
+#define STORE_BLOCK_MAX                                                    (512)
+
+// Settings used by MOSS
+#define STORE_KEY_BAND_LOW                                                   (0)
+#define STORE_KEY_BAND_HIGH                                                  (1)
+
+// Record types; an erased record header reads as STORE_TYPE_NONE
+#define STORE_TYPE_SETTING                                                (0x01)
+#define STORE_TYPE_BLOCK                                                  (0x02)
+#define STORE_TYPE_NONE                                                   (0xFF)
+
+#define STORE_NO_SECTOR                                                   (0xFF)
+
+
+//-----------------------------------------------------------------------------
+// Define the types used by the store
+//-----------------------------------------------------------------------------
+// Walks the blocks of one channel from oldest to newest
+typedef struct
+{
+  uint32_t seq;
+  uint16_t offset;
+  uint8_t  sector;
+  uint8_t  channel;
+} store_iter_struct;
+
+// flash_bytes / user_bytes is the write amplification since boot
+typedef struct
+{
+  uint32_t user_bytes;
+  uint32_t flash_bytes;
+  uint32_t erases;
+  uint32_t erase_min;
+  uint32_t erase_max;
+  uint16_t blocks;
+  uint8_t  settings;
+  uint8_t  sectors_used;
+} store_stats_struct;
+
+
+// ----------------------------------------------------------------------------
+// Prototype for support functions
+// ----------------------------------------------------------------------------
+bool store_init(const flash_dev_struct *dev);
+bool store_set(uint8_t key, const void *value, uint8_t length);
+bool store_get(uint8_t key, void *value, uint8_t *length);
+bool store_delete(uint8_t key);
+bool store_append_block(uint8_t channel, const void *data, uint16_t length);
+void store_iter_begin(store_iter_struct *iter, uint8_t channel);
+bool store_iter_next(store_iter_struct *iter, void *data, uint16_t *length);
+void store_get_stats(store_stats_struct *stats);
+
+#endif /* __STORE_H__ */
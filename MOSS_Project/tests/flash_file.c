@@ -0,0 +1,431 @@
+// *****************************************************************************
+// ***************************    C Source Code     ****************************
+// *****************************************************************************
+//   DESIGNER NAME:  Rafael Ortiz
+//
+//         VERSION:  1.0
+//
+//       FILE NAME:  flash_file.c
+//
+//-----------------------------------------------------------------------------
+// DESCRIPTION
+//    This file contains a flash model for the host tests, kept in a file so
+//    the image outlives a simulated reset. It implements flash_dev_struct
+//    with the rules of the MSPM0 flash: sectors erase to 0xFF, programming
+//    works on aligned 64-bit words, and a word can only be programmed once
+//    after each erase. A word programmed twice is refused and counted.
+//
+//    The model can cut the power after a set number of word programs and
+//    sector erases. The word being programmed when the power goes is left
+//    with only some of its bits programmed, and a sector being erased is
+//    left partly erased; then the cut handler runs, which is expected not to
+//    return (longjmp) so the test can restart the store as after a reset.
+//
+//-----------------------------------------------------------------------------
+// DISCLAIMER
+//    This code was developed for educational purposes as part of the CSC202
+//    course and is provided "as is" without warranties of any kind, whether
+//    express, implied, or statutory.
+//
+//    The author and organization do not warrant the accuracy, completeness, or
+//    reliability of the code. The author and organization shall not be liable
+//    for any direct, indirect, incidental, special, exemplary, or consequential
+//    damages arising out of the use of or inability to use the code, even if
+//    advised of the possibility of such damages.
+//
+//    Use of this code is at your own risk, and it is recommended to validate
+//    and adapt the code for your specific application and hardware requirements.
+//
+// Copyright (c) 2024 by TBD
+//    You may use, edit, run or distribute this file as long as the above
+//    copyright notice remains
+// *****************************************************************************
+//******************************************************************************
+
+
+//-----------------------------------------------------------------------------
+// Load standard C include files
+//-----------------------------------------------------------------------------
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+
+//-----------------------------------------------------------------------------
+// Loads MSP launchpad board support macros and definitions
+//-----------------------------------------------------------------------------
+#include "flash_file.h"
+
+
+//-----------------------------------------------------------------------------
+// Prototype for local functions
+//-----------------------------------------------------------------------------
+static bool flash_file_erase(uint16_t sector);
+static bool flash_file_program(uint32_t offset, const void *data,
+                               uint16_t length);
+static void flash_file_read(uint32_t offset, void *data, uint16_t length);
+static bool flash_file_power_left(void);
+static uint32_t flash_file_random(void);
+
+
+//-----------------------------------------------------------------------------
+// Define global variables and structures here.
+// NOTE: when possible avoid using global variables
+//-----------------------------------------------------------------------------
+static flash_dev_struct g_flash_file_dev =
+{
+  flash_file_erase,
+  flash_file_program,
+  flash_file_read,
+  0
+};
+
+static FILE *g_flash_file = NULL;
+static flash_file_stats_struct g_flash_file_stats;
+static uint32_t g_flash_file_budget = FLASH_FILE_NO_CUT;
+static flash_file_cut_t g_flash_file_on_cut = NULL;
+static uint32_t g_flash_file_rng = 0x2545F491;
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function opens the file holding the flash image. A new file, or
+//    one that is asked to be blank, starts fully erased; otherwise the image
+//    is kept as the last run left it. The power cut is turned off and the
+//    stats cleared.
+//
+// INPUT PARAMETERS:
+//   path         - the image file
+//   sector_count - the number of sectors in the image
+//   blank        - true to start from an erased image
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   the flash device, or NULL if the file cannot be opened
+// -----------------------------------------------------------------------------
+const flash_dev_struct *flash_file_open(const char *path,
+                                        uint16_t sector_count, bool blank)
+{
+  uint8_t erased[FLASH_SECTOR_SIZE];
+  long size = 0;
+
+  if (sector_count > FLASH_FILE_MAX_SECTORS)
+  {
+    return NULL;
+  } /* if */
+
+  flash_file_close();
+
+  g_flash_file = blank ? NULL : fopen(path, "r+b");
+  if (g_flash_file != NULL)
+  {
+    fseek(g_flash_file, 0, SEEK_END);
+    size = ftell(g_flash_file);
+  } /* if */
+
+  if (size != (long)sector_count * FLASH_SECTOR_SIZE)
+  {
+    if (g_flash_file != NULL)
+    {
+      fclose(g_flash_file);
+    } /* if */
+
+    g_flash_file = fopen(path, "w+b");
+    if (g_flash_file == NULL)
+    {
+      return NULL;
+    } /* if */
+
+    memset(erased, FLASH_ERASED_BYTE, sizeof(erased));
+    for (uint16_t i = 0; i < sector_count; i++)
+    {
+      fwrite(erased, 1, sizeof(erased), g_flash_file);
+    } /* for */
+    fflush(g_flash_file);
+  } /* if */
+
+  memset(&g_flash_file_stats, 0, sizeof(g_flash_file_stats));
+  g_flash_file_budget = FLASH_FILE_NO_CUT;
+  g_flash_file_on_cut = NULL;
+  g_flash_file_dev.sector_count = sector_count;
+
+  return &g_flash_file_dev;
+} /* flash_file_open */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function closes the image file, if one is open.
+//
+// INPUT PARAMETERS:
+//   none
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+void flash_file_close(void)
+{
+  if (g_flash_file != NULL)
+  {
+    fclose(g_flash_file);
+    g_flash_file = NULL;
+  } /* if */
+} /* flash_file_close */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function arms a power cut. The given number of word programs and
+//    sector erases complete; the next one is cut short and on_cut runs.
+//
+// INPUT PARAMETERS:
+//   operations - flash operations to allow, or FLASH_FILE_NO_CUT
+//   on_cut     - the function to call when the power goes
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+void flash_file_cut_after(uint32_t operations, flash_file_cut_t on_cut)
+{
+  g_flash_file_budget = operations;
+  g_flash_file_on_cut = on_cut;
+} /* flash_file_cut_after */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function copies what the store has asked of the flash since the
+//    image was opened.
+//
+// INPUT PARAMETERS:
+//   none
+//
+// OUTPUT PARAMETERS:
+//   stats - the flash totals
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+void flash_file_get_stats(flash_file_stats_struct *stats)
+{
+  *stats = g_flash_file_stats;
+} /* flash_file_get_stats */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function erases a sector to 0xFF. If the power is cut, a random
+//    part of the sector is erased and the rest keeps its old contents.
+//
+// INPUT PARAMETERS:
+//   sector - the sector to erase
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   true  - if the sector was erased
+//   false - if the sector is out of range
+// -----------------------------------------------------------------------------
+static bool flash_file_erase(uint16_t sector)
+{
+  uint8_t image[FLASH_SECTOR_SIZE];
+  uint16_t erased = FLASH_SECTOR_SIZE;
+  bool power;
+
+  if (sector >= g_flash_file_dev.sector_count)
+  {
+    g_flash_file_stats.bad_calls++;
+    return false;
+  } /* if */
+
+  power = flash_file_power_left();
+  if (!power)
+  {
+    erased = flash_file_random() % FLASH_SECTOR_SIZE;
+  } /* if */
+
+  flash_file_read(sector * FLASH_SECTOR_SIZE, image, sizeof(image));
+  for (uint16_t i = 0; i < erased; i++)
+  {
+    image[(i * 37) % FLASH_SECTOR_SIZE] = FLASH_ERASED_BYTE;
+  } /* for */
+
+  fseek(g_flash_file, (long)sector * FLASH_SECTOR_SIZE, SEEK_SET);
+  fwrite(image, 1, sizeof(image), g_flash_file);
+  fflush(g_flash_file);
+
+  if (!power)
+  {
+    g_flash_file_on_cut();
+  } /* if */
+
+  g_flash_file_stats.erases++;
+  g_flash_file_stats.sector_erases[sector]++;
+
+  return true;
+} /* flash_file_erase */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function programs whole flash words. A word that is not erased is
+//    refused and counted as an overwrite. If the power is cut, the word
+//    being programmed gets only some of its bits.
+//
+// INPUT PARAMETERS:
+//   offset - word-aligned offset from the start of the image
+//   data   - the bytes to program
+//   length - a multiple of FLASH_WORD_SIZE
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   true  - if every word was programmed
+//   false - if the call was malformed or a word was already programmed
+// -----------------------------------------------------------------------------
+static bool flash_file_program(uint32_t offset, const void *data,
+                               uint16_t length)
+{
+  const uint8_t *bytes = data;
+  uint8_t word[FLASH_WORD_SIZE];
+  bool power;
+  uint16_t i;
+  uint8_t j;
+
+  if ((offset % FLASH_WORD_SIZE) != 0 || (length % FLASH_WORD_SIZE) != 0 ||
+      offset + length >
+      (uint32_t)g_flash_file_dev.sector_count * FLASH_SECTOR_SIZE)
+  {
+    g_flash_file_stats.bad_calls++;
+    return false;
+  } /* if */
+
+  for (i = 0; i < length; i += FLASH_WORD_SIZE)
+  {
+    flash_file_read(offset + i, word, sizeof(word));
+    for (j = 0; j < FLASH_WORD_SIZE; j++)
+    {
+      if (word[j] != FLASH_ERASED_BYTE)
+      {
+        g_flash_file_stats.overwrites++;
+        return false;
+      } /* if */
+    } /* for */
+
+    power = flash_file_power_left();
+    if (power)
+    {
+      memcpy(word, &bytes[i], sizeof(word));
+    } /* if */
+    else
+    {
+      // Programming only clears bits; some of them did not get there
+      for (j = 0; j < FLASH_WORD_SIZE; j++)
+      {
+        word[j] = bytes[i + j] | (uint8_t)flash_file_random();
+      } /* for */
+    } /* else */
+
+    fseek(g_flash_file, (long)(offset + i), SEEK_SET);
+    fwrite(word, 1, sizeof(word), g_flash_file);
+    fflush(g_flash_file);
+
+    if (!power)
+    {
+      g_flash_file_on_cut();
+    } /* if */
+    g_flash_file_stats.program_bytes += FLASH_WORD_SIZE;
+  } /* for */
+
+  return true;
+} /* flash_file_program */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function reads bytes from the image.
+//
+// INPUT PARAMETERS:
+//   offset - offset from the start of the image
+//   length - the number of bytes to read
+//
+// OUTPUT PARAMETERS:
+//   data   - the bytes read
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+static void flash_file_read(uint32_t offset, void *data, uint16_t length)
+{
+  fseek(g_flash_file, (long)offset, SEEK_SET);
+  if (fread(data, 1, length, g_flash_file) != length)
+  {
+    memset(data, FLASH_ERASED_BYTE, length);
+  } /* if */
+} /* flash_file_read */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function takes one operation from the cut budget.
+//
+// INPUT PARAMETERS:
+//   none
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   true  - if the operation completes
+//   false - if the power is cut during it
+// -----------------------------------------------------------------------------
+static bool flash_file_power_left(void)
+{
+  if (g_flash_file_budget == FLASH_FILE_NO_CUT)
+  {
+    return true;
+  } /* if */
+
+  if (g_flash_file_budget == 0)
+  {
+    return false;
+  } /* if */
+
+  g_flash_file_budget--;
+  return true;
+} /* flash_file_power_left */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function returns the next value of a fixed-seed generator, used
+//    to pick the bits a cut operation leaves behind.
+//
+// INPUT PARAMETERS:
+//   none
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   a pseudo-random value
+// -----------------------------------------------------------------------------
+static uint32_t flash_file_random(void)
+{
+  g_flash_file_rng ^= g_flash_file_rng << 13;
+  g_flash_file_rng ^= g_flash_file_rng >> 17;
+  g_flash_file_rng ^= g_flash_file_rng << 5;
+  return g_flash_file_rng;
+} /* flash_file_random */
@@ -0,0 +1,91 @@
+// *****************************************************************************
+// ***************************    C Source Code     ****************************
+// *****************************************************************************
+//   DESIGNER NAME:  Rafael Ortiz
+//
+//         VERSION:  1.0
+//
+//       FILE NAME:  flash_file.h
+//
+//-----------------------------------------------------------------------------
+// DESCRIPTION
+//    This file contains a flash model for the host tests, kept in a file so
+//    the image outlives a simulated reset. It implements flash_dev_struct
+//    with the rules of the MSPM0 flash: sectors erase to 0xFF, programming
+//    works on aligned 64-bit words, and a word can only be programmed once
+//    after each erase. A word programmed twice is refused and counted.
+//
+//    The model can cut the power after a set number of word programs and
+//    sector erases. The word being programmed when the power goes is left
+//    with only some of its bits programmed, and a sector being erased is
+//    left partly erased; then the cut handler runs, which is expected not to
+//    return (longjmp) so the test can restart the store as after a reset.
+//
+//-----------------------------------------------------------------------------
+// DISCLAIMER
+//    This code was developed for educational purposes as part of the CSC202
+//    course and is provided "as is" without warranties of any kind, whether
+//    express, implied, or statutory.
+//
+//    The author and organization do not warrant the accuracy, completeness, or
+//    reliability of the code. The author and organization shall not be liable
+//    for any direct, indirect, incidental, special, exemplary, or consequential
+//    damages arising out of the use of or inability to use the code, even if
+//    advised of the possibility of such damages.
+//
+//    Use of this code is at your own risk, and it is recommended to validate
+//    and adapt the code for your specific application and hardware requirements.
+//
+// Copyright (c) 2024 by TBD
+//    You may use, edit, run or distribute this file as long as the above
+//    copyright notice remains
+// *****************************************************************************
+//******************************************************************************
+
+#ifndef __FLASH_FILE_H__
+#define __FLASH_FILE_H__
+
+//-----------------------------------------------------------------------------
+// Loads standard C include files
+//-----------------------------------------------------------------------------
+#include <stdbool.h>
+#include <stdint.h>
+#include "flash.h"
+
+
+//-----------------------------------------------------------------------------
+// Define symbolic constants used by the flash model
+//-----------------------------------------------------------------------------
+#define FLASH_FILE_MAX_SECTORS                                              (16)
+
+// Cut budget that never runs out
+#define FLASH_FILE_NO_CUT                                           (0xFFFFFFFF)
+
+
+//-----------------------------------------------------------------------------
+// Define the types used by the flash model
+//-----------------------------------------------------------------------------
+// Called in place of the flash operation the power is cut in
+typedef void (*flash_file_cut_t)(void);
+
+// What the store asked of the flash since the file was opened
+typedef struct
+{
+  uint32_t program_bytes;
+  uint32_t erases;
+  uint32_t overwrites;
+  uint32_t bad_calls;
+  uint32_t sector_erases[FLASH_FILE_MAX_SECTORS];
+} flash_file_stats_struct;
+
+
+// ----------------------------------------------------------------------------
+// Prototype for support functions
+// ----------------------------------------------------------------------------
+const flash_dev_struct *flash_file_open(const char *path,
+                                        uint16_t sector_count, bool blank);
+void flash_file_close(void);
+void flash_file_cut_after(uint32_t operations, flash_file_cut_t on_cut);
+void flash_file_get_stats(flash_file_stats_struct *stats);
+
+#endif /* __FLASH_FILE_H__ */
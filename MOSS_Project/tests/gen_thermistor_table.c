@@ -0,0 +1,77 @@
+// *****************************************************************************
+// ***************************    C Source Code     ****************************
+// *****************************************************************************
+//   DESIGNER NAME:  Rafael Ortiz
+//
+//         VERSION:  1.0
+//
+//       FILE NAME:  gen_thermistor_table.c
+//
+//-----------------------------------------------------------------------------
+// DESCRIPTION
+//    This file generates g_thermistor_table in adc.c from the polynomial in
+//    thermistor_calc_temperature(). It prints the entries of the table, in
+//    tenths of a degree rounded to nearest, in the layout adc.c keeps them.
+//    "make" compares its output with the table in adc.c; after changing the
+//    coefficients, VBias or THERMISTOR_TABLE_STEP, paste in the output of
+//    "make thermistor-table".
+//
+//-----------------------------------------------------------------------------
+// DISCLAIMER
+//    This code was developed for educational purposes as part of the CSC202
+//    course and is provided "as is" without warranties of any kind, whether
+//    express, implied, or statutory.
+//
+//    The author and organization do not warrant the accuracy, completeness, or
+//    reliability of the code. The author and organization shall not be liable
+//    for any direct, indirect, incidental, special, exemplary, or consequential
+//    damages arising out of the use of or inability to use the code, even if
+//    advised of the possibility of such damages.
+//
+//    Use of this code is at your own risk, and it is recommended to validate
+//    and adapt the code for your specific application and hardware requirements.
+//
+// Copyright (c) 2024 by TBD
+//    You may use, edit, run or distribute this file as long as the above
+//    copyright notice remains
+// *****************************************************************************
+//******************************************************************************
+
+
+
+//-----------------------------------------------------------------------------
+// Load standard C include files
+//-----------------------------------------------------------------------------
+#include <stdint.h>
+#include <stdio.h>
+#include <math.h>
+
+
+//-----------------------------------------------------------------------------
+// Loads MSP launchpad board support macros and definitions
+//-----------------------------------------------------------------------------
+#include "adc.h"
+
+
+//-----------------------------------------------------------------------------
+// Define symbolic constants used by the program
+//-----------------------------------------------------------------------------
+#define ENTRIES_PER_LINE                                                     (8)
+
+
+int main(void)
+{
+  uint16_t i;
+  long entry;
+
+  for (i = 0; i < THERMISTOR_TABLE_SIZE; i++)
+  {
+    entry = lround(thermistor_calc_temperature(i * THERMISTOR_TABLE_STEP) *
+                   10.0);
+    printf("%s%5ld%s", (i % ENTRIES_PER_LINE == 0) ? "  " : " ", entry,
+           (i == THERMISTOR_TABLE_SIZE - 1) ? "\n" :
+           (i % ENTRIES_PER_LINE == ENTRIES_PER_LINE - 1) ? ",\n" : ",");
+  } /* for */
+
+  return 0;
+} /* main */
@@ -0,0 +1,78 @@
+// *****************************************************************************
+// ***************************    C Source Code     ****************************
+// *****************************************************************************
+//   DESIGNER NAME:  Rafael Ortiz
+//
+//         VERSION:  1.0
+//
+//       FILE NAME:  host.h
+//
+//-----------------------------------------------------------------------------
+// DESCRIPTION
+//    This file contains the hooks the host unit tests use to drive the stand
+//    ins for the kernel, the clock and the peripheral registers: set the tick
+//    count, see how long a task asked to sleep, and change the bus clock.
+//
+//-----------------------------------------------------------------------------
+// DISCLAIMER
+//    This code was developed for educational purposes as part of the CSC202
+//    course and is provided "as is" without warranties of any kind, whether
+//    express, implied, or statutory.
+//
+//    The author and organization do not warrant the accuracy, completeness, or
+//    reliability of the code. The author and organization shall not be liable
+//    for any direct, indirect, incidental, special, exemplary, or consequential
+//    damages arising out of the use of or inability to use the code, even if
+//    advised of the possibility of such damages.
+//
+//    Use of this code is at your own risk, and it is recommended to validate
+//    and adapt the code for your specific application and hardware requirements.
+//
+// Copyright (c) 2024 by TBD
+//    You may use, edit, run or distribute this file as long as the above
+//    copyright notice remains
+// *****************************************************************************
+//******************************************************************************
+
+#ifndef __HOST_H__
+#define __HOST_H__
+
+//-----------------------------------------------------------------------------
+// Loads standard C include files
+//-----------------------------------------------------------------------------
+#include <stdbool.h>
+#include <stdint.h>
+
+
+//-----------------------------------------------------------------------------
+// Define the types used by the host stubs
+//-----------------------------------------------------------------------------
+// Runs in place of kernel_wait_event_timeout while set, and returns the
+// events the waiting task wakes with
+typedef uint32_t (*host_wait_hook_t)(uint32_t mask, uint32_t ms);
+
+// Takes each byte UART0 sends
+typedef void (*host_uart_tx_hook_t)(uint8_t data);
+
+
+// ----------------------------------------------------------------------------
+// Prototype for support functions
+// ----------------------------------------------------------------------------
+void host_kernel_reset(uint32_t ticks);
+void host_set_ticks(uint32_t ticks);
+void host_set_wait_hook(host_wait_hook_t hook);
+uint32_t host_pending_events(void);
+uint8_t host_lock_depth(void);
+
+void host_clock_reset(void);
+void host_set_bus_clock(uint32_t freq);
+uint64_t host_delay_cycles(void);
+
+void host_regs_reset(void);
+bool host_uart_rx_push(uint8_t data);
+uint32_t host_uart_rx_pop(void);
+void host_set_uart_tx_hook(host_uart_tx_hook_t hook);
+uint32_t host_uart_tx_slot(void);
+void host_uart_tx_flush(void);
+
+#endif /* __HOST_H__ */
@@ -0,0 +1,166 @@
+// *****************************************************************************
+// ***************************    C Source Code     ****************************
+// *****************************************************************************
+//   DESIGNER NAME:  Rafael Ortiz
+//
+//         VERSION:  1.0
+//
+//       FILE NAME:  host_clock.c
+//
+//-----------------------------------------------------------------------------
+// DESCRIPTION
+//    This file stands in for the clock calls the drivers make. The bus clock
+//    is a variable a test can change, which runs the registered notifiers
+//    the way clock_set_freq does, and clock_delay only counts cycles.
+//
+//-----------------------------------------------------------------------------
+// DISCLAIMER
+//    This code was developed for educational purposes as part of the CSC202
+//    course and is provided "as is" without warranties of any kind, whether
+//    express, implied, or statutory.
+//
+//    The author and organization do not warrant the accuracy, completeness, or
+//    reliability of the code. The author and organization shall not be liable
+//    for any direct, indirect, incidental, special, exemplary, or consequential
+//    damages arising out of the use of or inability to use the code, even if
+//    advised of the possibility of such damages.
+//
+//    Use of this code is at your own risk, and it is recommended to validate
+//    and adapt the code for your specific application and hardware requirements.
+//
+// Copyright (c) 2024 by TBD
+//    You may use, edit, run or distribute this file as long as the above
+//    copyright notice remains
+// *****************************************************************************
+//******************************************************************************
+
+
+//-----------------------------------------------------------------------------
+// Load standard C include files
+//-----------------------------------------------------------------------------
+#include <stdint.h>
+#include <stdbool.h>
+
+
+//-----------------------------------------------------------------------------
+// Loads MSP launchpad board support macros and definitions
+//-----------------------------------------------------------------------------
+#include "clock.h"
+#include "host.h"
+
+
+//-----------------------------------------------------------------------------
+// Define global variables and structures here.
+// NOTE: when possible avoid using global variables
+//-----------------------------------------------------------------------------
+static uint32_t g_host_bus_clock = CLOCK_MAX_FREQ;
+static uint64_t g_host_delay_cycles = 0;
+static clock_notifier_t g_host_notifiers[CLOCK_MAX_NOTIFIERS];
+static uint8_t g_host_notifier_count = 0;
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function puts the clock stand in back to an 80 MHz bus clock with
+//    no notifiers registered.
+//
+// INPUT PARAMETERS:
+//   none
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+void host_clock_reset(void)
+{
+  g_host_bus_clock = CLOCK_MAX_FREQ;
+  g_host_delay_cycles = 0;
+  g_host_notifier_count = 0;
+} /* host_clock_reset */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function changes the bus clock the way clock_set_freq does: every
+//    notifier sees CLOCK_CHANGE_PREPARE, then the clock changes, then every
+//    notifier sees CLOCK_CHANGE_COMMIT.
+//
+// INPUT PARAMETERS:
+//   freq - the new bus clock in Hz
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+void host_set_bus_clock(uint32_t freq)
+{
+  for (uint8_t i = 0; i < g_host_notifier_count; i++)
+  {
+    g_host_notifiers[i](CLOCK_CHANGE_PREPARE, freq);
+  } /* for */
+
+  g_host_bus_clock = freq;
+
+  for (uint8_t i = 0; i < g_host_notifier_count; i++)
+  {
+    g_host_notifiers[i](CLOCK_CHANGE_COMMIT, freq);
+  } /* for */
+} /* host_set_bus_clock */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function returns the cycles passed to clock_delay since the last
+//    reset.
+//
+// INPUT PARAMETERS:
+//   none
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   the total delay in bus clock cycles
+// -----------------------------------------------------------------------------
+uint64_t host_delay_cycles(void)
+{
+  return g_host_delay_cycles;
+} /* host_delay_cycles */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    These functions stand in for the clock driver.
+// -----------------------------------------------------------------------------
+uint32_t get_bus_clock_freq(void)
+{
+  return g_host_bus_clock;
+} /* get_bus_clock_freq */
+
+
+bool clock_register_notifier(clock_notifier_t notifier)
+{
+  if (g_host_notifier_count >= CLOCK_MAX_NOTIFIERS)
+  {
+    return false;
+  } /* if */
+
+  g_host_notifiers[g_host_notifier_count++] = notifier;
+  return true;
+} /* clock_register_notifier */
+
+
+void clock_delay(uint32_t cycles)
+{
+  g_host_delay_cycles += cycles;
+} /* clock_delay */
+
+
+void msec_sleep(uint32_t ms)
+{
+  (void)ms;
+} /* msec_sleep */
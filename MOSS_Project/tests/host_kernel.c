@@ -0,0 +1,226 @@
+// *****************************************************************************
+// ***************************    C Source Code     ****************************
+// *****************************************************************************
+//   DESIGNER NAME:  Rafael Ortiz
+//
+//         VERSION:  1.0
+//
+//       FILE NAME:  host_kernel.c
+//
+//-----------------------------------------------------------------------------
+// DESCRIPTION
+//    This file stands in for the kernel calls the modules under test make.
+//    The tick count only moves when a test moves it or a task waits, and a
+//    test can take over kernel_wait_event_timeout to step a task loop one
+//    wait at a time.
+//
+//-----------------------------------------------------------------------------
+// DISCLAIMER
+//    This code was developed for educational purposes as part of the CSC202
+//    course and is provided "as is" without warranties of any kind, whether
+//    express, implied, or statutory.
+//
+//    The author and organization do not warrant the accuracy, completeness, or
+//    reliability of the code. The author and organization shall not be liable
+//    for any direct, indirect, incidental, special, exemplary, or consequential
+//    damages arising out of the use of or inability to use the code, even if
+//    advised of the possibility of such damages.
+//
+//    Use of this code is at your own risk, and it is recommended to validate
+//    and adapt the code for your specific application and hardware requirements.
+//
+// Copyright (c) 2024 by TBD
+//    You may use, edit, run or distribute this file as long as the above
+//    copyright notice remains
+// *****************************************************************************
+//******************************************************************************
+
+
+//-----------------------------------------------------------------------------
+// Load standard C include files
+//-----------------------------------------------------------------------------
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+
+//-----------------------------------------------------------------------------
+// Loads MSP launchpad board support macros and definitions
+//-----------------------------------------------------------------------------
+#include "kernel.h"
+#include "host.h"
+
+
+//-----------------------------------------------------------------------------
+// Define global variables and structures here.
+// NOTE: when possible avoid using global variables
+//-----------------------------------------------------------------------------
+static uint32_t g_host_ticks = 0;
+static uint32_t g_host_events = 0;
+static uint8_t  g_host_lock_depth = 0;
+static host_wait_hook_t g_host_wait_hook = NULL;
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function puts the kernel stand in back to its starting state with
+//    the tick count at ticks, no events pending and no wait hook.
+//
+// INPUT PARAMETERS:
+//   ticks - the tick count to start from
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+void host_kernel_reset(uint32_t ticks)
+{
+  g_host_ticks = ticks;
+  g_host_events = 0;
+  g_host_lock_depth = 0;
+  g_host_wait_hook = NULL;
+} /* host_kernel_reset */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function sets the tick count kernel_get_ticks returns.
+//
+// INPUT PARAMETERS:
+//   ticks - the new tick count
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+void host_set_ticks(uint32_t ticks)
+{
+  g_host_ticks = ticks;
+} /* host_set_ticks */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function sets the function that runs in place of
+//    kernel_wait_event_timeout. A hook that never returns (longjmp) is how a
+//    test gets out of a task loop.
+//
+// INPUT PARAMETERS:
+//   hook - the function to run, or NULL for the default wait
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+void host_set_wait_hook(host_wait_hook_t hook)
+{
+  g_host_wait_hook = hook;
+} /* host_set_wait_hook */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function returns the events signalled and not yet waited for.
+//
+// INPUT PARAMETERS:
+//   none
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   the pending event flags
+// -----------------------------------------------------------------------------
+uint32_t host_pending_events(void)
+{
+  return g_host_events;
+} /* host_pending_events */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function returns how many kernel_lock calls are still waiting for
+//    their kernel_unlock, so a test can check a module keeps them paired.
+//
+// INPUT PARAMETERS:
+//   none
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   the lock nesting depth
+// -----------------------------------------------------------------------------
+uint8_t host_lock_depth(void)
+{
+  return g_host_lock_depth;
+} /* host_lock_depth */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    These functions stand in for the kernel. Nothing is scheduled: a wait
+//    returns the pending events it is waiting for if there are any,
+//    otherwise it moves the tick count on by the timeout and returns none.
+// -----------------------------------------------------------------------------
+uint32_t kernel_get_ticks(void)
+{
+  return g_host_ticks;
+} /* kernel_get_ticks */
+
+
+void kernel_lock(void)
+{
+  g_host_lock_depth++;
+} /* kernel_lock */
+
+
+void kernel_unlock(void)
+{
+  g_host_lock_depth--;
+} /* kernel_unlock */
+
+
+void kernel_signal_event(uint32_t events)
+{
+  g_host_events |= events;
+} /* kernel_signal_event */
+
+
+uint32_t kernel_wait_event_timeout(uint32_t mask, uint32_t ms)
+{
+  uint32_t events;
+
+  if (g_host_wait_hook != NULL)
+  {
+    return g_host_wait_hook(mask, ms);
+  } /* if */
+
+  events = g_host_events & mask;
+  g_host_events &= ~mask;
+
+  if (events == 0 && ms != KERNEL_WAIT_FOREVER)
+  {
+    g_host_ticks += ms;
+  } /* if */
+
+  return events;
+} /* kernel_wait_event_timeout */
+
+
+uint32_t kernel_wait_event(uint32_t mask)
+{
+  return kernel_wait_event_timeout(mask, KERNEL_WAIT_FOREVER);
+} /* kernel_wait_event */
+
+
+void kernel_sleep(uint32_t ms)
+{
+  g_host_ticks += ms;
+} /* kernel_sleep */
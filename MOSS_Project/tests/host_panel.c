@@ -0,0 +1,565 @@
+// *****************************************************************************
+// ***************************    C Source Code     ****************************
+// *****************************************************************************
+//   DESIGNER NAME:  Rafael Ortiz
+//
+//         VERSION:  1.0
+//
+//       FILE NAME:  host_panel.c
+//
+//-----------------------------------------------------------------------------
+// DESCRIPTION
+//    This file contains a model of the ILI9341 panel for the host tests. It
+//    stands in for the SPI1 driver, reads the D/C line from GPIOA the way the
+//    panel does, and decodes what the display driver sends: the address
+//    windows opened by CASET, PASET and RAMWR, the pixels written into
+//    display memory, and the vertical scroll registers. It also counts the
+//    bytes on the bus and how often D/C changed level.
+//
+//-----------------------------------------------------------------------------
+// DISCLAIMER
+//    This code was developed for educational purposes as part of the CSC202
+//    course and is provided "as is" without warranties of any kind, whether
+//    express, implied, or statutory.
+//
+//    The author and organization do not warrant the accuracy, completeness, or
+//    reliability of the code. The author and organization shall not be liable
+//    for any direct, indirect, incidental, special, exemplary, or consequential
+//    damages arising out of the use of or inability to use the code, even if
+//    advised of the possibility of such damages.
+//
+//    Use of this code is at your own risk, and it is recommended to validate
+//    and adapt the code for your specific application and hardware requirements.
+//
+// Copyright (c) 2024 by TBD
+//    You may use, edit, run or distribute this file as long as the above
+//    copyright notice remains
+// *****************************************************************************
+
+
+//-----------------------------------------------------------------------------
+// Load standard C include files
+//-----------------------------------------------------------------------------
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+
+//-----------------------------------------------------------------------------
+// Loads MSP launchpad board support macros and definitions
+//-----------------------------------------------------------------------------
+#include <ti/devices/msp/msp.h>
+#include "ili9341.h"
+#include "spi.h"
+#include "host_panel.h"
+
+
+//-----------------------------------------------------------------------------
+// Define symbolic constants used by the program
+//-----------------------------------------------------------------------------
+// Most parameter bytes a decoded command takes (VSCRDEF)
+#define HOST_PANEL_MAX_PARAMS                                                (6)
+
+
+//-----------------------------------------------------------------------------
+// Prototype for local functions
+//-----------------------------------------------------------------------------
+static void host_panel_frame(uint8_t data);
+static void host_panel_command(uint8_t cmd);
+static void host_panel_param(uint8_t data);
+static void host_panel_write_pixel(uint16_t color);
+
+
+//-----------------------------------------------------------------------------
+// Define global variables and structures here.
+// NOTE: when possible avoid using global variables
+//-----------------------------------------------------------------------------
+// Display memory, by memory line
+static uint16_t g_host_panel_gram[ILI9341_TFTHEIGHT][ILI9341_TFTWIDTH];
+
+// Command being decoded and the parameter bytes it has had
+static uint8_t g_host_panel_cmd = 0;
+static uint8_t g_host_panel_params[HOST_PANEL_MAX_PARAMS];
+static uint8_t g_host_panel_param_count = 0;
+
+// Column and page range, and where the next RAMWR pixel goes
+static uint16_t g_host_panel_x0 = 0;
+static uint16_t g_host_panel_x1 = ILI9341_TFTWIDTH - 1;
+static uint16_t g_host_panel_y0 = 0;
+static uint16_t g_host_panel_y1 = ILI9341_TFTHEIGHT - 1;
+static uint16_t g_host_panel_x = 0;
+static uint16_t g_host_panel_y = 0;
+
+// Vertical scrolling registers
+static uint16_t g_host_panel_scroll_top = 0;
+static uint16_t g_host_panel_scroll_start = 0;
+static uint16_t g_host_panel_scroll_area = ILI9341_TFTHEIGHT;
+
+// Level of D/C at the last byte, once there has been one
+static bool g_host_panel_dc = false;
+static bool g_host_panel_dc_seen = false;
+
+static host_panel_stats_struct g_host_panel_stats = {0};
+static host_panel_window_struct g_host_panel_windows[HOST_PANEL_MAX_WINDOWS];
+
+// What spi1_get_stats reports, cleared separately from the log
+static spi1_stats_struct g_host_panel_spi_stats = {0};
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function puts the panel in its power on state: display memory
+//    black, the full screen addressed, no scrolling, and the log cleared.
+//
+// INPUT PARAMETERS:
+//   none
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+void host_panel_reset(void)
+{
+  memset(g_host_panel_gram, 0, sizeof(g_host_panel_gram));
+
+  g_host_panel_cmd = 0;
+  g_host_panel_param_count = 0;
+  g_host_panel_x0 = 0;
+  g_host_panel_x1 = ILI9341_TFTWIDTH - 1;
+  g_host_panel_y0 = 0;
+  g_host_panel_y1 = ILI9341_TFTHEIGHT - 1;
+  g_host_panel_x = 0;
+  g_host_panel_y = 0;
+  g_host_panel_scroll_top = 0;
+  g_host_panel_scroll_start = 0;
+  g_host_panel_scroll_area = ILI9341_TFTHEIGHT;
+  g_host_panel_dc_seen = false;
+  memset(&g_host_panel_spi_stats, 0, sizeof(g_host_panel_spi_stats));
+
+  host_panel_clear_log();
+} /* host_panel_reset */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function clears the counters and the window log. Display memory,
+//    the panel registers and the level of D/C are kept.
+//
+// INPUT PARAMETERS:
+//   none
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+void host_panel_clear_log(void)
+{
+  memset(&g_host_panel_stats, 0, sizeof(g_host_panel_stats));
+} /* host_panel_clear_log */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function copies out the counters.
+//
+// INPUT PARAMETERS:
+//   none
+//
+// OUTPUT PARAMETERS:
+//   stats - what the display driver sent since the log was cleared
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+void host_panel_get_stats(host_panel_stats_struct *stats)
+{
+  *stats = g_host_panel_stats;
+} /* host_panel_get_stats */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function returns an address window from the log, in the order the
+//    windows were opened since the log was cleared.
+//
+// INPUT PARAMETERS:
+//   index - position of the window in the log
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   The window, or NULL if it was not opened or not kept
+// -----------------------------------------------------------------------------
+const host_panel_window_struct *host_panel_window(uint32_t index)
+{
+  if (index >= g_host_panel_stats.windows || index >= HOST_PANEL_MAX_WINDOWS)
+  {
+    return NULL;
+  } /* if */
+
+  return &g_host_panel_windows[index];
+} /* host_panel_window */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function reads a pixel of display memory. Coordinates are the ones
+//    address windows use, so memory lines, not screen lines.
+//
+// INPUT PARAMETERS:
+//   x - column
+//   y - memory line
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   The RGB565 color, or 0 outside the panel
+// -----------------------------------------------------------------------------
+uint16_t host_panel_pixel(uint16_t x, uint16_t y)
+{
+  if (x >= ILI9341_TFTWIDTH || y >= ILI9341_TFTHEIGHT)
+  {
+    return 0;
+  } /* if */
+
+  return g_host_panel_gram[y][x];
+} /* host_panel_pixel */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    These functions return the vertical scrolling registers: the memory
+//    line VSCRSADD put at the top of the scrolling area, and the height of
+//    the area VSCRDEF set.
+// -----------------------------------------------------------------------------
+uint16_t host_panel_scroll_start(void)
+{
+  return g_host_panel_scroll_start;
+} /* host_panel_scroll_start */
+
+
+uint16_t host_panel_scroll_area(void)
+{
+  return g_host_panel_scroll_area;
+} /* host_panel_scroll_area */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function returns the memory line the panel shows on a screen
+//    line. Lines in the scrolling area start from the VSCRSADD line and
+//    wrap within the area; the fixed areas above and below are shown as
+//    they are.
+//
+// INPUT PARAMETERS:
+//   y - screen line, counted from the top of the panel
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   The memory line
+// -----------------------------------------------------------------------------
+uint16_t host_panel_screen_line(uint16_t y)
+{
+  uint16_t top = g_host_panel_scroll_top;
+  uint16_t area = g_host_panel_scroll_area;
+
+  if (y < top || y >= top + area || area == 0)
+  {
+    return y;
+  } /* if */
+
+  return top + (y - top + g_host_panel_scroll_start - top) % area;
+} /* host_panel_screen_line */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    Stand-ins for the SPI1 driver. Every write is finished when it returns
+//    and goes to the panel model a byte at a time, most significant first.
+//    The driver's traffic counters count the same bytes, and an async write
+//    as one DMA transfer.
+// -----------------------------------------------------------------------------
+void spi1_set_frame_size(uint8_t bits)
+{
+  (void)bits;
+} /* spi1_set_frame_size */
+
+
+void spi1_write_data(uint8_t data)
+{
+  g_host_panel_spi_stats.tx_bytes++;
+  host_panel_frame(data);
+} /* spi1_write_data */
+
+
+void spi1_write_data16(uint16_t data)
+{
+  g_host_panel_spi_stats.tx_bytes += 2;
+  host_panel_frame(data >> 8);
+  host_panel_frame(data & 0xFF);
+} /* spi1_write_data16 */
+
+
+bool spi1_write_buffer16_async(const uint16_t *buffer, uint16_t count,
+                               spi1_callback_t callback)
+{
+  g_host_panel_spi_stats.dma_xfers++;
+  while (count-- > 0)
+  {
+    spi1_write_data16(*buffer++);
+  } /* while */
+  if (callback != NULL)
+  {
+    callback();
+  } /* if */
+  return true;
+} /* spi1_write_buffer16_async */
+
+
+bool spi1_write_repeat16_async(uint16_t data, uint32_t count,
+                               spi1_callback_t callback)
+{
+  g_host_panel_spi_stats.dma_xfers++;
+  while (count-- > 0)
+  {
+    spi1_write_data16(data);
+  } /* while */
+  if (callback != NULL)
+  {
+    callback();
+  } /* if */
+  return true;
+} /* spi1_write_repeat16_async */
+
+
+bool spi1_async_busy(void)
+{
+  return false;
+} /* spi1_async_busy */
+
+
+void spi1_wait_async(void)
+{
+} /* spi1_wait_async */
+
+
+bool spi1_xfer_done(void)
+{
+  return true;
+} /* spi1_xfer_done */
+
+
+void spi1_get_stats(spi1_stats_struct *stats)
+{
+  *stats = g_host_panel_spi_stats;
+} /* spi1_get_stats */
+
+
+void spi1_clear_stats(void)
+{
+  memset(&g_host_panel_spi_stats, 0, sizeof(g_host_panel_spi_stats));
+} /* spi1_clear_stats */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function takes one byte off the bus. D/C low makes it a command,
+//    high a parameter or, after RAMWR, half of a pixel.
+//
+// INPUT PARAMETERS:
+//   data - the byte sent
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+static void host_panel_frame(uint8_t data)
+{
+  bool dc = (GPIOA->DOUT31_0 & DC_MASK) != 0;
+
+  g_host_panel_stats.bytes++;
+  if (g_host_panel_dc_seen && dc != g_host_panel_dc)
+  {
+    g_host_panel_stats.dc_changes++;
+  } /* if */
+  g_host_panel_dc = dc;
+  g_host_panel_dc_seen = true;
+
+  if (dc)
+  {
+    host_panel_param(data);
+  } /* if */
+  else
+  {
+    host_panel_command(data);
+  } /* else */
+} /* host_panel_frame */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function starts a command. RAMWR opens the current address window
+//    and logs it.
+//
+// INPUT PARAMETERS:
+//   cmd - the command byte
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+static void host_panel_command(uint8_t cmd)
+{
+  host_panel_window_struct *window;
+
+  g_host_panel_stats.commands++;
+  g_host_panel_cmd = cmd;
+  g_host_panel_param_count = 0;
+
+  if (cmd == ILI9341_RAMWR)
+  {
+    g_host_panel_x = g_host_panel_x0;
+    g_host_panel_y = g_host_panel_y0;
+
+    if (g_host_panel_stats.windows < HOST_PANEL_MAX_WINDOWS)
+    {
+      window = &g_host_panel_windows[g_host_panel_stats.windows];
+      window->x0 = g_host_panel_x0;
+      window->x1 = g_host_panel_x1;
+      window->y0 = g_host_panel_y0;
+      window->y1 = g_host_panel_y1;
+      window->pixels = 0;
+    } /* if */
+    g_host_panel_stats.windows++;
+  } /* if */
+} /* host_panel_command */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function takes a data byte for the current command. The commands
+//    the display driver uses to address and scroll memory take effect once
+//    all their parameters are in; RAMWR data is written two bytes a pixel.
+//
+// INPUT PARAMETERS:
+//   data - the data byte
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+static void host_panel_param(uint8_t data)
+{
+  const uint8_t *p = g_host_panel_params;
+
+  if (g_host_panel_cmd == ILI9341_RAMWR)
+  {
+    g_host_panel_params[g_host_panel_param_count++] = data;
+    if (g_host_panel_param_count == 2)
+    {
+      host_panel_write_pixel((uint16_t)((p[0] << 8) | p[1]));
+      g_host_panel_param_count = 0;
+    } /* if */
+    return;
+  } /* if */
+
+  if (g_host_panel_param_count >= HOST_PANEL_MAX_PARAMS)
+  {
+    return;
+  } /* if */
+  g_host_panel_params[g_host_panel_param_count++] = data;
+
+  switch (g_host_panel_cmd)
+  {
+    case ILI9341_CASET:
+      if (g_host_panel_param_count == 4)
+      {
+        g_host_panel_x0 = (p[0] << 8) | p[1];
+        g_host_panel_x1 = (p[2] << 8) | p[3];
+      } /* if */
+      break;
+
+    case ILI9341_PASET:
+      if (g_host_panel_param_count == 4)
+      {
+        g_host_panel_y0 = (p[0] << 8) | p[1];
+        g_host_panel_y1 = (p[2] << 8) | p[3];
+      } /* if */
+      break;
+
+    case ILI9341_VSCRDEF:
+      if (g_host_panel_param_count == 6)
+      {
+        g_host_panel_scroll_top = (p[0] << 8) | p[1];
+        g_host_panel_scroll_area = (p[2] << 8) | p[3];
+      } /* if */
+      break;
+
+    case ILI9341_VSCRSADD:
+      if (g_host_panel_param_count == 2)
+      {
+        g_host_panel_scroll_start = (p[0] << 8) | p[1];
+      } /* if */
+      break;
+
+    default:
+      break;
+  } /* switch */
+} /* host_panel_param */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function writes a pixel at the RAMWR position and moves it along
+//    the window: across a line, then down, and back to the top corner after
+//    the last pixel as the panel does.
+//
+// INPUT PARAMETERS:
+//   color - the RGB565 color
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+static void host_panel_write_pixel(uint16_t color)
+{
+  if (g_host_panel_x < ILI9341_TFTWIDTH && g_host_panel_y < ILI9341_TFTHEIGHT)
+  {
+    g_host_panel_gram[g_host_panel_y][g_host_panel_x] = color;
+  } /* if */
+
+  g_host_panel_stats.pixels++;
+  if (g_host_panel_stats.windows > 0 &&
+      g_host_panel_stats.windows <= HOST_PANEL_MAX_WINDOWS)
+  {
+    g_host_panel_windows[g_host_panel_stats.windows - 1].pixels++;
+  } /* if */
+
+  if (g_host_panel_x < g_host_panel_x1)
+  {
+    g_host_panel_x++;
+  } /* if */
+  else
+  {
+    g_host_panel_x = g_host_panel_x0;
+    g_host_panel_y = (g_host_panel_y < g_host_panel_y1) ?
+                     g_host_panel_y + 1 : g_host_panel_y0;
+  } /* else */
+} /* host_panel_write_pixel */
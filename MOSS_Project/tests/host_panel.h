@@ -0,0 +1,92 @@
+// *****************************************************************************
+// ***************************    C Source Code     ****************************
+// *****************************************************************************
+//   DESIGNER NAME:  Rafael Ortiz
+//
+//         VERSION:  1.0
+//
+//       FILE NAME:  host_panel.h
+//
+//-----------------------------------------------------------------------------
+// DESCRIPTION
+//    This file contains a model of the ILI9341 panel for the host tests. It
+//    stands in for the SPI1 driver, reads the D/C line from GPIOA the way the
+//    panel does, and decodes what the display driver sends: the address
+//    windows opened by CASET, PASET and RAMWR, the pixels written into
+//    display memory, and the vertical scroll registers. It also counts the
+//    bytes on the bus and how often D/C changed level.
+//
+//-----------------------------------------------------------------------------
+// DISCLAIMER
+//    This code was developed for educational purposes as part of the CSC202
+//    course and is provided "as is" without warranties of any kind, whether
+//    express, implied, or statutory.
+//
+//    The author and organization do not warrant the accuracy, completeness, or
+//    reliability of the code. The author and organization shall not be liable
+//    for any direct, indirect, incidental, special, exemplary, or consequential
+//    damages arising out of the use of or inability to use the code, even if
+//    advised of the possibility of such damages.
+//
+//    Use of this code is at your own risk, and it is recommended to validate
+//    and adapt the code for your specific application and hardware requirements.
+//
+// Copyright (c) 2024 by TBD
+//    You may use, edit, run or distribute this file as long as the above
+//    copyright notice remains
+// *****************************************************************************
+//******************************************************************************
+
+#ifndef __HOST_PANEL_H__
+#define __HOST_PANEL_H__
+
+//-----------------------------------------------------------------------------
+// Loads standard C include files
+//-----------------------------------------------------------------------------
+#include <stdint.h>
+
+
+//-----------------------------------------------------------------------------
+// Define symbolic constants used by the panel model
+//-----------------------------------------------------------------------------
+// Address windows kept in the log; later ones are counted but not kept
+#define HOST_PANEL_MAX_WINDOWS                                              (64)
+
+
+//-----------------------------------------------------------------------------
+// Define the types used by the panel model
+//-----------------------------------------------------------------------------
+// An address window, inclusive, and the pixels written into it
+typedef struct
+{
+  uint16_t x0;
+  uint16_t x1;
+  uint16_t y0;
+  uint16_t y1;
+  uint32_t pixels;
+} host_panel_window_struct;
+
+// What the display driver sent since the log was cleared
+typedef struct
+{
+  uint32_t bytes;
+  uint32_t commands;
+  uint32_t dc_changes;
+  uint32_t pixels;
+  uint32_t windows;
+} host_panel_stats_struct;
+
+
+// ----------------------------------------------------------------------------
+// Prototype for support functions
+// ----------------------------------------------------------------------------
+void host_panel_reset(void);
+void host_panel_clear_log(void);
+void host_panel_get_stats(host_panel_stats_struct *stats);
+const host_panel_window_struct *host_panel_window(uint32_t index);
+uint16_t host_panel_pixel(uint16_t x, uint16_t y);
+uint16_t host_panel_scroll_start(void);
+uint16_t host_panel_scroll_area(void);
+uint16_t host_panel_screen_line(uint16_t y);
+
+#endif /* __HOST_PANEL_H__ */
@@ -0,0 +1,245 @@
+// *****************************************************************************
+// ***************************    C Source Code     ****************************
+// *****************************************************************************
+//   DESIGNER NAME:  Rafael Ortiz
+//
+//         VERSION:  1.0
+//
+//       FILE NAME:  host_regs.c
+//
+//-----------------------------------------------------------------------------
+// DESCRIPTION
+//    This file holds the peripheral register blocks the host msp.h stub
+//    declares, a reset that zeroes them between tests, and models of the
+//    UART0 receive FIFO behind RXDATA and of the line behind TXDATA.
+//
+//-----------------------------------------------------------------------------
+// DISCLAIMER
+//    This code was developed for educational purposes as part of the CSC202
+//    course and is provided "as is" without warranties of any kind, whether
+//    express, implied, or statutory.
+//
+//    The author and organization do not warrant the accuracy, completeness, or
+//    reliability of the code. The author and organization shall not be liable
+//    for any direct, indirect, incidental, special, exemplary, or consequential
+//    damages arising out of the use of or inability to use the code, even if
+//    advised of the possibility of such damages.
+//
+//    Use of this code is at your own risk, and it is recommended to validate
+//    and adapt the code for your specific application and hardware requirements.
+//
+// Copyright (c) 2024 by TBD
+//    You may use, edit, run or distribute this file as long as the above
+//    copyright notice remains
+// *****************************************************************************
+//******************************************************************************
+
+
+//-----------------------------------------------------------------------------
+// Load standard C include files
+//-----------------------------------------------------------------------------
+#include <string.h>
+
+
+//-----------------------------------------------------------------------------
+// Loads MSP launchpad board support macros and definitions
+//-----------------------------------------------------------------------------
+#include <ti/devices/msp/msp.h>
+#include "host.h"
+
+
+//-----------------------------------------------------------------------------
+// Define symbolic constants used by the program
+//-----------------------------------------------------------------------------
+// Depth of the UART0 receive FIFO
+#define HOST_UART_RX_FIFO_SIZE                                               (4)
+
+
+//-----------------------------------------------------------------------------
+// Define global variables and structures here.
+// NOTE: when possible avoid using global variables
+//-----------------------------------------------------------------------------
+SPI_Regs     host_spi1;
+UART_Regs    host_uart0;
+DMA_Regs     host_dma;
+ADC12_Regs   host_adc0;
+GPTIMER_Regs host_timg6;
+IOMUX_Regs   host_iomux;
+VREF_Regs    host_vref;
+GPIO_Regs    host_gpioa;
+RTC_Regs     host_rtc;
+
+// Bytes received by UART0 and not yet read from RXDATA
+static uint8_t g_host_uart_rx_fifo[HOST_UART_RX_FIFO_SIZE];
+static uint8_t g_host_uart_rx_count = 0;
+
+// Where bytes written to TXDATA go, and whether TXFIFO[0] holds one not yet
+// sent there
+static host_uart_tx_hook_t g_host_uart_tx_hook = NULL;
+static bool g_host_uart_tx_pending = false;
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function zeroes every register block, empties the UART0 receive
+//    FIFO and drops a byte written to TXDATA but not yet sent.
+//
+// INPUT PARAMETERS:
+//   none
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+void host_regs_reset(void)
+{
+  memset(&host_spi1, 0, sizeof(host_spi1));
+  memset(&host_uart0, 0, sizeof(host_uart0));
+  memset(&host_dma, 0, sizeof(host_dma));
+  memset(&host_adc0, 0, sizeof(host_adc0));
+  memset(&host_timg6, 0, sizeof(host_timg6));
+  memset(&host_iomux, 0, sizeof(host_iomux));
+  memset(&host_vref, 0, sizeof(host_vref));
+  memset(&host_gpioa, 0, sizeof(host_gpioa));
+  memset(&host_rtc, 0, sizeof(host_rtc));
+
+  g_host_uart_rx_count = 0;
+  g_host_uart_tx_pending = false;
+  host_uart0.STAT = UART_STAT_RXFE_SET;
+} /* host_regs_reset */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function receives a byte into the UART0 receive FIFO, as the
+//    line does when a stop bit ends. A full FIFO overruns and loses it.
+//
+// INPUT PARAMETERS:
+//   data - the byte received
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   true  - if the byte is in the FIFO
+//   false - if the FIFO was full
+// -----------------------------------------------------------------------------
+bool host_uart_rx_push(uint8_t data)
+{
+  if (g_host_uart_rx_count == HOST_UART_RX_FIFO_SIZE)
+  {
+    return false;
+  } /* if */
+
+  g_host_uart_rx_fifo[g_host_uart_rx_count++] = data;
+  host_uart0.STAT &= ~UART_STAT_RXFE_MASK;
+
+  return true;
+} /* host_uart_rx_push */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function is what a read of UART0's RXDATA does, through the macro
+//    in m0p/mspm0g350x.h. It takes the oldest byte out of the FIFO into
+//    RXFIFO[0], where the read finds it, and sets RXFE once the FIFO is
+//    empty. An empty FIFO reads the last byte again.
+//
+// INPUT PARAMETERS:
+//   none
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   0, the index of RXFIFO to read
+// -----------------------------------------------------------------------------
+uint32_t host_uart_rx_pop(void)
+{
+  if (g_host_uart_rx_count > 0)
+  {
+    host_uart0.RXFIFO[0] = g_host_uart_rx_fifo[0];
+    memmove(g_host_uart_rx_fifo, g_host_uart_rx_fifo + 1,
+            --g_host_uart_rx_count);
+  } /* if */
+
+  if (g_host_uart_rx_count == 0)
+  {
+    host_uart0.STAT |= UART_STAT_RXFE_SET;
+  } /* if */
+
+  return 0;
+} /* host_uart_rx_pop */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function sets where the bytes UART0 sends go. Without a hook they
+//    are dropped.
+//
+// INPUT PARAMETERS:
+//   hook - called with each byte sent, or NULL
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+void host_set_uart_tx_hook(host_uart_tx_hook_t hook)
+{
+  g_host_uart_tx_hook = hook;
+} /* host_set_uart_tx_hook */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function is what a write to UART0's TXDATA does, through the macro
+//    in m0p/mspm0g350x.h. The byte lands in TXFIFO[0] after this returns, so
+//    the byte the last write left there is sent first. The FIFO never fills.
+//
+// INPUT PARAMETERS:
+//   none
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   0, the index of TXFIFO to write
+// -----------------------------------------------------------------------------
+uint32_t host_uart_tx_slot(void)
+{
+  host_uart_tx_flush();
+  g_host_uart_tx_pending = true;
+
+  return 0;
+} /* host_uart_tx_slot */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function sends the byte the last write to TXDATA left in
+//    TXFIFO[0], if it has not been sent yet.
+//
+// INPUT PARAMETERS:
+//   none
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+void host_uart_tx_flush(void)
+{
+  if (g_host_uart_tx_pending)
+  {
+    g_host_uart_tx_pending = false;
+    if (g_host_uart_tx_hook != NULL)
+    {
+      g_host_uart_tx_hook((uint8_t)host_uart0.TXFIFO[0]);
+    } /* if */
+  } /* if */
+} /* host_uart_tx_flush */
@@ -0,0 +1,61 @@
+// *****************************************************************************
+// ***************************    C Source Code     ****************************
+// *****************************************************************************
+//   DESIGNER NAME:  Rafael Ortiz
+//
+//         VERSION:  1.0
+//
+//       FILE NAME:  sim.h
+//
+//-----------------------------------------------------------------------------
+// DESCRIPTION
+//    This file contains the interface between the parts of the MOSS simulator,
+//    which builds main.c and the drivers above the registers unmodified as a
+//    Linux process. sim_kernel.c runs the tasks and keeps the simulated time;
+//    sim_board.c models what is wired to the MSPM0: the UART on stdin and
+//    stdout, the ILI9341, the LCD1602, the RTC, the thermistor and the flash.
+//
+//-----------------------------------------------------------------------------
+// DISCLAIMER
+//    This code was developed for educational purposes as part of the CSC202
+//    course and is provided "as is" without warranties of any kind, whether
+//    express, implied, or statutory.
+//
+//    The author and organization do not warrant the accuracy, completeness, or
+//    reliability of the code. The author and organization shall not be liable
+//    for any direct, indirect, incidental, special, exemplary, or consequential
+//    damages arising out of the use of or inability to use the code, even if
+//    advised of the possibility of such damages.
+//
+//    Use of this code is at your own risk, and it is recommended to validate
+//    and adapt the code for your specific application and hardware requirements.
+//
+// Copyright (c) 2024 by TBD
+//    You may use, edit, run or distribute this file as long as the above
+//    copyright notice remains
+// *****************************************************************************
+//******************************************************************************
+
+#ifndef __SIM_H__
+#define __SIM_H__
+
+//-----------------------------------------------------------------------------
+// Loads standard C include files
+//-----------------------------------------------------------------------------
+#include <stdbool.h>
+#include <stdint.h>
+
+
+// ----------------------------------------------------------------------------
+// Prototype for support functions
+// ----------------------------------------------------------------------------
+uint64_t sim_now_us(void);
+void sim_advance_us(uint64_t us);
+void sim_advance_cycles(uint64_t cycles);
+
+void sim_board_init(void);
+void sim_board_second(void);
+bool sim_board_read_input(void);
+void sim_board_exit(void);
+
+#endif /* __SIM_H__ */
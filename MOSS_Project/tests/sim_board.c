@@ -0,0 +1,760 @@
+// *****************************************************************************
+// ***************************    C Source Code     ****************************
+// *****************************************************************************
+//   DESIGNER NAME:  Rafael Ortiz
+//
+//         VERSION:  1.0
+//
+//       FILE NAME:  sim_board.c
+//
+//-----------------------------------------------------------------------------
+// DESCRIPTION
+//    This file is the board the simulator runs MOSS on, in place of the parts
+//    of the LaunchPad the kernel, shell and tasks use. UART0 sends to stdout
+//    and receives from stdin. The ILI9341 is the panel model the display driver
+//    writes into, saved as a PPM image at the end of the run. The LCD1602 is an
+//    HD44780 model fed by the bytes sent to its I2C port expander, printed as a
+//    text grid at the end. The RTC counts simulated seconds from 12:00:00, the
+//    ADC reads a fixed temperature, and the flash is a file.
+//
+//-----------------------------------------------------------------------------
+// DISCLAIMER
+//    This code was developed for educational purposes as part of the CSC202
+//    course and is provided "as is" without warranties of any kind, whether
+//    express, implied, or statutory.
+//
+//    The author and organization do not warrant the accuracy, completeness, or
+//    reliability of the code. The author and organization shall not be liable
+//    for any direct, indirect, incidental, special, exemplary, or consequential
+//    damages arising out of the use of or inability to use the code, even if
+//    advised of the possibility of such damages.
+//
+//    Use of this code is at your own risk, and it is recommended to validate
+//    and adapt the code for your specific application and hardware requirements.
+//
+// Copyright (c) 2024 by TBD
+//    You may use, edit, run or distribute this file as long as the above
+//    copyright notice remains
+// *****************************************************************************
+
+
+//-----------------------------------------------------------------------------
+// Load standard C include files
+//-----------------------------------------------------------------------------
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+
+//-----------------------------------------------------------------------------
+// Loads MSP launchpad board support macros and definitions
+//-----------------------------------------------------------------------------
+#include <ti/devices/msp/msp.h>
+#include "LaunchPad.h"
+#include "kernel.h"
+#include "clock.h"
+#include "uart.h"
+#include "shell.h"
+#include "adc.h"
+#include "lcd1602.h"
+#include "ili9341.h"
+#include "spi.h"
+#include "flash.h"
+#include "store.h"
+#include "flash_file.h"
+#include "host.h"
+#include "host_panel.h"
+#include "sim.h"
+
+
+//-----------------------------------------------------------------------------
+// Define symbolic constants used by the program
+//-----------------------------------------------------------------------------
+// Files the run writes and reads, unless the environment names others
+#define SIM_FLASH_FILE                                    ("moss_sim_flash.bin")
+#define SIM_PPM_FILE                                            ("moss_sim.ppm")
+#define SIM_DEFAULT_TEMP_C                                                (23.5)
+
+// The RTC starts at noon
+#define SIM_RTC_START_HOUR                                                  (12)
+
+// Time a byte takes on the wire: 10 bits on UART0 and 9 on the I2C bus
+#define SIM_UART_BYTE_US                          (10 * 1000000 / BAUD_RATE + 1)
+#define SIM_I2C_BYTE_US                         (9 * 1000000 / I2C_BUS_SPEED_HZ)
+
+// HD44780 display memory, and the commands and flags the model decodes
+#define SIM_LCD_DDRAM_SIZE                                                (0x80)
+#define SIM_LCD_DDRAM_MASK                                                (0x7F)
+#define SIM_LCD_SET_DDRAM_CMD                                             (0x80)
+#define SIM_LCD_SET_CGRAM_CMD                                             (0x40)
+#define SIM_LCD_FUNCTION_MASK                                             (0xE0)
+#define SIM_LCD_FUNCTION_SET_CMD                                          (0x20)
+#define SIM_LCD_8BIT_FLAG                                                 (0x10)
+#define SIM_LCD_HOME_MASK                                                 (0xFE)
+
+#define SIM_PPM_MAX_VALUE                                                  (255)
+
+
+//-----------------------------------------------------------------------------
+// Define global variables and structures here.
+// NOTE: when possible avoid using global variables
+//-----------------------------------------------------------------------------
+// The HD44780 behind the PCF8574 port expander
+typedef struct
+{
+  uint8_t ddram[SIM_LCD_DDRAM_SIZE];
+  uint8_t addr;
+  uint8_t port;
+  uint8_t high_nibble;
+  bool    four_bit;
+  bool    have_high;
+  uint32_t strobes;
+} sim_lcd_struct;
+
+static sim_lcd_struct g_sim_lcd;
+
+static uint32_t g_sim_bus_clock = CLOCK_MAX_FREQ;
+static clock_notifier_t g_sim_notifiers[CLOCK_MAX_NOTIFIERS];
+static uint8_t g_sim_notifier_count = 0;
+
+// I2C traffic since the shell last cleared it, and since the run started
+static i2c_stats_struct g_sim_i2c_stats;
+static uint32_t g_sim_i2c_xfers = 0;
+static uint32_t g_sim_i2c_bytes = 0;
+static uint32_t g_sim_uart_tx_bytes = 0;
+static uint32_t g_sim_uart_rx_bytes = 0;
+static uint32_t g_sim_led_toggles = 0;
+static bool g_sim_led_on = false;
+
+
+//-----------------------------------------------------------------------------
+// Prototype for local functions
+//-----------------------------------------------------------------------------
+static void sim_uart_tx(uint8_t data);
+static void sim_lcd_port(uint8_t port);
+static void sim_lcd_strobe(uint8_t port);
+static void sim_lcd_execute(bool data_reg, uint8_t value);
+static void sim_adc_set_temperature(void);
+static void sim_write_ppm(const char *path);
+static void sim_print_lcd(void);
+static const char *sim_env(const char *name, const char *fallback);
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function brings up the board the way kernel_init does on the
+//    target: the clock, the LCD1602, the ADC, the RTC and the display, which
+//    is filled white. UART0 is brought up later by the shell.
+//
+// INPUT PARAMETERS:
+//   none
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+void sim_board_init(void)
+{
+  host_regs_reset();
+  host_panel_reset();
+  host_set_uart_tx_hook(sim_uart_tx);
+
+  memset(&g_sim_lcd, ' ', sizeof(g_sim_lcd.ddram));
+  g_sim_lcd.addr = 0;
+  g_sim_lcd.port = 0;
+  g_sim_lcd.four_bit = false;
+  g_sim_lcd.have_high = false;
+  g_sim_lcd.strobes = 0;
+
+  clock_init_80mhz();
+  I2C_init();
+  lcd1602_init();
+  ADC0_init(ADC12_MEMCTL_VRSEL_VDDA_VSSA);
+  sim_adc_set_temperature();
+  lp_leds_init();
+  RTC->HOUR = SIM_RTC_START_HOUR;
+  ili9341_init();
+  ili9341_fill_screen(ILI9341_WHITE);
+} /* sim_board_init */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function is the RTC second interrupt: it moves the clock on a
+//    second and signals the tasks.
+//
+// INPUT PARAMETERS:
+//   none
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+void sim_board_second(void)
+{
+  if (++RTC->SEC == 60)
+  {
+    RTC->SEC = 0;
+    if (++RTC->MIN == 60)
+    {
+      RTC->MIN = 0;
+      if (++RTC->HOUR == 24)
+      {
+        RTC->HOUR = 0;
+      } /* if */
+    } /* if */
+  } /* if */
+
+  kernel_signal_event(KERNEL_EVENT_RTC_SECOND);
+} /* sim_board_second */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function receives the next byte of stdin on UART0 and runs the
+//    UART0 receive interrupt for it. A newline arrives as the carriage
+//    return a terminal sends.
+//
+// INPUT PARAMETERS:
+//   none
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   false once stdin has ended, else true
+// -----------------------------------------------------------------------------
+bool sim_board_read_input(void)
+{
+  int data = getchar();
+
+  if (data == EOF)
+  {
+    return false;
+  } /* if */
+
+  if (data == '\n')
+  {
+    data = CARRIAGE_RETURN_CHAR;
+  } /* if */
+
+  sim_advance_us(SIM_UART_BYTE_US);
+  host_uart_rx_push((uint8_t)data);
+  g_sim_uart_rx_bytes++;
+  UART0->CPU_INT.IIDX = UART_CPU_INT_IIDX_STAT_RXIFG;
+  UART_irq_handler();
+
+  return true;
+} /* sim_board_read_input */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function ends the run: it saves the display as a PPM image, prints
+//    the LCD1602 and what each driver moved to stderr, and closes the flash
+//    file.
+//
+// INPUT PARAMETERS:
+//   none
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+void sim_board_exit(void)
+{
+  host_panel_stats_struct panel;
+  const char *ppm = sim_env("MOSS_SIM_PPM", SIM_PPM_FILE);
+
+  host_uart_tx_flush();
+  fflush(stdout);
+
+  host_panel_get_stats(&panel);
+  sim_write_ppm(ppm);
+  sim_print_lcd();
+
+  fprintf(stderr, "sim: uart0 %u bytes out, %u in\n",
+          (unsigned)g_sim_uart_tx_bytes, (unsigned)g_sim_uart_rx_bytes);
+  fprintf(stderr, "sim: spi1 %u bytes, %u commands, %u windows, %u pixels "
+          "-> %s\n", (unsigned)panel.bytes, (unsigned)panel.commands,
+          (unsigned)panel.windows, (unsigned)panel.pixels, ppm);
+  fprintf(stderr, "sim: i2c %u transfers, %u bytes, %u lcd strobes\n",
+          (unsigned)g_sim_i2c_xfers, (unsigned)g_sim_i2c_bytes,
+          (unsigned)g_sim_lcd.strobes);
+  fprintf(stderr, "sim: red led toggled %u times\n",
+          (unsigned)g_sim_led_toggles);
+
+  flash_file_close();
+} /* sim_board_exit */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    These functions stand in for the clock driver. The bus clock only
+//    changes the simulated time busy-waits take.
+// -----------------------------------------------------------------------------
+void clock_init_80mhz(void)
+{
+  g_sim_bus_clock = CLOCK_MAX_FREQ;
+} /* clock_init_80mhz */
+
+
+uint32_t get_bus_clock_freq(void)
+{
+  return g_sim_bus_clock;
+} /* get_bus_clock_freq */
+
+
+bool clock_register_notifier(clock_notifier_t notifier)
+{
+  if (g_sim_notifier_count >= CLOCK_MAX_NOTIFIERS)
+  {
+    return false;
+  } /* if */
+
+  g_sim_notifiers[g_sim_notifier_count++] = notifier;
+  return true;
+} /* clock_register_notifier */
+
+
+bool clock_set_freq(uint32_t freq)
+{
+  clock_config_struct config;
+
+  if (!clock_solve(freq, &config))
+  {
+    return false;
+  } /* if */
+
+  if (freq == g_sim_bus_clock)
+  {
+    return true;
+  } /* if */
+
+  for (uint8_t i = 0; i < g_sim_notifier_count; i++)
+  {
+    g_sim_notifiers[i](CLOCK_CHANGE_PREPARE, freq);
+  } /* for */
+
+  g_sim_bus_clock = freq;
+
+  for (uint8_t i = 0; i < g_sim_notifier_count; i++)
+  {
+    g_sim_notifiers[i](CLOCK_CHANGE_COMMIT, freq);
+  } /* for */
+
+  return true;
+} /* clock_set_freq */
+
+
+void clock_delay(uint32_t cycles)
+{
+  sim_advance_cycles(cycles);
+} /* clock_delay */
+
+
+void msec_sleep(uint32_t ms)
+{
+  sim_advance_us((uint64_t)ms * 1000);
+} /* msec_sleep */
+
+
+uint64_t now_us(void)
+{
+  return sim_now_us();
+} /* now_us */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    These functions stand in for the LaunchPad I2C and LED drivers. Every
+//    byte sent to the LCD1602 address drives the port expander, and a
+//    transfer takes the time its bytes take on the bus.
+// -----------------------------------------------------------------------------
+void I2C_init(void)
+{
+  memset(&g_sim_i2c_stats, 0, sizeof(g_sim_i2c_stats));
+} /* I2C_init */
+
+
+uint32_t I2C_send(uint8_t slave, const uint8_t *buffer, uint16_t count)
+{
+  if (count == 0)
+  {
+    return 0;
+  } /* if */
+
+  if (slave != LCD_IIC_ADDRESS)
+  {
+    g_sim_i2c_stats.nacks++;
+    return 0;
+  } /* if */
+
+  for (uint16_t i = 0; i < count; i++)
+  {
+    sim_lcd_port(buffer[i]);
+  } /* for */
+
+  g_sim_i2c_stats.xfers++;
+  g_sim_i2c_stats.tx_bytes += count;
+  g_sim_i2c_xfers++;
+  g_sim_i2c_bytes += count;
+  sim_advance_us((uint64_t)(count + 1) * SIM_I2C_BYTE_US);
+
+  return 1;
+} /* I2C_send */
+
+
+uint32_t I2C_send1(uint8_t slave, uint8_t data)
+{
+  return I2C_send(slave, &data, 1);
+} /* I2C_send1 */
+
+
+void I2C_get_stats(i2c_stats_struct *stats)
+{
+  *stats = g_sim_i2c_stats;
+} /* I2C_get_stats */
+
+
+void I2C_clear_stats(void)
+{
+  memset(&g_sim_i2c_stats, 0, sizeof(g_sim_i2c_stats));
+} /* I2C_clear_stats */
+
+
+void lp_leds_init(void)
+{
+  g_sim_led_on = false;
+  g_sim_led_toggles = 0;
+} /* lp_leds_init */
+
+
+void lp_leds_on(uint8_t index)
+{
+  if (index == LP_RED_LED1_IDX && !g_sim_led_on)
+  {
+    g_sim_led_on = true;
+    g_sim_led_toggles++;
+  } /* if */
+} /* lp_leds_on */
+
+
+void lp_leds_off(uint8_t index)
+{
+  if (index == LP_RED_LED1_IDX && g_sim_led_on)
+  {
+    g_sim_led_on = false;
+    g_sim_led_toggles++;
+  } /* if */
+} /* lp_leds_off */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function opens the file that holds the simulated flash, so the
+//    store keeps its records from one run to the next.
+//
+// INPUT PARAMETERS:
+//   none
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   the flash device for the store
+// -----------------------------------------------------------------------------
+const flash_dev_struct *flash_get_device(void)
+{
+  const flash_dev_struct *device;
+  const char *path = sim_env("MOSS_SIM_FLASH", SIM_FLASH_FILE);
+
+  device = flash_file_open(path, FLASH_STORE_SECTORS, false);
+  if (device == NULL)
+  {
+    fprintf(stderr, "sim: cannot open %s\n", path);
+    exit(EXIT_FAILURE);
+  } /* if */
+
+  return device;
+} /* flash_get_device */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function takes each byte UART0 sends.
+//
+// INPUT PARAMETERS:
+//   data - the byte sent
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+static void sim_uart_tx(uint8_t data)
+{
+  putchar(data);
+  g_sim_uart_tx_bytes++;
+} /* sim_uart_tx */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function sets the port expander outputs. The HD44780 latches the
+//    data nibble when E falls with RW low.
+//
+// INPUT PARAMETERS:
+//   port - the new port expander outputs
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+static void sim_lcd_port(uint8_t port)
+{
+  uint8_t last = g_sim_lcd.port;
+
+  g_sim_lcd.port = port;
+
+  if ((last & LCD_EN_BIT_MASK) && !(port & LCD_EN_BIT_MASK) &&
+      !(last & LCD_RW_BIT_MASK))
+  {
+    sim_lcd_strobe(last);
+  } /* if */
+} /* sim_lcd_port */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function latches a nibble. In 8-bit mode it is a whole instruction
+//    with the low data lines unconnected; in 4-bit mode two nibbles, high
+//    first, make one.
+//
+// INPUT PARAMETERS:
+//   port - the port expander outputs while E was high
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+static void sim_lcd_strobe(uint8_t port)
+{
+  bool data_reg = (port & LCD_RS_BIT_MASK) != 0;
+  uint8_t nibble = port >> NIBBLE_SHIFT;
+
+  g_sim_lcd.strobes++;
+
+  if (!g_sim_lcd.four_bit)
+  {
+    sim_lcd_execute(data_reg, nibble << NIBBLE_SHIFT);
+  } /* if */
+  else if (!g_sim_lcd.have_high)
+  {
+    g_sim_lcd.high_nibble = nibble;
+    g_sim_lcd.have_high = true;
+  } /* else if */
+  else
+  {
+    g_sim_lcd.have_high = false;
+    sim_lcd_execute(data_reg,
+                    (g_sim_lcd.high_nibble << NIBBLE_SHIFT) | nibble);
+  } /* else */
+} /* sim_lcd_strobe */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function runs an HD44780 instruction or writes a character. Only
+//    what the LCD1602 driver relies on is modelled: function set, clear,
+//    home, and setting and advancing the display memory address.
+//
+// INPUT PARAMETERS:
+//   data_reg - true for a character, false for an instruction
+//   value    - the character or instruction
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+static void sim_lcd_execute(bool data_reg, uint8_t value)
+{
+  if (data_reg)
+  {
+    g_sim_lcd.ddram[g_sim_lcd.addr] = value;
+    g_sim_lcd.addr = (g_sim_lcd.addr + 1) & SIM_LCD_DDRAM_MASK;
+  } /* if */
+  else if (value & SIM_LCD_SET_DDRAM_CMD)
+  {
+    g_sim_lcd.addr = value & SIM_LCD_DDRAM_MASK;
+  } /* else if */
+  else if (value & SIM_LCD_SET_CGRAM_CMD)
+  {
+    // Custom characters are not modelled
+  } /* else if */
+  else if ((value & SIM_LCD_FUNCTION_MASK) == SIM_LCD_FUNCTION_SET_CMD)
+  {
+    g_sim_lcd.four_bit = (value & SIM_LCD_8BIT_FLAG) == 0;
+  } /* else if */
+  else if (value == LCD_CLEAR_DISPLAY_CMD)
+  {
+    memset(g_sim_lcd.ddram, ' ', sizeof(g_sim_lcd.ddram));
+    g_sim_lcd.addr = 0;
+  } /* else if */
+  else if ((value & SIM_LCD_HOME_MASK) == LCD_RETURN_HOME_CMD)
+  {
+    g_sim_lcd.addr = 0;
+  } /* else if */
+} /* sim_lcd_execute */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function sets the ADC result to the code that reads closest to
+//    the temperature in MOSS_SIM_TEMP, in degrees C.
+//
+// INPUT PARAMETERS:
+//   none
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+static void sim_adc_set_temperature(void)
+{
+  const char *text = getenv("MOSS_SIM_TEMP");
+  float target = (text != NULL) ? strtof(text, NULL) : SIM_DEFAULT_TEMP_C;
+  float best_error = INFINITY;
+  uint16_t best = 0;
+  float error;
+
+  for (uint16_t code = 0; code <= ADC_MAX_CODE; code++)
+  {
+    error = fabsf(thermistor_calc_temperature(code) - target);
+    if (error < best_error)
+    {
+      best_error = error;
+      best = code;
+    } /* if */
+  } /* for */
+
+  ADC0->ULLMEM.MEMRES[0] = best;
+} /* sim_adc_set_temperature */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function saves what the display shows as a binary PPM image, with
+//    the vertical scroll applied the way the panel scans it out.
+//
+// INPUT PARAMETERS:
+//   path - the file to write
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+static void sim_write_ppm(const char *path)
+{
+  FILE *file = fopen(path, "wb");
+  uint16_t pixel;
+  uint16_t line;
+
+  if (file == NULL)
+  {
+    fprintf(stderr, "sim: cannot write %s\n", path);
+    return;
+  } /* if */
+
+  fprintf(file, "P6\n%u %u\n%u\n", ILI9341_TFTWIDTH, ILI9341_TFTHEIGHT,
+          SIM_PPM_MAX_VALUE);
+  for (uint16_t y = 0; y < ILI9341_TFTHEIGHT; y++)
+  {
+    line = host_panel_screen_line(y);
+    for (uint16_t x = 0; x < ILI9341_TFTWIDTH; x++)
+    {
+      pixel = host_panel_pixel(x, line);
+      fputc(((pixel >> 11) & 0x1F) * SIM_PPM_MAX_VALUE / 0x1F, file);
+      fputc(((pixel >> 5) & 0x3F) * SIM_PPM_MAX_VALUE / 0x3F, file);
+      fputc((pixel & 0x1F) * SIM_PPM_MAX_VALUE / 0x1F, file);
+    } /* for */
+  } /* for */
+
+  fclose(file);
+} /* sim_write_ppm */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function prints the two lines the LCD1602 shows.
+//
+// INPUT PARAMETERS:
+//   none
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+static void sim_print_lcd(void)
+{
+  static const uint8_t line_addr[LINES_PER_LCD] = {LCD_LINE1_ADDR,
+                                                   LCD_LINE2_ADDR};
+  uint8_t data;
+
+  fprintf(stderr, "sim: lcd1602 +----------------+\n");
+  for (uint8_t line = 0; line < LINES_PER_LCD; line++)
+  {
+    fprintf(stderr, "sim: lcd1602 |");
+    for (uint8_t i = 0; i < CHARACTERS_PER_LCD_LINE; i++)
+    {
+      data = g_sim_lcd.ddram[line_addr[line] + i];
+      fputc((data >= ' ' && data < 0x7F) ? data : '?', stderr);
+    } /* for */
+    fprintf(stderr, "|\n");
+  } /* for */
+  fprintf(stderr, "sim: lcd1602 +----------------+\n");
+} /* sim_print_lcd */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function reads a setting from the environment.
+//
+// INPUT PARAMETERS:
+//   name     - the environment variable
+//   fallback - the value when it is not set
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   the setting
+// -----------------------------------------------------------------------------
+static const char *sim_env(const char *name, const char *fallback)
+{
+  const char *value = getenv(name);
+
+  return (value != NULL && value[0] != '\0') ? value : fallback;
+} /* sim_env */
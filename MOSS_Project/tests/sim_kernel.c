@@ -0,0 +1,858 @@
+// *****************************************************************************
+// ***************************    C Source Code     ****************************
+// *****************************************************************************
+//   DESIGNER NAME:  Rafael Ortiz
+//
+//         VERSION:  1.0
+//
+//       FILE NAME:  sim_kernel.c
+//
+//-----------------------------------------------------------------------------
+// DESCRIPTION
+//    This file runs the MOSS kernel API for the simulator. Each task runs on
+//    its own host stack and they switch only where the target's tasks block:
+//    sleeping, waiting for an event or yielding. Time is simulated: it moves
+//    when a task busy-waits and, when every task is blocked, jumps to the next
+//    thing due, as the idle task's tickless sleep does. The idle loop is also
+//    where the UART receives: a byte of stdin is fed in whenever a task is
+//    waiting for one. When stdin ends the simulator runs on for a while so
+//    the tasks can settle, then the board writes its outputs and the process
+//    exits.
+//
+//-----------------------------------------------------------------------------
+// DISCLAIMER
+//    This code was developed for educational purposes as part of the CSC202
+//    course and is provided "as is" without warranties of any kind, whether
+//    express, implied, or statutory.
+//
+//    The author and organization do not warrant the accuracy, completeness, or
+//    reliability of the code. The author and organization shall not be liable
+//    for any direct, indirect, incidental, special, exemplary, or consequential
+//    damages arising out of the use of or inability to use the code, even if
+//    advised of the possibility of such damages.
+//
+//    Use of this code is at your own risk, and it is recommended to validate
+//    and adapt the code for your specific application and hardware requirements.
+//
+// Copyright (c) 2024 by TBD
+//    You may use, edit, run or distribute this file as long as the above
+//    copyright notice remains
+// *****************************************************************************
+
+
+//-----------------------------------------------------------------------------
+// Load standard C include files
+//-----------------------------------------------------------------------------
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <ucontext.h>
+
+
+//-----------------------------------------------------------------------------
+// Loads MSP launchpad board support macros and definitions
+//-----------------------------------------------------------------------------
+#include "kernel.h"
+#include "clock.h"
+#include "host.h"
+#include "sim.h"
+
+
+//-----------------------------------------------------------------------------
+// Define symbolic constants used by the program
+//-----------------------------------------------------------------------------
+// Host stack per task. Host frames are far larger than the target's, so
+// the sizes passed to kernel_create_task are not used.
+#define SIM_TASK_STACK_SIZE                                         (256 * 1024)
+
+// No task is running: the scheduler loop, which stands in for the idle task
+#define SIM_NO_TASK                                                         (-1)
+
+#define SIM_US_PER_TICK                                                   (1000)
+#define SIM_TICKS_PER_SECOND                                              (1000)
+
+// How long the tasks run on after stdin ends, and how long they may run
+// with input left and no task reading it before the run counts as stuck
+#define SIM_SETTLE_MS                                                     (3000)
+#define SIM_STALL_MS                                                     (60000)
+
+// Window measure_clock counts over
+#define SIM_MEASURE_CLOCK_MS                                               (100)
+
+
+//-----------------------------------------------------------------------------
+// Define global variables and structures here.
+// NOTE: when possible avoid using global variables
+//-----------------------------------------------------------------------------
+typedef struct
+{
+  ucontext_t   context;
+  task_entry_t entry;
+  uint32_t     wake_tick;
+  uint32_t     wait_mask;
+  const char  *name;
+  uint8_t      state;
+  bool         wait_timed;
+} sim_task_struct;
+
+static sim_task_struct g_sim_tasks[KERNEL_MAX_TASKS];
+static uint8_t g_sim_task_count = 0;
+static int8_t g_sim_current = SIM_NO_TASK;
+static uint8_t g_sim_last = 0;
+static ucontext_t g_sim_scheduler;
+
+static uint32_t g_pending_events = 0;
+static uint8_t g_lock_count = 0;
+
+// Simulated time, the tick count it gives, and cycles of busy-waiting not
+// yet a whole microsecond
+static uint64_t g_sim_now_us = 0;
+static uint32_t g_kernel_ticks = 0;
+static uint64_t g_sim_cycle_rest = 0;
+
+// Time the scheduler spent with every task blocked
+static uint64_t g_sim_idle_us = 0;
+static uint64_t g_sim_idle_mark_us = 0;
+static uint32_t g_sim_idle_wakeups = 0;
+static uint32_t g_idle_stats_start = 0;
+
+// Whether stdin has ended, when the run ends once it has, and when a task
+// last waited for input
+static bool g_sim_input_done = false;
+static uint64_t g_sim_end_us = 0;
+static uint64_t g_sim_reader_us = 0;
+
+
+//-----------------------------------------------------------------------------
+// Prototype for local functions
+//-----------------------------------------------------------------------------
+static void sim_tick(void);
+static void sim_task_start(void);
+static void sim_switch(void);
+static int8_t sim_next_ready(void);
+static bool sim_waiting_for(uint32_t events);
+static uint64_t sim_us_to_wake(void);
+static void sim_idle(void);
+static void sim_finish(int status);
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function sets up the board in place of the target's peripherals.
+//
+// INPUT PARAMETERS:
+//   none
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+void kernel_init(void)
+{
+  sim_board_init();
+} /* kernel_init */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function busy-waits the 100 ms window the target measures over and
+//    returns the bus clock cycles in it, which is what the target measures.
+//
+// INPUT PARAMETERS:
+//   none
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   The bus clock cycles in 100 ms
+// -----------------------------------------------------------------------------
+uint32_t measure_clock(void)
+{
+  sim_advance_us((uint64_t)SIM_MEASURE_CLOCK_MS * SIM_US_PER_TICK);
+  return get_bus_clock_freq() / (SIM_TICKS_PER_SECOND / SIM_MEASURE_CLOCK_MS);
+} /* measure_clock */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function creates a task on a host stack. Tasks must be created
+//    before kernel_start is called.
+//
+// INPUT PARAMETERS:
+//   entry      - function the task runs
+//   stack_size - size of the task stack on the target, not used
+//   name       - name of the task
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   The task index, or KERNEL_INVALID_TASK if there is no room for the task
+// -----------------------------------------------------------------------------
+int8_t kernel_create_task(task_entry_t entry, uint16_t stack_size,
+                          const char *name)
+{
+  sim_task_struct *task;
+
+  (void)stack_size;
+
+  if (g_sim_task_count >= KERNEL_MAX_TASKS)
+  {
+    return KERNEL_INVALID_TASK;
+  } /* if */
+
+  task = &g_sim_tasks[g_sim_task_count];
+  if (getcontext(&task->context) != 0)
+  {
+    return KERNEL_INVALID_TASK;
+  } /* if */
+  task->context.uc_stack.ss_sp = malloc(SIM_TASK_STACK_SIZE);
+  task->context.uc_stack.ss_size = SIM_TASK_STACK_SIZE;
+  task->context.uc_link = NULL;
+  if (task->context.uc_stack.ss_sp == NULL)
+  {
+    return KERNEL_INVALID_TASK;
+  } /* if */
+  makecontext(&task->context, sim_task_start, 0);
+
+  task->entry = entry;
+  task->name = name;
+  task->state = TASK_READY;
+
+  return g_sim_task_count++;
+} /* kernel_create_task */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function runs the tasks round robin, each until it blocks, and the
+//    idle loop whenever none is ready. It does not return; the process exits
+//    from the idle loop once the run is over.
+//
+// INPUT PARAMETERS:
+//   none
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+void kernel_start(void)
+{
+  int8_t next;
+
+  g_sim_reader_us = g_sim_now_us;
+
+  while (1)
+  {
+    next = sim_next_ready();
+    if (next == SIM_NO_TASK)
+    {
+      sim_idle();
+      continue;
+    } /* if */
+
+    g_sim_current = next;
+    g_sim_last = next;
+    swapcontext(&g_sim_scheduler, &g_sim_tasks[next].context);
+    g_sim_current = SIM_NO_TASK;
+  } /* while */
+} /* kernel_start */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function moves the simulated time on to the next tick.
+//
+// INPUT PARAMETERS:
+//   none
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+void kernel_tick(void)
+{
+  sim_advance_us(SIM_US_PER_TICK - g_sim_now_us % SIM_US_PER_TICK);
+} /* kernel_tick */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function lets the other ready tasks run before the running task
+//    goes on.
+//
+// INPUT PARAMETERS:
+//   none
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+void kernel_yield(void)
+{
+  if (g_sim_current != SIM_NO_TASK && g_lock_count == 0)
+  {
+    sim_switch();
+  } /* if */
+} /* kernel_yield */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function blocks the running task for at least the given number of
+//    milliseconds. Before the scheduler has started the time just passes.
+//
+// INPUT PARAMETERS:
+//   ms - number of milliseconds to sleep
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+void kernel_sleep(uint32_t ms)
+{
+  sim_task_struct *task;
+
+  if (g_sim_current == SIM_NO_TASK)
+  {
+    sim_advance_us((uint64_t)ms * SIM_US_PER_TICK);
+    return;
+  } /* if */
+
+  task = &g_sim_tasks[g_sim_current];
+  task->wake_tick = g_kernel_ticks + ms;
+  task->state = TASK_SLEEPING;
+  sim_switch();
+} /* kernel_sleep */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function blocks the running task until one of the events in the mask
+//    is signaled, as kernel_wait_event_timeout does with no timeout.
+//
+// INPUT PARAMETERS:
+//   mask - bitmask of KERNEL_EVENT_xxx flags to wait for
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   The events from the mask that were signaled
+// -----------------------------------------------------------------------------
+uint32_t kernel_wait_event(uint32_t mask)
+{
+  return kernel_wait_event_timeout(mask, KERNEL_WAIT_FOREVER);
+} /* kernel_wait_event */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function waits for events the way the target kernel does: pending
+//    events return at once and are cleared, otherwise the task blocks until
+//    kernel_signal_event or the timeout wakes it. Before the scheduler has
+//    started the time passes a tick at a time until an event or the timeout.
+//
+// INPUT PARAMETERS:
+//   mask - bitmask of KERNEL_EVENT_xxx flags to wait for
+//   ms   - the longest time to wait in milliseconds, 0 to only check for
+//          pending events, or KERNEL_WAIT_FOREVER
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   The events from the mask that were signaled, or 0 on timeout
+// -----------------------------------------------------------------------------
+uint32_t kernel_wait_event_timeout(uint32_t mask, uint32_t ms)
+{
+  sim_task_struct *task;
+  uint32_t start_ticks = g_kernel_ticks;
+  uint32_t events;
+
+  if (g_sim_current == SIM_NO_TASK)
+  {
+    while (((g_pending_events & mask) == 0) && (ms != KERNEL_WAIT_FOREVER) &&
+           (g_kernel_ticks - start_ticks < ms))
+    {
+      kernel_tick();
+    } /* while */
+  } /* if */
+
+  events = g_pending_events & mask;
+  if (events != 0 || ms == 0 || g_sim_current == SIM_NO_TASK)
+  {
+    g_pending_events &= ~events;
+    return events;
+  } /* if */
+
+  task = &g_sim_tasks[g_sim_current];
+  task->wait_mask = mask;
+  task->wake_tick = g_kernel_ticks + ms;
+  task->wait_timed = (ms != KERNEL_WAIT_FOREVER);
+  task->state = TASK_WAITING;
+  if (mask & KERNEL_EVENT_UART_RX)
+  {
+    g_sim_reader_us = g_sim_now_us;
+  } /* if */
+  sim_switch();
+
+  return task->wait_mask;
+} /* kernel_wait_event_timeout */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function signals events to the tasks waiting on them. Each waiting
+//    task whose mask matches is made ready with its mask replaced by the
+//    events it received; events nobody is waiting for are latched.
+//
+// INPUT PARAMETERS:
+//   events - bitmask of KERNEL_EVENT_xxx flags to signal
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+void kernel_signal_event(uint32_t events)
+{
+  uint32_t delivered = 0;
+  uint8_t i;
+
+  for (i = 0; i < g_sim_task_count; i++)
+  {
+    if ((g_sim_tasks[i].state == TASK_WAITING) &&
+        (g_sim_tasks[i].wait_mask & events))
+    {
+      g_sim_tasks[i].wait_mask &= events;
+      g_sim_tasks[i].state = TASK_READY;
+      delivered |= g_sim_tasks[i].wait_mask;
+    } /* if */
+  } /* for */
+  g_pending_events |= events & ~delivered;
+} /* kernel_signal_event */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    These functions lock and unlock the scheduler. Tasks only switch where
+//    they block, so the lock only keeps kernel_yield from switching.
+// -----------------------------------------------------------------------------
+void kernel_lock(void)
+{
+  g_lock_count++;
+} /* kernel_lock */
+
+
+void kernel_unlock(void)
+{
+  if (g_lock_count > 0)
+  {
+    g_lock_count--;
+  } /* if */
+} /* kernel_unlock */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function returns the number of ticks of simulated time.
+//
+// INPUT PARAMETERS:
+//   none
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   The kernel tick count
+// -----------------------------------------------------------------------------
+uint32_t kernel_get_ticks(void)
+{
+  return g_kernel_ticks;
+} /* kernel_get_ticks */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    These functions report and clear how much of the simulated time every
+//    task was blocked, the time the target's idle task sleeps.
+// -----------------------------------------------------------------------------
+void kernel_get_idle_stats(kernel_idle_stats_struct *stats)
+{
+  stats->elapsed_ms = g_kernel_ticks - g_idle_stats_start;
+  stats->asleep_ms = (g_sim_idle_us - g_sim_idle_mark_us) / SIM_US_PER_TICK;
+  stats->wakeups = g_sim_idle_wakeups;
+} /* kernel_get_idle_stats */
+
+
+void kernel_clear_idle_stats(void)
+{
+  g_idle_stats_start = g_kernel_ticks;
+  g_sim_idle_mark_us = g_sim_idle_us;
+  g_sim_idle_wakeups = 0;
+} /* kernel_clear_idle_stats */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function returns the simulated time.
+//
+// INPUT PARAMETERS:
+//   none
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   Microseconds since the simulator started
+// -----------------------------------------------------------------------------
+uint64_t sim_now_us(void)
+{
+  return g_sim_now_us;
+} /* sim_now_us */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function moves the simulated time on. Every tick crossed wakes the
+//    tasks due, and every second crossed is an RTC second.
+//
+// INPUT PARAMETERS:
+//   us - microseconds to move on
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+void sim_advance_us(uint64_t us)
+{
+  uint64_t target = g_sim_now_us + us;
+  uint64_t next_tick;
+
+  while (g_sim_now_us < target)
+  {
+    next_tick = (g_sim_now_us / SIM_US_PER_TICK + 1) * SIM_US_PER_TICK;
+    if (next_tick > target)
+    {
+      g_sim_now_us = target;
+      break;
+    } /* if */
+
+    g_sim_now_us = next_tick;
+    sim_tick();
+  } /* while */
+} /* sim_advance_us */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function moves the simulated time on by bus clock cycles a task
+//    spent busy-waiting.
+//
+// INPUT PARAMETERS:
+//   cycles - bus clock cycles
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+void sim_advance_cycles(uint64_t cycles)
+{
+  uint32_t freq = get_bus_clock_freq();
+
+  g_sim_cycle_rest += cycles * 1000000;
+  sim_advance_us(g_sim_cycle_rest / freq);
+  g_sim_cycle_rest %= freq;
+} /* sim_advance_cycles */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function counts a tick and wakes the tasks whose sleep or wait
+//    timeout is up. It makes every thousandth tick an RTC second.
+//
+// INPUT PARAMETERS:
+//   none
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+static void sim_tick(void)
+{
+  sim_task_struct *task;
+
+  g_kernel_ticks++;
+
+  for (uint8_t i = 0; i < g_sim_task_count; i++)
+  {
+    task = &g_sim_tasks[i];
+    if ((int32_t)(g_kernel_ticks - task->wake_tick) < 0)
+    {
+      continue;
+    } /* if */
+
+    if (task->state == TASK_SLEEPING)
+    {
+      task->state = TASK_READY;
+    } /* if */
+    else if (task->state == TASK_WAITING && task->wait_timed)
+    {
+      task->wait_mask = 0;
+      task->state = TASK_READY;
+    } /* else if */
+  } /* for */
+
+  if (g_kernel_ticks % SIM_TICKS_PER_SECOND == 0)
+  {
+    sim_board_second();
+  } /* if */
+} /* sim_tick */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function is where each task starts on its host stack. A task that
+//    returns is done and is not run again.
+//
+// INPUT PARAMETERS:
+//   none
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+static void sim_task_start(void)
+{
+  g_sim_tasks[g_sim_current].entry();
+  g_sim_tasks[g_sim_current].state = TASK_DONE;
+  setcontext(&g_sim_scheduler);
+} /* sim_task_start */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function switches from the running task back to the scheduler loop.
+//
+// INPUT PARAMETERS:
+//   none
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+static void sim_switch(void)
+{
+  swapcontext(&g_sim_tasks[g_sim_current].context, &g_sim_scheduler);
+} /* sim_switch */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function picks the next ready task, round robin after the one that
+//    ran last.
+//
+// INPUT PARAMETERS:
+//   none
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   The task index, or SIM_NO_TASK if no task is ready
+// -----------------------------------------------------------------------------
+static int8_t sim_next_ready(void)
+{
+  uint8_t index;
+
+  for (uint8_t i = 1; i <= g_sim_task_count; i++)
+  {
+    index = (g_sim_last + i) % g_sim_task_count;
+    if (g_sim_tasks[index].state == TASK_READY)
+    {
+      return index;
+    } /* if */
+  } /* for */
+
+  return SIM_NO_TASK;
+} /* sim_next_ready */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function tells whether a task is waiting for any of some events.
+//
+// INPUT PARAMETERS:
+//   events - bitmask of KERNEL_EVENT_xxx flags
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   true if a task waits for one of them
+// -----------------------------------------------------------------------------
+static bool sim_waiting_for(uint32_t events)
+{
+  for (uint8_t i = 0; i < g_sim_task_count; i++)
+  {
+    if ((g_sim_tasks[i].state == TASK_WAITING) &&
+        (g_sim_tasks[i].wait_mask & events))
+    {
+      return true;
+    } /* if */
+  } /* for */
+
+  return false;
+} /* sim_waiting_for */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function returns how long until the next tick that wakes a task or
+//    is an RTC second, whichever is first.
+//
+// INPUT PARAMETERS:
+//   none
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   Microseconds to that tick
+// -----------------------------------------------------------------------------
+static uint64_t sim_us_to_wake(void)
+{
+  uint32_t ticks = SIM_TICKS_PER_SECOND - g_kernel_ticks % SIM_TICKS_PER_SECOND;
+  const sim_task_struct *task;
+  int32_t due;
+
+  for (uint8_t i = 0; i < g_sim_task_count; i++)
+  {
+    task = &g_sim_tasks[i];
+    if ((task->state == TASK_SLEEPING) ||
+        (task->state == TASK_WAITING && task->wait_timed))
+    {
+      due = (int32_t)(task->wake_tick - g_kernel_ticks);
+      if (due < 1)
+      {
+        due = 1;
+      } /* if */
+      if ((uint32_t)due < ticks)
+      {
+        ticks = due;
+      } /* if */
+    } /* if */
+  } /* for */
+
+  return (uint64_t)ticks * SIM_US_PER_TICK - g_sim_now_us % SIM_US_PER_TICK;
+} /* sim_us_to_wake */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function runs while every task is blocked. The bytes UART0 sent go
+//    out first. A task waiting for input gets the next byte of stdin; else
+//    the time jumps to the next tick a task or the RTC is due. Once stdin has
+//    ended the run stops SIM_SETTLE_MS later, and it stops with an error if
+//    input is left that no task has read for SIM_STALL_MS.
+//
+// INPUT PARAMETERS:
+//   none
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+static void sim_idle(void)
+{
+  uint64_t wake_us;
+
+  host_uart_tx_flush();
+  fflush(stdout);
+
+  if (!g_sim_input_done && sim_waiting_for(KERNEL_EVENT_UART_RX))
+  {
+    if (sim_board_read_input())
+    {
+      return;
+    } /* if */
+    g_sim_input_done = true;
+    g_sim_end_us = g_sim_now_us + (uint64_t)SIM_SETTLE_MS * SIM_US_PER_TICK;
+  } /* if */
+
+  if (g_sim_input_done && g_sim_now_us >= g_sim_end_us)
+  {
+    sim_finish(EXIT_SUCCESS);
+  } /* if */
+  if (!g_sim_input_done && (g_sim_now_us - g_sim_reader_us >=
+                            (uint64_t)SIM_STALL_MS * SIM_US_PER_TICK))
+  {
+    fprintf(stderr, "sim: no task has read input for %u ms\n",
+            (unsigned)SIM_STALL_MS);
+    sim_finish(EXIT_FAILURE);
+  } /* if */
+
+  wake_us = sim_us_to_wake();
+  if (g_sim_input_done && g_sim_now_us + wake_us > g_sim_end_us)
+  {
+    wake_us = g_sim_end_us - g_sim_now_us;
+  } /* if */
+
+  g_sim_idle_us += wake_us;
+  g_sim_idle_wakeups++;
+  sim_advance_us(wake_us);
+} /* sim_idle */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function ends the run: it prints the simulated time, has the board
+//    write its outputs and exits.
+//
+// INPUT PARAMETERS:
+//   status - the exit status
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   none, the process exits
+// -----------------------------------------------------------------------------
+static void sim_finish(int status)
+{
+  fprintf(stderr, "sim: %u.%03u s simulated, %u.%03u s with every task "
+          "blocked\n",
+          (unsigned)(g_sim_now_us / 1000000),
+          (unsigned)(g_sim_now_us / 1000 % 1000),
+          (unsigned)(g_sim_idle_us / 1000000),
+          (unsigned)(g_sim_idle_us / 1000 % 1000));
+  sim_board_exit();
+  exit(status);
+} /* sim_finish */
@@ -0,0 +1,13 @@
+// Host stub: the register fields live in ti/devices/msp/msp.h. Only uart.c
+// and shell.c include this header, and only uart.c touches UART0's data
+// registers, so it is where they get the side effects a test needs from a
+// register. Reading RXDATA takes the oldest byte out of the RX FIFO model in
+// host_regs.c, which leaves the byte in RXFIFO[0]. Writing TXDATA puts the
+// byte in TXFIFO[0], and the model sends it on before the next write lands.
+#include <ti/devices/msp/msp.h>
+
+uint32_t host_uart_rx_pop(void);
+uint32_t host_uart_tx_slot(void);
+
+#define RXDATA                                      RXFIFO[host_uart_rx_pop()]
+#define TXDATA                                     TXFIFO[host_uart_tx_slot()]
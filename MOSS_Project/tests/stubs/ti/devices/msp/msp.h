@@ -0,0 +1,501 @@
+// *****************************************************************************
+// ***************************    C Source Code     ****************************
+// *****************************************************************************
+//   DESIGNER NAME:  Rafael Ortiz
+//
+//         VERSION:  1.0
+//
+//       FILE NAME:  msp.h (host stub)
+//
+//-----------------------------------------------------------------------------
+// DESCRIPTION
+//    This file stands in for the TI device header when the drivers are built
+//    on a Linux host for the unit tests. Each peripheral is a plain struct in
+//    RAM holding only the registers the drivers touch, so a test can set a
+//    status register before a call and read back what the driver wrote.
+//    Nothing reacts to a write: there is no simulated hardware behind the
+//    registers.
+//
+//    Field values follow the MSPM0G3507 headers where a test depends on
+//    them (the SPI repeat counter, the DMA width fields and the status bits
+//    the drivers poll); the rest only need to be distinct bits. The one
+//    register that acts on a read, UART0's RXDATA, is in m0p/mspm0g350x.h.
+//
+//-----------------------------------------------------------------------------
+// DISCLAIMER
+//    This code was developed for educational purposes as part of the CSC202
+//    course and is provided "as is" without warranties of any kind, whether
+//    express, implied, or statutory.
+//
+//    The author and organization do not warrant the accuracy, completeness, or
+//    reliability of the code. The author and organization shall not be liable
+//    for any direct, indirect, incidental, special, exemplary, or consequential
+//    damages arising out of the use of or inability to use the code, even if
+//    advised of the possibility of such damages.
+//
+//    Use of this code is at your own risk, and it is recommended to validate
+//    and adapt the code for your specific application and hardware requirements.
+//
+// Copyright (c) 2024 by TBD
+//    You may use, edit, run or distribute this file as long as the above
+//    copyright notice remains
+// *****************************************************************************
+//******************************************************************************
+
+#ifndef __HOST_MSP_H__
+#define __HOST_MSP_H__
+
+//-----------------------------------------------------------------------------
+// Loads standard C include files
+//-----------------------------------------------------------------------------
+#include <stdbool.h>
+#include <stdint.h>
+
+
+//-----------------------------------------------------------------------------
+// Define the register blocks
+//-----------------------------------------------------------------------------
+typedef struct
+{
+  volatile uint32_t PWREN;
+  volatile uint32_t RSTCTL;
+  volatile uint32_t CLKCFG;
+  volatile uint32_t STAT;
+} GPRCM_Regs;
+
+typedef struct
+{
+  volatile uint32_t IIDX;
+  volatile uint32_t IMASK;
+  volatile uint32_t RIS;
+  volatile uint32_t MIS;
+  volatile uint32_t ISET;
+  volatile uint32_t ICLR;
+} INT_Regs;
+
+typedef struct
+{
+  GPRCM_Regs        GPRCM;
+  volatile uint32_t CLKDIV;
+  volatile uint32_t CLKSEL;
+  INT_Regs          CPU_INT;
+  INT_Regs          DMA_TRIG_RX;
+  INT_Regs          DMA_TRIG_TX;
+  volatile uint32_t CTL0;
+  volatile uint32_t CTL1;
+  volatile uint32_t CLKCTL;
+  volatile uint32_t IFLS;
+  volatile uint32_t STAT;
+  volatile uint32_t RXDATA;
+  volatile uint32_t TXDATA;
+} SPI_Regs;
+
+typedef struct
+{
+  GPRCM_Regs        GPRCM;
+  volatile uint32_t CLKDIV;
+  volatile uint32_t CLKSEL;
+  INT_Regs          CPU_INT;
+  volatile uint32_t CTL0;
+  volatile uint32_t LCRH;
+  volatile uint32_t STAT;
+  volatile uint32_t IFLS;
+  volatile uint32_t IBRD;
+  volatile uint32_t FBRD;
+  union
+  {
+    volatile uint32_t TXDATA;
+    volatile uint32_t TXFIFO[1];
+  };
+  union
+  {
+    volatile uint32_t RXDATA;
+    volatile uint32_t RXFIFO[1];
+  };
+} UART_Regs;
+
+typedef struct
+{
+  volatile uint32_t DMATCTL;
+} DMA_DMATRIG_Regs;
+
+typedef struct
+{
+  volatile uint32_t DMACTL;
+  volatile uint32_t DMASA;
+  volatile uint32_t DMADA;
+  volatile uint32_t DMASZ;
+} DMA_DMACHAN_Regs;
+
+typedef struct
+{
+  INT_Regs          CPU_INT;
+  DMA_DMATRIG_Regs  DMATRIG[16];
+  DMA_DMACHAN_Regs  DMACHAN[16];
+} DMA_Regs;
+
+typedef struct
+{
+  GPRCM_Regs        GPRCM;
+  volatile uint32_t FSUB_0;
+  INT_Regs          CPU_INT;
+  INT_Regs          DMA_TRIG;
+  volatile uint32_t CTL0;
+  volatile uint32_t CTL1;
+  volatile uint32_t CTL2;
+  volatile uint32_t CLKFREQ;
+  volatile uint32_t SCOMP0;
+  volatile uint32_t WCLOW;
+  volatile uint32_t WCHIGH;
+  volatile uint32_t FIFODATA;
+  volatile uint32_t STATUS;
+  volatile uint32_t MEMCTL[12];
+  volatile uint32_t MEMRES[12];
+} ADC12_ULLMEM_Regs;
+
+typedef struct
+{
+  ADC12_ULLMEM_Regs ULLMEM;
+} ADC12_Regs;
+
+typedef struct
+{
+  volatile uint32_t CCLKCTL;
+  volatile uint32_t CPS;
+} GPTIMER_COMMONREGS_Regs;
+
+typedef struct
+{
+  volatile uint32_t CTRCTL;
+  volatile uint32_t LOAD;
+} GPTIMER_COUNTERREGS_Regs;
+
+typedef struct
+{
+  GPRCM_Regs               GPRCM;
+  volatile uint32_t        CLKDIV;
+  volatile uint32_t        CLKSEL;
+  volatile uint32_t        FPUB_0;
+  INT_Regs                 GEN_EVENT0;
+  GPTIMER_COMMONREGS_Regs  COMMONREGS;
+  GPTIMER_COUNTERREGS_Regs COUNTERREGS;
+} GPTIMER_Regs;
+
+typedef struct
+{
+  GPRCM_Regs        GPRCM;
+  volatile uint32_t CLKDIV;
+  volatile uint32_t CLKSEL;
+  volatile uint32_t CTL0;
+  volatile uint32_t CTL1;
+  volatile uint32_t CTL2;
+} VREF_Regs;
+
+typedef struct
+{
+  volatile uint32_t PINCM[251];
+} IOMUX_SECCFG_Regs;
+
+typedef struct
+{
+  IOMUX_SECCFG_Regs SECCFG;
+} IOMUX_Regs;
+
+typedef struct
+{
+  volatile uint32_t DOUT31_0;
+  volatile uint32_t DOUTSET31_0;
+  volatile uint32_t DOUTCLR31_0;
+  volatile uint32_t DOE31_0;
+} GPIO_Regs;
+
+typedef struct
+{
+  GPRCM_Regs        GPRCM;
+  INT_Regs          CPU_INT;
+  volatile uint32_t CLKCTL;
+  volatile uint32_t CTL;
+  volatile uint32_t SEC;
+  volatile uint32_t MIN;
+  volatile uint32_t HOUR;
+} RTC_Regs;
+
+
+//-----------------------------------------------------------------------------
+// Define the peripheral instances, defined in host_regs.c
+//-----------------------------------------------------------------------------
+extern SPI_Regs     host_spi1;
+extern UART_Regs    host_uart0;
+extern DMA_Regs     host_dma;
+extern ADC12_Regs   host_adc0;
+extern GPTIMER_Regs host_timg6;
+extern IOMUX_Regs   host_iomux;
+extern VREF_Regs    host_vref;
+extern GPIO_Regs    host_gpioa;
+extern RTC_Regs     host_rtc;
+
+#define SPI1                                                        (&host_spi1)
+#define UART0                                                      (&host_uart0)
+#define DMA                                                          (&host_dma)
+#define ADC0                                                        (&host_adc0)
+#define TIMG6                                                      (&host_timg6)
+#define IOMUX                                                      (&host_iomux)
+#define VREF                                                        (&host_vref)
+#define GPIOA                                                      (&host_gpioa)
+#define RTC                                                          (&host_rtc)
+
+
+//-----------------------------------------------------------------------------
+// Define the register fields used by the drivers
+//-----------------------------------------------------------------------------
+// Interrupt numbers and DMA trigger sources
+#define SPI1_INT_IRQn                                                       (10)
+#define UART0_INT_IRQn                                                      (15)
+#define ADC0_INT_IRQn                                                        (4)
+#define DMA_INT_IRQn                                                        (31)
+
+// IOMUX
+#define IOMUX_PINCM3                                                         (2)
+#define IOMUX_PINCM6                                                         (5)
+#define IOMUX_PINCM21                                                       (20)
+#define IOMUX_PINCM22                                                       (21)
+#define IOMUX_PINCM23                                                       (22)
+#define IOMUX_PINCM24                                                       (23)
+#define IOMUX_PINCM25                                                       (24)
+#define IOMUX_PINCM26                                                       (25)
+#define IOMUX_PINCM_PC_CONNECTED                                    (0x00000080)
+#define IOMUX_PINCM_PC_MASK                                         (0x00000080)
+#define IOMUX_PINCM21_PF_UART0_TX                                   (0x00000002)
+#define IOMUX_PINCM22_PF_UART0_RX                                   (0x00000002)
+#define IOMUX_PINCM_INENA_ENABLE                                    (0x00040000)
+
+// DMA
+#define DMA_SPI1_TX_TRIG                                                     (9)
+#define DMA_ADC0_EVT_GEN_BD_TRIG                                             (1)
+#define DMA_CPU_INT_IMASK_DMACH0_SET                                (0x00000001)
+#define DMA_CPU_INT_IMASK_DMACH1_SET                                (0x00000002)
+#define DMA_CPU_INT_IMASK_DMACH1_MASK                               (0x00000002)
+#define DMA_CPU_INT_IMASK_PREIRQCH1_SET                             (0x00020000)
+#define DMA_CPU_INT_IMASK_PREIRQCH1_MASK                            (0x00020000)
+#define DMA_CPU_INT_ICLR_DMACH0_CLR                                 (0x00000001)
+#define DMA_CPU_INT_ICLR_DMACH1_CLR                                 (0x00000002)
+#define DMA_CPU_INT_ICLR_PREIRQCH1_CLR                              (0x00020000)
+#define DMA_DMATCTL_DMATINT_EXTERNAL                                (0x00000000)
+#define DMA_DMACTL_DMAEN_MASK                                       (0x00000002)
+#define DMA_DMACTL_DMAEN_ENABLE                                     (0x00000002)
+#define DMA_DMACTL_DMAPREIRQ_PREIRQ_HALF                            (0x00000070)
+#define DMA_DMACTL_DMASRCWDTH_MASK                                  (0x00000300)
+#define DMA_DMACTL_DMASRCWDTH_BYTE                                  (0x00000000)
+#define DMA_DMACTL_DMASRCWDTH_HALF                                  (0x00000100)
+#define DMA_DMACTL_DMASRCWDTH_WORD                                  (0x00000200)
+#define DMA_DMACTL_DMADSTWDTH_MASK                                  (0x00003000)
+#define DMA_DMACTL_DMADSTWDTH_BYTE                                  (0x00000000)
+#define DMA_DMACTL_DMADSTWDTH_HALF                                  (0x00001000)
+#define DMA_DMACTL_DMADSTWDTH_WORD                                  (0x00002000)
+#define DMA_DMACTL_DMASRCINCR_UNCHANGED                             (0x00000000)
+#define DMA_DMACTL_DMASRCINCR_INCREMENT                             (0x00030000)
+#define DMA_DMACTL_DMADSTINCR_UNCHANGED                             (0x00000000)
+#define DMA_DMACTL_DMADSTINCR_INCREMENT                             (0x00300000)
+#define DMA_DMACTL_DMAEM_NORMAL                                     (0x00000000)
+#define DMA_DMACTL_DMATM_SINGLE                                     (0x00000000)
+#define DMA_DMACTL_DMATM_RPTSNGL                                    (0x20000000)
+
+// SPI
+#define SPI_CLKDIV_RATIO_DIV_BY_1                                   (0x00000000)
+#define SPI_CLKDIV_RATIO_DIV_BY_2                                   (0x00000001)
+#define SPI_CLKDIV_RATIO_DIV_BY_8                                   (0x00000007)
+#define SPI_CLKSEL_SYSCLK_SEL_ENABLE                                (0x00000008)
+#define SPI_CLKSEL_MFCLK_SEL_DISABLE                                (0x00000000)
+#define SPI_CLKSEL_LFCLK_SEL_DISABLE                                (0x00000000)
+#define SPI_CLKCTL_SCR_MINIMUM                                      (0x00000000)
+#define SPI_CPU_INT_IIDX_STAT_IDLE_EVT                              (0x0000000A)
+#define SPI_CPU_INT_IMASK_IDLE_SET                                  (0x00000100)
+#define SPI_CPU_INT_IMASK_IDLE_MASK                                 (0x00000100)
+#define SPI_CPU_INT_ICLR_IDLE_CLR                                   (0x00000100)
+#define SPI_DMA_TRIG_TX_IMASK_TX_SET                                (0x00000002)
+#define SPI_CTL0_DSS_MASK                                           (0x0000001F)
+#define SPI_CTL0_DSS_DSS_8                                          (0x00000007)
+#define SPI_CTL0_DSS_DSS_16                                         (0x0000000F)
+#define SPI_CTL0_FRF_MOTOROLA_4WIRE                                 (0x00000020)
+#define SPI_CTL0_SPO_LOW                                            (0x00000000)
+#define SPI_CTL0_SPH_FIRST                                          (0x00000000)
+#define SPI_CTL0_CSSEL_CSSEL_0                                      (0x00000000)
+#define SPI_CTL0_CSCLR_DISABLE                                      (0x00000000)
+#define SPI_CTL0_PACKEN_DISABLED                                    (0x00000000)
+#define SPI_CTL1_ENABLE_MASK                                        (0x00000001)
+#define SPI_CTL1_ENABLE_ENABLE                                      (0x00000001)
+#define SPI_CTL1_LBM_DISABLE                                        (0x00000000)
+#define SPI_CTL1_CP_ENABLE                                          (0x00000004)
+#define SPI_CTL1_POD_DISABLE                                        (0x00000000)
+#define SPI_CTL1_MSB_ENABLE                                         (0x00000010)
+#define SPI_CTL1_PREN_DISABLE                                       (0x00000000)
+#define SPI_CTL1_CDENABLE_DISABLE                                   (0x00000000)
+#define SPI_CTL1_PTEN_DISABLE                                       (0x00000000)
+#define SPI_CTL1_PES_DISABLE                                        (0x00000000)
+#define SPI_CTL1_CDMODE_MINIMUM                                     (0x00000000)
+#define SPI_CTL1_REPEATTX_OFS                                               (16)
+#define SPI_CTL1_REPEATTX_MASK                                      (0x00FF0000)
+#define SPI_CTL1_REPEATTX_DISABLE                                   (0x00000000)
+#define SPI_CTL1_RXTIMEOUT_MINIMUM                                  (0x00000000)
+#define SPI_IFLS_TXIFLSEL_MASK                                      (0x00000007)
+#define SPI_IFLS_TXIFLSEL_LVL_1_2                                   (0x00000002)
+#define SPI_STAT_TFE_MASK                                           (0x00000001)
+#define SPI_STAT_TFE_EMPTY                                          (0x00000001)
+#define SPI_STAT_TNF_MASK                                           (0x00000002)
+#define SPI_STAT_TNF_FULL                                           (0x00000000)
+#define SPI_STAT_RFE_MASK                                           (0x00000004)
+#define SPI_STAT_RFE_EMPTY                                          (0x00000004)
+#define SPI_STAT_RFE_NOT_EMPTY                                      (0x00000000)
+#define SPI_STAT_BUSY_MASK                                          (0x00000010)
+#define SPI_STAT_BUSY_IDLE                                          (0x00000000)
+
+// UART
+#define UART_PWREN_KEY_UNLOCK_W                                     (0x26000000)
+#define UART_PWREN_ENABLE_ENABLE                                    (0x00000001)
+#define UART_RSTCTL_KEY_UNLOCK_W                                    (0xB1000000)
+#define UART_RSTCTL_RESETASSERT_ASSERT                              (0x00000001)
+#define UART_RSTCTL_RESETSTKYCLR_CLR                                (0x00000002)
+#define UART_CLKSEL_BUSCLK_SEL_ENABLE                               (0x00000008)
+#define UART_CLKSEL_MFCLK_SEL_DISABLE                               (0x00000000)
+#define UART_CLKSEL_LFCLK_SEL_DISABLE                               (0x00000000)
+#define UART_CLKDIV_RATIO_DIV_BY_1                                  (0x00000000)
+#define UART_CTL0_ENABLE_MASK                                       (0x00000001)
+#define UART_CTL0_ENABLE_DISABLE                                    (0x00000000)
+#define UART_CTL0_ENABLE_ENABLE                                     (0x00000001)
+#define UART_CTL0_LBE_DISABLE                                       (0x00000000)
+#define UART_CTL0_RXE_ENABLE                                        (0x00000008)
+#define UART_CTL0_TXE_ENABLE                                        (0x00000010)
+#define UART_CTL0_MODE_UART                                         (0x00000000)
+#define UART_CTL0_RTS_CLR                                           (0x00000000)
+#define UART_CTL0_CTSEN_DISABLE                                     (0x00000000)
+#define UART_CTL0_HSE_OVS16                                         (0x00000000)
+#define UART_CTL0_FEN_ENABLE                                        (0x00020000)
+#define UART_LCRH_BRK_DISABLE                                       (0x00000000)
+#define UART_LCRH_PEN_DISABLE                                       (0x00000000)
+#define UART_LCRH_EPS_ODD                                           (0x00000000)
+#define UART_LCRH_STP2_DISABLE                                      (0x00000000)
+#define UART_LCRH_WLEN_DATABIT8                                     (0x00000030)
+#define UART_IFLS_TXIFLSEL_LVL_1_2                                  (0x00000002)
+#define UART_IFLS_RXIFLSEL_LVL_1                                    (0x00000050)
+#define UART_CPU_INT_IIDX_STAT_RXIFG                                (0x0000000B)
+#define UART_CPU_INT_IIDX_STAT_TXIFG                                (0x0000000C)
+#define UART_CPU_INT_IMASK_RXINT_SET                                (0x00000400)
+#define UART_CPU_INT_IMASK_TXINT_SET                                (0x00000800)
+#define UART_CPU_INT_ICLR_RXINT_CLR                                 (0x00000400)
+#define UART_CPU_INT_ICLR_TXINT_CLR                                 (0x00000800)
+#define UART_STAT_BUSY_MASK                                         (0x00000001)
+#define UART_STAT_BUSY_SET                                          (0x00000001)
+#define UART_STAT_RXFE_MASK                                         (0x00000004)
+#define UART_STAT_RXFE_SET                                          (0x00000004)
+#define UART_STAT_TXFF_MASK                                         (0x00000080)
+#define UART_STAT_TXFF_SET                                          (0x00000080)
+
+// ADC12
+#define ADC12_PWREN_KEY_UNLOCK_W                                    (0x26000000)
+#define ADC12_PWREN_ENABLE_ENABLE                                   (0x00000001)
+#define ADC12_RSTCTL_KEY_UNLOCK_W                                   (0xB1000000)
+#define ADC12_RSTCTL_RESETASSERT_ASSERT                             (0x00000001)
+#define ADC12_RSTCTL_RESETSTKYCLR_CLR                               (0x00000002)
+#define ADC12_CLKCFG_KEY_UNLOCK_W                                   (0xA9000000)
+#define ADC12_CLKCFG_SAMPCLK_ULPCLK                                 (0x00000000)
+#define ADC12_CLKCFG_CCONRUN_DISABLE                                (0x00000000)
+#define ADC12_CLKCFG_CCONSTOP_DISABLE                               (0x00000000)
+#define ADC12_CLKFREQ_FRANGE_RANGE1TO4                              (0x00000000)
+#define ADC12_CLKFREQ_FRANGE_RANGE4TO8                              (0x00000001)
+#define ADC12_CLKFREQ_FRANGE_RANGE8TO16                             (0x00000002)
+#define ADC12_CLKFREQ_FRANGE_RANGE16TO20                            (0x00000003)
+#define ADC12_CLKFREQ_FRANGE_RANGE20TO24                            (0x00000004)
+#define ADC12_CLKFREQ_FRANGE_RANGE24TO32                            (0x00000005)
+#define ADC12_CLKFREQ_FRANGE_RANGE32TO40                            (0x00000006)
+#define ADC12_CLKFREQ_FRANGE_RANGE40TO48                            (0x00000007)
+#define ADC12_CTL0_ENC_MASK                                         (0x00000001)
+#define ADC12_CTL0_ENC_OFF                                          (0x00000000)
+#define ADC12_CTL0_ENC_ON                                           (0x00000001)
+#define ADC12_CTL0_PWRDN_MANUAL                                     (0x00000010)
+#define ADC12_CTL0_SCLKDIV_DIV_BY_8                                 (0x03000000)
+#define ADC12_CTL1_SC_STOP                                          (0x00000000)
+#define ADC12_CTL1_SC_START                                         (0x00000100)
+#define ADC12_CTL1_TRIGSRC_SOFTWARE                                 (0x00000000)
+#define ADC12_CTL1_TRIGSRC_EVENT                                    (0x00000001)
+#define ADC12_CTL1_CONSEQ_SINGLE                                    (0x00000000)
+#define ADC12_CTL1_CONSEQ_REPEATSINGLE                              (0x00020000)
+#define ADC12_CTL1_CONSEQ_REPEATSEQUENCE                            (0x00030000)
+#define ADC12_CTL1_SAMPMODE_AUTO                                    (0x00000000)
+#define ADC12_CTL1_AVGN_OFS                                                 (24)
+#define ADC12_CTL1_AVGN_DISABLE                                     (0x00000000)
+#define ADC12_CTL1_AVGN_AVG_16                                      (0x04000000)
+#define ADC12_CTL1_AVGD_OFS                                                 (28)
+#define ADC12_CTL1_AVGD_SHIFT0                                      (0x00000000)
+#define ADC12_CTL1_AVGD_SHIFT4                                      (0x40000000)
+#define ADC12_CTL2_DF_UNSIGNED                                      (0x00000000)
+#define ADC12_CTL2_RES_BIT_12                                       (0x00000000)
+#define ADC12_CTL2_DMAEN_MASK                                       (0x00000100)
+#define ADC12_CTL2_DMAEN_DISABLE                                    (0x00000000)
+#define ADC12_CTL2_DMAEN_ENABLE                                     (0x00000100)
+#define ADC12_CTL2_FIFOEN_MASK                                      (0x00000400)
+#define ADC12_CTL2_FIFOEN_DISABLE                                   (0x00000000)
+#define ADC12_CTL2_FIFOEN_ENABLE                                    (0x00000400)
+#define ADC12_CTL2_STARTADD_ADDR_00                                 (0x00000000)
+#define ADC12_CTL2_ENDADD_OFS                                               (24)
+#define ADC12_CTL2_ENDADD_ADDR_00                                   (0x00000000)
+#define ADC12_CTL2_SAMPCNT_OFS                                              (11)
+#define ADC12_CTL2_SAMPCNT_MIN                                      (0x00000000)
+#define ADC12_STATUS_BUSY_MASK                                      (0x00000001)
+#define ADC12_STATUS_BUSY_ACTIVE                                    (0x00000001)
+#define ADC12_MEMCTL_VRSEL_VDDA_VSSA                                (0x00000000)
+#define ADC12_MEMCTL_VRSEL_INTREF_VSSA                              (0x00000200)
+#define ADC12_MEMCTL_STIME_SEL_SCOMP0                               (0x00000000)
+#define ADC12_MEMCTL_AVGEN_DISABLE                                  (0x00000000)
+#define ADC12_MEMCTL_AVGEN_ENABLE                                   (0x00010000)
+#define ADC12_MEMCTL_BCSEN_DISABLE                                  (0x00000000)
+#define ADC12_MEMCTL_TRIG_AUTO_NEXT                                 (0x00000000)
+#define ADC12_MEMCTL_TRIG_TRIGGER_NEXT                              (0x01000000)
+#define ADC12_MEMCTL_WINCOMP_MASK                                   (0x10000000)
+#define ADC12_MEMCTL_WINCOMP_DISABLE                                (0x00000000)
+#define ADC12_MEMCTL_WINCOMP_ENABLE                                 (0x10000000)
+#define ADC12_CPU_INT_IMASK_LOWIFG_SET                              (0x00000004)
+#define ADC12_CPU_INT_IMASK_HIGHIFG_SET                             (0x00000008)
+#define ADC12_CPU_INT_IMASK_MEMRESIFG0_SET                          (0x00000100)
+#define ADC12_CPU_INT_MIS_LOWIFG_SET                                (0x00000004)
+#define ADC12_CPU_INT_MIS_HIGHIFG_SET                               (0x00000008)
+#define ADC12_CPU_INT_ICLR_LOWIFG_CLR                               (0x00000004)
+#define ADC12_CPU_INT_ICLR_HIGHIFG_CLR                              (0x00000008)
+#define ADC12_DMA_TRIG_IMASK_MEMRESIFG0_SET                         (0x00000100)
+
+// GPTIMER
+#define GPTIMER_PWREN_KEY_UNLOCK_W                                  (0x26000000)
+#define GPTIMER_PWREN_ENABLE_ENABLE                                 (0x00000001)
+#define GPTIMER_PWREN_ENABLE_DISABLE                                (0x00000000)
+#define GPTIMER_RSTCTL_KEY_UNLOCK_W                                 (0xB1000000)
+#define GPTIMER_RSTCTL_RESETASSERT_ASSERT                           (0x00000001)
+#define GPTIMER_RSTCTL_RESETSTKYCLR_CLR                             (0x00000002)
+#define GPTIMER_CLKDIV_RATIO_DIV_BY_8                               (0x00000007)
+#define GPTIMER_CLKSEL_BUSCLK_SEL_ENABLE                            (0x00000008)
+#define GPTIMER_CLKSEL_MFCLK_SEL_DISABLE                            (0x00000000)
+#define GPTIMER_CLKSEL_LFCLK_SEL_DISABLE                            (0x00000000)
+#define GPTIMER_CCLKCTL_CLKEN_ENABLED                               (0x00000001)
+#define GPTIMER_CPS_PCNT_MASK                                       (0x000000FF)
+#define GPTIMER_LOAD_LD_MASK                                        (0x0000FFFF)
+#define GPTIMER_CTRCTL_EN_MASK                                      (0x00000001)
+#define GPTIMER_CTRCTL_EN_ENABLED                                   (0x00000001)
+#define GPTIMER_CTRCTL_REPEAT_REPEAT_1                              (0x00000002)
+#define GPTIMER_CTRCTL_CM_DOWN                                      (0x00000000)
+#define GPTIMER_CTRCTL_CVAE_LDVAL                                   (0x00000000)
+#define GPTIMER_GEN_EVENT0_IMASK_Z_SET                              (0x00000001)
+
+
+//-----------------------------------------------------------------------------
+// Define the core functions. Interrupts are never taken on the host, so the
+// tests call the driver ISR handlers directly.
+//-----------------------------------------------------------------------------
+static inline void __disable_irq(void) {}
+static inline void __enable_irq(void) {}
+static inline uint32_t __get_PRIMASK(void) { return 0; }
+static inline void __set_PRIMASK(uint32_t primask) { (void)primask; }
+static inline void __WFI(void) {}
+static inline void __NOP(void) {}
+static inline void NVIC_EnableIRQ(int irq) { (void)irq; }
+static inline void NVIC_DisableIRQ(int irq) { (void)irq; }
+static inline void NVIC_ClearPendingIRQ(int irq) { (void)irq; }
+
+#endif /* __HOST_MSP_H__ */
@@ -0,0 +1 @@
+// Host stub: the register fields live in ti/devices/msp/msp.h
@@ -0,0 +1,99 @@
+// *****************************************************************************
+// ***************************    C Source Code     ****************************
+// *****************************************************************************
+//   DESIGNER NAME:  Rafael Ortiz
+//
+//         VERSION:  1.0
+//
+//       FILE NAME:  test.h
+//
+//-----------------------------------------------------------------------------
+// DESCRIPTION
+//    This file contains the checks shared by the host unit tests. A failed
+//    check prints where it failed and the test carries on, and test_report
+//    turns the count of failures into the exit status make looks at.
+//
+//-----------------------------------------------------------------------------
+// DISCLAIMER
+//    This code was developed for educational purposes as part of the CSC202
+//    course and is provided "as is" without warranties of any kind, whether
+//    express, implied, or statutory.
+//
+//    The author and organization do not warrant the accuracy, completeness, or
+//    reliability of the code. The author and organization shall not be liable
+//    for any direct, indirect, incidental, special, exemplary, or consequential
+//    damages arising out of the use of or inability to use the code, even if
+//    advised of the possibility of such damages.
+//
+//    Use of this code is at your own risk, and it is recommended to validate
+//    and adapt the code for your specific application and hardware requirements.
+//
+// Copyright (c) 2024 by TBD
+//    You may use, edit, run or distribute this file as long as the above
+//    copyright notice remains
+// *****************************************************************************
+//******************************************************************************
+
+#ifndef __TEST_H__
+#define __TEST_H__
+
+//-----------------------------------------------------------------------------
+// Loads standard C include files
+//-----------------------------------------------------------------------------
+#include <stdint.h>
+#include <stdio.h>
+
+
+//-----------------------------------------------------------------------------
+// Define the checks
+//-----------------------------------------------------------------------------
+static int g_test_checks = 0;
+static int g_test_failures = 0;
+
+#define CHECK(cond)                                                            \
+  do                                                                           \
+  {                                                                            \
+    g_test_checks++;                                                           \
+    if (!(cond))                                                               \
+    {                                                                          \
+      g_test_failures++;                                                       \
+      printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond);         \
+    } /* if */                                                                 \
+  } while (0)
+
+// Prints both sides when they differ, for values that fit in a long long
+#define CHECK_EQ(actual, expected)                                             \
+  do                                                                           \
+  {                                                                            \
+    long long check_a = (long long)(actual);                                   \
+    long long check_e = (long long)(expected);                                 \
+    g_test_checks++;                                                           \
+    if (check_a != check_e)                                                    \
+    {                                                                          \
+      g_test_failures++;                                                       \
+      printf("%s:%d: CHECK_EQ(%s, %s) failed: %lld != %lld\n", __FILE__,      \
+             __LINE__, #actual, #expected, check_a, check_e);                  \
+    } /* if */                                                                 \
+  } while (0)
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function prints the result of a test program.
+//
+// INPUT PARAMETERS:
+//   name - name of the test program
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   0 if every check passed, otherwise 1; main returns it as the exit code
+// -----------------------------------------------------------------------------
+static inline int test_report(const char *name)
+{
+  printf("%s: %d checks, %d failed\n", name, g_test_checks, g_test_failures);
+  return (g_test_failures == 0) ? 0 : 1;
+} /* test_report */
+
+#endif /* __TEST_H__ */
@@ -0,0 +1,256 @@
+// *****************************************************************************
+// ***************************    C Source Code     ****************************
+// *****************************************************************************
+//   DESIGNER NAME:  Rafael Ortiz
+//
+//         VERSION:  1.0
+//
+//       FILE NAME:  test_clock.c
+//
+//-----------------------------------------------------------------------------
+// DESCRIPTION
+//    This file tests the SYSPLL divider search. Every setting clock_solve
+//    returns is checked against the datasheet limits and must make exactly
+//    the asked-for frequency, and a brute force walk over every divider
+//    combination must agree on which frequencies are reachable and on the
+//    slowest VCO that reaches them.
+//
+//-----------------------------------------------------------------------------
+// DISCLAIMER
+//    This code was developed for educational purposes as part of the CSC202
+//    course and is provided "as is" without warranties of any kind, whether
+//    express, implied, or statutory.
+//
+//    The author and organization do not warrant the accuracy, completeness, or
+//    reliability of the code. The author and organization shall not be liable
+//    for any direct, indirect, incidental, special, exemplary, or consequential
+//    damages arising out of the use of or inability to use the code, even if
+//    advised of the possibility of such damages.
+//
+//    Use of this code is at your own risk, and it is recommended to validate
+//    and adapt the code for your specific application and hardware requirements.
+//
+// Copyright (c) 2024 by TBD
+//    You may use, edit, run or distribute this file as long as the above
+//    copyright notice remains
+// *****************************************************************************
+//******************************************************************************
+
+
+//-----------------------------------------------------------------------------
+// Load standard C include files
+//-----------------------------------------------------------------------------
+#include <stdint.h>
+#include <stdbool.h>
+
+
+//-----------------------------------------------------------------------------
+// Loads MSP launchpad board support macros and definitions
+//-----------------------------------------------------------------------------
+#include "clock.h"
+#include "test.h"
+
+
+//-----------------------------------------------------------------------------
+// Define symbolic constants used by the program
+//-----------------------------------------------------------------------------
+#define MHZ                                                            (1000000)
+
+// Reachable whole-MHz frequencies from 8 to 80 MHz
+#define EXPECTED_REACHABLE                                                  (73)
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    Returns the frequency a setting makes, worked out from the dividers
+//    alone so it does not trust config->freq or config->vco_freq.
+// -----------------------------------------------------------------------------
+static uint64_t config_output_freq(const clock_config_struct *config)
+{
+  uint64_t vco = (uint64_t)(SYSPLL_REF_FREQ >> config->pdiv) * config->qdiv;
+
+  if (config->use_clk2x)
+  {
+    return 2 * vco / (config->rdiv + 1);
+  } /* if */
+
+  return vco / (2 * (config->rdiv + 1));
+} /* config_output_freq */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    Finds the slowest VCO that makes exactly freq by trying every PDIV,
+//    QDIV, RDIV and output within the datasheet limits. Returns 0 if none
+//    does.
+// -----------------------------------------------------------------------------
+static uint32_t brute_force_vco(uint32_t freq)
+{
+  uint32_t best = 0;
+
+  for (uint8_t pdiv = 0; pdiv <= SYSPLL_PDIV_MAX; pdiv++)
+  {
+    uint32_t loop_freq = SYSPLL_REF_FREQ >> pdiv;
+
+    if (loop_freq < SYSPLL_LOOPIN_MIN_FREQ ||
+        loop_freq > SYSPLL_LOOPIN_MAX_FREQ)
+    {
+      continue;
+    } /* if */
+
+    for (uint32_t qdiv = SYSPLL_QDIV_MIN; qdiv <= SYSPLL_QDIV_MAX; qdiv++)
+    {
+      uint64_t vco = (uint64_t)loop_freq * qdiv;
+
+      if (vco < SYSPLL_VCO_MIN_FREQ || vco > SYSPLL_VCO_MAX_FREQ)
+      {
+        continue;
+      } /* if */
+
+      for (uint32_t rdiv = 0; rdiv < SYSPLL_RDIV_COUNT; rdiv++)
+      {
+        bool clk2x_hit = (2 * vco == (uint64_t)freq * (rdiv + 1));
+        bool clk0_hit = (vco == 2 * (uint64_t)freq * (rdiv + 1));
+
+        if ((clk2x_hit || clk0_hit) && (best == 0 || vco < best))
+        {
+          best = (uint32_t)vco;
+        } /* if */
+      } /* for */
+    } /* for */
+  } /* for */
+
+  return best;
+} /* brute_force_vco */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    Checks one setting against the datasheet limits and freq.
+// -----------------------------------------------------------------------------
+static void check_config(uint32_t freq, const clock_config_struct *config)
+{
+  uint32_t loop_freq = SYSPLL_REF_FREQ >> config->pdiv;
+  uint8_t flash_wait = (freq <= FLASH_NO_WAIT_MAX_FREQ)  ? 0 :
+                       (freq <= FLASH_ONE_WAIT_MAX_FREQ) ? 1 : 2;
+
+  CHECK_EQ(config->freq, freq);
+  CHECK(config->pdiv <= SYSPLL_PDIV_MAX);
+  CHECK(loop_freq >= SYSPLL_LOOPIN_MIN_FREQ);
+  CHECK(loop_freq <= SYSPLL_LOOPIN_MAX_FREQ);
+  CHECK(config->qdiv >= SYSPLL_QDIV_MIN);
+  CHECK(config->qdiv <= SYSPLL_QDIV_MAX);
+  CHECK(config->rdiv < SYSPLL_RDIV_COUNT);
+  CHECK_EQ(config->vco_freq, (uint64_t)loop_freq * config->qdiv);
+  CHECK(config->vco_freq >= SYSPLL_VCO_MIN_FREQ);
+  CHECK(config->vco_freq <= SYSPLL_VCO_MAX_FREQ);
+  CHECK_EQ(config_output_freq(config), freq);
+  CHECK_EQ(config->flash_wait, flash_wait);
+} /* check_config */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    Every whole MHz from 1 to 100 MHz, and every 250 kHz across the
+//    supported range: clock_solve must agree with the brute force search,
+//    and what it returns must be within the limits. Nothing outside
+//    CLOCK_MIN_FREQ to CLOCK_MAX_FREQ is reachable.
+// -----------------------------------------------------------------------------
+static void test_solve_sweep(void)
+{
+  clock_config_struct config;
+  uint32_t freq;
+  bool found;
+
+  for (freq = 1 * MHZ; freq <= 100 * MHZ; freq += MHZ)
+  {
+    found = clock_solve(freq, &config);
+    if (freq < CLOCK_MIN_FREQ || freq > CLOCK_MAX_FREQ)
+    {
+      CHECK(!found);
+      continue;
+    } /* if */
+
+    CHECK_EQ(found, brute_force_vco(freq) != 0);
+    if (found)
+    {
+      check_config(freq, &config);
+      CHECK_EQ(config.vco_freq, brute_force_vco(freq));
+    } /* if */
+  } /* for */
+
+  for (freq = CLOCK_MIN_FREQ; freq <= CLOCK_MAX_FREQ; freq += 250000)
+  {
+    found = clock_solve(freq, &config);
+    CHECK_EQ(found, brute_force_vco(freq) != 0);
+    if (found)
+    {
+      check_config(freq, &config);
+      CHECK_EQ(config.vco_freq, brute_force_vco(freq));
+    } /* if */
+  } /* for */
+
+  CHECK(!clock_solve(CLOCK_MIN_FREQ - 1, &config));
+  CHECK(!clock_solve(CLOCK_MAX_FREQ + 1, &config));
+} /* test_solve_sweep */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    clock_reachable_freqs lists all 73 whole-MHz targets, slowest first,
+//    and stops at max_count.
+// -----------------------------------------------------------------------------
+static void test_reachable_freqs(void)
+{
+  uint32_t freqs[CLOCK_MAX_REACHABLE];
+  clock_config_struct config;
+  uint8_t count;
+
+  count = clock_reachable_freqs(freqs, CLOCK_MAX_REACHABLE);
+  CHECK_EQ(count, EXPECTED_REACHABLE);
+
+  for (uint8_t i = 0; i < count; i++)
+  {
+    CHECK(freqs[i] >= CLOCK_MIN_FREQ);
+    CHECK(freqs[i] <= CLOCK_MAX_FREQ);
+    CHECK_EQ(freqs[i] % CLOCK_FREQ_STEP, 0);
+    CHECK(i == 0 || freqs[i] > freqs[i - 1]);
+    CHECK(clock_solve(freqs[i], &config));
+    check_config(freqs[i], &config);
+  } /* for */
+
+  CHECK_EQ(clock_reachable_freqs(freqs, 5), 5);
+  CHECK_EQ(freqs[4], CLOCK_MIN_FREQ + 4 * CLOCK_FREQ_STEP);
+} /* test_reachable_freqs */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    The 80 MHz and 40 MHz clocks the board runs at both come out with the
+//    slowest legal VCO, 80 MHz, and each range gets its flash wait states.
+// -----------------------------------------------------------------------------
+static void test_known_settings(void)
+{
+  clock_config_struct config;
+
+  CHECK(clock_solve(80 * MHZ, &config));
+  CHECK_EQ(config.vco_freq, 80 * MHZ);
+  CHECK_EQ(config.flash_wait, 2);
+
+  CHECK(clock_solve(40 * MHZ, &config));
+  CHECK_EQ(config.vco_freq, 80 * MHZ);
+  CHECK_EQ(config.flash_wait, 1);
+
+  CHECK(clock_solve(CLOCK_MIN_FREQ, &config));
+  CHECK_EQ(config.flash_wait, 0);
+} /* test_known_settings */
+
+
+int main(void)
+{
+  test_solve_sweep();
+  test_reachable_freqs();
+  test_known_settings();
+
+  return test_report("test_clock");
+} /* main */
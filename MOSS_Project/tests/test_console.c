@@ -0,0 +1,352 @@
+// *****************************************************************************
+// ***************************    C Source Code     ****************************
+// *****************************************************************************
+//   DESIGNER NAME:  Rafael Ortiz
+//
+//         VERSION:  1.0
+//
+//       FILE NAME:  test_console.c
+//
+//-----------------------------------------------------------------------------
+// DESCRIPTION
+//    This file tests what the text console sends to the ILI9341 through the
+//    panel model: the address window and the pixels of a character written
+//    over another, of a line erased with backspaces, and of a hardware
+//    scroll step, where one line is blanked and VSCRSADD moves past it.
+//    Cells are checked against the glyphs decoded straight from the font.
+//
+//-----------------------------------------------------------------------------
+// DISCLAIMER
+//    This code was developed for educational purposes as part of the CSC202
+//    course and is provided "as is" without warranties of any kind, whether
+//    express, implied, or statutory.
+//
+//    The author and organization do not warrant the accuracy, completeness, or
+//    reliability of the code. The author and organization shall not be liable
+//    for any direct, indirect, incidental, special, exemplary, or consequential
+//    damages arising out of the use of or inability to use the code, even if
+//    advised of the possibility of such damages.
+//
+//    Use of this code is at your own risk, and it is recommended to validate
+//    and adapt the code for your specific application and hardware requirements.
+//
+// Copyright (c) 2024 by TBD
+//    You may use, edit, run or distribute this file as long as the above
+//    copyright notice remains
+// *****************************************************************************
+
+
+//-----------------------------------------------------------------------------
+// Load standard C include files
+//-----------------------------------------------------------------------------
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+
+//-----------------------------------------------------------------------------
+// Loads MSP launchpad board support macros and definitions
+//-----------------------------------------------------------------------------
+#include "ili9341.h"
+#include "console.h"
+#include "host.h"
+#include "host_panel.h"
+#include "test.h"
+
+// The font, for the reference cells. ili9341.c defines its public
+// descriptor, so this copy is renamed.
+#define jet_brains_mono                                  test_jet_brains_mono
+#include "jet_brains_mono.h"
+#undef jet_brains_mono
+
+
+//-----------------------------------------------------------------------------
+// Define symbolic constants used by the program
+//-----------------------------------------------------------------------------
+// Colors of CONSOLE_DEFAULT_ATTR, and of the second pair the tests use
+#define TEST_FG                                                  ILI9341_BLACK
+#define TEST_BG                                                  ILI9341_WHITE
+#define TEST_FG2                                                ILI9341_YELLOW
+#define TEST_BG2                                                  ILI9341_NAVY
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    Returns the pixel of a cell decoded straight from the font bitmap: the
+//    glyph placed in the cell by its box offsets on the console baseline.
+// -----------------------------------------------------------------------------
+static uint16_t reference_pixel(char c, uint16_t row, uint16_t col,
+                                uint16_t fg_color, uint16_t bg_color)
+{
+  uint8_t index = (c >= 32 && c <= 126) ? c - 32 + 1 : 0;
+  const glyph_dsc_t *glyph = &font_dsc.glyph_dsc[index];
+  const uint8_t *bitmap = &font_dsc.glyph_bitmap[glyph->bitmap_index];
+  int16_t glyph_row = row - (CONSOLE_BASELINE - (glyph->box_h + glyph->ofs_y));
+  int16_t glyph_col = col - glyph->ofs_x;
+  uint16_t bit_pos;
+
+  if (glyph_row < 0 || glyph_row >= glyph->box_h ||
+      glyph_col < 0 || glyph_col >= glyph->box_w)
+  {
+    return bg_color;
+  } /* if */
+
+  bit_pos = glyph_row * glyph->box_w + glyph_col;
+  return (bitmap[bit_pos >> 3] & (0x80 >> (bit_pos & 7))) ? fg_color
+                                                          : bg_color;
+} /* reference_pixel */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    Checks an address window in the log and that exactly its pixels were
+//    written into it.
+// -----------------------------------------------------------------------------
+static void check_window(uint32_t index, uint16_t x, uint16_t y, uint16_t w,
+                         uint16_t h)
+{
+  const host_panel_window_struct *window = host_panel_window(index);
+
+  CHECK(window != NULL);
+  if (window == NULL) return;
+
+  CHECK_EQ(window->x0, x);
+  CHECK_EQ(window->x1, x + w - 1);
+  CHECK_EQ(window->y0, y);
+  CHECK_EQ(window->y1, y + h - 1);
+  CHECK_EQ(window->pixels, (uint32_t)w * h);
+} /* check_window */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    Checks that the cell at a column of a display memory slot holds a
+//    character in the given colors.
+// -----------------------------------------------------------------------------
+static void check_cell(uint8_t slot, uint8_t col, char c, uint16_t fg_color,
+                       uint16_t bg_color)
+{
+  uint32_t wrong = 0;
+
+  for (uint16_t row = 0; row < CONSOLE_LINE_HEIGHT; row++)
+  {
+    for (uint16_t x = 0; x < GLYPH_WIDTH; x++)
+    {
+      if (host_panel_pixel(col * GLYPH_WIDTH + x,
+                           slot * CONSOLE_LINE_HEIGHT + row) !=
+          reference_pixel(c, row, x, fg_color, bg_color))
+      {
+        wrong++;
+      } /* if */
+    } /* for */
+  } /* for */
+
+  CHECK_EQ(wrong, 0);
+} /* check_cell */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    Checks that every pixel of a rectangle of display memory is one color.
+// -----------------------------------------------------------------------------
+static void check_fill(uint16_t x, uint16_t y, uint16_t w, uint16_t h,
+                       uint16_t color)
+{
+  uint32_t wrong = 0;
+
+  for (uint16_t row = y; row < y + h; row++)
+  {
+    for (uint16_t col = x; col < x + w; col++)
+    {
+      if (host_panel_pixel(col, row) != color)
+      {
+        wrong++;
+      } /* if */
+    } /* for */
+  } /* for */
+
+  CHECK_EQ(wrong, 0);
+} /* check_fill */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    Starts a test from a blank panel and a console just initialized in its
+//    default colors, with the log cleared.
+// -----------------------------------------------------------------------------
+static void setup(void)
+{
+  host_regs_reset();
+  host_panel_reset();
+  console_set_color(CONSOLE_COLOR_BLACK, CONSOLE_COLOR_WHITE);
+  console_init();
+} /* setup */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    console_init makes the console lines the scrolling area, fills the
+//    whole panel in the background color through one window and scrolls
+//    back to the top.
+// -----------------------------------------------------------------------------
+static void test_init(void)
+{
+  host_panel_stats_struct stats;
+
+  setup();
+  host_panel_get_stats(&stats);
+
+  CHECK_EQ(stats.windows, 1);
+  check_window(0, 0, 0, ILI9341_TFTWIDTH, ILI9341_TFTHEIGHT);
+  check_fill(0, 0, ILI9341_TFTWIDTH, ILI9341_TFTHEIGHT, TEST_BG);
+  CHECK_EQ(host_panel_scroll_area(), CONSOLE_HEIGHT);
+  CHECK_EQ(host_panel_scroll_start(), 0);
+} /* test_init */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    A character written over another is drawn through a window of just its
+//    cell, in the colors it was written in, and its neighbours are left
+//    alone. Writing the same character again sends nothing.
+// -----------------------------------------------------------------------------
+static void test_overwrite_char(void)
+{
+  host_panel_stats_struct stats;
+
+  setup();
+  console_write_string("ab\ncd");
+  console_flush();
+
+  host_panel_clear_log();
+  console_write_string("\rc");
+  console_set_color(CONSOLE_COLOR_YELLOW, CONSOLE_COLOR_NAVY);
+  console_put_char('X');
+  console_flush();
+
+  host_panel_get_stats(&stats);
+  CHECK_EQ(stats.windows, 1);
+  CHECK_EQ(stats.pixels, GLYPH_WIDTH * CONSOLE_LINE_HEIGHT);
+  check_window(0, GLYPH_WIDTH, CONSOLE_LINE_HEIGHT, GLYPH_WIDTH,
+               CONSOLE_LINE_HEIGHT);
+  check_cell(1, 1, 'X', TEST_FG2, TEST_BG2);
+  check_cell(1, 0, 'c', TEST_FG, TEST_BG);
+  check_cell(0, 1, 'b', TEST_FG, TEST_BG);
+  check_fill(2 * GLYPH_WIDTH, CONSOLE_LINE_HEIGHT,
+             ILI9341_TFTWIDTH - 2 * GLYPH_WIDTH, CONSOLE_LINE_HEIGHT, TEST_BG);
+
+  host_panel_clear_log();
+  console_set_color(CONSOLE_COLOR_BLACK, CONSOLE_COLOR_WHITE);
+  console_write_string("\rc");
+  console_set_color(CONSOLE_COLOR_YELLOW, CONSOLE_COLOR_NAVY);
+  console_put_char('X');
+  console_flush();
+  host_panel_get_stats(&stats);
+  CHECK_EQ(stats.bytes, 0);
+} /* test_overwrite_char */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    A line erased with backspaces is redrawn as one run of blank cells
+//    through a single window, and the line above is left alone.
+// -----------------------------------------------------------------------------
+static void test_clear_line(void)
+{
+  host_panel_stats_struct stats;
+
+  setup();
+  console_write_string("ab\nhello");
+  console_flush();
+  check_cell(1, 4, 'o', TEST_FG, TEST_BG);
+
+  host_panel_clear_log();
+  for (uint8_t i = 0; i < 5; i++)
+  {
+    console_backspace();
+  } /* for */
+  console_flush();
+
+  host_panel_get_stats(&stats);
+  CHECK_EQ(stats.windows, 1);
+  check_window(0, 0, CONSOLE_LINE_HEIGHT, 5 * GLYPH_WIDTH,
+               CONSOLE_LINE_HEIGHT);
+  check_fill(0, CONSOLE_LINE_HEIGHT, ILI9341_TFTWIDTH, CONSOLE_LINE_HEIGHT,
+             TEST_BG);
+  check_cell(0, 0, 'a', TEST_FG, TEST_BG);
+  check_cell(0, 1, 'b', TEST_FG, TEST_BG);
+} /* test_clear_line */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    A new line on the bottom line blanks the memory line holding the oldest
+//    line with one fill of its window and moves VSCRSADD past it; nothing
+//    else is sent and the other lines stay where they are in memory. The
+//    next character goes into the blanked memory line, now at the bottom.
+//    After one step per line the start address is back at 0.
+// -----------------------------------------------------------------------------
+static void test_scroll_step(void)
+{
+  host_panel_stats_struct stats;
+  uint8_t slot;
+
+  setup();
+  for (slot = 0; slot < CONSOLE_LINES; slot++)
+  {
+    if (slot > 0)
+    {
+      console_new_line();
+    } /* if */
+    console_put_char('A' + slot);
+  } /* for */
+  console_flush();
+
+  host_panel_clear_log();
+  console_new_line();
+  host_panel_get_stats(&stats);
+  CHECK_EQ(stats.windows, 1);
+  CHECK_EQ(stats.commands, 4);
+  check_window(0, 0, 0, ILI9341_TFTWIDTH, CONSOLE_LINE_HEIGHT);
+  check_fill(0, 0, ILI9341_TFTWIDTH, CONSOLE_LINE_HEIGHT, TEST_BG);
+  CHECK_EQ(host_panel_scroll_start(), CONSOLE_LINE_HEIGHT);
+  for (slot = 1; slot < CONSOLE_LINES; slot++)
+  {
+    check_cell(slot, 0, 'A' + slot, TEST_FG, TEST_BG);
+  } /* for */
+
+  host_panel_clear_log();
+  console_put_char('Z');
+  console_flush();
+  host_panel_get_stats(&stats);
+  CHECK_EQ(stats.windows, 1);
+  check_window(0, 0, 0, GLYPH_WIDTH, CONSOLE_LINE_HEIGHT);
+  check_cell(0, 0, 'Z', TEST_FG, TEST_BG);
+
+  host_panel_clear_log();
+  console_new_line();
+  check_window(0, 0, CONSOLE_LINE_HEIGHT, ILI9341_TFTWIDTH,
+               CONSOLE_LINE_HEIGHT);
+  check_fill(0, CONSOLE_LINE_HEIGHT, ILI9341_TFTWIDTH, CONSOLE_LINE_HEIGHT,
+             TEST_BG);
+  CHECK_EQ(host_panel_scroll_start(), 2 * CONSOLE_LINE_HEIGHT);
+  check_cell(0, 0, 'Z', TEST_FG, TEST_BG);
+
+  for (slot = 2; slot < CONSOLE_LINES; slot++)
+  {
+    console_new_line();
+  } /* for */
+  CHECK_EQ(host_panel_scroll_start(), 0);
+} /* test_scroll_step */
+
+
+int main(void)
+{
+  test_init();
+  test_overwrite_char();
+  test_clear_line();
+  test_scroll_step();
+
+  return test_report("test_console");
+} /* main */
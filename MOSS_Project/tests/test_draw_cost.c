@@ -0,0 +1,270 @@
+// *****************************************************************************
+// ***************************    C Source Code     ****************************
+// *****************************************************************************
+//   DESIGNER NAME:  Rafael Ortiz
+//
+//         VERSION:  1.0
+//
+//       FILE NAME:  test_draw_cost.c
+//
+//-----------------------------------------------------------------------------
+// DESCRIPTION
+//    This file measures what drawing text costs on the SPI bus, through the
+//    ILI9341 panel model: bytes sent and D/C changes per character drawn by
+//    ili9341_draw_char, per cell of a run drawn by ili9341_draw_text_cells,
+//    and, for comparison, per character drawn a lit pixel at a time with
+//    ili9341_draw_pixel as draw_char used to. The costs must stay within
+//    the bounds of one address window per glyph or per run.
+//
+//-----------------------------------------------------------------------------
+// DISCLAIMER
+//    This code was developed for educational purposes as part of the CSC202
+//    course and is provided "as is" without warranties of any kind, whether
+//    express, implied, or statutory.
+//
+//    The author and organization do not warrant the accuracy, completeness, or
+//    reliability of the code. The author and organization shall not be liable
+//    for any direct, indirect, incidental, special, exemplary, or consequential
+//    damages arising out of the use of or inability to use the code, even if
+//    advised of the possibility of such damages.
+//
+//    Use of this code is at your own risk, and it is recommended to validate
+//    and adapt the code for your specific application and hardware requirements.
+//
+// Copyright (c) 2024 by TBD
+//    You may use, edit, run or distribute this file as long as the above
+//    copyright notice remains
+// *****************************************************************************
+
+
+
+//-----------------------------------------------------------------------------
+// Load standard C include files
+//-----------------------------------------------------------------------------
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+
+//-----------------------------------------------------------------------------
+// Loads MSP launchpad board support macros and definitions
+//-----------------------------------------------------------------------------
+#include "ili9341.h"
+#include "console.h"
+#include "host.h"
+#include "host_panel.h"
+#include "test.h"
+
+// The font, for the glyph boxes. ili9341.c defines its public descriptor,
+// so this copy is renamed.
+#define jet_brains_mono                                  test_jet_brains_mono
+#include "jet_brains_mono.h"
+#undef jet_brains_mono
+
+
+//-----------------------------------------------------------------------------
+// Define symbolic constants used by the program
+//-----------------------------------------------------------------------------
+// Bytes that open an address window: CASET, PASET and RAMWR, the first two
+// with four parameter bytes each
+#define WINDOW_BYTES                                                        (11)
+
+// D/C changes per window: low for each of the three commands and high after
+// each, counting the change into the next window's CASET
+#define WINDOW_DC_CHANGES                                                    (6)
+
+// First and count of the printable characters
+#define FIRST_CHAR                                                          (32)
+#define CHAR_COUNT                                                          (95)
+
+// Where the characters are drawn, clear of the panel edges
+#define DRAW_X                                                              (20)
+#define DRAW_Y                                                              (40)
+
+
+//-----------------------------------------------------------------------------
+// Define the types used by the program
+//-----------------------------------------------------------------------------
+// Totals over the printable characters
+typedef struct
+{
+  uint32_t bytes;
+  uint32_t dc_changes;
+  uint32_t chars;
+} cost_struct;
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    Returns the number of lit pixels in a glyph.
+// -----------------------------------------------------------------------------
+static uint16_t lit_pixels(const glyph_dsc_t *glyph)
+{
+  const uint8_t *bitmap = &font_dsc.glyph_bitmap[glyph->bitmap_index];
+  uint16_t lit = 0;
+
+  for (uint16_t i = 0; i < glyph->box_w * glyph->box_h; i++)
+  {
+    if (bitmap[i >> 3] & (0x80 >> (i & 7)))
+    {
+      lit++;
+    } /* if */
+  } /* for */
+
+  return lit;
+} /* lit_pixels */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    Draws a character the way ili9341_draw_char used to, with
+//    ili9341_draw_pixel for every lit pixel of the glyph box.
+// -----------------------------------------------------------------------------
+static void draw_char_by_pixel(char c, uint16_t x, uint16_t y)
+{
+  const glyph_dsc_t *glyph = &font_dsc.glyph_dsc[c - FIRST_CHAR + 1];
+  const uint8_t *bitmap = &font_dsc.glyph_bitmap[glyph->bitmap_index];
+  int16_t top_y = y - (glyph->box_h + glyph->ofs_y);
+  uint16_t i;
+
+  for (i = 0; i < glyph->box_w * glyph->box_h; i++)
+  {
+    if (bitmap[i >> 3] & (0x80 >> (i & 7)))
+    {
+      ili9341_draw_pixel(x + glyph->ofs_x + i % glyph->box_w,
+                         top_y + i / glyph->box_w, ILI9341_BLACK);
+    } /* if */
+  } /* for */
+} /* draw_char_by_pixel */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    Starts a measurement from a blank panel with the log cleared. A pixel
+//    is drawn first and leaves D/C high, so the change into the first
+//    window counts, as it does for every character after the first.
+// -----------------------------------------------------------------------------
+static void setup(void)
+{
+  host_regs_reset();
+  host_panel_reset();
+  ili9341_set_text_color(ILI9341_BLACK, ILI9341_WHITE);
+  ili9341_draw_pixel(0, 0, ILI9341_WHITE);
+  host_panel_clear_log();
+} /* setup */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    Each printable character costs one window the size of its glyph box,
+//    exactly WINDOW_BYTES plus two bytes per box pixel and WINDOW_DC_CHANGES
+//    D/C changes, and never more than a console cell; a space sends
+//    nothing. Prints the averages next to those
+//    of drawing the lit pixels one at a time.
+// -----------------------------------------------------------------------------
+static void test_draw_char_cost(void)
+{
+  const host_panel_window_struct *window;
+  const glyph_dsc_t *glyph;
+  host_panel_stats_struct stats;
+  cost_struct blit = {0};
+  cost_struct by_pixel = {0};
+  uint32_t box;
+  char c;
+
+  for (uint8_t i = 0; i < CHAR_COUNT; i++)
+  {
+    c = (char)(FIRST_CHAR + i);
+    glyph = &font_dsc.glyph_dsc[i + 1];
+    box = (uint32_t)glyph->box_w * glyph->box_h;
+
+    setup();
+    ili9341_draw_char(c, DRAW_X, DRAW_Y);
+    host_panel_get_stats(&stats);
+
+    if (box == 0)
+    {
+      CHECK_EQ(stats.bytes, 0);
+      continue;
+    } /* if */
+
+    CHECK_EQ(stats.windows, 1);
+    CHECK_EQ(stats.commands, 3);
+    CHECK_EQ(stats.bytes, WINDOW_BYTES + 2 * box);
+    CHECK(stats.bytes <= WINDOW_BYTES + 2 * GLYPH_WIDTH * CONSOLE_LINE_HEIGHT);
+    CHECK_EQ(stats.dc_changes, WINDOW_DC_CHANGES);
+    window = host_panel_window(0);
+    CHECK(window != NULL);
+    if (window != NULL)
+    {
+      CHECK_EQ(window->x0, DRAW_X + glyph->ofs_x);
+      CHECK_EQ(window->x1 - window->x0 + 1, glyph->box_w);
+      CHECK_EQ(window->y0, DRAW_Y - (glyph->box_h + glyph->ofs_y));
+      CHECK_EQ(window->y1 - window->y0 + 1, glyph->box_h);
+      CHECK_EQ(window->pixels, box);
+    } /* if */
+    blit.bytes += stats.bytes;
+    blit.dc_changes += stats.dc_changes;
+    blit.chars++;
+
+    setup();
+    draw_char_by_pixel(c, DRAW_X, DRAW_Y);
+    host_panel_get_stats(&stats);
+    CHECK_EQ(stats.windows, lit_pixels(glyph));
+    by_pixel.bytes += stats.bytes;
+    by_pixel.dc_changes += stats.dc_changes;
+    by_pixel.chars++;
+  } /* for */
+
+  CHECK(blit.chars > 0);
+  CHECK(blit.bytes < by_pixel.bytes);
+  CHECK(by_pixel.dc_changes > blit.dc_changes);
+
+  printf("draw_char, per character over %u glyphs:\n", (unsigned)blit.chars);
+  printf("  one window : %4u SPI bytes, %4u D/C changes\n",
+         (unsigned)(blit.bytes / blit.chars),
+         (unsigned)(blit.dc_changes / blit.chars));
+  printf("  per pixel  : %4u SPI bytes, %4u D/C changes\n",
+         (unsigned)(by_pixel.bytes / by_pixel.chars),
+         (unsigned)(by_pixel.dc_changes / by_pixel.chars));
+} /* test_draw_char_cost */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    A run of console cells costs one window for the whole run, so per cell
+//    no more than two bytes per cell pixel plus its share of the window.
+// -----------------------------------------------------------------------------
+static void test_text_cells_cost(void)
+{
+  static const char text[] = "Temperature: 23C";
+  const uint8_t count = sizeof(text) - 1;
+  const uint32_t cell_bytes = 2 * GLYPH_WIDTH * CONSOLE_LINE_HEIGHT;
+  host_panel_stats_struct stats;
+
+  setup();
+  ili9341_draw_text_cells(text, count, 0, 0, CONSOLE_LINE_HEIGHT,
+                          CONSOLE_BASELINE);
+  host_panel_get_stats(&stats);
+
+  CHECK_EQ(stats.windows, 1);
+  CHECK_EQ(stats.commands, 3);
+  CHECK_EQ(stats.bytes, WINDOW_BYTES + count * cell_bytes);
+  CHECK_EQ(stats.dc_changes, WINDOW_DC_CHANGES);
+
+  printf("draw_text_cells, %u cells in one run: %u SPI bytes per cell "
+         "(%u of pixels), %u.%02u D/C changes per cell\n", (unsigned)count,
+         (unsigned)(stats.bytes / count), (unsigned)cell_bytes,
+         (unsigned)(stats.dc_changes / count),
+         (unsigned)(stats.dc_changes * 100 / count % 100));
+} /* test_text_cells_cost */
+
+
+int main(void)
+{
+  test_draw_char_cost();
+  test_text_cells_cost();
+
+  return test_report("test_draw_cost");
+} /* main */
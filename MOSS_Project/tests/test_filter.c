@@ -0,0 +1,490 @@
+// *****************************************************************************
+// ***************************    C Source Code     ****************************
+// *****************************************************************************
+//   DESIGNER NAME:  Rafael Ortiz
+//
+//         VERSION:  1.0
+//
+//       FILE NAME:  test_filter.c
+//
+//-----------------------------------------------------------------------------
+// DESCRIPTION
+//    This file tests the filter stages against reference outputs worked
+//    out the slow way: the boxcar and median from the whole window each
+//    sample, the CIC as a cascade of moving sums, and the IIR against the
+//    same recurrence in floating point. Inputs are random, steps and spikes,
+//    negative as well as positive.
+//
+//-----------------------------------------------------------------------------
+// DISCLAIMER
+//    This code was developed for educational purposes as part of the CSC202
+//    course and is provided "as is" without warranties of any kind, whether
+//    express, implied, or statutory.
+//
+//    The author and organization do not warrant the accuracy, completeness, or
+//    reliability of the code. The author and organization shall not be liable
+//    for any direct, indirect, incidental, special, exemplary, or consequential
+//    damages arising out of the use of or inability to use the code, even if
+//    advised of the possibility of such damages.
+//
+//    Use of this code is at your own risk, and it is recommended to validate
+//    and adapt the code for your specific application and hardware requirements.
+//
+// Copyright (c) 2024 by TBD
+//    You may use, edit, run or distribute this file as long as the above
+//    copyright notice remains
+// *****************************************************************************
+//******************************************************************************
+
+
+//-----------------------------------------------------------------------------
+// Load standard C include files
+//-----------------------------------------------------------------------------
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+
+//-----------------------------------------------------------------------------
+// Loads MSP launchpad board support macros and definitions
+//-----------------------------------------------------------------------------
+#include "filter.h"
+#include "test.h"
+
+
+//-----------------------------------------------------------------------------
+// Define symbolic constants used by the program
+//-----------------------------------------------------------------------------
+#define SAMPLES                                                           (2000)
+
+// Input kinds
+#define INPUT_RANDOM                                                         (0)
+#define INPUT_STEPS                                                          (1)
+#define INPUT_SPIKES                                                         (2)
+#define INPUT_KINDS                                                          (3)
+
+
+//-----------------------------------------------------------------------------
+// Define global variables and structures here.
+// NOTE: when possible avoid using global variables
+//-----------------------------------------------------------------------------
+static int32_t g_input[SAMPLES];
+static uint32_t g_rng;
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    A small fixed-seed generator, so a failure can be repeated.
+// -----------------------------------------------------------------------------
+static uint32_t rng_next(void)
+{
+  g_rng ^= g_rng << 13;
+  g_rng ^= g_rng >> 17;
+  g_rng ^= g_rng << 5;
+  return g_rng;
+} /* rng_next */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    Fills g_input with samples of one kind in -limit to limit - 1.
+// -----------------------------------------------------------------------------
+static void make_input(uint8_t kind, int32_t limit)
+{
+  int32_t level = 0;
+
+  g_rng = 0x2545F491 + kind * 77 + (uint32_t)limit;
+  for (uint16_t n = 0; n < SAMPLES; n++)
+  {
+    int32_t noise = (int32_t)(rng_next() % (2 * (uint32_t)limit)) - limit;
+
+    switch (kind)
+    {
+      case INPUT_RANDOM:
+        g_input[n] = noise;
+        break;
+
+      case INPUT_STEPS:
+        if (n % 150 == 0)
+        {
+          level = noise;
+        } /* if */
+        g_input[n] = level;
+        break;
+
+      default:
+        g_input[n] = (rng_next() % 10 == 0) ? noise : -limit / 3;
+        break;
+    } /* switch */
+  } /* for */
+} /* make_input */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    Input n, taking samples before the first as equal to it, as the
+//    boxcar, IIR and median stages do.
+// -----------------------------------------------------------------------------
+static int32_t primed_input(int32_t n)
+{
+  return g_input[(n < 0) ? 0 : n];
+} /* primed_input */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    Division rounding toward minus infinity, as the stages' shifts do.
+// -----------------------------------------------------------------------------
+static int64_t floor_div(int64_t value, int64_t divisor)
+{
+  int64_t quotient = value / divisor;
+
+  return (value % divisor != 0 && value < 0) ? quotient - 1 : quotient;
+} /* floor_div */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    Orders two samples for qsort.
+// -----------------------------------------------------------------------------
+static int compare_samples(const void *a, const void *b)
+{
+  int32_t x = *(const int32_t *)a;
+  int32_t y = *(const int32_t *)b;
+
+  return (x > y) - (x < y);
+} /* compare_samples */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    The boxcar against the floored mean of the last 2^length_log2 inputs.
+// -----------------------------------------------------------------------------
+static void check_boxcar(uint8_t length_log2)
+{
+  filter_chain_struct chain;
+  int32_t length = 1 << length_log2;
+  int32_t output;
+  int64_t sum;
+
+  filter_chain_init(&chain);
+  CHECK(filter_chain_add_boxcar(&chain, length_log2));
+
+  for (int32_t n = 0; n < SAMPLES; n++)
+  {
+    sum = 0;
+    for (int32_t k = 0; k < length; k++)
+    {
+      sum += primed_input(n - k);
+    } /* for */
+
+    CHECK(filter_chain_process(&chain, g_input[n], &output));
+    CHECK_EQ(output, floor_div(sum, length));
+  } /* for */
+} /* check_boxcar */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    The median against the middle of the sorted last length inputs.
+// -----------------------------------------------------------------------------
+static void check_median(uint8_t length)
+{
+  filter_chain_struct chain;
+  int32_t window[FILTER_MEDIAN_MAX_LENGTH];
+  int32_t output;
+
+  filter_chain_init(&chain);
+  CHECK(filter_chain_add_median(&chain, length));
+
+  for (int32_t n = 0; n < SAMPLES; n++)
+  {
+    for (int32_t k = 0; k < length; k++)
+    {
+      window[k] = primed_input(n - k);
+    } /* for */
+    qsort(window, length, sizeof(window[0]), compare_samples);
+
+    CHECK(filter_chain_process(&chain, g_input[n], &output));
+    CHECK_EQ(output, window[length / 2]);
+  } /* for */
+} /* check_median */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    The IIR against y += (x - y) / 2^shift in floating point. The state
+//    drops the fraction below its own bits each sample, which can only push
+//    it up, by less than one count in all; flooring the output can only
+//    pull it down, by less than one count. So the output stays within one
+//    count of the exact value, and once the input holds still it settles
+//    on it exactly.
+// -----------------------------------------------------------------------------
+static void check_iir(uint8_t shift)
+{
+  filter_chain_struct chain;
+  double scale = 1.0 / (1 << shift);
+  double exact = g_input[0];
+  double error;
+  int32_t output;
+
+  filter_chain_init(&chain);
+  CHECK(filter_chain_add_iir(&chain, shift));
+
+  for (int32_t n = 0; n < SAMPLES; n++)
+  {
+    exact += (g_input[n] - exact) * scale;
+
+    CHECK(filter_chain_process(&chain, g_input[n], &output));
+    error = output - exact;
+    CHECK(fabs(error) < 1.0);
+  } /* for */
+
+  // Settles on a constant input
+  for (int32_t n = 0; n < 40 << shift; n++)
+  {
+    filter_chain_process(&chain, -12345, &output);
+  } /* for */
+  CHECK_EQ(output, -12345);
+} /* check_iir */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    The CIC against order moving sums of 2^factor_log2 inputs in a row,
+//    starting from zero, taken at the end of each block and divided by the
+//    gain.
+// -----------------------------------------------------------------------------
+static void check_cic(uint8_t factor_log2, uint8_t order)
+{
+  static int64_t stage_in[SAMPLES];
+  static int64_t stage_out[SAMPLES];
+  filter_chain_struct chain;
+  int32_t factor = 1 << factor_log2;
+  int32_t output;
+  uint32_t outputs = 0;
+  bool ready;
+
+  for (int32_t n = 0; n < SAMPLES; n++)
+  {
+    stage_out[n] = g_input[n];
+  } /* for */
+  for (uint8_t section = 0; section < order; section++)
+  {
+    for (int32_t n = 0; n < SAMPLES; n++)
+    {
+      stage_in[n] = stage_out[n];
+    } /* for */
+    for (int32_t n = 0; n < SAMPLES; n++)
+    {
+      stage_out[n] = 0;
+      for (int32_t k = 0; k < factor && k <= n; k++)
+      {
+        stage_out[n] += stage_in[n - k];
+      } /* for */
+    } /* for */
+  } /* for */
+
+  filter_chain_init(&chain);
+  CHECK(filter_chain_add_cic(&chain, factor_log2, order));
+
+  for (int32_t n = 0; n < SAMPLES; n++)
+  {
+    ready = filter_chain_process(&chain, g_input[n], &output);
+    CHECK_EQ(ready, (n % factor) == factor - 1);
+    if (ready)
+    {
+      CHECK_EQ(output, floor_div(stage_out[n], 1LL << (order * factor_log2)));
+      outputs++;
+    } /* if */
+  } /* for */
+
+  CHECK_EQ(outputs, SAMPLES / factor);
+} /* check_cic */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    Each stage at each of its lengths, on each kind of input. Inputs are
+//    kept to the range the stage allows: for the IIR 31 - shift bits, for
+//    the CIC 31 - order * factor_log2 bits.
+// -----------------------------------------------------------------------------
+static void test_stages(void)
+{
+  for (uint8_t kind = 0; kind < INPUT_KINDS; kind++)
+  {
+    make_input(kind, 1 << 26);
+    for (uint8_t length_log2 = 0; length_log2 <= FILTER_BOXCAR_MAX_LOG2;
+         length_log2++)
+    {
+      check_boxcar(length_log2);
+    } /* for */
+    for (uint8_t length = 3; length <= FILTER_MEDIAN_MAX_LENGTH; length += 2)
+    {
+      check_median(length);
+    } /* for */
+
+    for (uint8_t shift = 1; shift <= FILTER_IIR_MAX_SHIFT; shift++)
+    {
+      make_input(kind, 1 << (30 - shift));
+      check_iir(shift);
+    } /* for */
+
+    for (uint8_t order = 1; order <= FILTER_CIC_MAX_ORDER; order++)
+    {
+      for (uint8_t factor_log2 = 1; factor_log2 <= FILTER_CIC_MAX_FACTOR_LOG2;
+           factor_log2++)
+      {
+        make_input(kind, 1 << (30 - order * factor_log2));
+        check_cic(factor_log2, order);
+      } /* for */
+    } /* for */
+  } /* for */
+} /* test_stages */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    Short vectors worked by hand: a median removing a spike, a boxcar and
+//    an IIR following a step down from a negative start.
+// -----------------------------------------------------------------------------
+static void test_known_outputs(void)
+{
+  static const int32_t spike_in[] = {5, 5, 900, 5, 6, -700, 7, 7};
+  static const int32_t spike_out[] = {5, 5, 5, 5, 6, 5, 6, 7};
+  static const int32_t step_in[] = {-8, -8, -16, -16, -16, -16};
+  static const int32_t boxcar_out[] = {-8, -8, -10, -12, -14, -16};
+  static const int32_t iir_out[] = {-8, -8, -12, -14, -15, -16};
+  filter_chain_struct chain;
+  int32_t output;
+  uint8_t i;
+
+  filter_chain_init(&chain);
+  CHECK(filter_chain_add_median(&chain, 3));
+  for (i = 0; i < sizeof(spike_in) / sizeof(spike_in[0]); i++)
+  {
+    CHECK(filter_chain_process(&chain, spike_in[i], &output));
+    CHECK_EQ(output, spike_out[i]);
+  } /* for */
+
+  filter_chain_init(&chain);
+  CHECK(filter_chain_add_boxcar(&chain, 2));
+  for (i = 0; i < sizeof(step_in) / sizeof(step_in[0]); i++)
+  {
+    CHECK(filter_chain_process(&chain, step_in[i], &output));
+    CHECK_EQ(output, boxcar_out[i]);
+  } /* for */
+
+  // acc starts at -16, then -16, -24, -28, -30, -31 halves
+  filter_chain_init(&chain);
+  CHECK(filter_chain_add_iir(&chain, 1));
+  for (i = 0; i < sizeof(step_in) / sizeof(step_in[0]); i++)
+  {
+    CHECK(filter_chain_process(&chain, step_in[i], &output));
+    CHECK_EQ(output, iir_out[i]);
+  } /* for */
+} /* test_known_outputs */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    A median, boxcar and CIC chained: the output is the CIC of the boxcar
+//    of the median, and a reset starts it over as if new.
+// -----------------------------------------------------------------------------
+static void test_chain(void)
+{
+  static int32_t first[SAMPLES / 4];
+  filter_chain_struct chain;
+  filter_chain_struct median;
+  filter_chain_struct boxcar;
+  filter_chain_struct cic;
+  int32_t output;
+  int32_t expected;
+  uint32_t outputs = 0;
+  bool ready;
+
+  make_input(INPUT_SPIKES, 1 << 20);
+
+  filter_chain_init(&chain);
+  CHECK(filter_chain_add_median(&chain, 5));
+  CHECK(filter_chain_add_boxcar(&chain, 3));
+  CHECK(filter_chain_add_cic(&chain, 2, 2));
+  CHECK(filter_chain_add_iir(&chain, 4));
+  CHECK(!filter_chain_add_iir(&chain, 4));
+
+  filter_chain_init(&median);
+  filter_chain_init(&boxcar);
+  filter_chain_init(&cic);
+  CHECK(filter_chain_add_median(&median, 5));
+  CHECK(filter_chain_add_boxcar(&boxcar, 3));
+  CHECK(filter_chain_add_cic(&cic, 2, 2));
+  CHECK(filter_chain_add_iir(&cic, 4));
+
+  for (int32_t n = 0; n < SAMPLES; n++)
+  {
+    CHECK(filter_chain_process(&median, g_input[n], &expected));
+    CHECK(filter_chain_process(&boxcar, expected, &expected));
+    ready = filter_chain_process(&cic, expected, &expected);
+
+    CHECK_EQ(filter_chain_process(&chain, g_input[n], &output), ready);
+    if (ready)
+    {
+      CHECK_EQ(output, expected);
+      if (outputs < SAMPLES / 4)
+      {
+        first[outputs] = output;
+      } /* if */
+      outputs++;
+    } /* if */
+  } /* for */
+  CHECK_EQ(outputs, SAMPLES / 4);
+
+  filter_chain_reset(&chain);
+  outputs = 0;
+  for (int32_t n = 0; n < SAMPLES; n++)
+  {
+    if (filter_chain_process(&chain, g_input[n], &output))
+    {
+      CHECK_EQ(output, first[outputs]);
+      outputs++;
+    } /* if */
+  } /* for */
+  CHECK_EQ(outputs, SAMPLES / 4);
+} /* test_chain */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    Lengths and orders out of range are refused.
+// -----------------------------------------------------------------------------
+static void test_parameters(void)
+{
+  filter_chain_struct chain;
+
+  filter_chain_init(&chain);
+  CHECK(!filter_chain_add_boxcar(&chain, FILTER_BOXCAR_MAX_LOG2 + 1));
+  CHECK(!filter_chain_add_iir(&chain, 0));
+  CHECK(!filter_chain_add_iir(&chain, FILTER_IIR_MAX_SHIFT + 1));
+  CHECK(!filter_chain_add_median(&chain, 1));
+  CHECK(!filter_chain_add_median(&chain, 4));
+  CHECK(!filter_chain_add_median(&chain, FILTER_MEDIAN_MAX_LENGTH + 2));
+  CHECK(!filter_chain_add_cic(&chain, 0, 1));
+  CHECK(!filter_chain_add_cic(&chain, FILTER_CIC_MAX_FACTOR_LOG2 + 1, 1));
+  CHECK(!filter_chain_add_cic(&chain, 1, 0));
+  CHECK(!filter_chain_add_cic(&chain, 1, FILTER_CIC_MAX_ORDER + 1));
+  CHECK_EQ(chain.stage_count, 0);
+} /* test_parameters */
+
+
+int main(void)
+{
+  test_stages();
+  test_known_outputs();
+  test_chain();
+  test_parameters();
+
+  return test_report("test_filter");
+} /* main */
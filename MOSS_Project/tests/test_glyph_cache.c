@@ -0,0 +1,408 @@
+// *****************************************************************************
+// ***************************    C Source Code     ****************************
+// *****************************************************************************
+//   DESIGNER NAME:  Rafael Ortiz
+//
+//         VERSION:  1.0
+//
+//       FILE NAME:  test_glyph_cache.c
+//
+//-----------------------------------------------------------------------------
+// DESCRIPTION
+//    This file tests the ILI9341 glyph cache through the text console. A
+//    scripted shell session is typed and printed the way shell.c does it,
+//    and the hit rate the cache reports is printed. SPI1 is replaced by
+//    stand-ins that finish every write at once and keep a checksum of the
+//    pixels, so a cell drawn from the cache can be checked against the
+//    same cell decoded straight from the font bitmap.
+//
+//-----------------------------------------------------------------------------
+// DISCLAIMER
+//    This code was developed for educational purposes as part of the CSC202
+//    course and is provided "as is" without warranties of any kind, whether
+//    express, implied, or statutory.
+//
+//    The author and organization do not warrant the accuracy, completeness, or
+//    reliability of the code. The author and organization shall not be liable
+//    for any direct, indirect, incidental, special, exemplary, or consequential
+//    damages arising out of the use of or inability to use the code, even if
+//    advised of the possibility of such damages.
+//
+//    Use of this code is at your own risk, and it is recommended to validate
+//    and adapt the code for your specific application and hardware requirements.
+//
+// Copyright (c) 2024 by TBD
+//    You may use, edit, run or distribute this file as long as the above
+//    copyright notice remains
+// *****************************************************************************
+//******************************************************************************
+
+
+//-----------------------------------------------------------------------------
+// Load standard C include files
+//-----------------------------------------------------------------------------
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+
+//-----------------------------------------------------------------------------
+// Loads MSP launchpad board support macros and definitions
+//-----------------------------------------------------------------------------
+#include "ili9341.h"
+#include "console.h"
+#include "spi.h"
+#include "test.h"
+
+// The font, for the reference cells. ili9341.c defines its public
+// descriptor, so this copy is renamed.
+#define jet_brains_mono                                  test_jet_brains_mono
+#include "jet_brains_mono.h"
+#undef jet_brains_mono
+
+
+//-----------------------------------------------------------------------------
+// Define symbolic constants used by the program
+//-----------------------------------------------------------------------------
+#define FNV_OFFSET                                                  (2166136261U)
+#define FNV_PRIME                                                     (16777619U)
+
+// Least hit rate, in percent, the session must reach
+#define MIN_HIT_RATE                                                        (80)
+
+
+//-----------------------------------------------------------------------------
+// Define global variables and structures here.
+// NOTE: when possible avoid using global variables
+//-----------------------------------------------------------------------------
+static uint32_t g_pixel_hash = FNV_OFFSET;
+static uint32_t g_pixel_count = 0;
+
+// A shell session: each entry is typed, then its output printed
+static const char *const g_session[][2] =
+{
+  {"help", "Available commands:\r\n"
+           "help - Show this help message\r\n"
+           "clock - Measure/set clock\r\n"
+           "temp - Read temperature from thermistor\r\n"
+           "time - Display current RTC time\r\n"
+           "color - Run LCD color test\r\n"
+           "clear - Clear the terminal\r\n"
+           "stats - Show driver traffic\r\n"
+           "scroll - Time console scrolling\r\n"
+           "cache - Show glyph cache hit rate\r\n"
+           "strip - Time the band renderer\r\n"
+           "tconv - Check temperature conversion\r\n"
+           "sample - Stream the thermistor\r\n"
+           "acq - Timed ADC acquisition\r\n"
+           "band - Watch thermistor band\r\n"
+           "history - Dump temperature log\r\n"
+           "store - Show flash store\r\n"},
+  {"temp", "Temperature: 23C / 73F\r\n"},
+  {"time", "Current Time: 14:05:37\r\n"},
+  {"stats", "SPI1: 1843200 bytes, 12 DMA\r\n"
+            "TFT: 5127 commands\r\n"
+            "UART0: 2281 tx, 57 rx, 0 drop\r\n"
+            "I2C1: 42 xfers, 0 nack, 0 arb\r\n"
+            "CPU: asleep 97.3% of 1000 ms, 1022 wakes\r\n"},
+  {"tmep", "Unknown command\r\n"},
+  {"temp", "Temperature: 24C / 75F\r\n"},
+  {"history", "History: 24 samples in 1 blocks\r\n"
+              "31 bytes, 1.29 bytes/sample\r\n"
+              "14:05:14,23.4\r\n14:05:15,23.4\r\n14:05:16,23.5\r\n"
+              "14:05:17,23.5\r\n14:05:18,23.5\r\n14:05:19,23.6\r\n"
+              "14:05:20,23.6\r\n14:05:21,23.7\r\n14:05:22,23.7\r\n"
+              "14:05:23,23.8\r\n14:05:24,23.8\r\n14:05:25,23.9\r\n"
+              "14:05:26,24.0\r\n14:05:27,24.0\r\n14:05:28,24.1\r\n"
+              "14:05:29,24.1\r\n14:05:30,24.2\r\n14:05:31,24.2\r\n"
+              "14:05:32,24.2\r\n14:05:33,24.3\r\n14:05:34,24.3\r\n"
+              "14:05:35,24.3\r\n14:05:36,24.4\r\n14:05:37,24.4\r\n"},
+  {"store", "Store: 3 sectors, 2 settings, 4 blocks\r\n"
+            "Erases: 1-2 per sector, 0 since boot\r\n"
+            "Wrote 0 B for 0 B (x0.00)\r\n"},
+  {"clock 40", "Bus clock: 40 MHz\r\n"},
+  {"time", "Current Time: 14:06:02\r\n"},
+  {"sample", "Sampled: 1000 results/s\r\n"
+             "Mean: 24.3C\r\n"
+             "Filtered: 24.3C (62 out)\r\n"},
+  {"cache", "Glyph cache: 84% hit\r\n"
+            "610 hit, 109 miss\r\n"
+            "108 evict, 32 slots\r\n"},
+  {"temp", "Temperature: 24C / 75F\r\n"},
+};
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    Stand-ins for the SPI1 driver. Every write is finished when it returns,
+//    and 16-bit frames, which carry the pixels, are added to the checksum.
+// -----------------------------------------------------------------------------
+static void hash_frame(uint16_t frame)
+{
+  g_pixel_hash = (g_pixel_hash ^ (frame & 0xFF)) * FNV_PRIME;
+  g_pixel_hash = (g_pixel_hash ^ (frame >> 8)) * FNV_PRIME;
+  g_pixel_count++;
+} /* hash_frame */
+
+
+void spi1_set_frame_size(uint8_t bits)
+{
+  (void)bits;
+} /* spi1_set_frame_size */
+
+
+void spi1_write_data(uint8_t data)
+{
+  (void)data;
+} /* spi1_write_data */
+
+
+void spi1_write_data16(uint16_t data)
+{
+  hash_frame(data);
+} /* spi1_write_data16 */
+
+
+bool spi1_write_buffer16_async(const uint16_t *buffer, uint16_t count,
+                               spi1_callback_t callback)
+{
+  while (count-- > 0)
+  {
+    hash_frame(*buffer++);
+  } /* while */
+  if (callback != NULL)
+  {
+    callback();
+  } /* if */
+  return true;
+} /* spi1_write_buffer16_async */
+
+
+bool spi1_write_repeat16_async(uint16_t data, uint32_t count,
+                               spi1_callback_t callback)
+{
+  while (count-- > 0)
+  {
+    hash_frame(data);
+  } /* while */
+  if (callback != NULL)
+  {
+    callback();
+  } /* if */
+  return true;
+} /* spi1_write_repeat16_async */
+
+
+bool spi1_async_busy(void)
+{
+  return false;
+} /* spi1_async_busy */
+
+
+void spi1_wait_async(void)
+{
+} /* spi1_wait_async */
+
+
+bool spi1_xfer_done(void)
+{
+  return true;
+} /* spi1_xfer_done */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    Draws a text run and returns the checksum of its pixels.
+// -----------------------------------------------------------------------------
+static uint32_t draw_hash(const char *text, uint8_t count, uint16_t cell_h,
+                          uint16_t baseline)
+{
+  g_pixel_hash = FNV_OFFSET;
+  g_pixel_count = 0;
+  ili9341_draw_text_cells(text, count, 0, 0, cell_h, baseline);
+  CHECK_EQ(g_pixel_count, count * GLYPH_WIDTH * cell_h);
+
+  return g_pixel_hash;
+} /* draw_hash */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    Returns the checksum of a text run drawn the way the uncached path does:
+//    every pixel decoded from the font bitmap, the glyph placed in its cell
+//    by its box offsets, and pixels outside the cell clipped.
+// -----------------------------------------------------------------------------
+static uint32_t reference_hash(const char *text, uint8_t count,
+                               uint16_t cell_h, uint16_t baseline,
+                               uint16_t fg_color, uint16_t bg_color)
+{
+  const glyph_dsc_t *glyph;
+  const uint8_t *bitmap;
+  uint32_t hash = FNV_OFFSET;
+  uint16_t pixel;
+  uint16_t bit_pos;
+  int16_t glyph_row;
+  int16_t glyph_col;
+  uint8_t index;
+
+  for (uint16_t row = 0; row < cell_h; row++)
+  {
+    for (uint8_t i = 0; i < count; i++)
+    {
+      index = (text[i] >= 32 && text[i] <= 126) ? text[i] - 32 + 1 : 0;
+      glyph = &font_dsc.glyph_dsc[index];
+      bitmap = &font_dsc.glyph_bitmap[glyph->bitmap_index];
+      glyph_row = row - (baseline - (glyph->box_h + glyph->ofs_y));
+
+      for (uint8_t col = 0; col < GLYPH_WIDTH; col++)
+      {
+        glyph_col = col - glyph->ofs_x;
+        pixel = bg_color;
+        if (glyph_row >= 0 && glyph_row < glyph->box_h &&
+            glyph_col >= 0 && glyph_col < glyph->box_w)
+        {
+          bit_pos = glyph_row * glyph->box_w + glyph_col;
+          if (bitmap[bit_pos >> 3] & (0x80 >> (bit_pos & 7)))
+          {
+            pixel = fg_color;
+          } /* if */
+        } /* if */
+        hash = (hash ^ (pixel & 0xFF)) * FNV_PRIME;
+        hash = (hash ^ (pixel >> 8)) * FNV_PRIME;
+      } /* for */
+    } /* for */
+  } /* for */
+
+  return hash;
+} /* reference_hash */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    Cells drawn as the cache fills and drawn from it both match the cells
+//    decoded straight from the bitmap at the same height, for every
+//    printable character. Entries do not depend on the colors, so a second
+//    color pair hits them. Cells taller than ILI9341_GLYPH_CACHE_MAX_CELL_H
+//    bypass the cache and match the reference too.
+// -----------------------------------------------------------------------------
+static void test_cached_pixels(void)
+{
+  static const char text[] = "Temp: 23.4C gW|";
+  char printable[95];
+  glyph_cache_stats_struct stats;
+  uint32_t reference;
+  uint32_t cached;
+  uint32_t bitmap;
+  uint8_t start;
+  uint8_t count;
+
+  ili9341_set_text_color(ILI9341_WHITE, ILI9341_BLACK);
+  ili9341_clear_glyph_cache_stats();
+
+  reference = reference_hash(text, 4, CONSOLE_LINE_HEIGHT, CONSOLE_BASELINE,
+                             ILI9341_WHITE, ILI9341_BLACK);
+  CHECK_EQ(draw_hash(text, 4, CONSOLE_LINE_HEIGHT, CONSOLE_BASELINE),
+           reference);
+  ili9341_get_glyph_cache_stats(&stats);
+  CHECK_EQ(stats.misses, 4);
+  cached = draw_hash(text, 4, CONSOLE_LINE_HEIGHT, CONSOLE_BASELINE);
+  ili9341_get_glyph_cache_stats(&stats);
+  CHECK_EQ(stats.hits, 4);
+  CHECK_EQ(cached, reference);
+
+  // Another color pair hits the same entries and draws in its own colors
+  ili9341_set_text_color(ILI9341_YELLOW, ILI9341_BLACK);
+  CHECK_EQ(draw_hash(text, 4, CONSOLE_LINE_HEIGHT, CONSOLE_BASELINE),
+           reference_hash(text, 4, CONSOLE_LINE_HEIGHT, CONSOLE_BASELINE,
+                          ILI9341_YELLOW, ILI9341_BLACK));
+  ili9341_get_glyph_cache_stats(&stats);
+  CHECK_EQ(stats.hits, 8);
+  CHECK_EQ(stats.misses, 4);
+
+  // Every printable character, as the cache fills and once it holds them
+  for (uint8_t i = 0; i < sizeof(printable); i++)
+  {
+    printable[i] = (char)(32 + i);
+  } /* for */
+  for (uint8_t pass = 0; pass < 2; pass++)
+  {
+    for (start = 0; start < sizeof(printable); start += count)
+    {
+      count = sizeof(printable) - start;
+      if (count > ILI9341_MAX_TEXT_CELLS)
+      {
+        count = ILI9341_MAX_TEXT_CELLS;
+      } /* if */
+      CHECK_EQ(draw_hash(printable + start, count, CONSOLE_LINE_HEIGHT,
+                         CONSOLE_BASELINE),
+               reference_hash(printable + start, count, CONSOLE_LINE_HEIGHT,
+                              CONSOLE_BASELINE, ILI9341_YELLOW,
+                              ILI9341_BLACK));
+    } /* for */
+  } /* for */
+
+  // One row past the cache's cells is drawn from the bitmap every time
+  ili9341_clear_glyph_cache_stats();
+  bitmap = draw_hash(text, 4, ILI9341_GLYPH_CACHE_MAX_CELL_H + 1,
+                     CONSOLE_BASELINE);
+  CHECK_EQ(draw_hash(text, 4, ILI9341_GLYPH_CACHE_MAX_CELL_H + 1,
+                     CONSOLE_BASELINE), bitmap);
+  ili9341_get_glyph_cache_stats(&stats);
+  CHECK_EQ(stats.hits, 0);
+  CHECK_EQ(bitmap, reference_hash(text, 4, ILI9341_GLYPH_CACHE_MAX_CELL_H + 1,
+                                  CONSOLE_BASELINE, ILI9341_YELLOW,
+                                  ILI9341_BLACK));
+} /* test_cached_pixels */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    Types each command of the session a key at a time, each key drawn as it
+//    is typed, then prints its output, as shell.c does. Prints the hit rate
+//    the cache reports.
+// -----------------------------------------------------------------------------
+static void test_session_hit_rate(void)
+{
+  glyph_cache_stats_struct stats;
+  uint32_t lookups;
+  const char *key;
+
+  console_init();
+  ili9341_clear_glyph_cache_stats();
+
+  for (uint8_t i = 0; i < sizeof(g_session) / sizeof(g_session[0]); i++)
+  {
+    for (key = g_session[i][0]; *key != '\0'; key++)
+    {
+      console_put_char(*key);
+      console_flush();
+    } /* for */
+    console_new_line();
+    console_flush();
+
+    console_write_string(g_session[i][1]);
+    console_flush();
+  } /* for */
+
+  ili9341_get_glyph_cache_stats(&stats);
+  lookups = stats.hits + stats.misses;
+  CHECK(lookups > 0);
+  CHECK(stats.hits * 100 >= lookups * MIN_HIT_RATE);
+
+  printf("glyph cache: %u entries of %u bytes, %u lookups, %u.%u%% hit, "
+         "%u evictions\n", (unsigned)ILI9341_GLYPH_CACHE_ENTRIES,
+         (unsigned)ILI9341_GLYPH_CACHE_ENTRY_SIZE, (unsigned)lookups,
+         (unsigned)(stats.hits * 100 / lookups),
+         (unsigned)(stats.hits * 1000 / lookups % 10),
+         (unsigned)stats.evictions);
+} /* test_session_hit_rate */
+
+
+int main(void)
+{
+  test_cached_pixels();
+  test_session_hit_rate();
+
+  return test_report("test_glyph_cache");
+} /* main */
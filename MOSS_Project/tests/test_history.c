@@ -0,0 +1,466 @@
+// *****************************************************************************
+// ***************************    C Source Code     ****************************
+// *****************************************************************************
+//   DESIGNER NAME:  Rafael Ortiz
+//
+//         VERSION:  1.0
+//
+//       FILE NAME:  test_history.c
+//
+//-----------------------------------------------------------------------------
+// DESCRIPTION
+//    This file tests the history encoder and decoder by round trip: every
+//    sample added must come back from the iterator exactly. It covers the
+//    zigzag extremes of the value deltas, samples off the channel period,
+//    the pool reusing blocks, and blocks reused under an iterator part way
+//    through a walk.
+//
+//-----------------------------------------------------------------------------
+// DISCLAIMER
+//    This code was developed for educational purposes as part of the CSC202
+//    course and is provided "as is" without warranties of any kind, whether
+//    express, implied, or statutory.
+//
+//    The author and organization do not warrant the accuracy, completeness, or
+//    reliability of the code. The author and organization shall not be liable
+//    for any direct, indirect, incidental, special, exemplary, or consequential
+//    damages arising out of the use of or inability to use the code, even if
+//    advised of the possibility of such damages.
+//
+//    Use of this code is at your own risk, and it is recommended to validate
+//    and adapt the code for your specific application and hardware requirements.
+//
+// Copyright (c) 2024 by TBD
+//    You may use, edit, run or distribute this file as long as the above
+//    copyright notice remains
+// *****************************************************************************
+//******************************************************************************
+
+
+//-----------------------------------------------------------------------------
+// Load standard C include files
+//-----------------------------------------------------------------------------
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+
+//-----------------------------------------------------------------------------
+// Loads MSP launchpad board support macros and definitions
+//-----------------------------------------------------------------------------
+#include "history.h"
+#include "test.h"
+
+
+//-----------------------------------------------------------------------------
+// Define symbolic constants used by the program
+//-----------------------------------------------------------------------------
+#define PERIOD                                                              (10)
+
+// Bytes in the pool, so at least as many samples as it can hold
+#define POOL_BYTES                         (HISTORY_BLOCKS * HISTORY_BLOCK_SIZE)
+#define MAX_SAMPLES                                           (4 * POOL_BYTES)
+
+
+//-----------------------------------------------------------------------------
+// Define the types used by the test
+//-----------------------------------------------------------------------------
+// Every sample added to one channel, oldest first
+typedef struct
+{
+  uint32_t time[MAX_SAMPLES];
+  int32_t  value[MAX_SAMPLES];
+  uint32_t count;
+} shadow_struct;
+
+
+//-----------------------------------------------------------------------------
+// Define global variables and structures here.
+// NOTE: when possible avoid using global variables
+//-----------------------------------------------------------------------------
+static shadow_struct g_shadow[HISTORY_MAX_CHANNELS];
+static uint32_t g_rng;
+
+static uint32_t g_callback_blocks;
+static uint32_t g_callback_bytes;
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    A small fixed-seed generator, so a failure can be repeated.
+// -----------------------------------------------------------------------------
+static uint32_t rng_next(void)
+{
+  g_rng ^= g_rng << 13;
+  g_rng ^= g_rng >> 17;
+  g_rng ^= g_rng << 5;
+  return g_rng;
+} /* rng_next */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    Empties the history and starts the channels used by a test.
+// -----------------------------------------------------------------------------
+static void setup(uint8_t channels)
+{
+  history_init();
+  history_set_block_callback(NULL);
+
+  for (uint8_t channel = 0; channel < channels; channel++)
+  {
+    CHECK(history_start_channel(channel, PERIOD));
+    g_shadow[channel].count = 0;
+  } /* for */
+} /* setup */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    Adds a sample to a channel and to the test's copy of it.
+// -----------------------------------------------------------------------------
+static void add(uint8_t channel, uint32_t time, int32_t value)
+{
+  shadow_struct *shadow = &g_shadow[channel];
+
+  CHECK(history_add(channel, time, value));
+  shadow->time[shadow->count] = time;
+  shadow->value[shadow->count] = value;
+  shadow->count++;
+} /* add */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    Adds a sample one period after the last one of the channel.
+// -----------------------------------------------------------------------------
+static void add_next(uint8_t channel, int32_t value)
+{
+  shadow_struct *shadow = &g_shadow[channel];
+  uint32_t time = (shadow->count == 0) ?
+                  0 : shadow->time[shadow->count - 1] + PERIOD;
+
+  add(channel, time, value);
+} /* add_next */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    Walks a channel and checks it returns the newest samples added, in
+//    order and without a gap, and as many as the stats report. Returns how
+//    many it held.
+// -----------------------------------------------------------------------------
+static uint32_t check_channel(uint8_t channel)
+{
+  const shadow_struct *shadow = &g_shadow[channel];
+  history_stats_struct stats;
+  history_iter_struct iter;
+  uint32_t first;
+  uint32_t count = 0;
+  uint32_t time;
+  int32_t value;
+
+  history_get_stats(channel, &stats);
+  CHECK(stats.samples <= shadow->count);
+  first = shadow->count - stats.samples;
+
+  history_iter_begin(&iter, channel);
+  while (history_iter_next(&iter, &time, &value))
+  {
+    if (first + count >= shadow->count)
+    {
+      CHECK(false);
+      break;
+    } /* if */
+    CHECK_EQ(time, shadow->time[first + count]);
+    CHECK_EQ(value, shadow->value[first + count]);
+    count++;
+  } /* while */
+
+  CHECK_EQ(count, stats.samples);
+
+  return count;
+} /* check_channel */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    Values at and next to the int32_t limits, and swings between them,
+//    round trip exactly, whether they fit a delta or start a new block.
+// -----------------------------------------------------------------------------
+static void test_zigzag_extremes(void)
+{
+  static const int32_t values[] =
+  {
+    0, INT32_MAX, INT32_MIN, INT32_MAX, -1, 1, INT32_MIN, INT32_MIN + 1,
+    INT32_MAX - 1, 0, -(1 << 30), (1 << 30) - 1, -(1 << 30) - 1, 1 << 30,
+    63, -64, 64, -65, 8191, -8192, 8192, INT32_MIN, 0, INT32_MAX, INT32_MAX
+  };
+  history_stats_struct stats;
+  uint8_t i;
+
+  setup(1);
+  for (i = 0; i < sizeof(values) / sizeof(values[0]); i++)
+  {
+    add_next(0, values[i]);
+  } /* for */
+
+  history_get_stats(0, &stats);
+  CHECK_EQ(stats.samples, sizeof(values) / sizeof(values[0]));
+  CHECK_EQ(check_channel(0), stats.samples);
+
+  // Random values over the whole range
+  setup(1);
+  g_rng = 0xC0FFEE;
+  for (i = 0; i < 200; i++)
+  {
+    add_next(0, (int32_t)rng_next());
+  } /* for */
+  check_channel(0);
+} /* test_zigzag_extremes */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    A change of -32 to 31 one period on costs one byte. Larger changes
+//    take more bytes but still round trip.
+// -----------------------------------------------------------------------------
+static void test_small_deltas(void)
+{
+  history_stats_struct before;
+  history_stats_struct after;
+  int32_t value = 1000;
+  int32_t delta;
+
+  setup(1);
+  add_next(0, value);
+  history_get_stats(0, &before);
+
+  for (delta = -32; delta <= 31; delta++)
+  {
+    value += delta;
+    add_next(0, value);
+  } /* for */
+
+  history_get_stats(0, &after);
+  CHECK_EQ(after.bytes - before.bytes, 64);
+  CHECK_EQ(after.blocks, 1);
+
+  add_next(0, value + 32);
+  add_next(0, value - 33);
+  history_get_stats(0, &before);
+  CHECK_EQ(before.bytes - after.bytes, 4);
+  check_channel(0);
+} /* test_small_deltas */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    Samples early, late, at the same time, and far enough on for the time
+//    to wrap round round trip with their own times.
+// -----------------------------------------------------------------------------
+static void test_late_samples(void)
+{
+  static const uint32_t gaps[] =
+  {
+    PERIOD, PERIOD + 1, PERIOD - 1, 0, PERIOD, 1, 127, 128, 16383, 16384,
+    0x7FFFFFFF, 0x80000000, 0xFFFFFFFF, PERIOD, 0xFFFFFFF0, PERIOD
+  };
+  history_stats_struct before;
+  history_stats_struct after;
+  uint32_t time = 0xFFFFFF00;
+  uint16_t i;
+
+  setup(1);
+  add(0, time, 5);
+  for (i = 0; i < sizeof(gaps) / sizeof(gaps[0]); i++)
+  {
+    time += gaps[i];
+    add(0, time, 5 + i);
+  } /* for */
+  check_channel(0);
+
+  // A late sample costs its time as well
+  history_get_stats(0, &before);
+  add(0, time + PERIOD + 1, 5);
+  history_get_stats(0, &after);
+  CHECK_EQ(after.bytes - before.bytes, 2);
+
+  // Random gaps and changes, across several blocks
+  setup(1);
+  g_rng = 0xBADC0DE;
+  time = 0;
+  for (i = 0; i < 2000; i++)
+  {
+    uint32_t pick = rng_next();
+
+    time += (pick & 3) ? PERIOD : (rng_next() >> (pick >> 27));
+    add(0, time, (int32_t)(rng_next() >> (pick >> 27)) - 1000);
+  } /* for */
+  check_channel(0);
+} /* test_late_samples */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    Counts the blocks handed to the callback as they fill.
+// -----------------------------------------------------------------------------
+static void count_block(uint8_t channel, const uint8_t *data, uint16_t length)
+{
+  (void)channel;
+  (void)data;
+
+  CHECK(length > 0);
+  CHECK(length <= HISTORY_BLOCK_SIZE);
+  g_callback_blocks++;
+  g_callback_bytes += length;
+} /* count_block */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    Two channels fill the pool several times over. Each keeps an unbroken
+//    run of its newest samples, the oldest block of either is reused first,
+//    and every block is handed to the callback once as it fills.
+// -----------------------------------------------------------------------------
+static void test_pool_reuse(void)
+{
+  history_stats_struct stats[HISTORY_MAX_CHANNELS];
+  uint32_t i;
+
+  setup(HISTORY_MAX_CHANNELS);
+  history_set_block_callback(count_block);
+  g_callback_blocks = 0;
+  g_callback_bytes = 0;
+  g_rng = 0x5EED;
+
+  for (i = 0; i < 3 * POOL_BYTES / 2; i++)
+  {
+    // Channel 0 changes slowly, channel 1 fast, so it fills blocks faster
+    add_next(0, (int32_t)(i / 8));
+    add_next(1, (int32_t)(rng_next() % 100000));
+  } /* for */
+
+  for (uint8_t channel = 0; channel < HISTORY_MAX_CHANNELS; channel++)
+  {
+    check_channel(channel);
+    history_get_stats(channel, &stats[channel]);
+    CHECK(stats[channel].samples > 0);
+    CHECK(stats[channel].samples < g_shadow[channel].count);
+  } /* for */
+
+  CHECK_EQ(stats[0].blocks + stats[1].blocks, HISTORY_BLOCKS);
+  CHECK(stats[1].blocks > stats[0].blocks);
+  CHECK(g_callback_blocks >= HISTORY_BLOCKS);
+  CHECK(g_callback_bytes > (g_callback_blocks - 1) *
+                           (HISTORY_BLOCK_SIZE - HISTORY_RECORD_MAX));
+
+  // Restarting a channel gives its blocks back for the other to use
+  CHECK(history_start_channel(1, PERIOD));
+  g_shadow[1].count = 0;
+  history_get_stats(1, &stats[1]);
+  CHECK_EQ(stats[1].samples, 0);
+  for (i = 0; i < POOL_BYTES; i++)
+  {
+    add_next(0, (int32_t)(rng_next() % 1000));
+  } /* for */
+  history_get_stats(0, &stats[0]);
+  CHECK_EQ(stats[0].blocks, HISTORY_BLOCKS);
+  check_channel(0);
+  check_channel(1);
+} /* test_pool_reuse */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    Samples added while a walk is under way. Those added after the walk
+//    has reached the end are still returned. If the block being read is
+//    reused, the walk carries on from the oldest sample left, never going
+//    back in time or returning a sample that is no longer held.
+// -----------------------------------------------------------------------------
+static void test_reuse_mid_iteration(void)
+{
+  const shadow_struct *shadow = &g_shadow[0];
+  history_stats_struct stats;
+  history_iter_struct iter;
+  uint32_t next;
+  uint32_t time;
+  int32_t value;
+  uint32_t i;
+
+  // Added after the end is reached
+  setup(1);
+  add_next(0, 1);
+  history_iter_begin(&iter, 0);
+  CHECK(history_iter_next(&iter, &time, &value));
+  CHECK(!history_iter_next(&iter, &time, &value));
+  for (i = 0; i < 2 * HISTORY_BLOCK_SIZE; i++)
+  {
+    add_next(0, (int32_t)i);
+  } /* for */
+  for (i = 1; history_iter_next(&iter, &time, &value); i++)
+  {
+    CHECK_EQ(time, shadow->time[i]);
+    CHECK_EQ(value, shadow->value[i]);
+  } /* for */
+  CHECK_EQ(i, shadow->count);
+
+  // Reused under the walk, at each point of the first blocks
+  for (uint32_t stop = 0; stop < 3 * HISTORY_BLOCK_SIZE; stop += 7)
+  {
+    setup(1);
+    g_rng = 0xABCD + stop;
+    while (shadow->count < POOL_BYTES / 2)
+    {
+      add_next(0, (int32_t)(rng_next() % 2000) - 1000);
+    } /* while */
+
+    history_get_stats(0, &stats);
+    next = shadow->count - stats.samples;
+    history_iter_begin(&iter, 0);
+    for (i = 0; i < stop; i++)
+    {
+      CHECK(history_iter_next(&iter, &time, &value));
+      CHECK_EQ(time, shadow->time[next]);
+      next++;
+    } /* for */
+
+    // Enough to push out the block being read
+    for (i = 0; i < 4 * HISTORY_BLOCK_SIZE; i++)
+    {
+      add_next(0, (int32_t)(rng_next() % 2000) - 1000);
+    } /* for */
+
+    history_get_stats(0, &stats);
+    if (next < shadow->count - stats.samples)
+    {
+      next = shadow->count - stats.samples;
+    } /* if */
+
+    while (history_iter_next(&iter, &time, &value))
+    {
+      if (next >= shadow->count)
+      {
+        CHECK(false);
+        break;
+      } /* if */
+      CHECK_EQ(time, shadow->time[next]);
+      CHECK_EQ(value, shadow->value[next]);
+      next++;
+    } /* while */
+    CHECK_EQ(next, shadow->count);
+  } /* for */
+} /* test_reuse_mid_iteration */
+
+
+int main(void)
+{
+  test_zigzag_extremes();
+  test_small_deltas();
+  test_late_samples();
+  test_pool_reuse();
+  test_reuse_mid_iteration();
+
+  return test_report("test_history");
+} /* main */
@@ -0,0 +1,434 @@
+// *****************************************************************************
+// ***************************    C Source Code     ****************************
+// *****************************************************************************
+//   DESIGNER NAME:  Rafael Ortiz
+//
+//         VERSION:  1.0
+//
+//       FILE NAME:  test_spi_dma.c
+//
+//-----------------------------------------------------------------------------
+// DESCRIPTION
+//    This file tests the SPI1 async transmits on the register stubs. The
+//    DMA is played by the test: while the channel is enabled it takes the
+//    chunk armed in DMASA, DMASZ and DMACTL, disables the channel as the
+//    hardware does at the end of a block, and calls spi1_dma_handler() as
+//    the DMA ISR would. The SPI1 IDLE interrupt is played the same way for
+//    the repeat transmit.
+//
+//-----------------------------------------------------------------------------
+// DISCLAIMER
+//    This code was developed for educational purposes as part of the CSC202
+//    course and is provided "as is" without warranties of any kind, whether
+//    express, implied, or statutory.
+//
+//    The author and organization do not warrant the accuracy, completeness, or
+//    reliability of the code. The author and organization shall not be liable
+//    for any direct, indirect, incidental, special, exemplary, or consequential
+//    damages arising out of the use of or inability to use the code, even if
+//    advised of the possibility of such damages.
+//
+//    Use of this code is at your own risk, and it is recommended to validate
+//    and adapt the code for your specific application and hardware requirements.
+//
+// Copyright (c) 2024 by TBD
+//    You may use, edit, run or distribute this file as long as the above
+//    copyright notice remains
+// *****************************************************************************
+//******************************************************************************
+
+
+//-----------------------------------------------------------------------------
+// Load standard C include files
+//-----------------------------------------------------------------------------
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+
+//-----------------------------------------------------------------------------
+// Loads MSP launchpad board support macros and definitions
+//-----------------------------------------------------------------------------
+#include <ti/devices/msp/msp.h>
+#include "spi.h"
+#include "host.h"
+#include "test.h"
+
+
+//-----------------------------------------------------------------------------
+// Define symbolic constants used by the program
+//-----------------------------------------------------------------------------
+#define MAX_CHUNKS                                                          (16)
+
+// A value the driver never writes to TXDATA
+#define TXDATA_UNTOUCHED                                            (0xDEADBEEF)
+
+#define WIDTH_MASK      (DMA_DMACTL_DMASRCWDTH_MASK | DMA_DMACTL_DMADSTWDTH_MASK)
+#define WIDTH_BYTE      (DMA_DMACTL_DMASRCWDTH_BYTE | DMA_DMACTL_DMADSTWDTH_BYTE)
+#define WIDTH_HALF      (DMA_DMACTL_DMASRCWDTH_HALF | DMA_DMACTL_DMADSTWDTH_HALF)
+
+
+//-----------------------------------------------------------------------------
+// Define the types used by the test
+//-----------------------------------------------------------------------------
+// What the DMA was asked to move, one entry per block
+typedef struct
+{
+  uint32_t source[MAX_CHUNKS];
+  uint32_t size[MAX_CHUNKS];
+  uint32_t width[MAX_CHUNKS];
+  uint32_t count;
+  uint32_t total;
+} dma_log_struct;
+
+
+//-----------------------------------------------------------------------------
+// Define global variables and structures here.
+// NOTE: when possible avoid using global variables
+//-----------------------------------------------------------------------------
+static uint32_t g_callbacks;
+static bool g_busy_in_callback;
+
+// Started from a callback by test_chained_from_callback
+static const uint8_t g_chained[3] = {1, 2, 3};
+static bool g_chain_started;
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    Resets the registers so the TX FIFO reads empty and SPI1 idle, then
+//    sets up the DMA channel.
+// -----------------------------------------------------------------------------
+static void setup(void)
+{
+  host_regs_reset();
+  host_clock_reset();
+  SPI1->STAT = SPI_STAT_TFE_EMPTY | SPI_STAT_TNF_MASK | SPI_STAT_BUSY_IDLE;
+  spi1_dma_init();
+  g_callbacks = 0;
+} /* setup */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    Counts completions, noting whether the transfer still read as busy.
+// -----------------------------------------------------------------------------
+static void on_done(void)
+{
+  g_callbacks++;
+  g_busy_in_callback = spi1_async_busy();
+} /* on_done */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    Plays the DMA channel until it is left disabled, logging every block.
+// -----------------------------------------------------------------------------
+static void run_dma(dma_log_struct *log)
+{
+  volatile uint32_t *ctl = &DMA->DMACHAN[SPI1_DMA_TX_CHAN].DMACTL;
+
+  log->count = 0;
+  log->total = 0;
+  while ((*ctl & DMA_DMACTL_DMAEN_MASK) != 0)
+  {
+    if (log->count < MAX_CHUNKS)
+    {
+      log->source[log->count] = DMA->DMACHAN[SPI1_DMA_TX_CHAN].DMASA;
+      log->size[log->count] = DMA->DMACHAN[SPI1_DMA_TX_CHAN].DMASZ;
+      log->width[log->count] = *ctl & WIDTH_MASK;
+    } /* if */
+    log->count++;
+    log->total += DMA->DMACHAN[SPI1_DMA_TX_CHAN].DMASZ;
+
+    *ctl &= ~DMA_DMACTL_DMAEN_MASK;
+    spi1_dma_handler();
+  } /* while */
+} /* run_dma */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    One pass through a buffer is one block of the whole length, in bytes,
+//    from the buffer to TXDATA, and the callback runs once it is done.
+// -----------------------------------------------------------------------------
+static void test_single_block(void)
+{
+  static const uint8_t bytes[100] = {0};
+  dma_log_struct log;
+
+  setup();
+  CHECK(spi1_write_buffer_async(bytes, sizeof(bytes), on_done));
+  CHECK(spi1_async_busy());
+  CHECK_EQ(DMA->DMACHAN[SPI1_DMA_TX_CHAN].DMADA, (uint32_t)(uintptr_t)&SPI1->TXDATA);
+  CHECK((DMA->DMACHAN[SPI1_DMA_TX_CHAN].DMACTL &
+         DMA_DMACTL_DMASRCINCR_INCREMENT) == DMA_DMACTL_DMASRCINCR_INCREMENT);
+
+  run_dma(&log);
+  CHECK_EQ(log.count, 1);
+  CHECK_EQ(log.source[0], (uint32_t)(uintptr_t)bytes);
+  CHECK_EQ(log.size[0], sizeof(bytes));
+  CHECK_EQ(log.width[0], WIDTH_BYTE);
+  CHECK_EQ(g_callbacks, 1);
+  CHECK(!g_busy_in_callback);
+  CHECK(!spi1_async_busy());
+
+  // A stray DMA interrupt after the end does not call back again
+  spi1_dma_handler();
+  CHECK_EQ(g_callbacks, 1);
+} /* test_single_block */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    A repeat write passes through the same buffer block after block, the
+//    last one cut short, and calls back once after the last.
+// -----------------------------------------------------------------------------
+static void test_repeat_chunks(void)
+{
+  static const uint8_t pattern[7] = {0};
+  dma_log_struct log;
+
+  setup();
+  CHECK(spi1_write_buffer_repeat_async(pattern, sizeof(pattern), 50, on_done));
+  run_dma(&log);
+  CHECK_EQ(log.count, 8);
+  CHECK_EQ(log.total, 50);
+  for (uint32_t i = 0; i < log.count; i++)
+  {
+    CHECK_EQ(log.source[i], (uint32_t)(uintptr_t)pattern);
+    CHECK_EQ(log.size[i], (i + 1 < log.count) ? sizeof(pattern) : 1);
+    CHECK_EQ(log.width[i], WIDTH_BYTE);
+  } /* for */
+  CHECK_EQ(g_callbacks, 1);
+
+  // An exact multiple has no short block
+  setup();
+  CHECK(spi1_write_buffer_repeat_async(pattern, 5, 20, on_done));
+  run_dma(&log);
+  CHECK_EQ(log.count, 4);
+  CHECK_EQ(log.size[3], 5);
+  CHECK_EQ(log.total, 20);
+  CHECK_EQ(g_callbacks, 1);
+
+  // Fewer bytes than the buffer holds is one short block
+  setup();
+  CHECK(spi1_write_buffer_repeat_async(pattern, sizeof(pattern), 3, NULL));
+  run_dma(&log);
+  CHECK_EQ(log.count, 1);
+  CHECK_EQ(log.size[0], 3);
+  CHECK(!spi1_async_busy());
+} /* test_repeat_chunks */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    A fill larger than a DMA block can hold, as a full screen of one color
+//    is, goes out in blocks of the largest size.
+// -----------------------------------------------------------------------------
+static void test_large_fill(void)
+{
+  static uint8_t pattern[SPI1_DMA_MAX_XFER_SIZE];
+  dma_log_struct log;
+
+  setup();
+  CHECK(spi1_write_buffer_repeat_async(pattern, SPI1_DMA_MAX_XFER_SIZE,
+                                       320UL * 240 * 2, on_done));
+  run_dma(&log);
+  CHECK_EQ(log.total, 320UL * 240 * 2);
+  CHECK_EQ(log.count, 3);
+  CHECK_EQ(log.size[0], SPI1_DMA_MAX_XFER_SIZE);
+  CHECK_EQ(log.size[1], SPI1_DMA_MAX_XFER_SIZE);
+  CHECK_EQ(log.size[2], 320UL * 240 * 2 - 2 * SPI1_DMA_MAX_XFER_SIZE);
+  CHECK_EQ(g_callbacks, 1);
+} /* test_large_fill */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    A 16-bit write moves halfwords, counted in frames, and the next 8-bit
+//    write goes back to bytes without disturbing the rest of DMACTL.
+// -----------------------------------------------------------------------------
+static void test_widths(void)
+{
+  static const uint16_t frames[12] = {0};
+  static const uint8_t bytes[4] = {0};
+  dma_log_struct log;
+  uint32_t other_bits;
+
+  setup();
+  other_bits = DMA->DMACHAN[SPI1_DMA_TX_CHAN].DMACTL & ~WIDTH_MASK;
+
+  CHECK(spi1_write_buffer16_async(frames, 12, on_done));
+  run_dma(&log);
+  CHECK_EQ(log.count, 1);
+  CHECK_EQ(log.size[0], 12);
+  CHECK_EQ(log.width[0], WIDTH_HALF);
+  CHECK_EQ(log.source[0], (uint32_t)(uintptr_t)frames);
+
+  CHECK(spi1_write_buffer_async(bytes, sizeof(bytes), on_done));
+  run_dma(&log);
+  CHECK_EQ(log.width[0], WIDTH_BYTE);
+  CHECK_EQ(DMA->DMACHAN[SPI1_DMA_TX_CHAN].DMACTL & ~WIDTH_MASK, other_bits);
+  CHECK_EQ(g_callbacks, 2);
+} /* test_widths */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    While one async write runs every other is refused and leaves the
+//    channel alone, as are zero-length writes.
+// -----------------------------------------------------------------------------
+static void test_busy_refusal(void)
+{
+  static const uint8_t bytes[8] = {0};
+  static const uint8_t other[8] = {0};
+  static const uint16_t frames[8] = {0};
+  dma_log_struct log;
+
+  setup();
+  CHECK(!spi1_write_buffer_async(bytes, 0, on_done));
+  CHECK(!spi1_write_buffer_repeat_async(bytes, sizeof(bytes), 0, on_done));
+  CHECK(!spi1_write_repeat16_async(0x1234, 0, on_done));
+  CHECK(!spi1_async_busy());
+
+  CHECK(spi1_write_buffer_async(bytes, sizeof(bytes), on_done));
+  CHECK(!spi1_write_buffer_async(other, 3, on_done));
+  CHECK(!spi1_write_buffer_repeat_async(other, 3, 30, on_done));
+  CHECK(!spi1_write_buffer16_async(frames, 8, on_done));
+  CHECK(!spi1_write_repeat16_async(0x1234, 10, on_done));
+  CHECK_EQ(DMA->DMACHAN[SPI1_DMA_TX_CHAN].DMASA, (uint32_t)(uintptr_t)bytes);
+  CHECK_EQ(DMA->DMACHAN[SPI1_DMA_TX_CHAN].DMASZ, sizeof(bytes));
+
+  run_dma(&log);
+  CHECK_EQ(log.count, 1);
+  CHECK_EQ(g_callbacks, 1);
+
+  // A repeat transmit blocks the DMA writes too
+  CHECK(spi1_write_repeat16_async(0x1234, 10, on_done));
+  CHECK(!spi1_write_buffer_async(bytes, sizeof(bytes), on_done));
+  SPI1->CPU_INT.IIDX = SPI_CPU_INT_IIDX_STAT_IDLE_EVT;
+  spi1_irq_handler();
+  CHECK(!spi1_async_busy());
+  CHECK(spi1_write_buffer_async(bytes, sizeof(bytes), on_done));
+} /* test_busy_refusal */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    Starts another write from a completion callback, as a driver queuing
+//    its next command would.
+// -----------------------------------------------------------------------------
+static void start_next(void)
+{
+  g_callbacks++;
+  g_chain_started = spi1_write_buffer_async(g_chained, sizeof(g_chained),
+                                            on_done);
+} /* start_next */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    The transfer is over by the time its callback runs, so the callback
+//    can start the next one, which the same DMA run then carries out.
+// -----------------------------------------------------------------------------
+static void test_chained_from_callback(void)
+{
+  static const uint8_t bytes[5] = {0};
+  dma_log_struct log;
+
+  setup();
+  g_chain_started = false;
+  CHECK(spi1_write_buffer_async(bytes, sizeof(bytes), start_next));
+  run_dma(&log);
+  CHECK(g_chain_started);
+  CHECK_EQ(log.count, 2);
+  CHECK_EQ(log.source[1], (uint32_t)(uintptr_t)g_chained);
+  CHECK_EQ(log.size[1], sizeof(g_chained));
+  CHECK_EQ(g_callbacks, 2);
+  CHECK(!spi1_async_busy());
+} /* test_chained_from_callback */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    Runs a repeat transmit of count frames, checking each run the driver
+//    loads. Every run but the last is SPI1_REPEATTX_MAX + 1 frames; the
+//    IDLE interrupt is unmasked throughout and masked again at the end,
+//    with the repeat feature off and one callback.
+// -----------------------------------------------------------------------------
+static void check_repeat16(uint32_t count)
+{
+  uint32_t runs = 0;
+  uint32_t sent = 0;
+  uint32_t repeat;
+
+  setup();
+  SPI1->CTL1 = 0x00000015;
+  SPI1->TXDATA = TXDATA_UNTOUCHED;
+  CHECK(spi1_write_repeat16_async(0xF81F, count, on_done));
+
+  while (SPI1->TXDATA != TXDATA_UNTOUCHED)
+  {
+    CHECK_EQ(SPI1->TXDATA, 0xF81F);
+    CHECK((SPI1->CPU_INT.IMASK & SPI_CPU_INT_IMASK_IDLE_MASK) != 0);
+    repeat = (SPI1->CTL1 & SPI_CTL1_REPEATTX_MASK) >> SPI_CTL1_REPEATTX_OFS;
+    sent += repeat + 1;
+    runs++;
+    CHECK(repeat == SPI1_REPEATTX_MAX || sent == count);
+    CHECK_EQ(SPI1->CTL1 & ~SPI_CTL1_REPEATTX_MASK, 0x00000015);
+    CHECK(spi1_async_busy());
+    CHECK_EQ(g_callbacks, 0);
+
+    SPI1->TXDATA = TXDATA_UNTOUCHED;
+    SPI1->CPU_INT.IIDX = SPI_CPU_INT_IIDX_STAT_IDLE_EVT;
+    spi1_irq_handler();
+  } /* while */
+
+  CHECK_EQ(sent, count);
+  CHECK_EQ(runs, (count + SPI1_REPEATTX_MAX) / (SPI1_REPEATTX_MAX + 1));
+  CHECK_EQ(SPI1->CTL1, 0x00000015 | SPI_CTL1_REPEATTX_DISABLE);
+  CHECK_EQ(SPI1->CPU_INT.IMASK & SPI_CPU_INT_IMASK_IDLE_MASK, 0);
+  CHECK(!spi1_async_busy());
+  CHECK_EQ(g_callbacks, 1);
+  CHECK(!g_busy_in_callback);
+
+  // An IDLE event with nothing running is ignored
+  SPI1->CPU_INT.IIDX = SPI_CPU_INT_IIDX_STAT_IDLE_EVT;
+  spi1_irq_handler();
+  CHECK_EQ(g_callbacks, 1);
+  CHECK_EQ(SPI1->TXDATA, TXDATA_UNTOUCHED);
+} /* check_repeat16 */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    Repeat transmits around the run length, and a full screen.
+// -----------------------------------------------------------------------------
+static void test_repeat16(void)
+{
+  static const uint32_t counts[] =
+  {
+    1, 2, SPI1_REPEATTX_MAX, SPI1_REPEATTX_MAX + 1, SPI1_REPEATTX_MAX + 2,
+    1000, 2 * (SPI1_REPEATTX_MAX + 1), 320UL * 240
+  };
+
+  for (uint8_t i = 0; i < sizeof(counts) / sizeof(counts[0]); i++)
+  {
+    check_repeat16(counts[i]);
+  } /* for */
+} /* test_repeat16 */
+
+
+int main(void)
+{
+  test_single_block();
+  test_repeat_chunks();
+  test_large_fill();
+  test_widths();
+  test_busy_refusal();
+  test_chained_from_callback();
+  test_repeat16();
+
+  return test_report("test_spi_dma");
+} /* main */
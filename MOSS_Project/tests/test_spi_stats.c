@@ -0,0 +1,161 @@
+// *****************************************************************************
+// ***************************    C Source Code     ****************************
+// *****************************************************************************
+//   DESIGNER NAME:  Rafael Ortiz
+//
+//         VERSION:  1.0
+//
+//       FILE NAME:  test_spi_stats.c
+//
+//-----------------------------------------------------------------------------
+// DESCRIPTION
+//    This file tests the SPI1 traffic counters the "stats" shell command
+//    reports: every way of sending counts its bytes once, DMA transfers are
+//    counted when they start, and clearing resets both totals.
+//
+//-----------------------------------------------------------------------------
+// DISCLAIMER
+//    This code was developed for educational purposes as part of the CSC202
+//    course and is provided "as is" without warranties of any kind, whether
+//    express, implied, or statutory.
+//
+//    The author and organization do not warrant the accuracy, completeness, or
+//    reliability of the code. The author and organization shall not be liable
+//    for any direct, indirect, incidental, special, exemplary, or consequential
+//    damages arising out of the use of or inability to use the code, even if
+//    advised of the possibility of such damages.
+//
+//    Use of this code is at your own risk, and it is recommended to validate
+//    and adapt the code for your specific application and hardware requirements.
+//
+// Copyright (c) 2024 by TBD
+//    You may use, edit, run or distribute this file as long as the above
+//    copyright notice remains
+// *****************************************************************************
+//******************************************************************************
+
+
+//-----------------------------------------------------------------------------
+// Load standard C include files
+//-----------------------------------------------------------------------------
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+
+//-----------------------------------------------------------------------------
+// Loads MSP launchpad board support macros and definitions
+//-----------------------------------------------------------------------------
+#include <ti/devices/msp/msp.h>
+#include "spi.h"
+#include "host.h"
+#include "test.h"
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    Resets the registers so the TX FIFO reads empty and SPI1 idle, which is
+//    what the blocking writes and spi1_wait_async poll for.
+// -----------------------------------------------------------------------------
+static void setup(void)
+{
+  host_regs_reset();
+  host_clock_reset();
+  SPI1->STAT = SPI_STAT_TFE_EMPTY | SPI_STAT_TNF_MASK | SPI_STAT_BUSY_IDLE;
+  spi1_dma_init();
+  spi1_clear_stats();
+} /* setup */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    The blocking writes count one byte per 8-bit frame and two per 16-bit
+//    frame.
+// -----------------------------------------------------------------------------
+static void test_blocking_writes(void)
+{
+  spi1_stats_struct stats;
+
+  setup();
+  spi1_write_data(0xA5);
+  spi1_write_data(0x5A);
+  spi1_write_data16(0x1234);
+
+  spi1_get_stats(&stats);
+  CHECK_EQ(stats.tx_bytes, 4);
+  CHECK_EQ(stats.dma_xfers, 0);
+  CHECK_EQ(SPI1->TXDATA, 0x1234);
+} /* test_blocking_writes */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    An async write counts its whole length and one DMA transfer as soon as
+//    it starts, however many chunks it takes, and a write refused because
+//    the channel is busy counts nothing.
+// -----------------------------------------------------------------------------
+static void test_async_writes(void)
+{
+  static const uint8_t bytes[10] = {0};
+  static const uint16_t frames[4] = {0};
+  spi1_stats_struct stats;
+
+  setup();
+  CHECK(spi1_write_buffer_async(bytes, sizeof(bytes), NULL));
+  CHECK(!spi1_write_buffer_async(bytes, sizeof(bytes), NULL));
+  spi1_get_stats(&stats);
+  CHECK_EQ(stats.tx_bytes, 10);
+  CHECK_EQ(stats.dma_xfers, 1);
+
+  spi1_dma_handler();
+  CHECK(spi1_write_buffer_repeat_async(bytes, sizeof(bytes), 1000, NULL));
+  while (spi1_async_busy())
+  {
+    spi1_dma_handler();
+  } /* while */
+
+  CHECK(spi1_write_buffer16_async(frames, 4, NULL));
+  spi1_dma_handler();
+
+  spi1_get_stats(&stats);
+  CHECK_EQ(stats.tx_bytes, 10 + 1000 + 8);
+  CHECK_EQ(stats.dma_xfers, 3);
+} /* test_async_writes */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    A repeat transmit counts two bytes per frame, and clearing the stats
+//    resets both totals.
+// -----------------------------------------------------------------------------
+static void test_repeat_and_clear(void)
+{
+  spi1_stats_struct stats;
+
+  setup();
+  CHECK(spi1_write_repeat16_async(0xF800, 1000, NULL));
+  while (spi1_async_busy())
+  {
+    SPI1->CPU_INT.IIDX = SPI_CPU_INT_IIDX_STAT_IDLE_EVT;
+    spi1_irq_handler();
+  } /* while */
+
+  spi1_get_stats(&stats);
+  CHECK_EQ(stats.tx_bytes, 2000);
+  CHECK_EQ(stats.dma_xfers, 0);
+
+  spi1_clear_stats();
+  spi1_get_stats(&stats);
+  CHECK_EQ(stats.tx_bytes, 0);
+  CHECK_EQ(stats.dma_xfers, 0);
+} /* test_repeat_and_clear */
+
+
+int main(void)
+{
+  test_blocking_writes();
+  test_async_writes();
+  test_repeat_and_clear();
+
+  return test_report("test_spi_stats");
+} /* main */
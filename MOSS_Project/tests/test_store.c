@@ -0,0 +1,736 @@
+// *****************************************************************************
+// ***************************    C Source Code     ****************************
+// *****************************************************************************
+//   DESIGNER NAME:  Rafael Ortiz
+//
+//         VERSION:  1.0
+//
+//       FILE NAME:  test_store.c
+//
+//-----------------------------------------------------------------------------
+// DESCRIPTION
+//    This file tests the flash store on the file-backed flash model. It
+//    covers a record header and a record payload torn by a reset, settings
+//    carried forward when the oldest sector is reclaimed, and the write
+//    amplification store_get_stats reports, checked against what the model
+//    saw. A last test cuts the power at every flash operation of a mixed
+//    workload in turn and checks that the store comes back with each
+//    setting either before or after the interrupted write and with an
+//    unbroken run of blocks.
+//
+//-----------------------------------------------------------------------------
+// DISCLAIMER
+//    This code was developed for educational purposes as part of the CSC202
+//    course and is provided "as is" without warranties of any kind, whether
+//    express, implied, or statutory.
+//
+//    The author and organization do not warrant the accuracy, completeness, or
+//    reliability of the code. The author and organization shall not be liable
+//    for any direct, indirect, incidental, special, exemplary, or consequential
+//    damages arising out of the use of or inability to use the code, even if
+//    advised of the possibility of such damages.
+//
+//    Use of this code is at your own risk, and it is recommended to validate
+//    and adapt the code for your specific application and hardware requirements.
+//
+// Copyright (c) 2024 by TBD
+//    You may use, edit, run or distribute this file as long as the above
+//    copyright notice remains
+// *****************************************************************************
+//******************************************************************************
+
+
+//-----------------------------------------------------------------------------
+// Load standard C include files
+//-----------------------------------------------------------------------------
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <setjmp.h>
+
+
+//-----------------------------------------------------------------------------
+// Loads MSP launchpad board support macros and definitions
+//-----------------------------------------------------------------------------
+#include "store.h"
+#include "flash_file.h"
+#include "test.h"
+
+
+//-----------------------------------------------------------------------------
+// Define symbolic constants used by the program
+//-----------------------------------------------------------------------------
+#define IMAGE_PATH                                     ("build/test_store.flash")
+#define IMAGE_SECTORS                                                        (3)
+
+#define CHANNEL                                                              (2)
+
+// Power cut workload
+#define CUT_OPS                                                            (150)
+#define CUT_KEYS                                                             (6)
+#define CUT_BLOCK_MAX                                                      (300)
+#define MAX_BLOCKS                                                        (2048)
+
+
+//-----------------------------------------------------------------------------
+// Define the types used by the test
+//-----------------------------------------------------------------------------
+// What the test expects of one setting
+typedef struct
+{
+  uint8_t value[STORE_VALUE_MAX];
+  uint8_t length;
+  bool    present;
+} setting_struct;
+
+// One step of the power cut workload
+typedef struct
+{
+  uint8_t  kind;
+  uint8_t  key;
+  uint16_t length;
+  uint8_t  fill;
+} op_struct;
+
+#define OP_SET                                                               (0)
+#define OP_DELETE                                                            (1)
+#define OP_BLOCK                                                             (2)
+
+
+//-----------------------------------------------------------------------------
+// Define global variables and structures here.
+// NOTE: when possible avoid using global variables
+//-----------------------------------------------------------------------------
+static const flash_dev_struct *g_dev;
+static jmp_buf g_cut_exit;
+
+static setting_struct g_settings[STORE_MAX_KEYS];
+static uint32_t g_blocks_done;
+
+static op_struct g_ops[CUT_OPS];
+static uint32_t g_rng;
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    Runs when the model cuts the power: back to the test, as after a reset.
+// -----------------------------------------------------------------------------
+static void on_power_cut(void)
+{
+  longjmp(g_cut_exit, 1);
+} /* on_power_cut */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    Starts from an erased image and an empty store.
+// -----------------------------------------------------------------------------
+static void fresh_store(void)
+{
+  g_dev = flash_file_open(IMAGE_PATH, IMAGE_SECTORS, true);
+  CHECK(g_dev != NULL);
+  CHECK(store_init(g_dev));
+
+  memset(g_settings, 0, sizeof(g_settings));
+  g_blocks_done = 0;
+} /* fresh_store */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    Restarts the store as after a reset, reopening the image file so only
+//    what reached it survives.
+// -----------------------------------------------------------------------------
+static void reboot(void)
+{
+  flash_file_cut_after(FLASH_FILE_NO_CUT, NULL);
+  g_dev = flash_file_open(IMAGE_PATH, IMAGE_SECTORS, false);
+  CHECK(g_dev != NULL);
+  CHECK(store_init(g_dev));
+} /* reboot */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    Fills a block with a pattern that starts with its number, so any block
+//    read back can be checked and placed in order.
+// -----------------------------------------------------------------------------
+static void make_block(uint32_t number, uint16_t length, uint8_t *data)
+{
+  for (uint16_t i = 0; i < length; i++)
+  {
+    data[i] = (uint8_t)(number * 31 + i * 7);
+  } /* for */
+  memcpy(data, &number, (length < sizeof(number)) ? length : sizeof(number));
+} /* make_block */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    Sets a setting and the test's copy of it.
+// -----------------------------------------------------------------------------
+static bool set_value(uint8_t key, const void *value, uint8_t length)
+{
+  bool ok = store_set(key, value, length);
+
+  if (ok)
+  {
+    memcpy(g_settings[key].value, value, length);
+    g_settings[key].length = length;
+    g_settings[key].present = true;
+  } /* if */
+
+  return ok;
+} /* set_value */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    Checks one setting against the test's copy.
+// -----------------------------------------------------------------------------
+static bool setting_matches(uint8_t key, const setting_struct *expected)
+{
+  uint8_t value[STORE_VALUE_MAX];
+  uint8_t length;
+  bool present = store_get(key, value, &length);
+
+  if (present != expected->present)
+  {
+    return false;
+  } /* if */
+
+  return !present || (length == expected->length &&
+                      memcmp(value, expected->value, length) == 0);
+} /* setting_matches */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    Checks every setting against the test's copies.
+// -----------------------------------------------------------------------------
+static void check_settings(void)
+{
+  for (uint8_t key = 0; key < STORE_MAX_KEYS; key++)
+  {
+    CHECK(setting_matches(key, &g_settings[key]));
+  } /* for */
+} /* check_settings */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    Reads back the blocks of the test channel. They must be intact, and
+//    numbered without a gap up to last, or up to last + 1 if extra_ok.
+//    Returns the number of blocks read.
+// -----------------------------------------------------------------------------
+static uint32_t check_blocks(uint32_t last, bool extra_ok)
+{
+  static uint8_t data[STORE_BLOCK_MAX];
+  static uint8_t expected[STORE_BLOCK_MAX];
+  store_iter_struct iter;
+  uint32_t number = 0;
+  uint32_t previous = 0;
+  uint32_t count = 0;
+  uint16_t length;
+
+  store_iter_begin(&iter, CHANNEL);
+  while (store_iter_next(&iter, data, &length))
+  {
+    CHECK(length >= sizeof(number));
+    memcpy(&number, data, sizeof(number));
+    make_block(number, length, expected);
+    CHECK(memcmp(data, expected, length) == 0);
+    CHECK(count == 0 || number == previous + 1);
+    previous = number;
+    count++;
+  } /* while */
+
+  if (count > 0)
+  {
+    CHECK(number == last || (extra_ok && number == last + 1));
+  } /* if */
+
+  return count;
+} /* check_blocks */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    Appends the next numbered block.
+// -----------------------------------------------------------------------------
+static bool append_block(uint16_t length)
+{
+  static uint8_t data[STORE_BLOCK_MAX];
+
+  make_block(g_blocks_done + 1, length, data);
+  if (!store_append_block(CHANNEL, data, length))
+  {
+    return false;
+  } /* if */
+
+  g_blocks_done++;
+  return true;
+} /* append_block */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    Settings and blocks survive a reset and a reopened image, and a
+//    deleted setting stays deleted.
+// -----------------------------------------------------------------------------
+static void test_persistence(void)
+{
+  fresh_store();
+
+  CHECK(set_value(0, "alpha", 5));
+  CHECK(set_value(1, "a longer value!", 16));
+  CHECK(set_value(3, "x", 1));
+  CHECK(store_delete(3));
+  g_settings[3].present = false;
+  CHECK(append_block(40));
+  CHECK(append_block(9));
+
+  reboot();
+  check_settings();
+  CHECK_EQ(check_blocks(2, false), 2);
+} /* test_persistence */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    A reset while a record header is being programmed leaves a header that
+//    fails its CRC. The setting keeps its old value, everything before the
+//    tear survives, and new records go to a fresh sector.
+// -----------------------------------------------------------------------------
+static void test_torn_header(void)
+{
+  store_stats_struct stats;
+  flash_file_stats_struct flash_stats;
+
+  fresh_store();
+  CHECK(set_value(0, "one", 3));
+  CHECK(set_value(1, "keep", 4));
+  CHECK(append_block(100));
+
+  flash_file_cut_after(0, on_power_cut);
+  if (setjmp(g_cut_exit) == 0)
+  {
+    store_set(0, "two", 3);
+    CHECK(false);
+  } /* if */
+
+  reboot();
+  check_settings();
+  CHECK_EQ(check_blocks(1, false), 1);
+  store_get_stats(&stats);
+  CHECK_EQ(stats.sectors_used, 1);
+
+  CHECK(set_value(0, "three", 5));
+  CHECK(append_block(100));
+  store_get_stats(&stats);
+  CHECK_EQ(stats.sectors_used, 2);
+
+  reboot();
+  check_settings();
+  CHECK_EQ(check_blocks(2, false), 2);
+
+  flash_file_get_stats(&flash_stats);
+  CHECK_EQ(flash_stats.overwrites, 0);
+} /* test_torn_header */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    A reset part way through a payload leaves a good header over a payload
+//    that fails its CRC. The record is skipped: a setting keeps its old
+//    value and a block is left out. Later records follow it in the same
+//    sector.
+// -----------------------------------------------------------------------------
+static void test_torn_payload(void)
+{
+  store_stats_struct stats;
+  flash_file_stats_struct flash_stats;
+
+  fresh_store();
+  CHECK(set_value(0, "one", 3));
+  CHECK(append_block(64));
+
+  // Header and three of the eight payload words, then the reset
+  flash_file_cut_after(4, on_power_cut);
+  if (setjmp(g_cut_exit) == 0)
+  {
+    append_block(64);
+    CHECK(false);
+  } /* if */
+
+  reboot();
+  check_settings();
+  CHECK_EQ(check_blocks(1, false), 1);
+
+  // Header and the first of two payload words
+  flash_file_cut_after(2, on_power_cut);
+  if (setjmp(g_cut_exit) == 0)
+  {
+    store_set(0, "sixteen bytes!!!", 16);
+    CHECK(false);
+  } /* if */
+
+  reboot();
+  check_settings();
+
+  CHECK(set_value(0, "three", 5));
+  CHECK(append_block(64));
+  store_get_stats(&stats);
+  CHECK_EQ(stats.sectors_used, 1);
+
+  reboot();
+  check_settings();
+  CHECK_EQ(check_blocks(2, false), 2);
+
+  flash_file_get_stats(&flash_stats);
+  CHECK_EQ(flash_stats.overwrites, 0);
+} /* test_torn_payload */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    Settings written once survive many reclaims of the oldest sector, as
+//    do deletions, while old blocks are dropped oldest first.
+// -----------------------------------------------------------------------------
+static void test_carry_forward(void)
+{
+  store_stats_struct stats;
+  flash_file_stats_struct flash_stats;
+  uint32_t kept;
+
+  fresh_store();
+  CHECK(set_value(0, "carried", 7));
+  CHECK(set_value(5, "sixteen byte val", 16));
+  CHECK(set_value(7, "gone", 4));
+  CHECK(store_delete(7));
+  g_settings[7].present = false;
+
+  // Enough blocks to go round the three sectors several times
+  for (uint16_t i = 0; i < 40; i++)
+  {
+    CHECK(append_block(STORE_BLOCK_MAX - (i % 5)));
+  } /* for */
+
+  store_get_stats(&stats);
+  CHECK(stats.erases >= 3 * IMAGE_SECTORS);
+  check_settings();
+  kept = check_blocks(g_blocks_done, false);
+  CHECK(kept > 0);
+  CHECK(kept < g_blocks_done);
+
+  reboot();
+  check_settings();
+  CHECK_EQ(check_blocks(g_blocks_done, false), kept);
+
+  flash_file_get_stats(&flash_stats);
+  CHECK_EQ(flash_stats.overwrites, 0);
+} /* test_carry_forward */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    Runs a workload and checks the bytes and erases store_get_stats reports
+//    against those the flash model saw, and the per-sector wear. Prints the
+//    write amplification.
+// -----------------------------------------------------------------------------
+static void check_amplification(const char *name, double max_amplification)
+{
+  store_stats_struct stats;
+  flash_file_stats_struct flash_stats;
+  uint32_t erase_min = UINT32_MAX;
+  uint32_t erase_max = 0;
+  double amplification;
+
+  store_get_stats(&stats);
+  flash_file_get_stats(&flash_stats);
+
+  CHECK_EQ(stats.flash_bytes, flash_stats.program_bytes);
+  CHECK_EQ(stats.erases, flash_stats.erases);
+  CHECK_EQ(flash_stats.overwrites, 0);
+  CHECK_EQ(flash_stats.bad_calls, 0);
+
+  for (uint8_t i = 0; i < IMAGE_SECTORS; i++)
+  {
+    if (flash_stats.sector_erases[i] < erase_min)
+    {
+      erase_min = flash_stats.sector_erases[i];
+    } /* if */
+    if (flash_stats.sector_erases[i] > erase_max)
+    {
+      erase_max = flash_stats.sector_erases[i];
+    } /* if */
+  } /* for */
+  CHECK_EQ(stats.erase_min, erase_min);
+  CHECK_EQ(stats.erase_max, erase_max);
+
+  amplification = (double)stats.flash_bytes / stats.user_bytes;
+  CHECK(amplification <= max_amplification);
+
+  printf("  %-22s: %6u user bytes, %6u flash bytes, %3u erases, "
+         "amplification %.2f\n", name, (unsigned)stats.user_bytes,
+         (unsigned)stats.flash_bytes, (unsigned)stats.erases, amplification);
+} /* check_amplification */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    Write amplification for two workloads. A 4-byte setting costs a
+//    header word and a payload word, so about 4 before reclaims; a full
+//    block costs one header word.
+// -----------------------------------------------------------------------------
+static void test_write_amplification(void)
+{
+  uint32_t value;
+
+  printf("write amplification:\n");
+
+  fresh_store();
+  for (value = 0; value < 1000; value++)
+  {
+    CHECK(set_value(value % 4, &value, sizeof(value)));
+  } /* for */
+  check_settings();
+  check_amplification("4-byte settings", 4.5);
+
+  fresh_store();
+  CHECK(set_value(0, "band", 4));
+  for (value = 0; value < 200; value++)
+  {
+    CHECK(append_block(STORE_BLOCK_MAX));
+  } /* for */
+  check_settings();
+  check_amplification("512-byte blocks", 1.1);
+
+  // An unchanged setting writes nothing
+  fresh_store();
+  CHECK(set_value(0, "same", 4));
+  CHECK(set_value(0, "same", 4));
+  check_amplification("unchanged setting", 16.0 / 4 + 16.0 / 4);
+} /* test_write_amplification */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    A small fixed-seed generator, so a failing cut can be repeated.
+// -----------------------------------------------------------------------------
+static uint32_t rng_next(void)
+{
+  g_rng ^= g_rng << 13;
+  g_rng ^= g_rng >> 17;
+  g_rng ^= g_rng << 5;
+  return g_rng;
+} /* rng_next */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    Builds the power cut workload: settings changes, deletions and blocks,
+//    enough to reclaim each sector a few times.
+// -----------------------------------------------------------------------------
+static void make_ops(void)
+{
+  g_rng = 0x1234567;
+
+  for (uint16_t i = 0; i < CUT_OPS; i++)
+  {
+    uint32_t pick = rng_next() % 10;
+
+    g_ops[i].key = rng_next() % CUT_KEYS;
+    g_ops[i].fill = (uint8_t)rng_next();
+    if (pick < 5)
+    {
+      g_ops[i].kind = OP_SET;
+      g_ops[i].length = 1 + rng_next() % STORE_VALUE_MAX;
+    } /* if */
+    else if (pick < 6)
+    {
+      g_ops[i].kind = OP_DELETE;
+    } /* else if */
+    else
+    {
+      g_ops[i].kind = OP_BLOCK;
+      g_ops[i].length = sizeof(uint32_t) + rng_next() % CUT_BLOCK_MAX;
+    } /* else */
+  } /* for */
+} /* make_ops */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    Runs one step of the workload and updates the test's copies once it
+//    has returned.
+// -----------------------------------------------------------------------------
+static void run_op(const op_struct *op)
+{
+  uint8_t value[STORE_VALUE_MAX];
+
+  switch (op->kind)
+  {
+    case OP_SET:
+      memset(value, op->fill, sizeof(value));
+      value[0] = (uint8_t)op->length;
+      CHECK(set_value(op->key, value, op->length));
+      break;
+
+    case OP_DELETE:
+      CHECK(store_delete(op->key));
+      g_settings[op->key].present = false;
+      break;
+
+    default:
+      CHECK(append_block(op->length));
+      break;
+  } /* switch */
+} /* run_op */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    Cuts the power at operation cut of the workload, restarts, and checks
+//    what came back. Every setting but the one being written must be as
+//    before; that one may be old or new. The blocks must run without a gap
+//    and end at the last one appended or the one being appended. The rest
+//    of the workload must then run normally. Returns false once cut is past
+//    the end of the workload.
+// -----------------------------------------------------------------------------
+static bool cut_run(uint32_t cut)
+{
+  static setting_struct before;
+  static uint16_t next_op;
+  const op_struct *op;
+  uint8_t value[STORE_VALUE_MAX];
+  bool old_ok;
+  bool new_ok;
+
+  fresh_store();
+  next_op = 0;
+
+  flash_file_cut_after(cut, on_power_cut);
+  if (setjmp(g_cut_exit) == 0)
+  {
+    while (next_op < CUT_OPS)
+    {
+      run_op(&g_ops[next_op]);
+      next_op++;
+    } /* while */
+    return false;
+  } /* if */
+
+  // g_ops[next_op] was cut short
+  op = &g_ops[next_op];
+  reboot();
+
+  for (uint8_t key = 0; key < STORE_MAX_KEYS; key++)
+  {
+    if (op->kind == OP_BLOCK || key != op->key)
+    {
+      CHECK(setting_matches(key, &g_settings[key]));
+      continue;
+    } /* if */
+
+    before = g_settings[key];
+    old_ok = setting_matches(key, &before);
+    if (op->kind == OP_SET)
+    {
+      memset(value, op->fill, sizeof(value));
+      value[0] = (uint8_t)op->length;
+      memcpy(g_settings[key].value, value, op->length);
+      g_settings[key].length = op->length;
+      g_settings[key].present = true;
+    } /* if */
+    else
+    {
+      g_settings[key].present = false;
+    } /* else */
+    new_ok = setting_matches(key, &g_settings[key]);
+    CHECK(old_ok || new_ok);
+    if (old_ok && !new_ok)
+    {
+      g_settings[key] = before;
+    } /* if */
+  } /* for */
+
+  check_blocks(g_blocks_done, op->kind == OP_BLOCK);
+
+  // Finish the workload from where it stopped; a block that made it in
+  // keeps its number
+  if (op->kind == OP_BLOCK)
+  {
+    store_iter_struct iter;
+    uint8_t data[STORE_BLOCK_MAX];
+    uint32_t number = 0;
+    uint16_t length;
+
+    store_iter_begin(&iter, CHANNEL);
+    while (store_iter_next(&iter, data, &length))
+    {
+      memcpy(&number, data, sizeof(number));
+    } /* while */
+    if (number == g_blocks_done + 1)
+    {
+      g_blocks_done++;
+    } /* if */
+  } /* if */
+
+  for (next_op++; next_op < CUT_OPS; next_op++)
+  {
+    run_op(&g_ops[next_op]);
+  } /* for */
+  check_settings();
+  check_blocks(g_blocks_done, false);
+
+  reboot();
+  check_settings();
+  check_blocks(g_blocks_done, false);
+
+  return true;
+} /* cut_run */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    Cuts the power at every flash operation of the workload in turn.
+// -----------------------------------------------------------------------------
+static void test_power_cuts(void)
+{
+  flash_file_stats_struct flash_stats;
+  int failures = g_test_failures;
+  uint32_t cut;
+
+  make_ops();
+  for (cut = 0; cut_run(cut); cut++)
+  {
+    flash_file_get_stats(&flash_stats);
+    CHECK_EQ(flash_stats.overwrites, 0);
+    if (g_test_failures != failures)
+    {
+      printf("  power cut at operation %u failed\n", (unsigned)cut);
+      break;
+    } /* if */
+  } /* for */
+
+  printf("power cuts: %u cut points\n", (unsigned)cut);
+} /* test_power_cuts */
+
+
+int main(void)
+{
+  test_persistence();
+  test_torn_header();
+  test_torn_payload();
+  test_carry_forward();
+  test_write_amplification();
+  test_power_cuts();
+
+  flash_file_close();
+  remove(IMAGE_PATH);
+
+  return test_report("test_store");
+} /* main */
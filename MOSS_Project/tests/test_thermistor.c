@@ -0,0 +1,140 @@
+// *****************************************************************************
+// ***************************    C Source Code     ****************************
+// *****************************************************************************
+//   DESIGNER NAME:  Rafael Ortiz
+//
+//         VERSION:  1.0
+//
+//       FILE NAME:  test_thermistor.c
+//
+//-----------------------------------------------------------------------------
+// DESCRIPTION
+//    This file tests the integer thermistor conversion against the
+//    polynomial it replaces, thermistor_calc_temperature(), at every 12-bit
+//    ADC code.
+//
+//-----------------------------------------------------------------------------
+// DISCLAIMER
+//    This code was developed for educational purposes as part of the CSC202
+//    course and is provided "as is" without warranties of any kind, whether
+//    express, implied, or statutory.
+//
+//    The author and organization do not warrant the accuracy, completeness, or
+//    reliability of the code. The author and organization shall not be liable
+//    for any direct, indirect, incidental, special, exemplary, or consequential
+//    damages arising out of the use of or inability to use the code, even if
+//    advised of the possibility of such damages.
+//
+//    Use of this code is at your own risk, and it is recommended to validate
+//    and adapt the code for your specific application and hardware requirements.
+//
+// Copyright (c) 2024 by TBD
+//    You may use, edit, run or distribute this file as long as the above
+//    copyright notice remains
+// *****************************************************************************
+//******************************************************************************
+
+
+//-----------------------------------------------------------------------------
+// Load standard C include files
+//-----------------------------------------------------------------------------
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <math.h>
+
+
+//-----------------------------------------------------------------------------
+// Loads MSP launchpad board support macros and definitions
+//-----------------------------------------------------------------------------
+#include "adc.h"
+#include "test.h"
+
+
+//-----------------------------------------------------------------------------
+// Define symbolic constants used by the program
+//-----------------------------------------------------------------------------
+// The bound thermistor_calc_temperature_x10() promises, in degrees
+#define MAX_ERROR                                                         (0.2)
+
+// At a table entry only the rounding to a tenth is left
+#define MAX_NODE_ERROR                                                   (0.05)
+
+// The TMP61's rated range, in degrees
+#define RATED_LOW                                                       (-40.0)
+#define RATED_HIGH                                                      (150.0)
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    Every code from 0 to ADC_MAX_CODE is within MAX_ERROR of the
+//    polynomial, and within MAX_NODE_ERROR at the table entries. Prints the
+//    worst error over all codes and over the sensor's rated range.
+// -----------------------------------------------------------------------------
+static void test_all_codes(void)
+{
+  double worst = 0.0;
+  double worst_rated = 0.0;
+  double celsius;
+  double error;
+  uint16_t worst_code = 0;
+  uint16_t code;
+
+  for (code = 0; code <= ADC_MAX_CODE; code++)
+  {
+    celsius = thermistor_calc_temperature(code);
+    error = thermistor_calc_temperature_x10(code) / 10.0 - celsius;
+    CHECK(fabs(error) < MAX_ERROR);
+    if (code % THERMISTOR_TABLE_STEP == 0)
+    {
+      CHECK(fabs(error) < MAX_NODE_ERROR);
+    } /* if */
+    if (fabs(error) > worst)
+    {
+      worst = fabs(error);
+      worst_code = code;
+    } /* if */
+    if (celsius >= RATED_LOW && celsius <= RATED_HIGH &&
+        fabs(error) > worst_rated)
+    {
+      worst_rated = fabs(error);
+    } /* if */
+  } /* for */
+
+  printf("thermistor: worst error %.3f C at code %u (%.1f C), %.3f C from "
+         "-40 to 150 C\n", worst, (unsigned)worst_code,
+         thermistor_calc_temperature(worst_code), worst_rated);
+} /* test_all_codes */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    The temperature never falls as the code rises, and codes past the
+//    12-bit range read as the top code.
+// -----------------------------------------------------------------------------
+static void test_monotonic_and_clamped(void)
+{
+  int16_t previous = thermistor_calc_temperature_x10(0);
+  int16_t current;
+  uint16_t code;
+
+  for (code = 1; code <= ADC_MAX_CODE; code++)
+  {
+    current = thermistor_calc_temperature_x10(code);
+    CHECK(current >= previous);
+    previous = current;
+  } /* for */
+
+  CHECK_EQ(thermistor_calc_temperature_x10(ADC_MAX_CODE + 1), previous);
+  CHECK_EQ(thermistor_calc_temperature_x10(UINT16_MAX), previous);
+} /* test_monotonic_and_clamped */
+
+
+int main(void)
+{
+  test_all_codes();
+  test_monotonic_and_clamped();
+
+  return test_report("test_thermistor");
+} /* main */
@@ -0,0 +1,511 @@
+// *****************************************************************************
+// ***************************    C Source Code     ****************************
+// *****************************************************************************
+//   DESIGNER NAME:  Rafael Ortiz
+//
+//         VERSION:  1.0
+//
+//       FILE NAME:  test_timer.c
+//
+//-----------------------------------------------------------------------------
+// DESCRIPTION
+//    This file tests the timer wheel by running timer_task against a fake
+//    tick count. The fuzz arms a few thousand one-shot and periodic timers
+//    with delays from 1 ms to past the span of the wheel, starts, restarts
+//    and cancels them from other tasks and from callbacks, and checks that
+//    every callback runs on exactly the tick it is due. The runs start just
+//    before the 32-bit tick count wraps. A second pass wakes the task late
+//    and checks that nothing runs early or is skipped. The benchmark times
+//    start, cancel and expiry with thousands of timers armed.
+//
+//-----------------------------------------------------------------------------
+// DISCLAIMER
+//    This code was developed for educational purposes as part of the CSC202
+//    course and is provided "as is" without warranties of any kind, whether
+//    express, implied, or statutory.
+//
+//    The author and organization do not warrant the accuracy, completeness, or
+//    reliability of the code. The author and organization shall not be liable
+//    for any direct, indirect, incidental, special, exemplary, or consequential
+//    damages arising out of the use of or inability to use the code, even if
+//    advised of the possibility of such damages.
+//
+//    Use of this code is at your own risk, and it is recommended to validate
+//    and adapt the code for your specific application and hardware requirements.
+//
+// Copyright (c) 2024 by TBD
+//    You may use, edit, run or distribute this file as long as the above
+//    copyright notice remains
+// *****************************************************************************
+//******************************************************************************
+
+
+//-----------------------------------------------------------------------------
+// Load standard C include files
+//-----------------------------------------------------------------------------
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <setjmp.h>
+#include <time.h>
+
+
+//-----------------------------------------------------------------------------
+// Loads MSP launchpad board support macros and definitions
+//-----------------------------------------------------------------------------
+#include "timer.h"
+#include "kernel.h"
+#include "host.h"
+#include "test.h"
+
+
+//-----------------------------------------------------------------------------
+// Define symbolic constants used by the program
+//-----------------------------------------------------------------------------
+#define FUZZ_TIMERS                                                       (2000)
+#define FUZZ_TICKS                                                      (200000)
+#define FUZZ_SEEDS                                                           (6)
+
+// Start a little before the tick count wraps, so every run crosses it
+#define WRAP_START_TICKS                                  (0xFFFFFFFFUL - 50000)
+
+// Waits in a row that do not move the tick count before the test gives up
+#define MAX_STALLED_WAITS                                                 (1000)
+
+#define BENCH_TIMERS                                                     (20000)
+#define NSEC_PER_SECOND                                             (1000000000)
+
+
+//-----------------------------------------------------------------------------
+// Define the types used by the test
+//-----------------------------------------------------------------------------
+// What the test expects of one timer
+typedef struct
+{
+  uint32_t expected;
+  uint32_t period;
+  uint32_t fired;
+  bool     armed;
+} shadow_struct;
+
+
+//-----------------------------------------------------------------------------
+// Define global variables and structures here.
+// NOTE: when possible avoid using global variables
+//-----------------------------------------------------------------------------
+static timer_struct  g_timers[BENCH_TIMERS];
+static shadow_struct g_shadow[BENCH_TIMERS];
+static uint16_t g_timer_total;
+
+static jmp_buf  g_sim_exit;
+static uint32_t g_sim_end;
+static uint32_t g_last_pass;
+static uint32_t g_rng;
+static uint32_t g_stalled;
+static bool     g_late_wakes;
+static uint32_t g_callbacks;
+static uint32_t g_passes;
+static uint32_t g_armed_count;
+
+
+//-----------------------------------------------------------------------------
+// Prototype for local functions
+//-----------------------------------------------------------------------------
+static void sim_callback(void *arg);
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    A small fixed-seed generator, so a failing run can be repeated.
+// -----------------------------------------------------------------------------
+static uint32_t rng_next(void)
+{
+  g_rng ^= g_rng << 13;
+  g_rng ^= g_rng >> 17;
+  g_rng ^= g_rng << 5;
+  return g_rng;
+} /* rng_next */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    Picks a delay: mostly within level 0, some within the wheel, and a few
+//    longer than the wheel spans so they have to be parked.
+// -----------------------------------------------------------------------------
+static uint32_t rng_delay(void)
+{
+  uint32_t pick = rng_next() % 16;
+
+  if (pick < 10)
+  {
+    return 1 + rng_next() % 64;
+  } /* if */
+  if (pick < 15)
+  {
+    return 1 + rng_next() % 5000;
+  } /* if */
+
+  return 1 + rng_next() % 100000;
+} /* rng_delay */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    Starts or restarts timer i, and updates what the test expects of it.
+// -----------------------------------------------------------------------------
+static void sim_start(uint16_t i)
+{
+  uint32_t delay = rng_delay();
+  uint32_t period = 0;
+
+  if (rng_next() % 4 == 0)
+  {
+    period = 8 + rng_next() % 2000;
+  } /* if */
+
+  if (!g_shadow[i].armed)
+  {
+    g_armed_count++;
+  } /* if */
+
+  g_shadow[i].expected = kernel_get_ticks() + delay;
+  g_shadow[i].period = period;
+  g_shadow[i].armed = true;
+  timer_start(&g_timers[i], delay, period, sim_callback, (void *)(uintptr_t)i);
+} /* sim_start */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    Cancels timer i. timer_cancel must say whether it was still armed.
+// -----------------------------------------------------------------------------
+static void sim_cancel(uint16_t i)
+{
+  CHECK_EQ(timer_cancel(&g_timers[i]), g_shadow[i].armed);
+  CHECK(!timer_is_active(&g_timers[i]));
+
+  if (g_shadow[i].armed)
+  {
+    g_armed_count--;
+  } /* if */
+  g_shadow[i].armed = false;
+} /* sim_cancel */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    Starts or cancels a random timer, the way another task would.
+// -----------------------------------------------------------------------------
+static void sim_random_action(void)
+{
+  uint16_t i = rng_next() % g_timer_total;
+
+  if (rng_next() % 3 == 0)
+  {
+    sim_cancel(i);
+  } /* if */
+  else
+  {
+    sim_start(i);
+  } /* else */
+} /* sim_random_action */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    The callback of every timer. It must run for an armed timer, on its due
+//    tick; with late wakes, on the first pass of the task at or after it.
+//    Now and then it starts or cancels another timer, or itself.
+// -----------------------------------------------------------------------------
+static void sim_callback(void *arg)
+{
+  uint16_t i = (uint16_t)(uintptr_t)arg;
+  shadow_struct *shadow = &g_shadow[i];
+  uint32_t now = kernel_get_ticks();
+
+  g_callbacks++;
+
+  CHECK(shadow->armed);
+  if (g_late_wakes)
+  {
+    CHECK((int32_t)(now - shadow->expected) >= 0);
+    CHECK((int32_t)(shadow->expected - g_last_pass) > 0);
+  } /* if */
+  else
+  {
+    CHECK_EQ(now, shadow->expected);
+  } /* else */
+
+  shadow->fired++;
+  if (shadow->period != 0)
+  {
+    shadow->expected += shadow->period;
+  } /* if */
+  else
+  {
+    shadow->armed = false;
+    g_armed_count--;
+  } /* else */
+  CHECK_EQ(timer_is_active(&g_timers[i]), shadow->armed);
+
+  if (rng_next() % 16 == 0)
+  {
+    sim_random_action();
+  } /* if */
+} /* sim_callback */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    Runs in place of the timer task's wait. Usually the tick count moves on
+//    by exactly the timeout. One wait in four is cut short by another task
+//    that starts or cancels timers and signals the timer event. With late
+//    wakes, the task also oversleeps now and then. Once the run is over it
+//    jumps back out of timer_task.
+// -----------------------------------------------------------------------------
+static uint32_t sim_wait(uint32_t mask, uint32_t ms)
+{
+  uint32_t now = kernel_get_ticks();
+  uint32_t wake = now + ms;
+  bool early = (ms > 1) && (rng_next() % 4 == 0);
+
+  CHECK_EQ(mask, KERNEL_EVENT_TIMER);
+  CHECK_EQ(host_lock_depth(), 0);
+
+  g_passes++;
+  g_last_pass = now;
+
+  g_stalled = (ms == 0) ? g_stalled + 1 : 0;
+  CHECK(g_stalled < MAX_STALLED_WAITS);
+
+  if (early)
+  {
+    wake = now + 1 + rng_next() % (ms - 1);
+  } /* if */
+  else if (g_late_wakes && rng_next() % 8 == 0)
+  {
+    wake += rng_next() % 300;
+  } /* else if */
+
+  if ((int32_t)(wake - g_sim_end) >= 0 || g_stalled >= MAX_STALLED_WAITS)
+  {
+    longjmp(g_sim_exit, 1);
+  } /* if */
+
+  host_set_ticks(wake);
+
+  if (early)
+  {
+    for (uint8_t n = 1 + rng_next() % 4; n > 0; n--)
+    {
+      sim_random_action();
+    } /* for */
+    return KERNEL_EVENT_TIMER;
+  } /* if */
+
+  return 0;
+} /* sim_wait */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    Clears the wheel and the timers and sets the tick count.
+// -----------------------------------------------------------------------------
+static void sim_reset(uint32_t ticks, uint16_t timer_total)
+{
+  host_kernel_reset(ticks);
+  memset(g_timers, 0, sizeof(g_timers));
+  memset(g_shadow, 0, sizeof(g_shadow));
+  g_timer_total = timer_total;
+  g_callbacks = 0;
+  g_passes = 0;
+  g_stalled = 0;
+  g_armed_count = 0;
+  timer_init();
+} /* sim_reset */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    Runs timer_task with hook in place of its wait, until the hook jumps
+//    back out.
+// -----------------------------------------------------------------------------
+static void sim_run_task(host_wait_hook_t hook)
+{
+  host_set_wait_hook(hook);
+  if (setjmp(g_sim_exit) == 0)
+  {
+    timer_task();
+  } /* if */
+  host_set_wait_hook(NULL);
+} /* sim_run_task */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    One fuzz run from a seed, with or without late wakes.
+// -----------------------------------------------------------------------------
+static void fuzz_run(uint32_t seed, bool late_wakes)
+{
+  uint32_t overdue = 0;
+
+  sim_reset(WRAP_START_TICKS - seed * 7919, FUZZ_TIMERS);
+  g_rng = seed;
+  g_late_wakes = late_wakes;
+  g_sim_end = kernel_get_ticks() + FUZZ_TICKS;
+
+  for (uint16_t i = 0; i < FUZZ_TIMERS; i++)
+  {
+    sim_start(i);
+  } /* for */
+
+  sim_run_task(sim_wait);
+
+  // Anything still armed must not be due before the last pass
+  for (uint16_t i = 0; i < FUZZ_TIMERS; i++)
+  {
+    if (g_shadow[i].armed &&
+        (int32_t)(g_shadow[i].expected - g_last_pass) <= 0)
+    {
+      overdue++;
+    } /* if */
+    CHECK_EQ(timer_is_active(&g_timers[i]), g_shadow[i].armed);
+  } /* for */
+  CHECK_EQ(overdue, 0);
+
+  // The run must have crossed the wrap and done real work
+  CHECK(g_last_pass < WRAP_START_TICKS);
+  CHECK(g_callbacks > FUZZ_TIMERS);
+
+  printf("  seed %2u %-5s: %8u callbacks, %7u passes, %4u armed at end\n",
+         (unsigned)seed, late_wakes ? "late" : "exact", (unsigned)g_callbacks,
+         (unsigned)g_passes, (unsigned)g_armed_count);
+} /* fuzz_run */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    Returns a monotonic time stamp in nanoseconds.
+// -----------------------------------------------------------------------------
+static uint64_t bench_now_ns(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * NSEC_PER_SECOND + ts.tv_nsec;
+} /* bench_now_ns */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    Runs in place of the timer task's wait during the benchmark: moves the
+//    tick count on by exactly the timeout and ends the run once no timer is
+//    armed.
+// -----------------------------------------------------------------------------
+static uint32_t bench_wait(uint32_t mask, uint32_t ms)
+{
+  (void)mask;
+
+  g_passes++;
+  if (g_armed_count == 0)
+  {
+    longjmp(g_sim_exit, 1);
+  } /* if */
+
+  host_set_ticks(kernel_get_ticks() + ms);
+  return 0;
+} /* bench_wait */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    The benchmark callback: checks the due tick and counts the timer done.
+// -----------------------------------------------------------------------------
+static void bench_callback(void *arg)
+{
+  uint16_t i = (uint16_t)(uintptr_t)arg;
+
+  CHECK_EQ(kernel_get_ticks(), g_shadow[i].expected);
+  g_shadow[i].armed = false;
+  g_armed_count--;
+  g_callbacks++;
+} /* bench_callback */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    Arms count one-shot timers, cancels every other one, then runs the
+//    rest to expiry, timing each phase. The tick count starts just before
+//    the wrap.
+// -----------------------------------------------------------------------------
+static void bench_run(uint16_t count, uint32_t max_delay)
+{
+  uint64_t start_ns;
+  uint64_t arm_ns;
+  uint64_t cancel_ns;
+  uint64_t run_ns;
+  uint32_t delay;
+  uint16_t cancelled = 0;
+
+  sim_reset(WRAP_START_TICKS, count);
+  g_rng = 12345;
+
+  start_ns = bench_now_ns();
+  for (uint16_t i = 0; i < count; i++)
+  {
+    delay = 1 + rng_next() % max_delay;
+    g_shadow[i].expected = kernel_get_ticks() + delay;
+    g_shadow[i].armed = true;
+    timer_start(&g_timers[i], delay, 0, bench_callback, (void *)(uintptr_t)i);
+  } /* for */
+  arm_ns = bench_now_ns() - start_ns;
+  g_armed_count = count;
+
+  start_ns = bench_now_ns();
+  for (uint16_t i = 0; i < count; i += 2)
+  {
+    timer_cancel(&g_timers[i]);
+    cancelled++;
+  } /* for */
+  cancel_ns = bench_now_ns() - start_ns;
+
+  for (uint16_t i = 0; i < count; i += 2)
+  {
+    g_shadow[i].armed = false;
+  } /* for */
+  g_armed_count -= cancelled;
+
+  start_ns = bench_now_ns();
+  sim_run_task(bench_wait);
+  run_ns = bench_now_ns() - start_ns;
+
+  CHECK_EQ(g_callbacks, count - cancelled);
+  CHECK_EQ(g_armed_count, 0);
+
+  printf("  %5u timers, delays to %6u ms: start %5.1f ns, cancel %5.1f ns, "
+         "expiry %6.1f ns, %6u task passes\n", (unsigned)count,
+         (unsigned)max_delay, (double)arm_ns / count,
+         (double)cancel_ns / cancelled, (double)run_ns / g_callbacks,
+         (unsigned)g_passes);
+} /* bench_run */
+
+
+int main(void)
+{
+  printf("fuzz:\n");
+  for (uint32_t seed = 1; seed <= FUZZ_SEEDS; seed++)
+  {
+    fuzz_run(seed, false);
+    fuzz_run(seed, true);
+  } /* for */
+
+  printf("benchmark:\n");
+  bench_run(2000, 1000);
+  bench_run(BENCH_TIMERS, 1000);
+  bench_run(BENCH_TIMERS, 30000);
+  bench_run(BENCH_TIMERS, 200000);
+
+  return test_report("test_timer");
+} /* main */
@@ -0,0 +1,275 @@
+// *****************************************************************************
+// ***************************    C Source Code     ****************************
+// *****************************************************************************
+//   DESIGNER NAME:  Rafael Ortiz
+//
+//         VERSION:  1.0
+//
+//       FILE NAME:  test_uart.c
+//
+//-----------------------------------------------------------------------------
+// DESCRIPTION
+//    This file floods the UART0 receive path at full line rate. The line
+//    puts a byte in the RX FIFO every byte time, the RX interrupt runs
+//    UART_irq_handler at most a few byte times later, and the consumer only
+//    reads the ring after it has been busy for a while. Every byte must
+//    come out in order and none may be dropped while the ring can hold what
+//    arrives during the busy time; past that, every lost byte is counted.
+//
+//-----------------------------------------------------------------------------
+// DISCLAIMER
+//    This code was developed for educational purposes as part of the CSC202
+//    course and is provided "as is" without warranties of any kind, whether
+//    express, implied, or statutory.
+//
+//    The author and organization do not warrant the accuracy, completeness, or
+//    reliability of the code. The author and organization shall not be liable
+//    for any direct, indirect, incidental, special, exemplary, or consequential
+//    damages arising out of the use of or inability to use the code, even if
+//    advised of the possibility of such damages.
+//
+//    Use of this code is at your own risk, and it is recommended to validate
+//    and adapt the code for your specific application and hardware requirements.
+//
+// Copyright (c) 2024 by TBD
+//    You may use, edit, run or distribute this file as long as the above
+//    copyright notice remains
+// *****************************************************************************
+//******************************************************************************
+
+
+//-----------------------------------------------------------------------------
+// Load standard C include files
+//-----------------------------------------------------------------------------
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+
+//-----------------------------------------------------------------------------
+// Loads MSP launchpad board support macros and definitions
+//-----------------------------------------------------------------------------
+#include <ti/devices/msp/msp.h>
+#include "uart.h"
+#include "host.h"
+#include "test.h"
+
+
+//-----------------------------------------------------------------------------
+// Define symbolic constants used by the program
+//-----------------------------------------------------------------------------
+#define BAUD_RATE                                                       (115200)
+
+// 8N1: a start bit, 8 data bits and a stop bit per byte
+#define BITS_PER_BYTE                                                       (10)
+
+#define FLOOD_BYTES                                                       (8192)
+
+// Longest the RX interrupt waits behind other code, in byte times. The
+// 4-byte FIFO overruns in hardware past this.
+#define MAX_IRQ_LATENCY                                                      (4)
+
+// Bytes the ring holds; one slot tells full from empty
+#define RING_CAPACITY                                    (UART_RX_BUFFER_SIZE - 1)
+
+
+//-----------------------------------------------------------------------------
+// Define the types used by the test
+//-----------------------------------------------------------------------------
+// What one flood did
+typedef struct
+{
+  uint32_t received;
+  uint32_t dropped;
+  uint32_t overruns;
+  uint32_t skipped;
+  bool     in_order;
+} flood_result_struct;
+
+
+//-----------------------------------------------------------------------------
+// Define global variables and structures here.
+// NOTE: when possible avoid using global variables
+//-----------------------------------------------------------------------------
+static uint8_t g_sent[FLOOD_BYTES];
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    Fills the bytes to send with every byte value in a scrambled order, so
+//    a byte read twice or out of place does not match by chance.
+// -----------------------------------------------------------------------------
+static void make_pattern(void)
+{
+  uint32_t state = 1;
+
+  for (uint32_t i = 0; i < FLOOD_BYTES; i++)
+  {
+    state = state * 1103515245U + 12345U;
+    g_sent[i] = (uint8_t)(state >> 16);
+  } /* for */
+} /* make_pattern */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    Starts UART0 on fresh registers.
+// -----------------------------------------------------------------------------
+static void setup(void)
+{
+  host_regs_reset();
+  host_clock_reset();
+  host_kernel_reset(0);
+  UART_init(BAUD_RATE);
+  UART_clear_stats();
+} /* setup */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    Runs the RX interrupt, as the NVIC does once the FIFO holds a byte.
+// -----------------------------------------------------------------------------
+static void rx_interrupt(void)
+{
+  UART0->CPU_INT.IIDX = UART_CPU_INT_IIDX_STAT_RXIFG;
+  UART_irq_handler();
+} /* rx_interrupt */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    Sends FLOOD_BYTES back to back. The RX interrupt runs every
+//    irq_latency byte times and the consumer drains the ring every
+//    busy_time byte times. Received bytes are matched against the sent ones:
+//    each must be the next sent byte, or a later one if bytes were dropped,
+//    in which case the sent bytes passed over are counted as skipped.
+// -----------------------------------------------------------------------------
+static void flood(uint32_t busy_time, uint32_t irq_latency,
+                  flood_result_struct *result)
+{
+  uart_stats_struct stats;
+  char buffer[UART_RX_BUFFER_SIZE];
+  uint32_t next = 0;
+  uint16_t count;
+
+  setup();
+  result->received = 0;
+  result->overruns = 0;
+  result->skipped = 0;
+  result->in_order = true;
+
+  for (uint32_t t = 0; t < FLOOD_BYTES + busy_time + irq_latency; t++)
+  {
+    if (t < FLOOD_BYTES && !host_uart_rx_push(g_sent[t]))
+    {
+      result->overruns++;
+    } /* if */
+
+    if ((t + 1) % irq_latency == 0)
+    {
+      rx_interrupt();
+    } /* if */
+
+    if ((t + 1) % busy_time == 0)
+    {
+      while ((count = UART_read(buffer, sizeof(buffer))) > 0)
+      {
+        for (uint16_t i = 0; i < count; i++)
+        {
+          while (next < FLOOD_BYTES && g_sent[next] != (uint8_t)buffer[i])
+          {
+            next++;
+            result->skipped++;
+          } /* while */
+          if (next == FLOOD_BYTES)
+          {
+            result->in_order = false;
+          } /* if */
+          next++;
+        } /* for */
+        result->received += count;
+      } /* while */
+    } /* if */
+  } /* for */
+
+  UART_get_stats(&stats);
+  result->dropped = stats.rx_dropped;
+  CHECK_EQ(stats.rx_bytes, result->received);
+} /* flood */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    While the consumer is busy for no longer than the ring takes to fill,
+//    every byte arrives intact and in order. Bytes still in the FIFO when
+//    the consumer drains the ring land in it later, so each byte time of
+//    interrupt latency takes one byte time off the busy time.
+// -----------------------------------------------------------------------------
+static void test_no_drops(void)
+{
+  flood_result_struct result;
+
+  for (uint32_t latency = 1; latency <= MAX_IRQ_LATENCY; latency++)
+  {
+    for (uint32_t busy = 1; busy <= RING_CAPACITY - (latency - 1); busy++)
+    {
+      flood(busy, latency, &result);
+      CHECK_EQ(result.overruns, 0);
+      CHECK_EQ(result.dropped, 0);
+      CHECK_EQ(result.received, FLOOD_BYTES);
+      CHECK_EQ(result.skipped, 0);
+      CHECK(result.in_order);
+    } /* for */
+  } /* for */
+} /* test_no_drops */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    A consumer that stays busy longer loses bytes, but only whole bytes:
+//    each is either received in order or counted in rx_dropped.
+// -----------------------------------------------------------------------------
+static void test_counted_drops(void)
+{
+  flood_result_struct result;
+
+  flood(2 * UART_RX_BUFFER_SIZE, 1, &result);
+  CHECK(result.dropped > 0);
+  CHECK_EQ(result.received + result.dropped, FLOOD_BYTES);
+  CHECK(result.skipped <= result.dropped);
+  CHECK(result.in_order);
+} /* test_counted_drops */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    Reports how long the consumer may stay busy at line rate without
+//    losing a byte.
+// -----------------------------------------------------------------------------
+static void report_headroom(void)
+{
+  flood_result_struct result;
+  uint32_t busy = RING_CAPACITY;
+  double byte_us = 1e6 * BITS_PER_BYTE / BAUD_RATE;
+
+  do
+  {
+    busy++;
+    flood(busy, 1, &result);
+  } while (result.dropped == 0);
+
+  printf("uart: %u baud, a consumer busy for up to %u byte times "
+         "(%.1f ms) loses nothing\n", BAUD_RATE, (unsigned)(busy - 1),
+         (busy - 1) * byte_us / 1000.0);
+} /* report_headroom */
+
+
+int main(void)
+{
+  make_pattern();
+  test_no_drops();
+  test_counted_drops();
+  report_headroom();
+
+  return test_report("test_uart");
+} /* main */
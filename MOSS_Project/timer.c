@@ -0,0 +1,551 @@
+// *****************************************************************************
+// ***************************    C Source Code     ****************************
+// *****************************************************************************
+//   DESIGNER NAME:  Rafael Ortiz
+//
+//         VERSION:  1.0
+//
+//       FILE NAME:  timer.c
+//
+//-----------------------------------------------------------------------------
+// DESCRIPTION
+//    This file contains the software timer service. The wheel keeps its own
+//    time, g_timer_now, which the timer task moves up to the kernel tick
+//    count one tick at a time. Each step runs the level 0 slot for that tick,
+//    and on every turn of a level it empties the next slot of the level above
+//    back into the wheel, where its timers land at a finer level. Each level
+//    has a bitmap of the slots holding timers, so empty stretches are skipped
+//    and the next due time is found without walking lists.
+//
+//-----------------------------------------------------------------------------
+// DISCLAIMER
+//    This code was developed for educational purposes as part of the CSC202
+//    course and is provided "as is" without warranties of any kind, whether
+//    express, implied, or statutory.
+//
+//    The author and organization do not warrant the accuracy, completeness, or
+//    reliability of the code. The author and organization shall not be liable
+//    for any direct, indirect, incidental, special, exemplary, or consequential
+//    damages arising out of the use of or inability to use the code, even if
+//    advised of the possibility of such damages.
+//
+//    Use of this code is at your own risk, and it is recommended to validate
+//    and adapt the code for your specific application and hardware requirements.
+//
+// Copyright (c) 2024 by TBD
+//    You may use, edit, run or distribute this file as long as the above
+//    copyright notice remains
+// *****************************************************************************
+//******************************************************************************
+
+//-----------------------------------------------------------------------------
+// Load standard C include files
+//-----------------------------------------------------------------------------
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+
+//-----------------------------------------------------------------------------
+// Loads MSP launchpad board support macros and definitions
+//-----------------------------------------------------------------------------
+#include "timer.h"
+#include "kernel.h"
+
+
+//-----------------------------------------------------------------------------
+// Define symbolic constants used by the program
+//-----------------------------------------------------------------------------
+// Ticks covered by one slot of a level, and by a whole level
+#define TIMER_SLOT_TICKS(level)            (1UL << (TIMER_WHEEL_BITS * (level)))
+#define TIMER_LEVEL_TICKS(level)                 (TIMER_SLOT_TICKS((level) + 1))
+
+// The longest wait the timer task makes when no timer is armed
+#define TIMER_IDLE_WAIT_MS                                               (60000)
+
+
+//-----------------------------------------------------------------------------
+// Define global variables and structures here.
+// NOTE: when possible avoid using global variables
+//-----------------------------------------------------------------------------
+static timer_struct *g_timer_wheel[TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOTS];
+static uint32_t g_timer_bitmap[TIMER_WHEEL_LEVELS];
+static uint32_t g_timer_now = 0;
+static uint32_t g_timer_count = 0;
+
+
+//-----------------------------------------------------------------------------
+// Prototype for local functions
+//-----------------------------------------------------------------------------
+static void timer_link(timer_struct *timer, uint32_t first);
+static void timer_unlink(timer_struct *timer);
+static void timer_cascade(uint8_t level);
+static timer_struct *timer_next_expired(uint32_t target);
+static uint32_t timer_ticks_to_next(void);
+static uint32_t timer_rotate_right(uint32_t bits, uint8_t count);
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function empties the wheel and sets its time to the kernel tick
+//    count. Call it before any timer is started.
+//
+// INPUT PARAMETERS:
+//   none
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+void timer_init(void)
+{
+  uint8_t i;
+
+  for (i = 0; i < TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOTS; i++)
+  {
+    g_timer_wheel[i] = NULL;
+  } /* for */
+
+  for (i = 0; i < TIMER_WHEEL_LEVELS; i++)
+  {
+    g_timer_bitmap[i] = 0;
+  } /* for */
+
+  g_timer_now = kernel_get_ticks();
+  g_timer_count = 0;
+} /* timer_init */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function starts a timer, or restarts it if it is already running.
+//    The callback runs in the timer task once delay_ms has passed, then
+//    every period_ms after that if period_ms is not 0. Periodic timers keep
+//    to their original schedule; if the timer task falls more than a period
+//    behind, the missed runs are dropped rather than run back to back.
+//
+//    Callbacks run with the scheduler locked, so they must be short and must
+//    not sleep or wait for events. They may start and cancel timers,
+//    including their own.
+//
+// INPUT PARAMETERS:
+//   timer     - the timer
+//   delay_ms  - milliseconds until the first run
+//   period_ms - milliseconds between runs after that, or 0 for one run
+//   callback  - the function to run
+//   arg       - passed to the callback
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+void timer_start(timer_struct *timer, uint32_t delay_ms, uint32_t period_ms,
+                 timer_callback_t callback, void *arg)
+{
+  kernel_lock();
+
+  if (timer->active)
+  {
+    timer_unlink(timer);
+  } /* if */
+
+  timer->callback = callback;
+  timer->arg = arg;
+  timer->period = period_ms;
+  timer->expires = kernel_get_ticks() + delay_ms;
+  timer->active = true;
+  timer_link(timer, g_timer_now + 1);
+
+  kernel_unlock();
+
+  // The timer task may be asleep past the new expiry
+  kernel_signal_event(KERNEL_EVENT_TIMER);
+} /* timer_start */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function stops a timer. Its callback does not run again.
+//
+// INPUT PARAMETERS:
+//   timer - the timer
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   true  - if the timer was running
+//   false - if it had already expired or was never started
+// -----------------------------------------------------------------------------
+bool timer_cancel(timer_struct *timer)
+{
+  bool was_active;
+
+  kernel_lock();
+
+  was_active = timer->active;
+  if (was_active)
+  {
+    timer_unlink(timer);
+    timer->active = false;
+  } /* if */
+
+  kernel_unlock();
+
+  return was_active;
+} /* timer_cancel */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function reports whether a timer is waiting to run.
+//
+// INPUT PARAMETERS:
+//   timer - the timer
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   true  - if the timer is running
+//   false - otherwise
+// -----------------------------------------------------------------------------
+bool timer_is_active(const timer_struct *timer)
+{
+  return timer->active;
+} /* timer_is_active */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This task runs the timer callbacks. It brings the wheel up to the
+//    kernel tick count, running every timer that falls due on the way, then
+//    waits until the next one is due or a timer is started.
+//
+// INPUT PARAMETERS:
+//   none
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+void timer_task(void)
+{
+  timer_struct *timer;
+  uint32_t ticks;
+
+  while (1)
+  {
+    kernel_lock();
+
+    timer = timer_next_expired(kernel_get_ticks());
+    while (timer != NULL)
+    {
+      if (timer->period != 0)
+      {
+        timer->expires += timer->period;
+        if ((int32_t)(timer->expires - g_timer_now) <= 0)
+        {
+          timer->expires = g_timer_now + timer->period;
+        } /* if */
+        timer_link(timer, g_timer_now + 1);
+      } /* if */
+      else
+      {
+        timer->active = false;
+      } /* else */
+
+      timer->callback(timer->arg);
+      timer = timer_next_expired(kernel_get_ticks());
+    } /* while */
+
+    ticks = timer_ticks_to_next();
+
+    kernel_unlock();
+
+    kernel_wait_event_timeout(KERNEL_EVENT_TIMER, ticks);
+  } /* while */
+} /* timer_task */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function files a timer in the wheel. It goes to the finest level
+//    whose span reaches its expiry, in the slot holding that expiry. A timer
+//    due before the first tick allowed goes into that tick's slot; one beyond
+//    the top level's span goes into the farthest top-level slot and is filed
+//    again when that slot comes round.
+//
+// INPUT PARAMETERS:
+//   timer - the timer
+//   first - the earliest tick it may run at: the wheel's time while that
+//           tick's slot is still to be run, otherwise the tick after
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+static void timer_link(timer_struct *timer, uint32_t first)
+{
+  int32_t delta = (int32_t)(timer->expires - g_timer_now);
+  uint32_t when = timer->expires;
+  uint8_t level = 0;
+  uint8_t slot;
+
+  if ((int32_t)(timer->expires - first) <= 0)
+  {
+    when = first;
+  } /* if */
+  else
+  {
+    while (level < TIMER_WHEEL_LEVELS - 1 &&
+           (uint32_t)delta >= TIMER_LEVEL_TICKS(level))
+    {
+      level++;
+    } /* while */
+
+    if ((uint32_t)delta >= TIMER_LEVEL_TICKS(level))
+    {
+      when = g_timer_now + TIMER_LEVEL_TICKS(level) - 1;
+    } /* if */
+  } /* else */
+
+  slot = (when >> (TIMER_WHEEL_BITS * level)) & TIMER_WHEEL_MASK;
+  timer->slot = level * TIMER_WHEEL_SLOTS + slot;
+
+  timer->prev = NULL;
+  timer->next = g_timer_wheel[timer->slot];
+  if (timer->next != NULL)
+  {
+    timer->next->prev = timer;
+  } /* if */
+  g_timer_wheel[timer->slot] = timer;
+  g_timer_bitmap[level] |= (1UL << slot);
+  g_timer_count++;
+} /* timer_link */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function takes a timer out of its slot.
+//
+// INPUT PARAMETERS:
+//   timer - the timer, which must be in the wheel
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+static void timer_unlink(timer_struct *timer)
+{
+  if (timer->prev != NULL)
+  {
+    timer->prev->next = timer->next;
+  } /* if */
+  else
+  {
+    g_timer_wheel[timer->slot] = timer->next;
+  } /* else */
+
+  if (timer->next != NULL)
+  {
+    timer->next->prev = timer->prev;
+  } /* if */
+
+  if (g_timer_wheel[timer->slot] == NULL)
+  {
+    g_timer_bitmap[timer->slot / TIMER_WHEEL_SLOTS] &=
+                            ~(1UL << (timer->slot & TIMER_WHEEL_MASK));
+  } /* if */
+  g_timer_count--;
+} /* timer_unlink */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function empties the slot of a level that the wheel's time has
+//    just reached, filing each of its timers again. They are now close
+//    enough to their expiry to land at a finer level.
+//
+// INPUT PARAMETERS:
+//   level - the level, 1 or above
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+static void timer_cascade(uint8_t level)
+{
+  uint8_t slot = level * TIMER_WHEEL_SLOTS +
+                 ((g_timer_now >> (TIMER_WHEEL_BITS * level)) &
+                  TIMER_WHEEL_MASK);
+  timer_struct *timer;
+
+  while ((timer = g_timer_wheel[slot]) != NULL)
+  {
+    timer_unlink(timer);
+    timer_link(timer, g_timer_now);
+  } /* while */
+} /* timer_cascade */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function moves the wheel's time towards a target tick until a
+//    timer falls due, and takes that timer out of the wheel. Stretches where
+//    level 0 is empty are crossed in one step.
+//
+// INPUT PARAMETERS:
+//   target - the tick to move up to, normally the kernel tick count
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   The timer that is due, or NULL once the wheel has reached the target
+// -----------------------------------------------------------------------------
+static timer_struct *timer_next_expired(uint32_t target)
+{
+  timer_struct *timer;
+  uint8_t level;
+
+  while (1)
+  {
+    timer = g_timer_wheel[g_timer_now & TIMER_WHEEL_MASK];
+    if (timer != NULL)
+    {
+      timer_unlink(timer);
+      if ((int32_t)(timer->expires - g_timer_now) <= 0)
+      {
+        return timer;
+      } /* if */
+
+      // Parked a whole turn early; file it where it belongs
+      timer_link(timer, g_timer_now + 1);
+      continue;
+    } /* if */
+
+    if (g_timer_now == target)
+    {
+      return NULL;
+    } /* if */
+
+    // Nothing at level 0 this turn, so jump to its last slot
+    if (g_timer_bitmap[0] == 0 &&
+        (g_timer_now & TIMER_WHEEL_MASK) != TIMER_WHEEL_MASK)
+    {
+      g_timer_now |= TIMER_WHEEL_MASK;
+      if ((int32_t)(g_timer_now - target) > 0)
+      {
+        g_timer_now = target;
+      } /* if */
+      continue;
+    } /* if */
+
+    g_timer_now++;
+
+    // Coarsest level first, so its timers can drop through the finer ones
+    for (level = TIMER_WHEEL_LEVELS - 1; level > 0; level--)
+    {
+      if ((g_timer_now & (TIMER_SLOT_TICKS(level) - 1)) == 0)
+      {
+        timer_cascade(level);
+      } /* if */
+    } /* for */
+  } /* while */
+} /* timer_next_expired */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function finds how long the timer task can wait before the wheel
+//    has work to do: the next level 0 slot holding a timer, or the next
+//    higher-level slot holding timers that must be filed again, whichever
+//    comes first.
+//
+// INPUT PARAMETERS:
+//   none
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   The number of ticks from the kernel tick count, 0 if the wheel is
+//   behind, or TIMER_IDLE_WAIT_MS if no timer is armed
+// -----------------------------------------------------------------------------
+static uint32_t timer_ticks_to_next(void)
+{
+  uint32_t best = TIMER_IDLE_WAIT_MS;
+  uint32_t turn;
+  uint32_t due;
+  uint32_t bits;
+  int32_t behind;
+  uint8_t level;
+  uint8_t shift;
+
+  if (g_timer_count == 0)
+  {
+    return best;
+  } /* if */
+
+  for (level = 0; level < TIMER_WHEEL_LEVELS; level++)
+  {
+    if (g_timer_bitmap[level] == 0)
+    {
+      continue;
+    } /* if */
+
+    // Search from the slot after the current one round to the current one
+    shift = TIMER_WHEEL_BITS * level;
+    turn = g_timer_now >> shift;
+    bits = timer_rotate_right(g_timer_bitmap[level],
+                              (turn + 1) & TIMER_WHEEL_MASK);
+    due = (turn + 1 + __builtin_ctz(bits)) << shift;
+
+    if (due - g_timer_now < best)
+    {
+      best = due - g_timer_now;
+    } /* if */
+  } /* for */
+
+  behind = (int32_t)(kernel_get_ticks() - g_timer_now);
+  if (behind > 0)
+  {
+    best = ((uint32_t)behind >= best) ? 0 : best - behind;
+  } /* if */
+
+  return best;
+} /* timer_ticks_to_next */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function rotates a slot bitmap right, so the given slot becomes
+//    bit 0.
+//
+// INPUT PARAMETERS:
+//   bits  - the bitmap
+//   count - the number of places to rotate, 0 to 31
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   The rotated bitmap
+// -----------------------------------------------------------------------------
+static uint32_t timer_rotate_right(uint32_t bits, uint8_t count)
+{
+  return (bits >> count) | (bits << ((32 - count) & 31));
+} /* timer_rotate_right */
@@ -0,0 +1,96 @@
+// *****************************************************************************
+// ***************************    C Source Code     ****************************
+// *****************************************************************************
+//   DESIGNER NAME:  Rafael Ortiz
+//
+//         VERSION:  1.0
+//
+//       FILE NAME:  timer.h
+//
+//-----------------------------------------------------------------------------
+// DESCRIPTION
+//    This file contains a software timer service for one-shot and periodic
+//    callbacks. Timers live in a hierarchical timing wheel of
+//    TIMER_WHEEL_LEVELS levels of TIMER_WHEEL_SLOTS slots each: level 0
+//    counts single ticks, and each level above counts whole turns of the one
+//    below. A timer is filed in the slot for its expiry at the coarsest
+//    level that can hold it and moves down as its time nears, so starting
+//    and cancelling a timer are constant time however many are armed.
+//
+//    Callbacks run in the timer task, never in an interrupt handler. The
+//    task sleeps until the next timer is due, so timers do not keep the
+//    core out of tickless idle.
+//
+//-----------------------------------------------------------------------------
+// DISCLAIMER
+//    This code was developed for educational purposes as part of the CSC202
+//    course and is provided "as is" without warranties of any kind, whether
+//    express, implied, or statutory.
+//
+//    The author and organization do not warrant the accuracy, completeness, or
+//    reliability of the code. The author and organization shall not be liable
+//    for any direct, indirect, incidental, special, exemplary, or consequential
+//    damages arising out of the use of or inability to use the code, even if
+//    advised of the possibility of such damages.
+//
+//    Use of this code is at your own risk, and it is recommended to validate
+//    and adapt the code for your specific application and hardware requirements.
+//
+// Copyright (c) 2024 by TBD
+//    You may use, edit, run or distribute this file as long as the above
+//    copyright notice remains
+// *****************************************************************************
+//******************************************************************************
+
+#ifndef __TIMER_H__
+#define __TIMER_H__
+
+//-----------------------------------------------------------------------------
+// Loads standard C include files
+//-----------------------------------------------------------------------------
+#include <stdbool.h>
+#include <stdint.h>
+
+
+//-----------------------------------------------------------------------------
+// Define symbolic constants used by the program
+//-----------------------------------------------------------------------------
+// Three levels of 32 slots span 32768 ticks (ms); longer timers are parked
+// at the top level and filed again when they come round
+#define TIMER_WHEEL_BITS                                                     (5)
+#define TIMER_WHEEL_SLOTS                                (1 << TIMER_WHEEL_BITS)
+#define TIMER_WHEEL_MASK                                 (TIMER_WHEEL_SLOTS - 1)
+#define TIMER_WHEEL_LEVELS                                                   (3)
+
+
+//-----------------------------------------------------------------------------
+// Define the types used by the timers
+//-----------------------------------------------------------------------------
+typedef void (*timer_callback_t)(void *arg);
+
+// A timer. The caller owns the memory, usually a static variable, and must
+// keep it until the timer is cancelled or has expired.
+typedef struct timer_struct
+{
+  struct timer_struct *next;
+  struct timer_struct *prev;
+  timer_callback_t     callback;
+  void                *arg;
+  uint32_t             expires;
+  uint32_t             period;
+  uint8_t              slot;
+  bool                 active;
+} timer_struct;
+
+
+// ----------------------------------------------------------------------------
+// Prototype for support functions
+// ----------------------------------------------------------------------------
+void timer_init(void);
+void timer_start(timer_struct *timer, uint32_t delay_ms, uint32_t period_ms,
+                 timer_callback_t callback, void *arg);
+bool timer_cancel(timer_struct *timer);
+bool timer_is_active(const timer_struct *timer);
+void timer_task(void);
+
+#endif /* __TIMER_H__ */
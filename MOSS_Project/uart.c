@@ -22,6 +22,13 @@
 //      - J25: Connects PA10 to XDS_UART
 //      - J26: Connects PA11 to XDS_UART
 //
+//    Received bytes are moved by the UART0 ISR into an RX ring buffer, and
+//    transmitted bytes are queued in a TX ring buffer that the ISR drains
+//    into the FIFO. Each ring has a single producer and a single consumer,
+//    so neither side needs to disable interrupts. UART_read and UART_write
+//    never block; UART_in_char and UART_out_char wait on kernel events when
+//    the rings are empty or full.
+//
 //    Note: The code for this module is adapted from TI's sample project 
 //    'uart_rw_multibyte_fifo_poll_LP_MSPM0G3507_nortos_ticlang'.
 //
@@ -51,6 +58,7 @@
 // Load standard C include files
 //-----------------------------------------------------------------------------
 #include <stdint.h>
+#include <stdbool.h>
 
 //-----------------------------------------------------------------------------
 // Loads MSP launchpad board support macros and definitions
@@ -59,6 +67,45 @@
 #include <ti/devices/msp/m0p/mspm0g350x.h>
 #include "uart.h"
 #include "clock.h"
+#include "kernel.h"
+
+
+//-----------------------------------------------------------------------------
+// Define symbolic constants used by the program
+//-----------------------------------------------------------------------------
+#define UART_RX_BUFFER_MASK                          (UART_RX_BUFFER_SIZE - 1)
+#define UART_TX_BUFFER_MASK                          (UART_TX_BUFFER_SIZE - 1)
+
+#define OVERSAMPLING        16    // UART_CTL0_HSE_OVS16 set in CTL0
+#define PD0_CPUCLK_CLKDIV   2     // UART0-2 BUSCLK is half of CPUCLK
+
+
+//-----------------------------------------------------------------------------
+// Define global variables and structures here.
+// NOTE: when possible avoid using global variables
+//-----------------------------------------------------------------------------
+// Ring buffers: head is only written by the producer, tail by the consumer
+typedef struct
+{
+  char              rx_buffer[UART_RX_BUFFER_SIZE];
+  volatile uint16_t rx_head;
+  volatile uint16_t rx_tail;
+  char              tx_buffer[UART_TX_BUFFER_SIZE];
+  volatile uint16_t tx_head;
+  volatile uint16_t tx_tail;
+} uart_ring_struct;
+
+static uart_ring_struct g_uart_ring = {0};
+static uart_stats_struct g_uart_stats = {0};
+static uint32_t g_uart_baud_rate = 0;
+
+
+//-----------------------------------------------------------------------------
+// Prototype for local functions
+//-----------------------------------------------------------------------------
+static void UART_fill_tx_fifo(void);
+static void UART_set_baud_rate(uint32_t bus_clock_freq);
+static void UART_clock_changed(uint8_t stage, uint32_t freq);
 
 
 //-----------------------------------------------------------------------------
@@ -66,7 +113,8 @@
 //    This function initializes and enables the UART0 peripheral for 
 //    serial communication with a specified baud rate using 8-bit, no parity 
 //    and 1 stop bit. This function also configures the GPIO pins for UART0 
-//    transmission and reception. 
+//    transmission and reception, and registers for bus clock changes so the
+//    baud rate is kept when the clock is switched.
 //
 // INPUT PARAMETERS:
 //   baud_rate  : 32-bit value for the desired baud rate for UART. 
@@ -111,16 +159,51 @@ void UART_init(uint32_t baud_rate)
                 UART_CTL0_TXE_ENABLE| UART_CTL0_RXE_ENABLE | 
                 UART_CTL0_LBE_DISABLE | UART_CTL0_ENABLE_DISABLE;
 
-  #define OVERSAMPLING        16    // UART_CTL0_HSE_OVS16 set above in CTL0
-  #define PD0_CPUCLK_CLKDIV   2     // UART0-2 BUSCLK is half of CPUCLK
-  #define PD1_CPUCLK_CLKDIV   1     // UART3 BUSCLK is same as CPUCLK
+  g_uart_baud_rate = baud_rate;
+  UART_set_baud_rate(get_bus_clock_freq());
+
+  // Interrupt on every received byte, and refill the transmit FIFO once it
+  // drains to half full
+  UART0->IFLS = UART_IFLS_RXIFLSEL_LVL_1 | UART_IFLS_TXIFLSEL_LVL_1_2;
+
+  g_uart_ring.rx_head = g_uart_ring.rx_tail = 0;
+  g_uart_ring.tx_head = g_uart_ring.tx_tail = 0;
+
+  // TX interrupt is only unmasked while the TX ring holds data
+  UART0->CPU_INT.ICLR = UART_CPU_INT_ICLR_RXINT_CLR | 
+                        UART_CPU_INT_ICLR_TXINT_CLR;
+  UART0->CPU_INT.IMASK = UART_CPU_INT_IMASK_RXINT_SET;
+  NVIC_EnableIRQ(UART0_INT_IRQn);
+
+  // Now enable UART0
+  UART0->CTL0 |= UART_CTL0_ENABLE_ENABLE;
 
+  clock_register_notifier(UART_clock_changed);
+} /* UART_init */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function sets the baud rate divisors for g_uart_baud_rate from the
+//    bus clock. UART0 must be disabled.
+//
+// INPUT PARAMETERS:
+//   bus_clock_freq - the bus clock frequency in Hz
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+static void UART_set_baud_rate(uint32_t bus_clock_freq)
+{
   // Calculate integer (IBRD) and fractional (FBRD) for the desired baud 
   // rate given UART is configrued for 16x oversampling and CLKDIV=1
-  uint32_t uart_clock = get_bus_clock_freq() / PD0_CPUCLK_CLKDIV;     // Really returns CPU_CLK
-  uint32_t ibrd = uart_clock / (OVERSAMPLING * baud_rate);
-  uint32_t remainder = uart_clock % (OVERSAMPLING * baud_rate);
-  uint32_t fbrd = ((remainder * 64 / (OVERSAMPLING * baud_rate)) + 0.5);
+  uint32_t uart_clock = bus_clock_freq / PD0_CPUCLK_CLKDIV;
+  uint32_t ibrd = uart_clock / (OVERSAMPLING * g_uart_baud_rate);
+  uint32_t remainder = uart_clock % (OVERSAMPLING * g_uart_baud_rate);
+  uint32_t fbrd = ((remainder * 64 / (OVERSAMPLING * g_uart_baud_rate)) + 0.5);
 
   UART0->IBRD = ibrd;
   UART0->FBRD = fbrd;
@@ -130,20 +213,49 @@ void UART_init(uint32_t baud_rate)
   UART0->LCRH = UART_LCRH_WLEN_DATABIT8 | UART_LCRH_STP2_DISABLE | 
                 UART_LCRH_EPS_ODD | UART_LCRH_PEN_DISABLE | 
                 UART_LCRH_BRK_DISABLE;
+} /* UART_set_baud_rate */
 
-  // Now enable UART0
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function keeps the baud rate across a bus clock change. Before the
+//    change it waits for the TX ring and transmit FIFO to empty and the last
+//    byte to leave the shift register. After it, UART0 is briefly disabled
+//    while the divisors are recomputed; bytes arriving in that moment are
+//    lost.
+//
+// INPUT PARAMETERS:
+//   stage - CLOCK_CHANGE_PREPARE or CLOCK_CHANGE_COMMIT
+//   freq  - the new bus clock frequency in Hz
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+static void UART_clock_changed(uint8_t stage, uint32_t freq)
+{
+  if (stage == CLOCK_CHANGE_PREPARE)
+  {
+    while (g_uart_ring.tx_head != g_uart_ring.tx_tail);
+    while ((UART0->STAT & UART_STAT_BUSY_MASK) == UART_STAT_BUSY_SET);
+    return;
+  } /* if */
+
+  UART0->CTL0 &= ~UART_CTL0_ENABLE_MASK;
+  UART_set_baud_rate(freq);
   UART0->CTL0 |= UART_CTL0_ENABLE_ENABLE;
-} /* UART_init */
+} /* UART_clock_changed */
 
 
 
 //-----------------------------------------------------------------------------
 // DESCRIPTION:
-//    This function reads a single character from the UART0 receiver. It waits
-//    until there is data available in the receiver FIFO (RXFE is clear) and
-//    then returns the received character.
+//    This function reads a single character from the UART0 receive ring
+//    buffer. If the ring is empty the calling task waits for the UART ISR
+//    to signal that a byte has arrived, so other tasks run in the meantime.
 //
-//    Call this function to read a character from the UART0 receiver.
 //    This function blocks execution until a character is available, which
 //    means it will wait indefinitely if no data is received.
 //
@@ -158,20 +270,22 @@ void UART_init(uint32_t baud_rate)
 // -----------------------------------------------------------------------------
 char UART_in_char(void)
 {
-  while((UART0->STAT & UART_STAT_RXFE_MASK) == UART_STAT_RXFE_SET);
+  char data;
 
-  return((char)(UART0->RXDATA));
+  while (UART_read(&data, 1) == 0)
+  {
+    kernel_wait_event(KERNEL_EVENT_UART_RX);
+  } /* while */
+
+  return data;
 } /* UART_in_char */
 
 
 //-----------------------------------------------------------------------------
 // DESCRIPTION:
-//    This function transmits a single character via UART0. It waits until
-//    there is space available in the transmitter FIFO (TXFF is clear) and
-//    then writes the character to the UART0 transmitter data register.
-//
-//    This function blocks execution until the transmitter FIFO has space,
-//    which means it will wait indefinitely if the FIFO is full.
+//    This function queues a single character for transmission via UART0.
+//    If the transmit ring buffer is full the calling task waits for the UART
+//    ISR to make room.
 //
 // INPUT PARAMETERS:
 //   data - letter is an 8-bit ASCII character to be transferred
@@ -184,17 +298,19 @@ char UART_in_char(void)
 // -----------------------------------------------------------------------------
 void UART_out_char(char data)
 {
-  // wait if TxFifo full
-  while((UART0->STAT & UART_STAT_TXFF_MASK) == UART_STAT_TXFF_SET);
-
-  UART0->TXDATA = data;
+  while (UART_write(&data, 1) == 0)
+  {
+    kernel_wait_event(KERNEL_EVENT_UART_TX);
+  } /* while */
 } /* UART_out_char */
 
 
 //------------------------------------------------------------------------------
 // DESCRIPTION:
 //  This function sends and displays a string over the UART and console. It goes
-//  through the string until it reaches the end (null character) and then stops. 
+//  through the string until it reaches the end (null character) and then stops.
+//  It returns as soon as the whole string is queued, not when it has been
+//  sent.
 //
 // INPUT PARAMETERS:
 //  string - message to be sent and displayed over the UART and console.
@@ -207,11 +323,237 @@ void UART_out_char(char data)
 //------------------------------------------------------------------------------
 void UART_write_string(char* string)
 {
-  uint8_t index = 0;
-  char current_char = *(string + index);
-  while (current_char != '\0')
+  uint16_t length = 0;
+  uint16_t queued;
+
+  while (string[length] != '\0')
+  {
+    length++;
+  } /* while */
+
+  while (length > 0)
   {
-    current_char = *(string + index++);
-    UART_out_char(current_char); 
+    queued = UART_write(string, length);
+    if (queued == 0)
+    {
+      kernel_wait_event(KERNEL_EVENT_UART_TX);
+    } /* if */
+    string += queued;
+    length -= queued;
   } /* while */
-} /* UART_write_string */
\ No newline at end of file
+} /* UART_write_string */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function copies up to count received characters out of the RX ring
+//    buffer. It never blocks.
+//
+// INPUT PARAMETERS:
+//   count - maximum number of characters to read
+//
+// OUTPUT PARAMETERS:
+//   buffer - the characters read
+//
+// RETURN:
+//   The number of characters read, 0 if none were waiting
+// -----------------------------------------------------------------------------
+uint16_t UART_read(char *buffer, uint16_t count)
+{
+  uint16_t tail = g_uart_ring.rx_tail;
+  uint16_t head = g_uart_ring.rx_head;
+  uint16_t read_count = 0;
+
+  while ((tail != head) && (read_count < count))
+  {
+    buffer[read_count++] = g_uart_ring.rx_buffer[tail];
+    tail = (tail + 1) & UART_RX_BUFFER_MASK;
+  } /* while */
+
+  g_uart_ring.rx_tail = tail;
+
+  return read_count;
+} /* UART_read */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function queues up to count characters in the TX ring buffer and
+//    starts the transmitter. It never blocks; characters that do not fit are
+//    left for the caller to retry.
+//
+// INPUT PARAMETERS:
+//   buffer - the characters to send
+//   count  - number of characters to send
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   The number of characters queued, 0 if the ring buffer is full
+// -----------------------------------------------------------------------------
+uint16_t UART_write(const char *buffer, uint16_t count)
+{
+  uint16_t head = g_uart_ring.tx_head;
+  uint16_t tail = g_uart_ring.tx_tail;
+  uint16_t write_count = 0;
+  uint16_t next_head;
+
+  while (write_count < count)
+  {
+    next_head = (head + 1) & UART_TX_BUFFER_MASK;
+    if (next_head == tail)
+    {
+      break;
+    } /* if */
+    g_uart_ring.tx_buffer[head] = buffer[write_count++];
+    head = next_head;
+  } /* while */
+
+  g_uart_ring.tx_head = head;
+  g_uart_stats.tx_bytes += write_count;
+
+  // Mask the TX interrupt so the ISR and this task are not both draining the
+  // ring, then prime the FIFO. The ISR takes over once the FIFO drains.
+  UART0->CPU_INT.IMASK &= ~UART_CPU_INT_IMASK_TXINT_SET;
+  UART_fill_tx_fifo();
+
+  return write_count;
+} /* UART_write */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function handles the UART0 interrupt. It is called by
+//    UART0_IRQHandler. Received bytes are moved into the RX ring buffer;
+//    bytes that do not fit are dropped and counted. When the transmit FIFO
+//    drains it is refilled from the TX ring buffer.
+//
+// INPUT PARAMETERS:
+//   none
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+void UART_irq_handler(void)
+{
+  uint16_t head;
+  uint16_t next_head;
+  char data;
+
+  switch (UART0->CPU_INT.IIDX)  // Read (clears)
+  {
+    case UART_CPU_INT_IIDX_STAT_RXIFG:
+      head = g_uart_ring.rx_head;
+      while ((UART0->STAT & UART_STAT_RXFE_MASK) != UART_STAT_RXFE_SET)
+      {
+        data = (char)UART0->RXDATA;
+        next_head = (head + 1) & UART_RX_BUFFER_MASK;
+        if (next_head == g_uart_ring.rx_tail)
+        {
+          g_uart_stats.rx_dropped++;
+        } /* if */
+        else
+        {
+          g_uart_ring.rx_buffer[head] = data;
+          head = next_head;
+          g_uart_stats.rx_bytes++;
+        } /* else */
+      } /* while */
+      g_uart_ring.rx_head = head;
+      kernel_signal_event(KERNEL_EVENT_UART_RX);
+      break;
+
+    case UART_CPU_INT_IIDX_STAT_TXIFG:
+      UART_fill_tx_fifo();
+      kernel_signal_event(KERNEL_EVENT_UART_TX);
+      break;
+
+    default:
+      break;
+  } /* switch */
+} /* UART_irq_handler */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function moves bytes from the TX ring buffer into the transmit FIFO
+//    until the FIFO is full or the ring is empty. The TX interrupt is left
+//    unmasked only while the ring still holds data. The caller must make sure
+//    the ISR cannot run this at the same time.
+//
+// INPUT PARAMETERS:
+//   none
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+static void UART_fill_tx_fifo(void)
+{
+  uint16_t tail = g_uart_ring.tx_tail;
+
+  while ((tail != g_uart_ring.tx_head) &&
+         ((UART0->STAT & UART_STAT_TXFF_MASK) != UART_STAT_TXFF_SET))
+  {
+    UART0->TXDATA = g_uart_ring.tx_buffer[tail];
+    tail = (tail + 1) & UART_TX_BUFFER_MASK;
+  } /* while */
+
+  g_uart_ring.tx_tail = tail;
+
+  if (tail != g_uart_ring.tx_head)
+  {
+    UART0->CPU_INT.IMASK |= UART_CPU_INT_IMASK_TXINT_SET;
+  } /* if */
+  else
+  {
+    UART0->CPU_INT.IMASK &= ~UART_CPU_INT_IMASK_TXINT_SET;
+  } /* else */
+} /* UART_fill_tx_fifo */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function copies the UART0 traffic totals counted since startup or 
+//    the last call to UART_clear_stats().
+//
+// INPUT PARAMETERS:
+//   none
+//
+// OUTPUT PARAMETERS:
+//   stats - the UART0 traffic totals
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+void UART_get_stats(uart_stats_struct *stats)
+{
+  *stats = g_uart_stats;
+} /* UART_get_stats */
+
+
+//-----------------------------------------------------------------------------
+// DESCRIPTION:
+//    This function resets the UART0 traffic totals to zero.
+//
+// INPUT PARAMETERS:
+//   none
+//
+// OUTPUT PARAMETERS:
+//   none
+//
+// RETURN:
+//   none
+// -----------------------------------------------------------------------------
+void UART_clear_stats(void)
+{
+  g_uart_stats.tx_bytes = 0;
+  g_uart_stats.rx_bytes = 0;
+  g_uart_stats.rx_dropped = 0;
+} /* UART_clear_stats */
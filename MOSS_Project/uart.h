@@ -58,6 +58,19 @@
 #include <stdint.h>
 
 
+// Sizes of the interrupt-fed ring buffers (must be powers of two)
+#define UART_RX_BUFFER_SIZE                                                (128)
+#define UART_TX_BUFFER_SIZE                                                (256)
+
+// Running totals of UART0 traffic, used to measure driver throughput
+typedef struct
+{
+  uint32_t tx_bytes;
+  uint32_t rx_bytes;
+  uint32_t rx_dropped;
+} uart_stats_struct;
+
+
 // --------------------------------------------------------------------------
 // Prototype for Launchpad support functions
 // --------------------------------------------------------------------------
@@ -66,6 +79,11 @@ void UART_init(uint32_t baud_rate);
 char UART_in_char(void);
 void UART_out_char(char data);
 void UART_write_string(char *string);
+uint16_t UART_read(char *buffer, uint16_t count);
+uint16_t UART_write(const char *buffer, uint16_t count);
+void UART_irq_handler(void);
+void UART_get_stats(uart_stats_struct *stats);
+void UART_clear_stats(void);
 
 
 